@@ -0,0 +1,60 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_CATALOG_CONJUNCTIONS_H
+#define KEP_TOOLBOX_CATALOG_CONJUNCTIONS_H
+
+#include <cstddef>
+#include <vector>
+
+#include <keplerian_toolbox/catalog/tle_catalog.hpp>
+#include <keplerian_toolbox/detail/visibility.hpp>
+
+namespace kep_toolbox
+{
+namespace catalog
+{
+
+/// A close approach between two catalog objects
+struct KEP_TOOLBOX_DLL_PUBLIC conjunction {
+    /// Index of the first object in the catalog
+    std::size_t i;
+    /// Index of the second object in the catalog (always larger than i)
+    std::size_t j;
+    /// Time of closest approach (mjd2000)
+    double tca;
+    /// Distance at the time of closest approach (m)
+    double miss_distance;
+    /// Relative speed at the time of closest approach (m/s)
+    double relative_speed;
+};
+
+KEP_TOOLBOX_DLL_PUBLIC std::vector<conjunction> screen_conjunctions(const tle_catalog &cat, double start,
+                                                                    double end, double threshold, double step,
+                                                                    unsigned n_threads = 0u, double pad = 50000.);
+} // namespace catalog
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_CATALOG_CONJUNCTIONS_H
@@ -0,0 +1,108 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_CATALOG_MPCORB_CATALOG_H
+#define KEP_TOOLBOX_CATALOG_MPCORB_CATALOG_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/detail/visibility.hpp>
+#include <keplerian_toolbox/planet/mpcorb.hpp>
+
+namespace kep_toolbox
+{
+namespace catalog
+{
+
+/// Minor planet catalog (MPCORB.DAT)
+/**
+ * This class loads a whole MPCORB.DAT file in a compact structure-of-arrays. The file is memory mapped and
+ * split in chunks that are parsed in parallel, reading the fixed-width fields in place (no per-line allocations).
+ * The data are the same as those of planet::mpcorb (elements in SI units, lower case names), and planet::mpcorb
+ * objects can be materialized on demand via get_planet().
+ *
+ * The MPCORB.DAT header, if present, is skipped: parsing starts after the line of dashes that closes it. Lines
+ * too short to contain the orbital data (e.g. the empty lines separating the catalog sections) are ignored, while
+ * malformed data lines result in an exception.
+ */
+class KEP_TOOLBOX_DLL_PUBLIC mpcorb_catalog
+{
+public:
+    mpcorb_catalog();
+    mpcorb_catalog(const std::string &file_name, unsigned n_threads = 0u);
+
+    std::size_t size() const;
+
+    /** @name Structure-of-arrays access */
+    //@{
+    const std::vector<double> &get_a() const;
+    const std::vector<double> &get_e() const;
+    const std::vector<double> &get_i() const;
+    const std::vector<double> &get_W() const;
+    const std::vector<double> &get_w() const;
+    const std::vector<double> &get_M() const;
+    const std::vector<double> &get_ref_mjd2000() const;
+    const std::vector<double> &get_H() const;
+    const std::vector<unsigned> &get_n_observations() const;
+    const std::vector<unsigned> &get_n_oppositions() const;
+    const std::vector<unsigned> &get_year_of_discovery() const;
+    //@}
+
+    /** @name Per object access */
+    //@{
+    array6D get_elements(std::size_t idx) const;
+    std::string get_name(std::size_t idx) const;
+    planet::mpcorb get_planet(std::size_t idx) const;
+    //@}
+
+    /// Width of the name field in MPCORB.DAT
+    static const std::size_t name_width = 28u;
+
+private:
+    void parse(const char *begin, const char *end, unsigned n_threads);
+    void check_index(std::size_t idx) const;
+
+    std::vector<double> m_a;
+    std::vector<double> m_e;
+    std::vector<double> m_i;
+    std::vector<double> m_W;
+    std::vector<double> m_w;
+    std::vector<double> m_M;
+    std::vector<double> m_ref_mjd2000;
+    std::vector<double> m_H;
+    std::vector<unsigned> m_n_observations;
+    std::vector<unsigned> m_n_oppositions;
+    std::vector<unsigned> m_year_of_discovery;
+    // Names are stored in fixed-width slots of name_width characters.
+    std::vector<char> m_names;
+    std::vector<unsigned char> m_name_lengths;
+};
+} // namespace catalog
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_CATALOG_MPCORB_CATALOG_H
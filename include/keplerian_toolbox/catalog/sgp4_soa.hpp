@@ -0,0 +1,105 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_CATALOG_SGP4_SOA_H
+#define KEP_TOOLBOX_CATALOG_SGP4_SOA_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <keplerian_toolbox/detail/visibility.hpp>
+#include <keplerian_toolbox/third_party/libsgp4/SGP4.h>
+
+namespace kep_toolbox
+{
+namespace catalog
+{
+
+class tle_catalog;
+
+/// Positions and velocities in structure-of-arrays form
+struct KEP_TOOLBOX_DLL_PUBLIC soa_states {
+    void resize(std::size_t n);
+    std::size_t size() const;
+
+    std::vector<double> x, y, z;
+    std::vector<double> vx, vy, vz;
+};
+
+/// Structure-of-arrays SGP4 propagator
+/**
+ * This class keeps the SGP4 initialised constants of many satellites in structure-of-arrays form and
+ * propagates them in blocks of sgp4_soa::lanes satellites, the blocks being spread over threads. Within a block, the
+ * secular update, the long period periodics, the Kepler equation solution and the short period periodics are each a
+ * loop over the satellites of the block (the near-Earth model selection and the Kepler iterations use per-lane masks).
+ * These loops call libm with its default semantics and are not vectorized by the compiler.
+ *
+ * The arithmetic follows libsgp4 (SGP4::FindPositionSGP4) operation by operation, hence the results match
+ * planet::tle and tle_catalog to round-off. Deep space satellites (period larger than 225 minutes) are propagated
+ * with the scalar libsgp4 SDP4 implementation.
+ *
+ * Units and error reporting are the same as in tle_catalog.
+ */
+class KEP_TOOLBOX_DLL_PUBLIC sgp4_soa
+{
+public:
+    /// Number of satellites propagated together
+    static const std::size_t lanes = 8u;
+
+    sgp4_soa();
+    sgp4_soa(const std::vector<std::string> &line1, const std::vector<std::string> &line2);
+    explicit sgp4_soa(const tle_catalog &cat);
+
+    std::size_t size() const;
+    std::size_t get_n_deep_space() const;
+    const std::vector<double> &get_ref_mjd2000() const;
+
+    void propagate(double mjd2000, soa_states &states, std::vector<int> &status, unsigned n_threads = 0u) const;
+
+private:
+    void init(const std::vector<std::string> &line1, const std::vector<std::string> &line2);
+    void propagate_block(std::size_t block, double mjd2000, soa_states &states, std::vector<int> &status) const;
+    double *consts(std::size_t field, std::size_t idx);
+    const double *consts(std::size_t field, std::size_t idx) const;
+
+    std::size_t m_size;
+    // Number of satellites in the near-Earth arrays, padded to a multiple of lanes
+    std::size_t m_n_padded;
+    // Initialised constants, one array of m_n_padded values per field
+    std::vector<double> m_consts;
+    // Index in the catalog of the near-Earth satellites
+    std::vector<std::size_t> m_near_index;
+    // Deep space satellites and their index in the catalog
+    std::vector<SGP4> m_deep;
+    std::vector<std::size_t> m_deep_index;
+    // Catalog indices of the element sets rejected by SGP4 at initialisation
+    std::vector<std::size_t> m_invalid_index;
+    std::vector<double> m_ref_mjd2000;
+};
+} // namespace catalog
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_CATALOG_SGP4_SOA_H
@@ -0,0 +1,102 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_CATALOG_TLE_CATALOG_H
+#define KEP_TOOLBOX_CATALOG_TLE_CATALOG_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/detail/visibility.hpp>
+#include <keplerian_toolbox/planet/tle.hpp>
+#include <keplerian_toolbox/third_party/libsgp4/SGP4.h>
+
+namespace kep_toolbox
+{
+namespace catalog
+{
+
+/// Catalog of objects from two line elements
+/**
+ * This class loads a whole TLE file (two or three line format) and propagates all its objects with SGP4,
+ * in parallel. Contrary to planet::tle, propagation errors do not throw: they are reported, per object and
+ * epoch, in a status array, while the corresponding position and velocity are set to NaN.
+ *
+ * Positions and velocities are in SI units, in the TEME frame used by SGP4 (as for planet::tle).
+ */
+class KEP_TOOLBOX_DLL_PUBLIC tle_catalog
+{
+public:
+    /// Propagation status codes
+    enum status_code : int {
+        /// Propagation successful
+        ok = 0,
+        /// SGP4 could not propagate the elements (e.g. eccentricity out of range)
+        sgp4_error = 1,
+        /// The satellite decayed
+        decayed = 2
+    };
+
+    tle_catalog();
+    tle_catalog(const std::string &file_name, unsigned n_threads = 0u);
+    tle_catalog(const std::vector<std::string> &lines, unsigned n_threads = 0u);
+
+    std::size_t size() const;
+    std::size_t get_n_rejected() const;
+
+    /** @name Per object access */
+    //@{
+    const std::vector<double> &get_ref_mjd2000() const;
+    std::string get_name(std::size_t idx) const;
+    std::string get_line1(std::size_t idx) const;
+    std::string get_line2(std::size_t idx) const;
+    planet::tle get_planet(std::size_t idx) const;
+    //@}
+
+    /** @name Batch propagation */
+    //@{
+    void propagate(double mjd2000, std::vector<array3D> &r, std::vector<array3D> &v, std::vector<int> &status,
+                   unsigned n_threads = 0u) const;
+    void propagate(const std::vector<double> &mjd2000s, std::vector<array3D> &r, std::vector<array3D> &v,
+                   std::vector<int> &status, unsigned n_threads = 0u) const;
+    int propagate(std::size_t idx, double mjd2000, array3D &r, array3D &v) const;
+    //@}
+
+private:
+    void load(const std::vector<std::string> &lines, unsigned n_threads);
+
+    std::vector<SGP4> m_propagators;
+    std::vector<double> m_ref_mjd2000;
+    std::vector<std::string> m_names;
+    std::vector<std::string> m_line1;
+    std::vector<std::string> m_line2;
+    std::size_t m_n_rejected;
+};
+} // namespace catalog
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_CATALOG_TLE_CATALOG_H
@@ -0,0 +1,12 @@
+#ifndef KEP_TOOLBOX_CONFIG_HPP
+#define KEP_TOOLBOX_CONFIG_HPP
+
+// Start of defines instantiated by CMake.
+// clang-format off
+#define KEP_TOOLBOX_VERSION_STRING "2.6"
+#define KEP_TOOLBOX_VERSION_MAJOR 2
+#define KEP_TOOLBOX_VERSION_MINOR 6
+#define PYKEP_USING_SPICE
+
+
+#endif
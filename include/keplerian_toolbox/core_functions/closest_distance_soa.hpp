@@ -0,0 +1,97 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_CLOSEST_DISTANCE_SOA_H
+#define KEP_TOOLBOX_CLOSEST_DISTANCE_SOA_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <boost/math/constants/constants.hpp>
+
+#include <keplerian_toolbox/core_functions/soa.hpp>
+
+namespace kep_toolbox
+{
+
+/// Closest distance along many keplerian arcs (structure-of-arrays)
+/**
+ * As kep_toolbox::closest_distance, for many arcs defined by their initial and final states (see soa.hpp). The
+ * results agree with the scalar function to round-off.
+ *
+ * \param[out] d_min minimum distances along the arcs
+ * \param[out] ra apoapsis radii
+ * \param[in] r0 initial positions
+ * \param[in] v0 initial velocities
+ * \param[in] r1 final positions
+ * \param[in] v1 final velocities
+ * \param[in] mu central body gravitational parameters, one per arc
+ *
+ * NOTE: multiple revolutions are not accounted for
+ *
+ * \throws value_error if the arrays (including \p mu) do not have the same size
+ */
+inline void closest_distance_soa(std::vector<double> &d_min, std::vector<double> &ra, const soa3D &r0,
+                                 const soa3D &v0, const soa3D &r1, const soa3D &v1,
+                                 const std::vector<double> &mu)
+{
+    const double pi2 = boost::math::constants::two_pi<double>();
+    const std::size_t size = detail::soa_size(r0);
+    detail::soa_check_size(v0, size);
+    detail::soa_check_size(r1, size);
+    detail::soa_check_size(v1, size);
+    detail::soa_check_size(mu, size);
+    d_min.resize(size);
+    ra.resize(size);
+    for (std::size_t j = 0u; j < size; ++j) {
+        const double x0 = r0[0][j], y0 = r0[1][j], z0 = r0[2][j];
+        const double vx0 = v0[0][j], vy0 = v0[1][j], vz0 = v0[2][j];
+        const double x1 = r1[0][j], y1 = r1[1][j], z1 = r1[2][j];
+        // Angular momentum, parameter and eccentricity vector
+        const double hx = y0 * vz0 - z0 * vy0, hy = z0 * vx0 - x0 * vz0, hz = x0 * vy0 - y0 * vx0;
+        const double p = (hx * hx + hy * hy + hz * hz) / mu[j];
+        const double R0 = std::sqrt(x0 * x0 + y0 * y0 + z0 * z0);
+        const double R1 = std::sqrt(x1 * x1 + y1 * y1 + z1 * z1);
+        const double ex = (vy0 * hz - vz0 * hy) / mu[j] - x0 / R0;
+        const double ey = (vz0 * hx - vx0 * hz) / mu[j] - y0 / R0;
+        const double ez = (vx0 * hy - vy0 * hx) / mu[j] - z0 / R0;
+        const double e = std::sqrt(ex * ex + ey * ey + ez * ez);
+        // True anomalies of the initial and final positions (in 0-2pi)
+        double ni0 = std::acos((ex * x0 + ey * y0 + ez * z0) / e / R0);
+        double ni1 = std::acos((ex * x1 + ey * y1 + ez * z1) / e / R1);
+        ni0 = (x0 * vx0 + y0 * vy0 + z0 * vz0 < 0.) ? pi2 - ni0 : ni0;
+        ni1 = (x1 * v1[0][j] + y1 * v1[1][j] + z1 * v1[2][j] < 0.) ? pi2 - ni1 : ni1;
+        // The periapsis is traversed if the true anomaly wraps around, circular orbits are special cased
+        const bool circular = e < 1e-12;
+        const double d = (ni0 > ni1) ? p / (1 + e) : std::min(R0, R1);
+        d_min[j] = circular ? R0 : d;
+        ra[j] = circular ? R0 : p / (1 - e);
+    }
+}
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_CLOSEST_DISTANCE_SOA_H
@@ -0,0 +1,154 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_FB_SOA_H
+#define KEP_TOOLBOX_FB_SOA_H
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <keplerian_toolbox/core_functions/soa.hpp>
+
+// Array versions of fb_con, fb_prop and fb_vel, for the evaluation of many fly-bys at once (e.g. all the fly-bys of
+// a population). The vectors are stored in structure-of-arrays form and the planets are replaced by arrays of their
+// safe radii and gravitational parameters (see soa.hpp). The results agree with the scalar functions to round-off.
+
+namespace kep_toolbox
+{
+
+/// Fly-by constraints (structure-of-arrays)
+/**
+ * As kep_toolbox::fb_con, for many fly-bys.
+ *
+ * @param[out] eq_V2 the equality constraints Vin^2 - Vout^2
+ * @param[out] ineq_delta the inequality constraints (the turning angle minus the maximum one)
+ * @param[in] v_rel_in the incoming velocities relative to the planets
+ * @param[in] v_rel_out the outgoing velocities relative to the planets
+ * @param[in] safe_radius the safe radii of the planets
+ * @param[in] mu_self the gravitational parameters of the planets
+ */
+inline void fb_con_soa(std::vector<double> &eq_V2, std::vector<double> &ineq_delta, const soa3D &v_rel_in,
+                       const soa3D &v_rel_out, const std::vector<double> &safe_radius,
+                       const std::vector<double> &mu_self)
+{
+    const std::size_t size = detail::soa_size(v_rel_in);
+    detail::soa_check_size(v_rel_out, size);
+    detail::soa_check_size(safe_radius, size);
+    detail::soa_check_size(mu_self, size);
+    eq_V2.resize(size);
+    ineq_delta.resize(size);
+    const double *ix = v_rel_in[0].data(), *iy = v_rel_in[1].data(), *iz = v_rel_in[2].data();
+    const double *ox = v_rel_out[0].data(), *oy = v_rel_out[1].data(), *oz = v_rel_out[2].data();
+    for (std::size_t j = 0u; j < size; ++j) {
+        const double Vin2 = ix[j] * ix[j] + iy[j] * iy[j] + iz[j] * iz[j];
+        const double Vout2 = ox[j] * ox[j] + oy[j] * oy[j] + oz[j] * oz[j];
+        eq_V2[j] = Vin2 - Vout2;
+        const double e_min = 1 + safe_radius[j] / mu_self[j] * Vin2;
+        const double alpha = std::acos((ix[j] * ox[j] + iy[j] * oy[j] + iz[j] * oz[j]) / std::sqrt(Vin2 * Vout2));
+        ineq_delta[j] = alpha - 2 * std::asin(1 / e_min);
+    }
+}
+
+/// Fly-by propagation (structure-of-arrays)
+/**
+ * As kep_toolbox::fb_prop, for many fly-bys.
+ *
+ * @param[out] v_out the outgoing absolute velocities
+ * @param[in] v_in the incoming absolute velocities
+ * @param[in] v_pla the velocities of the planets
+ * @param[in] rp the pericenter radii of the fly-bys
+ * @param[in] beta the fly-by plane orientations
+ * @param[in] mu the gravitational parameters of the planets
+ */
+inline void fb_prop_soa(soa3D &v_out, const soa3D &v_in, const soa3D &v_pla, const std::vector<double> &rp,
+                        const std::vector<double> &beta, const std::vector<double> &mu)
+{
+    const std::size_t size = detail::soa_size(v_in);
+    detail::soa_check_size(v_pla, size);
+    detail::soa_check_size(rp, size);
+    detail::soa_check_size(beta, size);
+    detail::soa_check_size(mu, size);
+    detail::soa_resize(v_out, size);
+    for (std::size_t j = 0u; j < size; ++j) {
+        const double px = v_pla[0][j], py = v_pla[1][j], pz = v_pla[2][j];
+        const double rx = v_in[0][j] - px, ry = v_in[1][j] - py, rz = v_in[2][j] - pz;
+        const double v_rel_in2 = rx * rx + ry * ry + rz * rz;
+        const double v_rel_in_norm = std::sqrt(v_rel_in2);
+        const double ecc = 1 + rp[j] / mu[j] * v_rel_in2;
+        const double delta = 2 * std::asin(1.0 / ecc);
+        const double ix = rx / v_rel_in_norm, iy = ry / v_rel_in_norm, iz = rz / v_rel_in_norm;
+        // j_hat = vers(i_hat x v_pla), k_hat = i_hat x j_hat
+        double jx = iy * pz - iz * py, jy = iz * px - ix * pz, jz = ix * py - iy * px;
+        const double j_norm = std::sqrt(jx * jx + jy * jy + jz * jz);
+        jx /= j_norm;
+        jy /= j_norm;
+        jz /= j_norm;
+        const double kx = iy * jz - iz * jy, ky = iz * jx - ix * jz, kz = ix * jy - iy * jx;
+        const double ci = v_rel_in_norm * std::cos(delta);
+        const double cj = v_rel_in_norm * std::cos(beta[j]) * std::sin(delta);
+        const double ck = v_rel_in_norm * std::sin(beta[j]) * std::sin(delta);
+        v_out[0][j] = px + ci * ix + cj * jx + ck * kx;
+        v_out[1][j] = py + ci * iy + cj * jy + ck * ky;
+        v_out[2][j] = pz + ci * iz + cj * jz + ck * kz;
+    }
+}
+
+/// Fly-by DV (structure-of-arrays)
+/**
+ * As kep_toolbox::fb_vel, for many fly-bys.
+ *
+ * @param[out] dV the DVs needed to make the fly-bys feasible
+ * @param[in] v_rel_in the incoming velocities relative to the planets
+ * @param[in] v_rel_out the outgoing velocities relative to the planets
+ * @param[in] safe_radius the safe radii of the planets
+ * @param[in] mu_self the gravitational parameters of the planets
+ */
+inline void fb_vel_soa(std::vector<double> &dV, const soa3D &v_rel_in, const soa3D &v_rel_out,
+                       const std::vector<double> &safe_radius, const std::vector<double> &mu_self)
+{
+    const std::size_t size = detail::soa_size(v_rel_in);
+    detail::soa_check_size(v_rel_out, size);
+    detail::soa_check_size(safe_radius, size);
+    detail::soa_check_size(mu_self, size);
+    dV.resize(size);
+    const double *ix = v_rel_in[0].data(), *iy = v_rel_in[1].data(), *iz = v_rel_in[2].data();
+    const double *ox = v_rel_out[0].data(), *oy = v_rel_out[1].data(), *oz = v_rel_out[2].data();
+    for (std::size_t j = 0u; j < size; ++j) {
+        const double Vin2 = ix[j] * ix[j] + iy[j] * iy[j] + iz[j] * iz[j];
+        const double Vout2 = ox[j] * ox[j] + oy[j] * oy[j] + oz[j] * oz[j];
+        const double e_min = 1 + safe_radius[j] / mu_self[j] * Vin2;
+        const double alpha = std::acos((ix[j] * ox[j] + iy[j] * oy[j] + iz[j] * oz[j]) / std::sqrt(Vin2 * Vout2));
+        const double ineq_delta = alpha - 2 * std::asin(1 / e_min);
+        if (ineq_delta > 0.0) {
+            dV[j] = std::sqrt(Vout2 + Vin2 - 2.0 * std::sqrt(Vout2 * Vin2) * std::cos(ineq_delta));
+        } else {
+            dV[j] = std::abs(std::sqrt(Vout2) - std::sqrt(Vin2));
+        }
+    }
+}
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_FB_SOA_H
@@ -0,0 +1,188 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_PROPAGATE_LAGRANGIAN_STM_H
+#define KEP_TOOLBOX_PROPAGATE_LAGRANGIAN_STM_H
+
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/detail/dual.hpp>
+#include <keplerian_toolbox/exceptions.hpp>
+
+namespace kep_toolbox
+{
+
+namespace detail
+{
+
+// Stumpff functions c(z) and s(z) on doubles or dual numbers. Close to zero the closed forms suffer
+// from cancellation and the series expansions are used instead.
+template <class S>
+inline void stumpff_cs(const S &z, S &c, S &s)
+{
+    using std::cos;
+    using std::cosh;
+    using std::sin;
+    using std::sinh;
+    using std::sqrt;
+    if (value(z) > 0.1) {
+        S sz = sqrt(z);
+        c = (1. - cos(sz)) / z;
+        s = (sz - sin(sz)) / (sz * sz * sz);
+    } else if (value(z) < -0.1) {
+        S sz = sqrt(-z);
+        c = (cosh(sz) - 1.) / (-z);
+        s = (sinh(sz) - sz) / (sz * sz * sz);
+    } else {
+        c = 1. / 2. - z * (1. / 24. - z * (1. / 720. - z * (1. / 40320. - z * (1. / 3628800. - z / 479001600.))));
+        s = 1. / 6. - z * (1. / 120. - z * (1. / 5040. - z * (1. / 362880. - z * (1. / 39916800. - z / 6227020800.))));
+    }
+}
+
+// The universal Kepler equation sqrt(mu) t = K(chi), and its derivative dK/dchi = r
+template <class S>
+inline S universal_kepler(const S &chi, const S &r0, const S &sigma0, const S &alpha, S &r)
+{
+    S c, s;
+    S z = alpha * chi * chi;
+    stumpff_cs(z, c, s);
+    r = chi * chi * c + sigma0 * chi * (1. - z * s) + r0 * (1. - z * c);
+    return sigma0 * chi * chi * c + (1. - alpha * r0) * chi * chi * chi * s + r0 * chi;
+}
+
+// Solves the universal Kepler equation for the universal anomaly (doubles only). K is monotonic in chi,
+// so Newton iterations are safeguarded by bisection on a bracket.
+inline double solve_universal_kepler(double r0, double sigma0, double alpha, double t, double mu)
+{
+    const double target = std::sqrt(mu) * t;
+    if (t == 0.) {
+        return 0.;
+    }
+    double r;
+    // Bracket the solution, starting from the small time guess
+    double chi = target / r0;
+    double lo = 0., hi = 0.;
+    double step = chi;
+    for (unsigned i = 0u; i < 2000u; ++i) {
+        if ((universal_kepler(step, r0, sigma0, alpha, r) - target) * t > 0.) {
+            break;
+        }
+        step *= 2.;
+    }
+    (t > 0.) ? hi = step : lo = step;
+    for (unsigned i = 0u; i < ASTRO_MAX_ITER * 4u; ++i) {
+        double k = universal_kepler(chi, r0, sigma0, alpha, r) - target;
+        (k > 0.) ? hi = chi : lo = chi;
+        double next = chi - k / r;
+        if (!(next > lo && next < hi)) {
+            next = (lo + hi) / 2.;
+        }
+        if (std::abs(next - chi) <= 4. * std::numeric_limits<double>::epsilon() * std::abs(chi)) {
+            return next;
+        }
+        chi = next;
+    }
+    return chi;
+}
+
+// Keplerian propagation with the universal anomaly, on doubles or dual numbers. The universal anomaly
+// is found on the values, then one Newton step on S carries the derivatives through the Kepler equation.
+template <class S, class V>
+inline void propagate_universal(V &r, V &v, const S &t, double mu)
+{
+    using std::sqrt;
+    const double sqrt_mu = std::sqrt(mu);
+    S r0 = sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+    S sigma0 = (r[0] * v[0] + r[1] * v[1] + r[2] * v[2]) / sqrt_mu;
+    S alpha = 2. / r0 - (v[0] * v[0] + v[1] * v[1] + v[2] * v[2]) / mu;
+    S chi(solve_universal_kepler(value(r0), value(sigma0), value(alpha), value(t), mu));
+    S rn;
+    S k = universal_kepler(chi, r0, sigma0, alpha, rn);
+    chi = chi - (k - sqrt_mu * t) / rn;
+
+    S c, s;
+    S z = alpha * chi * chi;
+    stumpff_cs(z, c, s);
+    S f = 1. - chi * chi / r0 * c;
+    S g = t - chi * chi * chi * s / sqrt_mu;
+    V rf;
+    for (unsigned i = 0u; i < 3u; ++i) {
+        rf[i] = f * r[i] + g * v[i];
+    }
+    rn = sqrt(rf[0] * rf[0] + rf[1] * rf[1] + rf[2] * rf[2]);
+    S ft = sqrt_mu / (rn * r0) * chi * (z * s - 1.);
+    S gt = 1. - chi * chi / rn * c;
+    for (unsigned i = 0u; i < 3u; ++i) {
+        v[i] = ft * r[i] + gt * v[i];
+    }
+    r = rf;
+}
+} // namespace detail
+
+/// Lagrangian propagation with the state transition matrix
+/**
+ * This template function propagates an initial state for a time t assuming a central body and a keplerian
+ * motion, as propagate_lagrangian, and also computes the state transition matrix (the Jacobian of the final
+ * state with respect to the initial one). The universal anomaly formulation is used, so that elliptic, parabolic
+ * and hyperbolic orbits are dealt with in the same way, and the derivatives are obtained exactly (to round-off)
+ * by forward mode automatic differentiation.
+ *
+ * \param[in,out] r0 initial position vector. On output contains the propagated position.
+ * \param[in,out] v0 initial velocity vector. On output contains the propagated velocity.
+ * \param[in] t propagation time (can be negative)
+ * \param[in] mu central body gravitational parameter
+ * \param[out] stm the state transition matrix \f$ \partial (\mathbf r, \mathbf v) / \partial (\mathbf r_0, \mathbf
+ * v_0)\f$, 6x6 stored by rows
+ *
+ * \throws value_error if mu is not positive
+ */
+template <class T>
+void propagate_lagrangian_stm(T &r0, T &v0, const double &t, const double &mu, std::array<double, 36> &stm)
+{
+    if (!(mu > 0.)) {
+        throw_value_error("Gravitational constant is less or equal to zero");
+    }
+    typedef detail::dual<6> dual6;
+    std::array<dual6, 3> r, v;
+    for (unsigned i = 0u; i < 3u; ++i) {
+        r[i] = dual6::variable(r0[i], i);
+        v[i] = dual6::variable(v0[i], i + 3u);
+    }
+    detail::propagate_universal(r, v, dual6(t), mu);
+    for (unsigned i = 0u; i < 3u; ++i) {
+        r0[i] = r[i].v;
+        v0[i] = v[i].v;
+        for (unsigned j = 0u; j < 6u; ++j) {
+            stm[i * 6u + j] = r[i].d[j];
+            stm[(i + 3u) * 6u + j] = v[i].d[j];
+        }
+    }
+}
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_PROPAGATE_LAGRANGIAN_STM_H
@@ -0,0 +1,229 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_PROPAGATE_TAYLOR_VARIATIONAL_H
+#define KEP_TOOLBOX_PROPAGATE_TAYLOR_VARIATIONAL_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/detail/dual.hpp>
+#include <keplerian_toolbox/exceptions.hpp>
+
+namespace kep_toolbox
+{
+
+namespace detail
+{
+typedef dual<11> taylor_dual;
+
+// As propagate_taylor_step, but on dual numbers: the Taylor coefficients of the variational equations are
+// obtained together with those of the state. The step size is selected on the values only.
+inline double propagate_taylor_variational_step(std::array<taylor_dual, 7> &x0, const double &h, const int &order,
+                                                const std::array<taylor_dual, 3> &thrust, const double &mu,
+                                                const double &veff, const double &xm, const double &eps_a,
+                                                const double &eps_r, std::vector<std::array<taylor_dual, 7>> &x,
+                                                std::vector<std::array<taylor_dual, 21>> &u)
+{
+    x[0] = x0;
+    int n = 0;
+    const double alpha = -1.5; // Exponent for r^2
+    const double beta = -1.;   // Exponent for m
+    taylor_dual sqrtT = thrust[0] * thrust[0] + thrust[1] * thrust[1] + thrust[2] * thrust[2];
+    // The thrust magnitude is not differentiable at zero, its derivatives are set to zero there
+    sqrtT = (sqrtT.v > 0.) ? sqrt(sqrtT) : taylor_dual(0.);
+    while (n < order) {
+        for (int k = 0; k < 7; ++k) {
+            u[n][k] = x[n][k];
+        }
+        for (int j = 0; j <= n; j++) {
+            u[n][7] += u[j][0] * u[n - j][0]; // x^2
+            u[n][8] += u[j][1] * u[n - j][1]; // y^2
+            u[n][9] += u[j][2] * u[n - j][2]; // z^2
+        }
+        u[n][10] = u[n][7] + u[n][8];  // x^2+y^2
+        u[n][11] = u[n][10] + u[n][9]; // r^2
+
+        if (n == 0) {
+            u[n][12] = sqrt(1. / (u[n][11] * u[n][11] * u[n][11]));
+        } else {
+            for (int j = 0; j < n; ++j) {
+                u[n][12] += (alpha * n - j * (alpha + 1)) * u[n - j][11] * u[j][12];
+            }
+            u[n][12] /= n * u[0][11];
+        }
+
+        u[n][13] = -u[n][12] * mu; //-mu/r^3
+
+        for (int j = 0; j <= n; j++) {
+            u[n][14] += u[j][0] * u[n - j][13]; //-mu x /r^3
+            u[n][15] += u[j][1] * u[n - j][13]; //-mu y /r^3
+            u[n][16] += u[j][2] * u[n - j][13]; //-mu z /r^3
+        }
+
+        if (n == 0) {
+            u[n][17] = 1. / u[0][6];
+        } else {
+            for (int j = 0; j < n; ++j) {
+                u[n][17] += (beta * n - j * (beta + 1)) * u[n - j][6] * u[j][17];
+            }
+            u[n][17] /= n * u[0][6];
+        } // 1/m
+
+        u[n][18] = u[n][14] + u[n][17] * thrust[0]; // eq1
+        u[n][19] = u[n][15] + u[n][17] * thrust[1]; // eq2
+        u[n][20] = u[n][16] + u[n][17] * thrust[2]; // eq3
+
+        x[n + 1][0] = 1. / (n + 1) * u[n][3];
+        x[n + 1][1] = 1. / (n + 1) * u[n][4];
+        x[n + 1][2] = 1. / (n + 1) * u[n][5];
+        x[n + 1][3] = 1. / (n + 1) * u[n][18];
+        x[n + 1][4] = 1. / (n + 1) * u[n][19];
+        x[n + 1][5] = 1. / (n + 1) * u[n][20];
+        x[n + 1][6] = (n == 0) ? -sqrtT / veff : taylor_dual(0.);
+        n++;
+    }
+
+    // Optimal step size (see Jorba's method), on the values
+    double xm_n = 0., xm_n1 = 0.;
+    for (int k = 0; k < 7; ++k) {
+        xm_n = std::max(xm_n, std::abs(x[n][k].v));
+        xm_n1 = std::max(xm_n1, std::abs(x[n - 1][k].v));
+    }
+    double rho_m;
+    if (eps_r * xm < eps_a) {
+        rho_m = std::min(std::pow((1 / xm_n), 1. / n), std::pow((1 / xm_n1), 1. / (n - 1)));
+    } else {
+        rho_m = std::min(std::pow((xm / xm_n), 1. / n), std::pow((xm / xm_n1), 1. / (n - 1)));
+    }
+    double step = rho_m / (M_E * M_E);
+    if (h < 0) step = -step;
+    if (std::abs(step) > std::abs(h)) step = h;
+
+    double steppow = step;
+    for (int j = 1; j <= order; ++j) {
+        for (int k = 0; k < 6; ++k) {
+            x0[k] += x[j][k] * steppow;
+        }
+        steppow *= step;
+    }
+    x0[6] += x[1][6] * step;
+    return step;
+}
+} // namespace detail
+
+/// Taylor series propagation of a constant thrust trajectory, with its variational equations
+/**
+ * This template function propagates an initial state as propagate_taylor does, and also computes the Jacobian
+ * of the final state with respect to the initial state, the thrust and the propagation time. The variational
+ * equations are integrated together with the equations of motion by carrying the derivatives through the
+ * Taylor coefficients recursion (forward mode automatic differentiation), while the step sizes are selected
+ * on the state only.
+ *
+ * \param[in,out] r0 initial position vector. On output contains the propagated position.
+ * \param[in,out] v0 initial velocity vector. On output contains the propagated velocity.
+ * \param[in,out] m0 initial mass. On output contains the propagated mass.
+ * \param[in] u thrust vector (cartesian components)
+ * \param[in] t0 propagation time (can be negative)
+ * \param[in] mu central body gravitational parameter
+ * \param[in] veff effective exhaust velocity
+ * \param[out] jac the Jacobian \f$ \partial (\mathbf r, \mathbf v, m) / \partial (\mathbf r_0, \mathbf v_0, m_0,
+ * \mathbf u, t_0) \f$, 7x11 stored by rows
+ * \param[in] log10tolerance logarithm of the desired absolute tolerance
+ * \param[in] log10rtolerance logarithm of the desired relative tolerance
+ * \param[in] max_iter maximum number of iteration allowed
+ * \param[in] max_order maximum order for the polynomial expansion
+ *
+ * \throw value_error if max_iter is hit or max_order is exceeded
+ */
+template <class T>
+void propagate_taylor_variational(T &r0, T &v0, double &m0, const T &u, const double &t0, const double &mu,
+                                  const double &veff, std::array<double, 77> &jac, const int &log10tolerance = -10,
+                                  const int &log10rtolerance = -10, const int &max_iter = 10000,
+                                  const int &max_order = 3000)
+{
+    typedef detail::taylor_dual dual11;
+    std::array<dual11, 7> x0;
+    std::array<dual11, 3> thrust;
+    for (unsigned i = 0u; i < 3u; ++i) {
+        x0[i] = dual11::variable(r0[i], i);
+        x0[i + 3u] = dual11::variable(v0[i], i + 3u);
+        thrust[i] = dual11::variable(u[i], i + 7u);
+    }
+    x0[6] = dual11::variable(m0, 6u);
+
+    std::vector<std::array<dual11, 7>> _x;
+    std::vector<std::array<dual11, 21>> _u;
+    std::array<dual11, 7> zeros7;
+    std::array<dual11, 21> zeros21;
+
+    double step = t0;
+    double eps_a = std::pow(10., log10tolerance);
+    double eps_r = std::pow(10., log10rtolerance);
+    int j;
+    for (j = 0; j < max_iter; ++j) {
+        double xm = 0.;
+        for (int k = 0; k < 7; ++k) {
+            xm = std::max(xm, std::abs(x0[k].v));
+        }
+        double eps_m = (eps_r * xm < eps_a) ? eps_a : eps_r;
+        int order = (int)(std::ceil(-0.5 * std::log(eps_m) + 1));
+        if (order > max_order) throw_value_error("Polynomial order is too high.....");
+        _x.assign(order + 1, zeros7);
+        _u.assign(order, zeros21);
+        double h = detail::propagate_taylor_variational_step(x0, step, order, thrust, mu, veff, xm, eps_a, eps_r, _x,
+                                                            _u);
+        if (std::abs(h) >= std::abs(step))
+            break;
+        else {
+            step = step - h;
+        }
+    }
+    if (j > max_iter - 1) throw_value_error("Maximum number of iteration reached");
+
+    for (unsigned i = 0u; i < 3u; ++i) {
+        r0[i] = x0[i].v;
+        v0[i] = x0[i + 3u].v;
+    }
+    m0 = x0[6].v;
+    // The derivatives with respect to the propagation time are the equations of motion at the final state
+    double r2 = r0[0] * r0[0] + r0[1] * r0[1] + r0[2] * r0[2];
+    double mu_r3 = mu / (r2 * std::sqrt(r2));
+    std::array<double, 7> f = {{v0[0], v0[1], v0[2], -mu_r3 * r0[0] + u[0] / m0, -mu_r3 * r0[1] + u[1] / m0,
+                                -mu_r3 * r0[2] + u[2] / m0,
+                                -std::sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]) / veff}};
+    for (unsigned i = 0u; i < 7u; ++i) {
+        for (unsigned k = 0u; k < 10u; ++k) {
+            jac[i * 11u + k] = x0[i].d[k];
+        }
+        jac[i * 11u + 10u] = f[i];
+    }
+}
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_PROPAGATE_TAYLOR_VARIATIONAL_H
@@ -0,0 +1,86 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_SOA_H
+#define KEP_TOOLBOX_SOA_H
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <keplerian_toolbox/exceptions.hpp>
+
+// Structure-of-arrays containers and helpers shared by the array versions of the core functions (soa_conversions.hpp,
+// fb_soa.hpp, closest_distance_soa.hpp). The array versions evaluate a whole batch in one call and read each
+// component contiguously, but they are compiled as scalar loops: they call libm functions (sin, cos, acos, atan2, ...)
+// in every iteration, and GCC does not vectorize them, not even with -ffast-math.
+
+namespace kep_toolbox
+{
+
+/// Three components of many vectors in structure-of-arrays form
+typedef std::array<std::vector<double>, 3> soa3D;
+/// Six components of many states (cartesian or orbital elements) in structure-of-arrays form
+typedef std::array<std::vector<double>, 6> soa6D;
+
+namespace detail
+{
+template <std::size_t N>
+inline std::size_t soa_size(const std::array<std::vector<double>, N> &x)
+{
+    for (const auto &c : x) {
+        if (c.size() != x[0].size()) {
+            throw_value_error("The components must have the same size");
+        }
+    }
+    return x[0].size();
+}
+
+template <std::size_t N>
+inline void soa_resize(std::array<std::vector<double>, N> &x, std::size_t n)
+{
+    for (auto &c : x) {
+        c.resize(n);
+    }
+}
+
+inline void soa_check_size(const std::vector<double> &x, std::size_t n)
+{
+    if (x.size() != n) {
+        throw_value_error("The arrays must have the same size");
+    }
+}
+
+template <std::size_t N>
+inline void soa_check_size(const std::array<std::vector<double>, N> &x, std::size_t n)
+{
+    if (soa_size(x) != n) {
+        throw_value_error("The arrays must have the same size");
+    }
+}
+} // namespace detail
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_SOA_H
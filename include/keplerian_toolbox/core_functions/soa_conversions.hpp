@@ -0,0 +1,327 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_SOA_CONVERSIONS_H
+#define KEP_TOOLBOX_SOA_CONVERSIONS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include <boost/math/constants/constants.hpp>
+
+#include <keplerian_toolbox/core_functions/soa.hpp>
+
+// Array versions of par2ic, ic2par, ic2eq, eq2ic, eq2par and par2eq. The six components (x, y, z, vx, vy, vz or the
+// elements) of many states are stored in structure-of-arrays form (see soa.hpp). The results agree with the scalar
+// functions to round-off.
+
+namespace kep_toolbox
+{
+
+/// From osculating Keplerian to cartesian (structure-of-arrays)
+/**
+ * As kep_toolbox::par2ic, for many states.
+ *
+ * @param[in] E the osculating Keplerian elements (a,e,i,W,w,E) in SI (E is the Gudermannian if e > 1)
+ * @param[in] mu gravitational parameter, (m^3/s^2)
+ *
+ * @param[out] rv the cartesian positions and velocities (x,y,z,vx,vy,vz)
+ */
+inline void par2ic_soa(const soa6D &E, const double &mu, soa6D &rv)
+{
+    const std::size_t size = detail::soa_size(E);
+    detail::soa_resize(rv, size);
+    const double *A = E[0].data(), *ecc = E[1].data(), *inc = E[2].data(), *omg = E[3].data(), *omp = E[4].data(),
+                 *EA = E[5].data();
+    double *x = rv[0].data(), *y = rv[1].data(), *z = rv[2].data(), *vx = rv[3].data(), *vy = rv[4].data(),
+           *vz = rv[5].data();
+    for (std::size_t j = 0u; j < size; ++j) {
+        const double e = ecc[j];
+        // Negative semi-major axis for hyperbolas, as in par2ic
+        const double a = (e > 1.) ? -A[j] : A[j];
+        const double cE = std::cos(EA[j]), sE = std::sin(EA[j]);
+        double xper, yper, xdotper, ydotper;
+
+        // 1 - Perifocal position and velocity
+        if (e < 1.) {
+            const double b = a * std::sqrt(1. - e * e);
+            const double n = std::sqrt(mu / (a * a * a));
+            xper = a * (cE - e);
+            yper = b * sE;
+            xdotper = -(a * n * sE) / (1. - e * cE);
+            ydotper = (b * n * cE) / (1. - e * cE);
+        } else {
+            const double b = -a * std::sqrt(e * e - 1.);
+            const double n = std::sqrt(-mu / (a * a * a));
+            // tan(EA / 2 + pi / 4) = (1 + sin(EA)) / cos(EA)
+            const double tE = sE / cE, tg = (1. + sE) / cE;
+            const double dNdZeta = e * (1. + tE * tE) - (0.5 + 0.5 * tg * tg) / tg;
+            xper = a / cE - a * e;
+            yper = b * tE;
+            xdotper = a * tE / cE * n / dNdZeta;
+            ydotper = b / (cE * cE) * n / dNdZeta;
+        }
+
+        // 2 - Rotation from the perifocal to the inertial frame
+        const double cosomg = std::cos(omg[j]), cosomp = std::cos(omp[j]), sinomg = std::sin(omg[j]),
+                     sinomp = std::sin(omp[j]), cosi = std::cos(inc[j]), sini = std::sin(inc[j]);
+        const double R00 = cosomg * cosomp - sinomg * sinomp * cosi;
+        const double R01 = -cosomg * sinomp - sinomg * cosomp * cosi;
+        const double R10 = sinomg * cosomp + cosomg * sinomp * cosi;
+        const double R11 = -sinomg * sinomp + cosomg * cosomp * cosi;
+        const double R20 = sinomp * sini;
+        const double R21 = cosomp * sini;
+
+        x[j] = R00 * xper + R01 * yper;
+        y[j] = R10 * xper + R11 * yper;
+        z[j] = R20 * xper + R21 * yper;
+        vx[j] = R00 * xdotper + R01 * ydotper;
+        vy[j] = R10 * xdotper + R11 * ydotper;
+        vz[j] = R20 * xdotper + R21 * ydotper;
+    }
+}
+
+/// From cartesian to osculating Keplerian (structure-of-arrays)
+/**
+ * As kep_toolbox::ic2par, for many states.
+ *
+ * @param[in] rv the cartesian positions and velocities (x,y,z,vx,vy,vz)
+ * @param[in] mu gravitational parameter, (m^3/s^2)
+ *
+ * @param[out] E the osculating Keplerian elements (a,e,i,W,w,E) (E is the Gudermannian if e > 1)
+ */
+inline void ic2par_soa(const soa6D &rv, const double &mu, soa6D &E)
+{
+    const double pi = boost::math::constants::pi<double>();
+    const std::size_t size = detail::soa_size(rv);
+    detail::soa_resize(E, size);
+    const double *x = rv[0].data(), *y = rv[1].data(), *z = rv[2].data(), *vx = rv[3].data(), *vy = rv[4].data(),
+                 *vz = rv[5].data();
+    double *A = E[0].data(), *ecc = E[1].data(), *inc = E[2].data(), *omg = E[3].data(), *omp = E[4].data(),
+           *EA = E[5].data();
+    for (std::size_t j = 0u; j < size; ++j) {
+        // 1 - Angular momentum, node line and eccentricity vector
+        const double hx = y[j] * vz[j] - z[j] * vy[j], hy = z[j] * vx[j] - x[j] * vz[j],
+                     hz = x[j] * vy[j] - y[j] * vx[j];
+        const double p = (hx * hx + hy * hy + hz * hz) / mu;
+        const double nn = std::sqrt(hx * hx + hy * hy);
+        const double nx = -hy / nn, ny = hx / nn;
+        const double R0 = std::sqrt(x[j] * x[j] + y[j] * y[j] + z[j] * z[j]);
+        const double ex = (vy[j] * hz - vz[j] * hy) / mu - x[j] / R0;
+        const double ey = (vz[j] * hx - vx[j] * hz) / mu - y[j] / R0;
+        const double ez = (vx[j] * hy - vy[j] * hx) / mu - z[j] / R0;
+        const double e = std::sqrt(ex * ex + ey * ey + ez * ez);
+
+        // 2 - Elements
+        A[j] = std::abs(p / (1. - e * e));
+        ecc[j] = e;
+        inc[j] = std::acos(hz / std::sqrt(hx * hx + hy * hy + hz * hz));
+        const double w = std::acos((nx * ex + ny * ey) / e);
+        omp[j] = (ez < 0.) ? 2. * pi - w : w;
+        const double W = std::acos(nx);
+        omg[j] = (ny < 0.) ? 2. * pi - W : W;
+
+        // 3 - True anomaly (in 0, 2 pi), then eccentric anomaly or Gudermannian
+        const double ni0 = std::acos((ex * x[j] + ey * y[j] + ez * z[j]) / e / R0);
+        const double ni = (x[j] * vx[j] + y[j] * vy[j] + z[j] * vz[j] < 0.) ? 2. * pi - ni0 : ni0;
+        EA[j] = 2. * std::atan(std::sqrt(std::abs(1. - e) / (1. + e)) * std::tan(ni / 2.));
+    }
+}
+
+/// From cartesian to modified equinoctial (structure-of-arrays)
+/**
+ * As kep_toolbox::ic2eq, for many states.
+ *
+ * @param[in] rv the cartesian positions and velocities (x,y,z,vx,vy,vz)
+ * @param[in] mu gravitational parameter, (m^3/s^2)
+ * @param[in] retrograde forces retrograde elements to be used
+ *
+ * @param[out] EQ the modified equinoctial elements (p,f,g,h,k,L)
+ */
+inline void ic2eq_soa(const soa6D &rv, const double &mu, soa6D &EQ, const bool retrograde = false)
+{
+    const double I = retrograde ? -1. : 1.;
+    const std::size_t size = detail::soa_size(rv);
+    detail::soa_resize(EQ, size);
+    const double *x = rv[0].data(), *y = rv[1].data(), *z = rv[2].data(), *vx = rv[3].data(), *vy = rv[4].data(),
+                 *vz = rv[5].data();
+    double *P = EQ[0].data(), *F = EQ[1].data(), *G = EQ[2].data(), *H = EQ[3].data(), *K = EQ[4].data(),
+           *L = EQ[5].data();
+    for (std::size_t j = 0u; j < size; ++j) {
+        const double angx = y[j] * vz[j] - z[j] * vy[j], angy = z[j] * vx[j] - x[j] * vz[j],
+                     angz = x[j] * vy[j] - y[j] * vx[j];
+
+        // 0 - Semi-major axis
+        const double R0 = std::sqrt(x[j] * x[j] + y[j] * y[j] + z[j] * z[j]);
+        const double V0 = std::sqrt(vx[j] * vx[j] + vy[j] * vy[j] + vz[j] * vz[j]);
+        const double a = std::abs(1. / (2. / R0 - V0 * V0 / mu));
+
+        // 1 - Equinoctial frame
+        const double ang = std::sqrt(angx * angx + angy * angy + angz * angz);
+        const double wx = angx / ang, wy = angy / ang, wz = angz / ang;
+        const double k = wx / (1. + I * wz);
+        const double h = -wy / (1. + I * wz);
+        const double den = k * k + h * h + 1.;
+        const double fx = (1. - k * k + h * h) / den, fy = (2. * k * h) / den, fz = (-2. * I * k) / den;
+        const double gx = (2. * I * k * h) / den, gy = (1. + k * k - h * h) * I / den, gz = (2. * h) / den;
+
+        // 2 - Eccentricity vector
+        const double ex = (vy[j] * angz - vz[j] * angy) / mu - x[j] / R0;
+        const double ey = (vz[j] * angx - vx[j] * angz) / mu - y[j] / R0;
+        const double ez = (vx[j] * angy - vy[j] * angx) / mu - z[j] / R0;
+        const double ecc2 = ex * ex + ey * ey + ez * ez;
+
+        // 3 - True longitude, from the best conditioned projection of r on the (f, g) plane
+        const double det1 = gy * fx - fy * gx, det2 = gz * fx - fz * gx, det3 = gz * fy - fz * gy;
+        const double max = std::max(std::abs(det1), std::max(std::abs(det2), std::abs(det3)));
+        const bool use1 = std::abs(det1) == max, use2 = !use1 && std::abs(det2) == max;
+        const double det = use1 ? det1 : (use2 ? det2 : det3);
+        const double Xn = use1 ? gy * x[j] - gx * y[j] : (use2 ? gz * x[j] - gx * z[j] : gz * y[j] - gy * z[j]);
+        const double Yn = use1 ? -fy * x[j] + fx * y[j] : (use2 ? -fz * x[j] + fx * z[j] : -fz * y[j] + fy * z[j]);
+
+        P[j] = a * (1. - ecc2);
+        F[j] = ex * fx + ey * fy + ez * fz;
+        G[j] = ex * gx + ey * gy + ez * gz;
+        H[j] = h;
+        K[j] = k;
+        L[j] = std::atan2(Yn / det / R0, Xn / det / R0);
+    }
+}
+
+/// From modified equinoctial to cartesian (structure-of-arrays)
+/**
+ * As kep_toolbox::eq2ic, for many states.
+ *
+ * @param[in] EQ the modified equinoctial elements (p,f,g,h,k,L)
+ * @param[in] mu gravitational parameter, (m^3/s^2)
+ * @param[in] retrograde forces retrograde elements to be used
+ *
+ * @param[out] rv the cartesian positions and velocities (x,y,z,vx,vy,vz)
+ */
+inline void eq2ic_soa(const soa6D &EQ, const double &mu, soa6D &rv, const bool retrograde = false)
+{
+    const double I = retrograde ? -1. : 1.;
+    const std::size_t size = detail::soa_size(EQ);
+    detail::soa_resize(rv, size);
+    const double *P = EQ[0].data(), *F = EQ[1].data(), *G = EQ[2].data(), *H = EQ[3].data(), *K = EQ[4].data(),
+                 *L = EQ[5].data();
+    double *x = rv[0].data(), *y = rv[1].data(), *z = rv[2].data(), *vx = rv[3].data(), *vy = rv[4].data(),
+           *vz = rv[5].data();
+    for (std::size_t j = 0u; j < size; ++j) {
+        // p = a (1 - e^2) is negative for hyperbolas
+        const double par = std::abs(P[j]);
+        const double f = F[j], g = G[j], h = H[j], k = K[j];
+        const double cL = std::cos(L[j]), sL = std::sin(L[j]);
+
+        // Equinoctial reference frame
+        const double den = k * k + h * h + 1.;
+        const double fx = (1. - k * k + h * h) / den, fy = (2. * k * h) / den, fz = (-2. * I * k) / den;
+        const double gx = (2. * I * k * h) / den, gy = (1. + k * k - h * h) * I / den, gz = (2. * h) / den;
+
+        // State in the equinoctial frame
+        const double radius = par / (1. + g * sL + f * cL);
+        const double X = radius * cL, Y = radius * sL;
+        const double VX = -std::sqrt(mu / par) * (g + sL), VY = std::sqrt(mu / par) * (f + cL);
+
+        x[j] = X * fx + Y * gx;
+        y[j] = X * fy + Y * gy;
+        z[j] = X * fz + Y * gz;
+        vx[j] = VX * fx + VY * gx;
+        vy[j] = VX * fy + VY * gy;
+        vz[j] = VX * fz + VY * gz;
+    }
+}
+
+/// From modified equinoctial elements to osculating parameters (structure-of-arrays)
+/**
+ * As kep_toolbox::eq2par, for many states.
+ *
+ * @param[in] EQ the modified equinoctial elements (p,f,g,h,k,L)
+ * @param[in] retrograde forces retrograde elements to be used
+ *
+ * @param[out] E the osculating Keplerian elements (a,e,i,W,w,E) (E is the Gudermannian if e > 1)
+ */
+inline void eq2par_soa(soa6D &E, const soa6D &EQ, const bool retrograde = false)
+{
+    const double pi = boost::math::constants::pi<double>();
+    const double I = retrograde ? -1. : 1.;
+    const std::size_t size = detail::soa_size(EQ);
+    detail::soa_resize(E, size);
+    const double *P = EQ[0].data(), *F = EQ[1].data(), *G = EQ[2].data(), *H = EQ[3].data(), *K = EQ[4].data(),
+                 *L = EQ[5].data();
+    double *A = E[0].data(), *ecc = E[1].data(), *inc = E[2].data(), *omg = E[3].data(), *omp = E[4].data(),
+           *EA = E[5].data();
+    for (std::size_t j = 0u; j < size; ++j) {
+        const double e = std::sqrt(F[j] * F[j] + G[j] * G[j]);
+        const double tmp = std::sqrt(H[j] * H[j] + K[j] * K[j]);
+        const double zita = std::atan2(G[j] / e, F[j] / e);
+        const double W = std::atan2(K[j] / tmp, H[j] / tmp);
+
+        A[j] = P[j] / (1. - e * e);
+        ecc[j] = e;
+        inc[j] = pi / 2. * (1. - I) + 2. * I * std::atan(tmp);
+        omg[j] = W;
+        omp[j] = zita - I * W;
+        // f2e for e < 1, f2zeta for e > 1
+        EA[j] = 2. * std::atan(std::sqrt(std::abs(1. - e) / (1. + e)) * std::tan((L[j] - zita) / 2.));
+    }
+}
+
+/// From osculating Keplerian to equinoctial (structure-of-arrays)
+/**
+ * As kep_toolbox::par2eq, for many states.
+ *
+ * @param[in] E the osculating Keplerian elements (a,e,i,W,w,E) (E is the Gudermannian if e > 1)
+ * @param[in] retrograde forces retrograde elements to be used
+ *
+ * @param[out] EQ the modified equinoctial elements (p,f,g,h,k,L)
+ */
+inline void par2eq_soa(soa6D &EQ, const soa6D &E, const bool retrograde = false)
+{
+    const double I = retrograde ? -1. : 1.;
+    const std::size_t size = detail::soa_size(E);
+    detail::soa_resize(EQ, size);
+    const double *A = E[0].data(), *ecc = E[1].data(), *inc = E[2].data(), *omg = E[3].data(), *omp = E[4].data(),
+                 *EA = E[5].data();
+    double *P = EQ[0].data(), *F = EQ[1].data(), *G = EQ[2].data(), *H = EQ[3].data(), *K = EQ[4].data(),
+           *L = EQ[5].data();
+    for (std::size_t j = 0u; j < size; ++j) {
+        const double e = ecc[j];
+        const double t = std::tan(inc[j] / 2.);
+        const double hk = retrograde ? 1. / t : t;
+        H[j] = hk * std::cos(omg[j]);
+        K[j] = hk * std::sin(omg[j]);
+        P[j] = A[j] * (1. - e * e);
+        F[j] = e * std::cos(omp[j] + I * omg[j]);
+        G[j] = e * std::sin(omp[j] + I * omg[j]);
+        // e2f for e < 1, zeta2f for e > 1
+        const double f = 2. * std::atan(std::sqrt((1. + e) / std::abs(1. - e)) * std::tan(EA[j] / 2.));
+        L[j] = f + omp[j] + I * omg[j];
+    }
+}
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_SOA_CONVERSIONS_H
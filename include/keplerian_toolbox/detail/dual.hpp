@@ -0,0 +1,230 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_DETAIL_DUAL_H
+#define KEP_TOOLBOX_DETAIL_DUAL_H
+
+#include <array>
+#include <cmath>
+
+namespace kep_toolbox
+{
+namespace detail
+{
+
+// Forward mode automatic differentiation: a value together with its derivatives with respect to N independent
+// variables. Only the operations needed by the propagators are implemented. Comparisons are intentionally not
+// overloaded: branches must be taken on the value (member v).
+template <unsigned N>
+struct dual {
+    dual(double x = 0.) : v(x)
+    {
+        d.fill(0.);
+    }
+    // The i-th independent variable, with value x
+    static dual variable(double x, unsigned i)
+    {
+        dual retval(x);
+        retval.d[i] = 1.;
+        return retval;
+    }
+    dual &operator+=(const dual &o)
+    {
+        v += o.v;
+        for (unsigned i = 0u; i < N; ++i) {
+            d[i] += o.d[i];
+        }
+        return *this;
+    }
+    dual &operator-=(const dual &o)
+    {
+        v -= o.v;
+        for (unsigned i = 0u; i < N; ++i) {
+            d[i] -= o.d[i];
+        }
+        return *this;
+    }
+    dual &operator*=(const dual &o)
+    {
+        for (unsigned i = 0u; i < N; ++i) {
+            d[i] = d[i] * o.v + v * o.d[i];
+        }
+        v *= o.v;
+        return *this;
+    }
+    dual &operator/=(const dual &o)
+    {
+        v /= o.v;
+        for (unsigned i = 0u; i < N; ++i) {
+            d[i] = (d[i] - v * o.d[i]) / o.v;
+        }
+        return *this;
+    }
+    double v;
+    std::array<double, N> d;
+};
+
+// f(a) given f(a.v) and f'(a.v)
+template <unsigned N>
+inline dual<N> chain(const dual<N> &a, double f, double df)
+{
+    dual<N> retval(f);
+    for (unsigned i = 0u; i < N; ++i) {
+        retval.d[i] = df * a.d[i];
+    }
+    return retval;
+}
+
+template <unsigned N>
+inline dual<N> operator-(const dual<N> &a)
+{
+    return chain(a, -a.v, -1.);
+}
+
+template <unsigned N>
+inline dual<N> operator+(dual<N> a, const dual<N> &b)
+{
+    return a += b;
+}
+
+template <unsigned N>
+inline dual<N> operator-(dual<N> a, const dual<N> &b)
+{
+    return a -= b;
+}
+
+template <unsigned N>
+inline dual<N> operator*(dual<N> a, const dual<N> &b)
+{
+    return a *= b;
+}
+
+template <unsigned N>
+inline dual<N> operator/(dual<N> a, const dual<N> &b)
+{
+    return a /= b;
+}
+
+template <unsigned N>
+inline dual<N> operator+(const dual<N> &a, double b)
+{
+    return chain(a, a.v + b, 1.);
+}
+
+template <unsigned N>
+inline dual<N> operator+(double a, const dual<N> &b)
+{
+    return chain(b, a + b.v, 1.);
+}
+
+template <unsigned N>
+inline dual<N> operator-(const dual<N> &a, double b)
+{
+    return chain(a, a.v - b, 1.);
+}
+
+template <unsigned N>
+inline dual<N> operator-(double a, const dual<N> &b)
+{
+    return chain(b, a - b.v, -1.);
+}
+
+template <unsigned N>
+inline dual<N> operator*(const dual<N> &a, double b)
+{
+    return chain(a, a.v * b, b);
+}
+
+template <unsigned N>
+inline dual<N> operator*(double a, const dual<N> &b)
+{
+    return chain(b, a * b.v, a);
+}
+
+template <unsigned N>
+inline dual<N> operator/(const dual<N> &a, double b)
+{
+    return chain(a, a.v / b, 1. / b);
+}
+
+template <unsigned N>
+inline dual<N> operator/(double a, const dual<N> &b)
+{
+    return chain(b, a / b.v, -a / (b.v * b.v));
+}
+
+template <unsigned N>
+inline dual<N> sqrt(const dual<N> &a)
+{
+    const double s = std::sqrt(a.v);
+    return chain(a, s, 0.5 / s);
+}
+
+template <unsigned N>
+inline dual<N> exp(const dual<N> &a)
+{
+    const double e = std::exp(a.v);
+    return chain(a, e, e);
+}
+
+template <unsigned N>
+inline dual<N> sin(const dual<N> &a)
+{
+    return chain(a, std::sin(a.v), std::cos(a.v));
+}
+
+template <unsigned N>
+inline dual<N> cos(const dual<N> &a)
+{
+    return chain(a, std::cos(a.v), -std::sin(a.v));
+}
+
+template <unsigned N>
+inline dual<N> sinh(const dual<N> &a)
+{
+    return chain(a, std::sinh(a.v), std::cosh(a.v));
+}
+
+template <unsigned N>
+inline dual<N> cosh(const dual<N> &a)
+{
+    return chain(a, std::cosh(a.v), std::sinh(a.v));
+}
+
+// Overloads on double, so that the same template code can run on both types.
+inline double value(double a)
+{
+    return a;
+}
+
+template <unsigned N>
+inline double value(const dual<N> &a)
+{
+    return a.v;
+}
+} // namespace detail
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_DETAIL_DUAL_H
@@ -29,8 +29,13 @@
 #include <keplerian_toolbox/config.hpp>
 
 #include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/catalog/conjunctions.hpp>
+#include <keplerian_toolbox/catalog/mpcorb_catalog.hpp>
+#include <keplerian_toolbox/catalog/sgp4_soa.hpp>
+#include <keplerian_toolbox/catalog/tle_catalog.hpp>
 #include <keplerian_toolbox/core_functions/array3D_operations.hpp>
 #include <keplerian_toolbox/core_functions/closest_distance.hpp>
+#include <keplerian_toolbox/core_functions/closest_distance_soa.hpp>
 #include <keplerian_toolbox/core_functions/convert_anomalies.hpp>
 #include <keplerian_toolbox/core_functions/convert_dates.hpp>
 #include <keplerian_toolbox/core_functions/damon.hpp>
@@ -38,6 +43,7 @@
 #include <keplerian_toolbox/core_functions/eq2par.hpp>
 #include <keplerian_toolbox/core_functions/fb_con.hpp>
 #include <keplerian_toolbox/core_functions/fb_prop.hpp>
+#include <keplerian_toolbox/core_functions/fb_soa.hpp>
 #include <keplerian_toolbox/core_functions/fb_vel.hpp>
 #include <keplerian_toolbox/core_functions/ic2eq.hpp>
 #include <keplerian_toolbox/core_functions/ic2par.hpp>
@@ -48,15 +54,24 @@
 #include <keplerian_toolbox/core_functions/par2eq.hpp>
 #include <keplerian_toolbox/core_functions/par2ic.hpp>
 #include <keplerian_toolbox/core_functions/propagate_lagrangian.hpp>
+#include <keplerian_toolbox/core_functions/propagate_lagrangian_stm.hpp>
 #include <keplerian_toolbox/core_functions/propagate_lagrangian_u.hpp>
 #include <keplerian_toolbox/core_functions/propagate_taylor.hpp>
 #include <keplerian_toolbox/core_functions/propagate_taylor_J2.hpp>
 #include <keplerian_toolbox/core_functions/propagate_taylor_disturbance.hpp>
 #include <keplerian_toolbox/core_functions/propagate_taylor_jorba.hpp>
 #include <keplerian_toolbox/core_functions/propagate_taylor_s.hpp>
+#include <keplerian_toolbox/core_functions/propagate_taylor_variational.hpp>
+#include <keplerian_toolbox/core_functions/soa.hpp>
+#include <keplerian_toolbox/core_functions/soa_conversions.hpp>
 #include <keplerian_toolbox/core_functions/three_impulses_approximation.hpp>
 #include <keplerian_toolbox/epoch.hpp>
 #include <keplerian_toolbox/lambert_problem.hpp>
+#include <keplerian_toolbox/phasing/damon_batch.hpp>
+#include <keplerian_toolbox/phasing/dbscan.hpp>
+#include <keplerian_toolbox/phasing/kdtree.hpp>
+#include <keplerian_toolbox/phasing/lambert_matrix.hpp>
+#include <keplerian_toolbox/phasing/three_impulses_matrix.hpp>
 #include <keplerian_toolbox/planet/base.hpp>
 #include <keplerian_toolbox/planet/gtoc2.hpp>
 #include <keplerian_toolbox/planet/gtoc5.hpp>
@@ -68,9 +83,20 @@
 #include <keplerian_toolbox/planet/tle.hpp>
 #include <keplerian_toolbox/sims_flanagan/leg.hpp>
 #include <keplerian_toolbox/sims_flanagan/leg_s.hpp>
+#include <keplerian_toolbox/sims_flanagan/propulsion_model.hpp>
 #include <keplerian_toolbox/sims_flanagan/sc_state.hpp>
 #include <keplerian_toolbox/sims_flanagan/spacecraft.hpp>
 #include <keplerian_toolbox/sims_flanagan/throttle.hpp>
+#include <keplerian_toolbox/trajopt/batch_fitness.hpp>
+#include <keplerian_toolbox/trajopt/mga_1dsm_evaluator.hpp>
+#include <keplerian_toolbox/trajopt/mga_evaluator.hpp>
+#include <keplerian_toolbox/trajopt/mga_lt_nep_evaluator.hpp>
+#include <keplerian_toolbox/trajopt/mga_sequence_search.hpp>
+#include <keplerian_toolbox/trajopt/pl2pl_N_impulses_evaluator.hpp>
+#include <keplerian_toolbox/util/finite_differences.hpp>
+#include <keplerian_toolbox/util/grid.hpp>
+#include <keplerian_toolbox/util/parallel_for.hpp>
+#include <keplerian_toolbox/util/trajectory_sampling.hpp>
 
 #if defined(PYKEP_USING_SPICE)
 #include <keplerian_toolbox/planet/spice.hpp>
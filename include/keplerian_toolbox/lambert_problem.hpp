@@ -70,13 +70,26 @@ public:
     const std::vector<double> &get_x() const;
     const std::vector<int> &get_iters() const;
     int get_Nmax() const;
+    static void solve_0rev(array3D &v1, array3D &v2, const array3D &r1, const array3D &r2, const double tof,
+                           const double mu, const int cw = 0);
 
 private:
-    int householder(const double T, double &x0, const int N, const double eps, const int itermax);
-    void dTdx(double &DT, double &DDT, double &DDDT, const double x0, const double tof);
-    void x2tof(double &tof, const double x0, const int N);
-    void x2tof2(double &tof, const double x0, const int N);
-    double hypergeometricF(double z, double tol);
+    // Chord, semi-perimeter, radii, lambda (and its square), non dimensional time of flight and radial and
+    // tangential unit vectors at r1 and r2
+    struct geometry {
+        double c, s, R1, R2, lambda, lambda2, T;
+        array3D ir1, ir2, it1, it2;
+    };
+    static void get_geometry(geometry &g, const array3D &r1, const array3D &r2, const double tof, const double mu,
+                             const int cw);
+    static double initial_guess_0rev(const geometry &g);
+    static void terminal_velocities(array3D &v1, array3D &v2, const double x, const geometry &g, const double mu);
+    static int householder(const double T, double &x0, const int N, const double eps, const int itermax,
+                           const double lambda);
+    static void dTdx(double &DT, double &DDT, double &DDDT, const double x0, const double tof, const double lambda);
+    static void x2tof(double &tof, const double x0, const int N, const double lambda);
+    static void x2tof2(double &tof, const double x0, const int N, const double lambda);
+    static double hypergeometricF(double z, double tol);
     friend class boost::serialization::access;
     template <class Archive>
     void serialize(Archive &ar, const unsigned int)
@@ -0,0 +1,59 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_PHASING_DAMON_BATCH_H
+#define KEP_TOOLBOX_PHASING_DAMON_BATCH_H
+
+#include <cstddef>
+#include <vector>
+
+#include <keplerian_toolbox/detail/visibility.hpp>
+
+namespace kep_toolbox
+{
+namespace phasing
+{
+
+/// Lambert arcs in structure-of-arrays form
+/**
+ * The velocities of the spacecraft relative to the departure body at the start of the arcs (v1) and to the arrival
+ * body at their end (v2), in m/s, and the times of flight in s, as in kep_toolbox::damon_approx.
+ */
+struct KEP_TOOLBOX_DLL_PUBLIC lambert_arcs {
+    void resize(std::size_t n);
+    std::size_t size() const;
+
+    std::vector<double> v1x, v1y, v1z;
+    std::vector<double> v2x, v2y, v2z;
+    std::vector<double> tof;
+};
+
+KEP_TOOLBOX_DLL_PUBLIC void damon_batch(const lambert_arcs &arcs, double T_max, double Isp, double m0,
+                                        std::vector<double> &acc, std::vector<double> &dv,
+                                        std::vector<char> &feasible, unsigned n_threads = 0u);
+} // namespace phasing
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_PHASING_DAMON_BATCH_H
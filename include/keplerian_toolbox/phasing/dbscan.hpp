@@ -0,0 +1,46 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_PHASING_DBSCAN_H
+#define KEP_TOOLBOX_PHASING_DBSCAN_H
+
+#include <cstddef>
+#include <vector>
+
+#include <keplerian_toolbox/detail/visibility.hpp>
+#include <keplerian_toolbox/phasing/kdtree.hpp>
+
+namespace kep_toolbox
+{
+namespace phasing
+{
+
+KEP_TOOLBOX_DLL_PUBLIC std::size_t dbscan(const kdtree &tree, double eps, std::size_t min_samples,
+                                          std::vector<long> &labels, std::vector<std::size_t> &core_samples,
+                                          unsigned n_threads = 0u);
+} // namespace phasing
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_PHASING_DBSCAN_H
@@ -0,0 +1,131 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_PHASING_KDTREE_H
+#define KEP_TOOLBOX_PHASING_KDTREE_H
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/catalog/mpcorb_catalog.hpp>
+#include <keplerian_toolbox/detail/visibility.hpp>
+#include <keplerian_toolbox/planet/base.hpp>
+
+namespace kep_toolbox
+{
+namespace phasing
+{
+
+/// Kd-tree over the phasing embedding of a set of planets
+/**
+ * This class indexes the states of a set of planets (typically thousands of asteroids) at one epoch, as points of
+ * a six dimensional embedding where the Euclidean distance is the phasing metric of pykep.phasing.knn:
+ *
+ * - ORBITAL: \f$ (\mathbf r / T + \mathbf v, \mathbf r / T) \f$, where \f$ T \f$ is an average transfer time.
+ *   The distance (m/s) is the DV of a linear model of the orbital transfer.
+ * - EUCLIDEAN: \f$ (\mathbf r / r_{ref}, \mathbf v / v_{ref}) \f$, a non dimensional distance.
+ * - EUCLIDEAN_R: \f$ (\mathbf r / r_{ref}, \mathbf 0) \f$, the non dimensional distance between the positions.
+ *
+ * The ephemerides and the tree are computed in parallel. The tree is balanced (median splits along the widest
+ * dimension of the bounding box of each node), stores the bounding boxes of the nodes and has buckets of at most
+ * leaf_size points. Queries (k nearest neighbours or all the points within a distance) are exact and their results
+ * are sorted by distance (ties by index).
+ *
+ * Since the states of the planets change smoothly, the tree can be moved to a new epoch with update(), which
+ * recomputes the points and refits the bounding boxes keeping the tree structure. The queries stay exact, but the
+ * boxes of a refitted tree overlap more and more: the tree is rebuilt when the total size of the boxes of its leaves
+ * exceeds that of the last build by a given factor.
+ */
+class KEP_TOOLBOX_DLL_PUBLIC kdtree
+{
+public:
+    /// Metrics
+    enum metric { EUCLIDEAN = 0, ORBITAL = 1, EUCLIDEAN_R = 2 };
+    /// A point of the embedding
+    typedef std::array<double, 6> point_type;
+
+    kdtree(const std::vector<planet::planet_ptr> &planets, double mjd2000, metric m = ORBITAL, double T = 180.,
+           double ref_r = ASTRO_AU, double ref_v = ASTRO_EARTH_VELOCITY, unsigned n_threads = 0u);
+    kdtree(const catalog::mpcorb_catalog &cat, double mjd2000, metric m = ORBITAL, double T = 180.,
+           double ref_r = ASTRO_AU, double ref_v = ASTRO_EARTH_VELOCITY, unsigned n_threads = 0u);
+
+    point_type embed(const array3D &r, const array3D &v) const;
+    point_type embed(const planet::base &pl) const;
+
+    void query_knn(const point_type &x, std::size_t k, std::vector<std::size_t> &ids,
+                   std::vector<double> &dists) const;
+    void query_ball(const point_type &x, double r, std::vector<std::size_t> &ids, std::vector<double> &dists) const;
+    void query_knn(const std::vector<std::size_t> &idxs, std::size_t k, std::vector<std::size_t> &ids,
+                   std::vector<double> &dists, unsigned n_threads = 0u) const;
+
+    bool update(double mjd2000, double rebuild_factor = 2., unsigned n_threads = 0u);
+    double get_degradation() const;
+
+    std::size_t size() const;
+    double get_mjd2000() const;
+    metric get_metric() const;
+    const point_type &get_point(std::size_t idx) const;
+    const std::vector<planet::planet_ptr> &get_planets() const;
+
+    /// Maximum number of points in a leaf
+    static const std::size_t leaf_size = 16u;
+
+private:
+    struct node {
+        std::size_t begin;
+        std::size_t end;
+        point_type lo;
+        point_type hi;
+    };
+    void compute_points(unsigned n_threads);
+    void build(unsigned n_threads);
+    void build_node(std::size_t n, std::size_t begin, std::size_t end, unsigned depth, unsigned stop_depth);
+    void refit(unsigned n_threads);
+    double leaves_size() const;
+    void check_index(std::size_t idx) const;
+    template <typename Visitor>
+    void visit(const point_type &x, Visitor &v) const;
+
+    std::vector<planet::planet_ptr> m_planets;
+    double m_mjd2000;
+    metric m_metric;
+    double m_T;
+    double m_ref_r;
+    double m_ref_v;
+    std::vector<point_type> m_points;
+    // Indices of the points, ordered so that each node spans a contiguous range
+    std::vector<std::size_t> m_perm;
+    // Nodes in heap order (the children of n are 2n + 1 and 2n + 2), all leaves are at depth m_depth
+    std::vector<node> m_nodes;
+    unsigned m_depth;
+    // Total size of the boxes of the leaves at the last build
+    double m_build_size;
+};
+} // namespace phasing
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_PHASING_KDTREE_H
@@ -0,0 +1,60 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_PHASING_LAMBERT_MATRIX_H
+#define KEP_TOOLBOX_PHASING_LAMBERT_MATRIX_H
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <keplerian_toolbox/detail/visibility.hpp>
+#include <keplerian_toolbox/planet/base.hpp>
+
+namespace kep_toolbox
+{
+namespace phasing
+{
+
+KEP_TOOLBOX_DLL_PUBLIC std::size_t lambert_matrix(const std::vector<planet::planet_ptr> &planets,
+                                                  const std::array<double, 2> &t0, unsigned n_t0,
+                                                  const std::array<double, 2> &tof, unsigned n_tof,
+                                                  std::vector<float> &dv, std::vector<float> &best_t0,
+                                                  std::vector<float> &best_tof,
+                                                  double dv_max = std::numeric_limits<double>::infinity(),
+                                                  unsigned n_threads = 0u);
+
+KEP_TOOLBOX_DLL_PUBLIC std::size_t lambert_damon_matrix(const std::vector<planet::planet_ptr> &planets,
+                                                        const std::vector<std::size_t> &departures,
+                                                        const std::array<double, 2> &t0, unsigned n_t0,
+                                                        const std::array<double, 2> &tof, unsigned n_tof,
+                                                        double T_max, double Isp, double m0, std::vector<float> &dv,
+                                                        std::vector<float> &best_t0, std::vector<float> &best_tof,
+                                                        unsigned n_threads = 0u);
+} // namespace phasing
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_PHASING_LAMBERT_MATRIX_H
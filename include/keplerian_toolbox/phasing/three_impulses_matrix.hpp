@@ -0,0 +1,65 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_PHASING_THREE_IMPULSES_MATRIX_H
+#define KEP_TOOLBOX_PHASING_THREE_IMPULSES_MATRIX_H
+
+#include <cstddef>
+#include <vector>
+
+#include <keplerian_toolbox/detail/visibility.hpp>
+#include <keplerian_toolbox/planet/base.hpp>
+
+namespace kep_toolbox
+{
+namespace phasing
+{
+
+/// Osculating orbital elements of a catalog in structure-of-arrays form
+/**
+ * The elements (a, e, i, W, w, M) are in SI units, as returned by planet::base::compute_elements, and mu is the
+ * gravitational parameter of the central body of the catalog.
+ */
+struct KEP_TOOLBOX_DLL_PUBLIC soa_elements {
+    soa_elements() = default;
+    soa_elements(const std::vector<planet::planet_ptr> &planets, double mjd2000 = 0., unsigned n_threads = 0u);
+
+    void resize(std::size_t n);
+    std::size_t size() const;
+
+    std::vector<double> a, e, i, W, w, M;
+    double mu = 0.;
+};
+
+KEP_TOOLBOX_DLL_PUBLIC void three_impulses_matrix(const soa_elements &from, const soa_elements &to,
+                                                  std::vector<float> &dv, unsigned n_threads = 0u);
+
+KEP_TOOLBOX_DLL_PUBLIC void three_impulses_knn(const soa_elements &from, const soa_elements &to, std::size_t k,
+                                               std::vector<std::size_t> &ids, std::vector<float> &dv,
+                                               bool exclude_self = false, unsigned n_threads = 0u);
+} // namespace phasing
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_PHASING_THREE_IMPULSES_MATRIX_H
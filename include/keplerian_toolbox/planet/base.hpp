@@ -28,6 +28,7 @@
 
 #include <boost/shared_ptr.hpp>
 #include <string>
+#include <vector>
 
 #include <keplerian_toolbox/astro_constants.hpp>
 #include <keplerian_toolbox/detail/visibility.hpp>
@@ -65,6 +66,7 @@ public:
     /// Ephemerides methods
     void eph(const epoch &when, array3D &r, array3D &v) const;
     void eph(const double mjd2000, array3D &r, array3D &v) const;
+    void eph(const std::vector<double> &mjd2000s, std::vector<array3D> &r, std::vector<array3D> &v) const;
 
     /// Simple basic keplerian mechanics computations
     array6D compute_elements(const epoch &when = kep_toolbox::epoch(0)) const;
@@ -97,6 +99,8 @@ public:
 
 protected:
     virtual void eph_impl(double mjd2000, array3D &r, array3D &v) const = 0;
+    virtual void eph_batch_impl(const std::vector<double> &mjd2000s, std::vector<array3D> &r,
+                                std::vector<array3D> &v) const;
 
 private:
     friend class boost::serialization::access;
@@ -50,6 +50,8 @@ public:
     mpcorb(const std::string & = "00001    3.34  0.12 K107N 113.41048   72.58976   80.39321   10.58682  0.0791382  "
                                  "0.21432817   2.7653485  0 MPO110568  6063  94 1802-2006 0.61 M-v 30h MPCW       0000 "
                                  "     (1) Ceres              20061025");
+    mpcorb(const array6D &elem, const kep_toolbox::epoch &ref_epoch, double H, unsigned n_observations,
+           unsigned n_oppositions, unsigned year_of_discovery, const std::string &name);
     planet_ptr clone() const override;
 
     static epoch packed_date2epoch(std::string);
@@ -83,6 +85,7 @@ private:
     }
 
     static short unsigned packed_date2number(char c);
+    void setup(const array6D &elem, const kep_toolbox::epoch &ref_epoch, const std::string &name);
     // Absolute Magnitude
     double m_H;
     // Number of observations
@@ -27,6 +27,7 @@
 #define KEP_TOOLBOX_PLANET_SPICE_H
 
 #include <string>
+#include <vector>
 
 #include <keplerian_toolbox/planet/base.hpp>
 #include <keplerian_toolbox/detail/visibility.hpp>
@@ -47,6 +48,11 @@ namespace planet
  * in memory. Its only when the ephemerides are actually called that an exception is thrown
  * in case the required kernels are not loaded
  *
+ * NOTE: CSPICE is not re-entrant. All calls into the toolbox are serialized through
+ * kep_toolbox::util::spice_mutex(), so that the ephemerides can be safely computed from many threads.
+ * To limit contention, each thread keeps a small cache of its latest results and the batch
+ * ephemerides (base::eph with a vector of epochs) acquire the mutex only once.
+ *
  * @see http://naif.jpl.nasa.gov/naif/toolkit.html
  *
  * @author Dario Izzo (dario.izzo _AT_ googlemail.com)
@@ -67,6 +73,10 @@ public:
 
 private:
     void eph_impl(double mjd2000, array3D &r, array3D &v) const override;
+    void eph_batch_impl(const std::vector<double> &mjd2000s, std::vector<array3D> &r,
+                        std::vector<array3D> &v) const override;
+    void spkezr_locked(double mjd2000, array3D &r, array3D &v) const;
+    static unsigned long long new_id();
 
     friend class boost::serialization::access;
     template <class Archive>
@@ -77,6 +87,10 @@ private:
         ar &const_cast<std::string &>(m_observer);
         ar &const_cast<std::string &>(m_reference_frame);
         ar &const_cast<std::string &>(m_aberrations);
+        // A loaded object must not hit cache entries of the one it was default constructed as
+        if (Archive::is_loading::value) {
+            m_id = new_id();
+        }
     }
 
     const std::string m_target;
@@ -84,9 +98,9 @@ private:
     const std::string m_reference_frame;
     const std::string m_aberrations;
 
-    // Dummy variables that store intermidiate values to transfer to and from SPICE
-    mutable SpiceDouble m_state[6];
-    mutable SpiceDouble m_lt;
+    // Identifies the (target, observer, frame, aberrations) query in the per-thread caches.
+    // Copies share it as they compute the same ephemerides.
+    unsigned long long m_id;
 };
 } // namespace planet
 } // namespace kep_toolbox
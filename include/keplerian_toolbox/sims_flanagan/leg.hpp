@@ -28,12 +28,18 @@
 
 #include <boost/type_traits/is_same.hpp>
 #include <boost/utility.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
 #include <iterator>
+#include <utility>
 #include <vector>
 
 #include <keplerian_toolbox/core_functions/array3D_operations.hpp>
 #include <keplerian_toolbox/core_functions/propagate_lagrangian.hpp>
 #include <keplerian_toolbox/core_functions/propagate_taylor.hpp>
+#include <keplerian_toolbox/core_functions/soa.hpp>
 #include <keplerian_toolbox/detail/visibility.hpp>
 #include <keplerian_toolbox/epoch.hpp>
 #include <keplerian_toolbox/exceptions.hpp>
@@ -63,6 +69,15 @@ namespace sims_flanagan
  * the cartesian components \f$ \mathbf x = (x_1,y_1,z_1) \f$ of a normalized \f$ \Delta V \f$ and are thus
  * numbers that need to satisfy the constraint \f$|\mathbf x| \le 1\f$
  *
+ * The maximum thrust and the specific impulse are given, at each segment, by the propulsion model of the
+ * spacecraft evaluated at the position of the impulse (or at the beginning of the segment, in the propagation
+ * direction, when high fidelity is on).
+ *
+ * The states reached after each segment are cached, so that when only some throttles change the mismatch
+ * evaluation restarts from the first changed segment on each side of the match point. The cache is used by one
+ * evaluation at a time: concurrent evaluations of the mismatch constraints on a single leg object are thread-safe,
+ * but those not holding the cache propagate the whole leg.
+ *
  * \image html sims_flanagan_leg.png "Visualization of a feasible leg (Earth-Mars)"
  * \image latex sims_flanagan_leg.png "Visualization of a feasible leg (Earth-Mars)" width=5cm
  *
@@ -449,16 +464,93 @@ public:
     template <typename it_type>
     void get_mismatch_con(it_type begin, it_type end) const
     {
+        // An evaluation running while another one holds the cache propagates the whole leg with an empty cache
+        cache_guard guard(m_cache);
+        propagation_cache tmp;
+        propagation_cache &c = guard.owns() ? m_cache : tmp;
         if (m_hf) {
-            get_mismatch_con_low_thrust(begin, end);
+            get_mismatch_con_low_thrust(begin, end, c);
         } else {
-            get_mismatch_con_chemical(begin, end);
+            get_mismatch_con_chemical(begin, end, c);
         }
     }
 
+private:
+    // States after each segment (forward segments in the first half, backward ones in the second) together with
+    // the data they were computed from
+    struct propagation_cache {
+        propagation_cache()
+            : n_seg(0u), hf(false), tol(0), mu(0.), thrust(0.), isp(0.), n_fwd(0u), n_back(0u), fwd_boundary(),
+              back_boundary(), busy(false)
+        {
+        }
+        // Copies start empty, as the copied cache may be in use by another thread
+        propagation_cache(const propagation_cache &) : propagation_cache() {}
+        propagation_cache &operator=(const propagation_cache &)
+        {
+            n_seg = 0u;
+            n_fwd = 0u;
+            n_back = 0u;
+            return *this;
+        }
+        std::size_t n_seg;
+        bool hf;
+        int tol;
+        double mu;
+        double thrust;
+        double isp;
+        propulsion_model propulsion;
+        // Throttle components, start and end epochs of each cached segment
+        std::vector<std::array<double, 5>> throttles;
+        std::vector<array7D> states;
+        // Number of valid cached segments on each side
+        std::size_t n_fwd;
+        std::size_t n_back;
+        // Boundary state and epoch on each side
+        std::array<double, 8> fwd_boundary;
+        std::array<double, 8> back_boundary;
+        // Set while an evaluation uses the cache
+        std::atomic<bool> busy;
+    };
+
+    // Takes the cache for the lifetime of the object, unless another evaluation holds it already
+    class cache_guard
+    {
+    public:
+        explicit cache_guard(propagation_cache &c) : m_c(c), m_owns(!c.busy.exchange(true, std::memory_order_acquire))
+        {
+        }
+        ~cache_guard()
+        {
+            if (m_owns) {
+                m_c.busy.store(false, std::memory_order_release);
+            }
+        }
+        cache_guard(const cache_guard &) = delete;
+        cache_guard &operator=(const cache_guard &) = delete;
+        bool owns() const
+        {
+            return m_owns;
+        }
+
+    private:
+        propagation_cache &m_c;
+        const bool m_owns;
+    };
+
+    // Keplerian arcs of the impulsive model: arc 2i goes from the beginning of segment i to its impulse, arc 2i + 1
+    // from the impulse to the end of the segment
+    struct impulsive_arcs {
+        // States at the two ends of each arc
+        soa3D r0, v0, r1, v1;
+        // Epochs (in seconds) at the two ends of each arc and mass along it
+        std::vector<double> t0, t1, m;
+    };
+    void get_impulsive_arcs(impulsive_arcs &a) const;
+
 protected:
     template <typename it_type>
-    void get_mismatch_con_chemical(it_type begin, it_type end) const
+    void get_mismatch_con_chemical(it_type begin, it_type end, propagation_cache &c) const
     {
         assert(end - begin == 7);
         (void)end;
@@ -466,25 +558,32 @@ protected:
         auto n_seg_fwd = (n_seg + 1) / 2, n_seg_back = n_seg / 2;
 
         // Aux variables
-        double max_thrust = m_sc.get_thrust();
-        double isp = m_sc.get_isp();
+        double max_thrust, isp;
         double norm_dv;
         array3D dv;
 
-        // Initial state
-        array3D rfwd = x_i.get_position();
-        array3D vfwd = x_i.get_velocity();
-        double mfwd = x_i.get_mass();
+        // Initial state, or the cached state after the last unchanged segment
+        update_cache(c);
+        const std::size_t fwd_valid = reusable_segments(c, true);
+        array3D rfwd, vfwd;
+        double mfwd;
+        load_state(c, true, fwd_valid, rfwd, vfwd, mfwd);
 
         // Forward Propagation
         double current_time_fwd = t_i.mjd2000() * ASTRO_DAY2SEC;
-        for (decltype(n_seg_fwd) i = 0u; i < n_seg_fwd; ++i) {
+        if (fwd_valid > 0u) {
+            current_time_fwd = (throttles[fwd_valid - 1u].get_start().mjd2000()
+                                + throttles[fwd_valid - 1u].get_end().mjd2000())
+                               / 2. * ASTRO_DAY2SEC;
+        }
+        for (decltype(n_seg_fwd) i = fwd_valid; i < n_seg_fwd; ++i) {
             double thrust_duration
                 = (throttles[i].get_end().mjd2000() - throttles[i].get_start().mjd2000()) * ASTRO_DAY2SEC;
             double manouver_time
                 = (throttles[i].get_start().mjd2000() + throttles[i].get_end().mjd2000()) / 2. * ASTRO_DAY2SEC;
             propagate_lagrangian(rfwd, vfwd, manouver_time - current_time_fwd, m_mu);
             current_time_fwd = manouver_time;
+            m_sc.get_thrust_isp(rfwd, max_thrust, isp);
 
             for (unsigned j = 0u; j < 3; j++) {
                 dv[j] = max_thrust / mfwd * thrust_duration * throttles[i].get_value()[j];
@@ -495,16 +594,23 @@ protected:
             mfwd *= exp(-norm_dv / isp / ASTRO_G0);
             // Temporary solution to the creation of NaNs when mass gets too small (i.e. 0)
             if (mfwd < 1) mfwd = 1;
+            store_state(c, true, i, rfwd, vfwd, mfwd);
         }
 
-        // Final state
-        array3D rback = x_f.get_position();
-        array3D vback = x_f.get_velocity();
-        double mback = x_f.get_mass();
+        // Final state, or the cached state after the last unchanged segment
+        const std::size_t back_valid = reusable_segments(c, false);
+        array3D rback, vback;
+        double mback;
+        load_state(c, false, back_valid, rback, vback, mback);
 
         // Backward Propagation
         double current_time_back = t_f.mjd2000() * ASTRO_DAY2SEC;
-        for (decltype(n_seg_back) i = 0; i < n_seg_back; i++) {
+        if (back_valid > 0u) {
+            current_time_back = (throttles[n_seg - back_valid].get_start().mjd2000()
+                                 + throttles[n_seg - back_valid].get_end().mjd2000())
+                                / 2. * ASTRO_DAY2SEC;
+        }
+        for (decltype(n_seg_back) i = back_valid; i < n_seg_back; i++) {
             double thrust_duration = (throttles[throttles.size() - i - 1].get_end().mjd2000()
                                       - throttles[throttles.size() - i - 1].get_start().mjd2000())
                                      * ASTRO_DAY2SEC;
@@ -514,6 +620,7 @@ protected:
             // manouver_time - current_time_back is negative, so this should propagate backwards
             propagate_lagrangian(rback, vback, manouver_time - current_time_back, m_mu);
             current_time_back = manouver_time;
+            m_sc.get_thrust_isp(rback, max_thrust, isp);
 
             for (int j = 0; j < 3; j++) {
                 dv[j] = -max_thrust / mback * thrust_duration * throttles[throttles.size() - i - 1].get_value()[j];
@@ -521,6 +628,7 @@ protected:
             norm_dv = norm(dv);
             sum(vback, vback, dv);
             mback *= exp(norm_dv / isp / ASTRO_G0);
+            store_state(c, false, i, rback, vback, mback);
         }
 
         // finally, we propagate from current_time_fwd to current_time_back with a keplerian motion
@@ -536,7 +644,7 @@ protected:
     }
 
     template <typename it_type>
-    void get_mismatch_con_low_thrust(it_type begin, it_type end) const
+    void get_mismatch_con_low_thrust(it_type begin, it_type end, propagation_cache &c) const
     {
         assert(end - begin == 7);
         (void)end;
@@ -544,40 +652,48 @@ protected:
         auto n_seg_fwd = (n_seg + 1) / 2, n_seg_back = n_seg / 2;
 
         // Aux variables
-        double max_thrust = m_sc.get_thrust();
-        double veff = m_sc.get_isp() * ASTRO_G0;
+        double max_thrust, isp, veff;
         array3D thrust;
 
-        // Initial state
-        array3D rfwd = x_i.get_position();
-        array3D vfwd = x_i.get_velocity();
-        double mfwd = x_i.get_mass();
+        // Initial state, or the cached state after the last unchanged segment
+        update_cache(c);
+        const std::size_t fwd_valid = reusable_segments(c, true);
+        array3D rfwd, vfwd;
+        double mfwd;
+        load_state(c, true, fwd_valid, rfwd, vfwd, mfwd);
 
         // Forward Propagation
-        for (decltype(n_seg_fwd) i = 0; i < n_seg_fwd; ++i) {
+        for (decltype(n_seg_fwd) i = fwd_valid; i < n_seg_fwd; ++i) {
             double thrust_duration
                 = (throttles[i].get_end().mjd2000() - throttles[i].get_start().mjd2000()) * ASTRO_DAY2SEC;
 
+            m_sc.get_thrust_isp(rfwd, max_thrust, isp);
+            veff = isp * ASTRO_G0;
             for (unsigned j = 0u; j < 3; j++) {
                 thrust[j] = max_thrust * throttles[i].get_value()[j];
             }
             propagate_taylor(rfwd, vfwd, mfwd, thrust, thrust_duration, m_mu, veff, m_tol, m_tol);
+            store_state(c, true, i, rfwd, vfwd, mfwd);
         }
 
-        // Final state
-        array3D rback = x_f.get_position();
-        array3D vback = x_f.get_velocity();
-        double mback = x_f.get_mass();
+        // Final state, or the cached state after the last unchanged segment
+        const std::size_t back_valid = reusable_segments(c, false);
+        array3D rback, vback;
+        double mback;
+        load_state(c, false, back_valid, rback, vback, mback);
 
         // Backward Propagation
-        for (decltype(n_seg_back) i = 0; i < n_seg_back; i++) {
+        for (decltype(n_seg_back) i = back_valid; i < n_seg_back; i++) {
             double thrust_duration = (throttles[throttles.size() - i - 1].get_end().mjd2000()
                                       - throttles[throttles.size() - i - 1].get_start().mjd2000())
                                      * ASTRO_DAY2SEC;
+            m_sc.get_thrust_isp(rback, max_thrust, isp);
+            veff = isp * ASTRO_G0;
             for (unsigned j = 0u; j < 3; j++) {
                 thrust[j] = max_thrust * throttles[throttles.size() - i - 1].get_value()[j];
             }
             propagate_taylor(rback, vback, mback, thrust, -thrust_duration, m_mu, veff, m_tol, m_tol);
+            store_state(c, false, i, rback, vback, mback);
         }
 
         // Return the mismatch
@@ -628,6 +744,36 @@ public:
             ++start;
         }
     }
+
+    void get_closest_distances(std::vector<double> &d_min) const;
+
+    /// Evaluate the minimum radius constraints
+    /**
+     * Stores, for each segment, \f$ r_{min} - d_i\f$ at the locations indicated by the iterators, where \f$ d_i\f$
+     * is the closest distance to the primary body along the segment (see get_closest_distances). The iterators must
+     * have a distance of \f$ n\f$. If the stored values are not all \f$ \le 0 \f$ then the trajectory is unfeasible.
+     *
+     * @param[out] start std::vector<double>iterator from the first element where to store the constraints
+     * @param[out] end std::vector<double>iterator to the last+1 element where to store the constraints
+     * @param[in] r_min minimum allowed distance from the primary body
+     */
+    template <typename it_type>
+    void get_min_radius_con(it_type start, it_type end, double r_min) const
+    {
+        if ((end - start) != (int)throttles.size()) {
+            throw_value_error("Iterators distance is incompatible with the throttles size");
+        }
+        std::vector<double> d_min;
+        get_closest_distances(d_min);
+        for (std::vector<double>::size_type i = 0; i < d_min.size(); ++i, ++start) {
+            *start = r_min - d_min[i];
+        }
+    }
+
+    void sample_trajectory(unsigned N, std::vector<array3D> &r, std::vector<array3D> &v, std::vector<double> &m) const;
+    void get_constraints_jacobian(std::vector<double> &jac) const;
+    std::vector<std::pair<std::size_t, std::size_t>> get_constraints_jacobian_sparsity() const;
+    void get_constraints_jacobian_sparse(std::vector<double> &values) const;
     //@}
 
     /// Approximate the leg dv
@@ -648,6 +794,85 @@ public:
     }
 
 private:
+    // Resets the cache if the propagation parameters, or the number of segments, changed.
+    void update_cache(propagation_cache &c) const
+    {
+        if (c.n_seg != throttles.size() || c.hf != m_hf || c.tol != m_tol || c.mu != m_mu
+            || c.thrust != m_sc.get_thrust() || c.isp != m_sc.get_isp()
+            || c.propulsion != m_sc.get_propulsion_model()) {
+            c.n_seg = throttles.size();
+            c.hf = m_hf;
+            c.tol = m_tol;
+            c.mu = m_mu;
+            c.thrust = m_sc.get_thrust();
+            c.isp = m_sc.get_isp();
+            c.propulsion = m_sc.get_propulsion_model();
+            c.throttles.assign(throttles.size(), std::array<double, 5>());
+            c.states.assign(throttles.size(), array7D());
+            c.n_fwd = 0u;
+            c.n_back = 0u;
+        }
+    }
+
+    // Returns the number of segments, from the beginning (fwd) or the end of the leg, whose cached final states can
+    // be reused, and marks the following ones as changed in the cache.
+    std::size_t reusable_segments(propagation_cache &c, bool fwd) const
+    {
+        const sc_state &x = fwd ? x_i : x_f;
+        const double t = fwd ? t_i.mjd2000() : t_f.mjd2000();
+        std::array<double, 8> &boundary = fwd ? c.fwd_boundary : c.back_boundary;
+        std::size_t &n_valid = fwd ? c.n_fwd : c.n_back;
+        const array7D state = x.get_state();
+        std::array<double, 8> current;
+        std::copy(state.begin(), state.end(), current.begin());
+        current[7] = t;
+        if (current != boundary) {
+            boundary = current;
+            n_valid = 0u;
+        }
+        std::size_t k = 0u;
+        for (; k < n_valid; ++k) {
+            const throttle &th = throttles[fwd ? k : throttles.size() - 1u - k];
+            std::array<double, 5> key = {{th.get_value()[0], th.get_value()[1], th.get_value()[2],
+                                          th.get_start().mjd2000(), th.get_end().mjd2000()}};
+            if (key != c.throttles[fwd ? k : throttles.size() - 1u - k]) {
+                break;
+            }
+        }
+        n_valid = k;
+        return k;
+    }
+
+    // Loads the state after the first n segments on one side (the boundary state if n is zero).
+    void load_state(const propagation_cache &c, bool fwd, std::size_t n, array3D &r, array3D &v, double &m) const
+    {
+        if (n == 0u) {
+            const sc_state &x = fwd ? x_i : x_f;
+            r = x.get_position();
+            v = x.get_velocity();
+            m = x.get_mass();
+        } else {
+            const array7D &s = c.states[fwd ? n - 1u : throttles.size() - n];
+            std::copy(s.begin(), s.begin() + 3, r.begin());
+            std::copy(s.begin() + 3, s.begin() + 6, v.begin());
+            m = s[6];
+        }
+    }
+
+    // Stores the state after segment i (counted from the beginning or from the end of the leg).
+    void store_state(propagation_cache &c, bool fwd, std::size_t i, const array3D &r, const array3D &v, double m) const
+    {
+        const std::size_t seg = fwd ? i : throttles.size() - 1u - i;
+        const throttle &th = throttles[seg];
+        c.throttles[seg] = {{th.get_value()[0], th.get_value()[1], th.get_value()[2], th.get_start().mjd2000(),
+                             th.get_end().mjd2000()}};
+        array7D &s = c.states[seg];
+        std::copy(r.begin(), r.end(), s.begin());
+        std::copy(v.begin(), v.end(), s.begin() + 3);
+        s[6] = m;
+        (fwd ? c.n_fwd : c.n_back) = i + 1u;
+    }
+
     // Serialization code
     friend class boost::serialization::access;
     template <class Archive>
@@ -673,6 +898,7 @@ private:
     double m_mu;
     bool m_hf;
     int m_tol;
+    mutable propagation_cache m_cache;
 };
 
 KEP_TOOLBOX_DLL_PUBLIC std::ostream &operator<<(std::ostream &s, const leg &in);
@@ -316,8 +316,7 @@ public:
         auto n_seg_fwd = (n_seg + 1) / 2, n_seg_back = n_seg / 2;
 
         // Aux variables
-        double max_thrust = m_sc.get_thrust();
-        double veff = m_sc.get_isp() * ASTRO_G0;
+        double max_thrust, isp, veff;
         array3D thrust;
         double ds = m_sf / static_cast<double>(n_seg);                 // pseudo-time interval for each segment
         double dt = (m_tf.mjd2000() - m_ti.mjd2000()) * ASTRO_DAY2SEC; // length of the leg in seconds
@@ -330,6 +329,8 @@ public:
 
         // Forward Propagation
         for (decltype(n_seg_fwd) i = 0u; i < n_seg_fwd; i++) {
+            m_sc.get_thrust_isp(rfwd, max_thrust, isp);
+            veff = isp * ASTRO_G0;
             for (int j = 0; j < 3; j++) {
                 thrust[j] = max_thrust * m_throttles[i].get_value()[j];
             }
@@ -344,6 +345,8 @@ public:
 
         // Backward Propagation
         for (decltype(n_seg_back) i = 0u; i < n_seg_back; ++i) {
+            m_sc.get_thrust_isp(rback, max_thrust, isp);
+            veff = isp * ASTRO_G0;
             for (unsigned j = 0u; j < 3u; ++j) {
                 thrust[j] = max_thrust * m_throttles[m_throttles.size() - i - 1].get_value()[j];
             }
@@ -394,8 +397,7 @@ public:
         auto n_seg_fwd = (n_seg + 1) / 2, n_seg_back = n_seg / 2;
 
         // Aux variables
-        double max_thrust = m_sc.get_thrust();
-        double veff = m_sc.get_isp() * ASTRO_G0;
+        double max_thrust, isp, veff;
         array3D thrust = {{0, 0, 0}};
         array3D zeros = {{0, 0, 0}};
         double ds = m_sf / static_cast<double>(n_seg);                                      // pseudo-time interval for each segment
@@ -411,6 +413,8 @@ public:
 
         // Forward Propagation
         for (decltype(n_seg_fwd) i = 0u; i < n_seg_fwd; ++i) {
+            m_sc.get_thrust_isp(rfwd, max_thrust, isp);
+            veff = isp * ASTRO_G0;
             for (unsigned j = 0u; j < 3u; ++j) {
                 thrust[j] = max_thrust * m_throttles[i].get_value()[j];
             }
@@ -432,6 +436,8 @@ public:
 
         // Backward Propagation
         for (decltype(n_seg_back) i = 0u; i < n_seg_back; ++i) {
+            m_sc.get_thrust_isp(rback, max_thrust, isp);
+            veff = isp * ASTRO_G0;
             for (unsigned j = 0u; j < 3u; ++j) {
                 thrust[j] = max_thrust * m_throttles[m_throttles.size() - i - 1].get_value()[j];
             }
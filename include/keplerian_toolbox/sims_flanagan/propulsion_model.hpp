@@ -0,0 +1,115 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_PROPULSION_MODEL_H
+#define KEP_TOOLBOX_PROPULSION_MODEL_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <keplerian_toolbox/detail/visibility.hpp>
+#include <keplerian_toolbox/serialization.hpp>
+
+namespace kep_toolbox
+{
+namespace sims_flanagan
+{
+
+/// Propulsion model
+/**
+ * Describes how the maximum thrust and the specific impulse of a low-thrust propulsion system depend on the
+ * distance \f$ r \f$ from the Sun (in AU). Three models are available:
+ *
+ * - constant: the nominal thrust and specific impulse of the spacecraft are used everywhere (the default),
+ * - solar polynomial: a solar electric propulsion system. The power generated is \f$ P = p(r) \f$, reduced by
+ *   the deficit \f$ P_s - p_b(r) \f$ of the power \f$ p_b \f$ available to the bus with respect to its demand
+ *   \f$ P_s \f$ (when positive). The power fed to the engine is \f$ P_{in} = \min(\eta P, P_{max}) \f$ (thermal
+ *   cap) and the thrust and specific impulse are \f$ T = \max(t(P_{in}), 0) \f$ and \f$ I_{sp} = i(P_{in}) \f$,
+ * - tabulated: thrust and specific impulse are linearly interpolated in a table of distances (and kept constant
+ *   outside of the table).
+ *
+ * All polynomials \f$ p, p_b, t, i \f$ are given by their coefficients in increasing degree order.
+ */
+class KEP_TOOLBOX_DLL_PUBLIC propulsion_model
+{
+    friend std::ostream &operator<<(std::ostream &s, const propulsion_model &in);
+
+public:
+    /// Model type
+    enum type { CONSTANT = 0, SOLAR_POLYNOMIAL = 1, TABULATED = 2 };
+
+    propulsion_model();
+    static propulsion_model solar_polynomial(const std::vector<double> &power, const std::vector<double> &bus_power,
+                                             double bus_demand, double efficiency, double max_power,
+                                             const std::vector<double> &thrust, const std::vector<double> &isp);
+    static propulsion_model tabulated(const std::vector<double> &r, const std::vector<double> &thrust,
+                                      const std::vector<double> &isp);
+
+    /// Gets the model type
+    type get_type() const
+    {
+        return m_type;
+    }
+    void eval(double r, double nominal_thrust, double nominal_isp, double &thrust, double &isp) const;
+    bool operator==(const propulsion_model &) const;
+    bool operator!=(const propulsion_model &) const;
+    std::string human_readable() const;
+
+private:
+    // Serialization code
+    friend class boost::serialization::access;
+    template <class Archive>
+    void serialize(Archive &ar, const unsigned int)
+    {
+        ar &m_type;
+        ar &m_power;
+        ar &m_bus_power;
+        ar &m_bus_demand;
+        ar &m_efficiency;
+        ar &m_max_power;
+        ar &m_r;
+        ar &m_thrust;
+        ar &m_isp;
+    }
+    // Serialization code (END)
+    type m_type;
+    // Solar polynomial model
+    std::vector<double> m_power;
+    std::vector<double> m_bus_power;
+    double m_bus_demand;
+    double m_efficiency;
+    double m_max_power;
+    // Thrust and isp, polynomials in the input power (solar polynomial) or table values (tabulated)
+    std::vector<double> m_r;
+    std::vector<double> m_thrust;
+    std::vector<double> m_isp;
+};
+
+KEP_TOOLBOX_DLL_PUBLIC std::ostream &operator<<(std::ostream &s, const propulsion_model &in);
+} // namespace sims_flanagan
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_PROPULSION_MODEL_H
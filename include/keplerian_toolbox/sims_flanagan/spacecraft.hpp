@@ -26,10 +26,13 @@
 #ifndef KEP_TOOLBOX_SPACECRAFT_H
 #define KEP_TOOLBOX_SPACECRAFT_H
 
+#include <cmath>
 #include <iostream>
 
+#include <keplerian_toolbox/astro_constants.hpp>
 #include <keplerian_toolbox/detail/visibility.hpp>
 #include <keplerian_toolbox/serialization.hpp>
+#include <keplerian_toolbox/sims_flanagan/propulsion_model.hpp>
 
 namespace kep_toolbox
 {
@@ -38,7 +41,9 @@ namespace sims_flanagan
 
 /// Spacecraft
 /**
- * A container for system design parameters of a spacecraft.
+ * A container for system design parameters of a spacecraft. The thrust and the specific impulse are the nominal
+ * ones: the values actually used along a trajectory are given by the propulsion model (by default constant, i.e.
+ * equal to the nominal ones) as a function of the distance from the Sun.
  *
  * @author Dario Izzo (dario.izzo _AT_ googlemail.com)
  */
@@ -77,26 +82,57 @@ public:
     {
         m_isp = _isp;
     }
+    const propulsion_model &get_propulsion_model() const
+    {
+        return m_propulsion;
+    }
+    void set_propulsion_model(const propulsion_model &model)
+    {
+        m_propulsion = model;
+    }
+    /// Maximum thrust and specific impulse at a given position
+    /**
+     * \param[in] r heliocentric position (m)
+     * \param[out] thrust maximum thrust (N)
+     * \param[out] isp specific impulse (s)
+     */
+    void get_thrust_isp(const array3D &r, double &thrust, double &isp) const
+    {
+        if (m_propulsion.get_type() == propulsion_model::CONSTANT) {
+            thrust = m_thrust;
+            isp = m_isp;
+        } else {
+            m_propulsion.eval(std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]) / ASTRO_AU, m_thrust, m_isp, thrust,
+                              isp);
+        }
+    }
     std::string human_readable() const;
 
 private:
     // Serialization code
     friend class boost::serialization::access;
     template <class Archive>
-    void serialize(Archive &ar, const unsigned int)
+    void serialize(Archive &ar, const unsigned int version)
     {
         ar &m_mass;
         ar &m_thrust;
         ar &m_isp;
+        // Version 1 adds the propulsion model
+        if (version > 0u) {
+            ar &m_propulsion;
+        }
     }
     // Serialization code (END)
     double m_mass;
     double m_thrust;
     double m_isp;
+    propulsion_model m_propulsion;
 };
 
 KEP_TOOLBOX_DLL_PUBLIC std::ostream &operator<<(std::ostream &s, const spacecraft &in);
 } // namespace sims_flanagan
 } // namespace kep_toolbox
 
+BOOST_CLASS_VERSION(kep_toolbox::sims_flanagan::spacecraft, 1)
+
 #endif // KEP_TOOLBOX_SPACECRAFT_H
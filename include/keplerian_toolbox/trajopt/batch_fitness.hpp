@@ -0,0 +1,87 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_TRAJOPT_BATCH_FITNESS_H
+#define KEP_TOOLBOX_TRAJOPT_BATCH_FITNESS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/util/parallel_for.hpp>
+
+namespace kep_toolbox
+{
+namespace trajopt
+{
+
+/// Batch fitness evaluation
+/**
+ * Evaluates the fitness of a population of decision vectors in parallel. The decision vectors are concatenated
+ * in dvs and the fitness vectors are concatenated, in the same order, in the returned vector (as in the pygmo
+ * batch_fitness interface).
+ *
+ * The evaluators of this namespace keep per-evaluation state and cannot be shared by several threads: each block
+ * of decision vectors is evaluated by its own copy of ev. The copies of the evaluators clone the planets, as the
+ * ephemerides of some of them (e.g. planet::tle) are not reentrant.
+ *
+ * \param[in] ev the evaluator, exposing get_nx(), get_nf() and std::vector<double> fitness(const std::vector<double> &)
+ * \param[in] dvs the decision vectors, concatenated
+ * \param[in] n_threads number of threads (0 means all the available cores)
+ *
+ * @return the fitness vectors, concatenated
+ *
+ * \throws value_error if the size of dvs is not a multiple of the decision vector size
+ */
+template <typename Evaluator>
+inline std::vector<double> batch_fitness(const Evaluator &ev, const std::vector<double> &dvs, unsigned n_threads = 0u)
+{
+    const std::size_t nx = ev.get_nx(), nf = ev.get_nf();
+    if (nx == 0u || dvs.size() % nx != 0u) {
+        throw_value_error("The size of the batch must be a multiple of the decision vector size");
+    }
+    const std::size_t n = dvs.size() / nx;
+    std::vector<double> retval(n * nf);
+    // Blocks small enough to balance evaluations of different cost, large enough to amortise the copies of ev
+    const unsigned n_workers = n_threads ? n_threads : util::default_n_threads();
+    const std::size_t grain = std::max<std::size_t>(1u, std::min<std::size_t>(64u, n / (8u * n_workers)));
+    util::parallel_for(0u, n,
+                       [&](std::size_t b, std::size_t e) {
+                           const Evaluator local(ev);
+                           std::vector<double> x(nx);
+                           for (std::size_t i = b; i < e; ++i) {
+                               std::copy(dvs.begin() + i * nx, dvs.begin() + (i + 1u) * nx, x.begin());
+                               const std::vector<double> f = local.fitness(x);
+                               std::copy(f.begin(), f.end(), retval.begin() + i * nf);
+                           }
+                       },
+                       n_threads, grain);
+    return retval;
+}
+} // namespace trajopt
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_TRAJOPT_BATCH_FITNESS_H
@@ -0,0 +1,110 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_TRAJOPT_MGA_1DSM_EVALUATOR_H
+#define KEP_TOOLBOX_TRAJOPT_MGA_1DSM_EVALUATOR_H
+
+#include <cstddef>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/detail/visibility.hpp>
+#include <keplerian_toolbox/planet/base.hpp>
+
+namespace kep_toolbox
+{
+namespace trajopt
+{
+
+/// Multiple gravity assist trajectory with one deep space manoeuvre per leg (MGA-1DSM)
+/**
+ * This class evaluates the trajectory of pykep.trajopt.mga_1dsm, which is also the kernel of the MGA-1DSM problems
+ * of the trajectory optimisation gym (cassini2, rosetta, messenger, juice, tandem, ...). Each leg starts with a
+ * Keplerian arc (after the launch or an unpowered fly-by), followed by a deep space manoeuvre and a Lambert arc
+ * (zero revolutions, prograde) to the next planet. The objective is the total DV (m/s): the deep space
+ * manoeuvres, optionally the launch hyperbolic velocity and the arrival relative velocity (or, if orbit insertion
+ * is selected, the pericenter burn acquiring the target orbit). If multi-objective, the total time of flight
+ * (days) is the second objective.
+ *
+ * The decision vector depends on the encoding of the times of flight:
+ *
+ * - DIRECT: \f$ [t_0] + [u, v, V_\infty, \eta_1, T_1] + [\beta, r_p/r_P, \eta_2, T_2] + ... \f$
+ * - ALPHA: \f$ [t_0] + [u, v, V_\infty, \eta_1, \alpha_1] + [\beta, r_p/r_P, \eta_2, \alpha_2] + ... + [T] \f$
+ *   with \f$ T_i = T \log\alpha_i / \sum_n \log\alpha_n \f$
+ * - ETA: \f$ [t_0] + [u, v, V_\infty, \eta_1, n_1] + [\beta, r_p/r_P, \eta_2, n_2] + ... \f$ with
+ *   \f$ T_i = (T_{max} - \sum_{j<i} T_j) n_i \f$
+ *
+ * with \f$ t_0 \f$ in mjd2000, \f$ V_\infty \f$ in m/s, the times of flight in days and \f$ \beta \f$ in radians.
+ * The launch hyperbolic velocity has the direction \f$ \theta = 2\pi u \f$, \f$ \phi = \arccos(2v - 1) - \pi/2 \f$
+ * (uniform on the sphere).
+ *
+ * The evaluation does not allocate memory (apart from the returned vector of the convenience overload).
+ *
+ * Copies clone the planets, so that each copy can be used by its own thread (see batch_fitness).
+ */
+class KEP_TOOLBOX_DLL_PUBLIC mga_1dsm_evaluator
+{
+public:
+    /// Encodings of the times of flight
+    enum tof_encoding { DIRECT = 0, ALPHA = 1, ETA = 2 };
+
+    mga_1dsm_evaluator(const std::vector<planet::planet_ptr> &seq, tof_encoding encoding = DIRECT,
+                       double tof_max = 0., bool add_vinf_dep = false, bool add_vinf_arr = true,
+                       bool multi_objective = false, bool orbit_insertion = false, double e_target = 0.,
+                       double rp_target = 0.);
+    mga_1dsm_evaluator(const mga_1dsm_evaluator &);
+    mga_1dsm_evaluator(mga_1dsm_evaluator &&) = default;
+    mga_1dsm_evaluator &operator=(const mga_1dsm_evaluator &);
+    mga_1dsm_evaluator &operator=(mga_1dsm_evaluator &&) = default;
+
+    void fitness(const std::vector<double> &x, std::vector<double> &f) const;
+    std::vector<double> fitness(const std::vector<double> &x) const;
+    void decode_tofs(const std::vector<double> &x, std::vector<double> &T) const;
+    void decode_vinf(const std::vector<double> &x, array3D &vinf) const;
+
+    std::size_t get_nx() const;
+    std::size_t get_nobj() const;
+    std::size_t get_nf() const;
+    const std::vector<planet::planet_ptr> &get_seq() const;
+    tof_encoding get_tof_encoding() const;
+
+private:
+    double tof(const std::vector<double> &x, std::size_t i, double &acc) const;
+
+    std::vector<planet::planet_ptr> m_seq;
+    tof_encoding m_encoding;
+    double m_tof_max;
+    bool m_add_vinf_dep;
+    bool m_add_vinf_arr;
+    bool m_multi_objective;
+    bool m_orbit_insertion;
+    double m_e_target;
+    double m_rp_target;
+    double m_mu;
+};
+} // namespace trajopt
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_TRAJOPT_MGA_1DSM_EVALUATOR_H
@@ -0,0 +1,99 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_TRAJOPT_MGA_EVALUATOR_H
+#define KEP_TOOLBOX_TRAJOPT_MGA_EVALUATOR_H
+
+#include <cstddef>
+#include <vector>
+
+#include <keplerian_toolbox/detail/visibility.hpp>
+#include <keplerian_toolbox/planet/base.hpp>
+
+namespace kep_toolbox
+{
+namespace trajopt
+{
+
+/// Multiple gravity assist trajectory (Lambert legs, no deep space manoeuvres)
+/**
+ * This class evaluates the trajectory of pykep.trajopt.mga: a sequence of Lambert arcs (zero revolutions,
+ * prograde) between the planets of the sequence, linked by powered fly-bys. The objective is the total DV (m/s):
+ * the launch DV exceeding the vinf given for free, the fly-by DVs (see fb_vel) and the arrival DV (the relative
+ * velocity or, if orbit insertion is selected, the pericenter burn acquiring the target orbit). If multi-objective,
+ * the total time of flight (days) is the second objective.
+ *
+ * The decision vector depends on the encoding of the times of flight:
+ *
+ * - DIRECT: \f$ [t_0, T_1, T_2, ...] \f$ in [mjd2000, days, days, ...]
+ * - ALPHA: \f$ [t_0, T, \alpha_1, \alpha_2, ...] \f$ with \f$ T_i = T \log\alpha_i / \sum_n \log\alpha_n \f$
+ * - ETA: \f$ [t_0, \eta_1, \eta_2, ...] \f$ with \f$ T_i = (T_{max} - \sum_{j<i} T_j) \eta_i \f$
+ *
+ * The evaluation does not allocate memory (apart from the returned vector of the convenience overload): the times
+ * of flight are decoded, the ephemerides computed and the Lambert problems solved leg by leg.
+ *
+ * Copies clone the planets, so that each copy can be used by its own thread (see batch_fitness).
+ */
+class KEP_TOOLBOX_DLL_PUBLIC mga_evaluator
+{
+public:
+    /// Encodings of the times of flight
+    enum tof_encoding { DIRECT = 0, ALPHA = 1, ETA = 2 };
+
+    mga_evaluator(const std::vector<planet::planet_ptr> &seq, tof_encoding encoding = DIRECT, double tof_max = 0.,
+                  double vinf = 0., bool multi_objective = false, bool orbit_insertion = false, double e_target = 0.,
+                  double rp_target = 0.);
+    mga_evaluator(const mga_evaluator &);
+    mga_evaluator(mga_evaluator &&) = default;
+    mga_evaluator &operator=(const mga_evaluator &);
+    mga_evaluator &operator=(mga_evaluator &&) = default;
+
+    void fitness(const std::vector<double> &x, std::vector<double> &f) const;
+    std::vector<double> fitness(const std::vector<double> &x) const;
+    void decode_tofs(const std::vector<double> &x, std::vector<double> &T) const;
+
+    std::size_t get_nx() const;
+    std::size_t get_nobj() const;
+    std::size_t get_nf() const;
+    const std::vector<planet::planet_ptr> &get_seq() const;
+    tof_encoding get_tof_encoding() const;
+
+private:
+    double tof(const std::vector<double> &x, std::size_t i, double &acc) const;
+
+    std::vector<planet::planet_ptr> m_seq;
+    tof_encoding m_encoding;
+    double m_tof_max;
+    double m_vinf;
+    bool m_multi_objective;
+    bool m_orbit_insertion;
+    double m_e_target;
+    double m_rp_target;
+    double m_mu;
+};
+} // namespace trajopt
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_TRAJOPT_MGA_EVALUATOR_H
@@ -0,0 +1,115 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_TRAJOPT_MGA_LT_NEP_EVALUATOR_H
+#define KEP_TOOLBOX_TRAJOPT_MGA_LT_NEP_EVALUATOR_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/detail/visibility.hpp>
+#include <keplerian_toolbox/planet/base.hpp>
+#include <keplerian_toolbox/sims_flanagan/leg.hpp>
+#include <keplerian_toolbox/sims_flanagan/spacecraft.hpp>
+
+namespace kep_toolbox
+{
+/// Native evaluators of trajectory optimisation problems
+/**
+ * This namespace contains the C++ implementation of the fitness functions of the pykep.trajopt problems.
+ */
+namespace trajopt
+{
+
+/// Low-thrust multiple gravity assist trajectory (Sims-Flanagan legs)
+/**
+ * This class evaluates the low-thrust interplanetary trajectory of pykep.trajopt.mga_lt_nep: a sequence of
+ * sims_flanagan::leg linked by unpowered fly-bys. The decision vector is:
+ *
+ * \f$ [t_0] + [T_1, m_{f1}, \mathbf V_{\infty i1}, \mathbf V_{\infty f1}] + ... + [T_n, m_{fn}, \mathbf V_{\infty in},
+ * \mathbf V_{\infty fn}] + [\mbox{throttles}_1] + ... + [\mbox{throttles}_n] \f$
+ *
+ * with epochs in mjd2000, times of flight in days, masses in kg and relative velocities in m/s. The fitness is
+ * made of the objective (minus the final mass, and the total time of flight if multi-objective), the equality
+ * constraints (the non-dimensional state mismatch of each leg followed by the fly-by velocity constraints) and
+ * the inequality constraints (the throttle magnitudes of all legs, the fly-by deflections and the launch and
+ * arrival hyperbolic velocities).
+ *
+ * Each leg is evaluated by its own sims_flanagan::leg, so that the legs can be evaluated in parallel and
+ * each keeps the propagation cache of its last evaluation. For the same reason, a single evaluator cannot be
+ * used by several threads at once. Copies clone the planets, so that each copy can be used by its own thread.
+ *
+ * The gradient is estimated with coloured finite differences on the sparsity pattern of the fitness, which is
+ * assembled from the patterns of the legs: as the throttles of a leg only affect that leg, the throttles of
+ * different legs are perturbed in the same evaluations.
+ */
+class KEP_TOOLBOX_DLL_PUBLIC mga_lt_nep_evaluator
+{
+public:
+    mga_lt_nep_evaluator(const std::vector<planet::planet_ptr> &seq, const std::vector<unsigned> &n_seg,
+                         double vinf_dep, double vinf_arr, double mass, double thrust, double isp,
+                         bool multi_objective = false, bool high_fidelity = false, double mu = ASTRO_MU_SUN);
+    mga_lt_nep_evaluator(const mga_lt_nep_evaluator &);
+    mga_lt_nep_evaluator(mga_lt_nep_evaluator &&) = default;
+    mga_lt_nep_evaluator &operator=(const mga_lt_nep_evaluator &);
+    mga_lt_nep_evaluator &operator=(mga_lt_nep_evaluator &&) = default;
+
+    void fitness(const std::vector<double> &x, std::vector<double> &obj, std::vector<double> &ec,
+                 std::vector<double> &ic, unsigned n_threads = 1u) const;
+    std::vector<double> fitness(const std::vector<double> &x, unsigned n_threads = 1u) const;
+    const std::vector<std::pair<std::size_t, std::size_t>> &get_gradient_sparsity() const;
+    std::vector<double> gradient(const std::vector<double> &x, unsigned n_threads = 1u, double dx = 1e-8) const;
+
+    std::size_t get_nx() const;
+    std::size_t get_nobj() const;
+    std::size_t get_nec() const;
+    std::size_t get_nic() const;
+    std::size_t get_nf() const;
+    const std::vector<planet::planet_ptr> &get_seq() const;
+
+    bool get_high_fidelity() const;
+    void set_high_fidelity(bool);
+
+private:
+    void set_gradient_sparsity();
+
+    std::vector<planet::planet_ptr> m_seq;
+    std::vector<unsigned> m_n_seg;
+    double m_vinf_dep;
+    double m_vinf_arr;
+    double m_mass;
+    bool m_multi_objective;
+    bool m_high_fidelity;
+    // One leg per trajectory leg, reused (see the class documentation)
+    mutable std::vector<sims_flanagan::leg> m_legs;
+    std::vector<std::pair<std::size_t, std::size_t>> m_sparsity;
+    std::vector<std::size_t> m_colours;
+};
+} // namespace trajopt
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_TRAJOPT_MGA_LT_NEP_EVALUATOR_H
@@ -0,0 +1,108 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_TRAJOPT_MGA_SEQUENCE_SEARCH_H
+#define KEP_TOOLBOX_TRAJOPT_MGA_SEQUENCE_SEARCH_H
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/detail/visibility.hpp>
+#include <keplerian_toolbox/planet/base.hpp>
+
+namespace kep_toolbox
+{
+namespace trajopt
+{
+
+/// Beam search over the fly-by sequences of an MGA trajectory
+/**
+ * This class searches the encounter sequences of an MGA trajectory (see mga_evaluator) from a departure to an
+ * arrival planet, the fly-bys being chosen among a set of planets. The sequences are expanded one leg at a time:
+ * each partial sequence (node) is extended with every planet of the set and, for each, the leg is evaluated over a
+ * coarse grid of times of flight (zero revolutions Lambert arcs), keeping the time of flight of least DV (launch
+ * or fly-by DV, see fb_vel). The search starts from a grid of launch epochs.
+ *
+ * At each depth only the beam_width most promising nodes are kept, ranked by their DV plus the three impulses
+ * estimate (see three_impulses_approx) of the transfer from their last planet to the arrival one. The estimate is
+ * computed once, at the start of the launch window, and it is a heuristic, not a lower bound on the remaining DV.
+ * Nodes are pruned if their DV, plus bound_factor times that estimate, is not better than the top_k-th complete
+ * trajectory found so far. With bound_factor = 0 (the default) the pruning is exact, as DVs only grow along a
+ * sequence, while with bound_factor > 0 it may also discard sequences better than the threshold. The pruning on
+ * the fly-by DV is opt-in: a node is dropped if a fly-by needs more than max_fb_dv, which is infinite by default.
+ * The nodes of a depth are expanded in parallel, each thread using its own clones of the planets.
+ *
+ * Each solution is returned with its decision vector in the direct encoding of mga_evaluator ([t0, T1, T2, ...])
+ * and its DV, which is the fitness of that decision vector for mga_evaluator(seq, DIRECT, 0., vinf).
+ */
+class KEP_TOOLBOX_DLL_PUBLIC mga_sequence_search
+{
+public:
+    /// A complete trajectory
+    struct solution {
+        /// Encounter sequence, as indices in the planet set
+        std::vector<std::size_t> seq;
+        /// Decision vector, direct encoding ([t0, T1, T2, ...] in [mjd2000, days, days, ...])
+        std::vector<double> x;
+        /// Total DV (m/s)
+        double dv;
+    };
+
+    mga_sequence_search(const std::vector<planet::planet_ptr> &planets, std::size_t departure, std::size_t arrival,
+                        const std::array<double, 2> &t0, unsigned n_t0, const std::array<double, 2> &tof,
+                        unsigned n_tof, double vinf = 0., unsigned max_flybys = 3u, unsigned beam_width = 100u,
+                        double bound_factor = 0., double max_fb_dv = std::numeric_limits<double>::infinity());
+
+    std::vector<solution> run(unsigned top_k = 10u, unsigned n_threads = 0u) const;
+
+    const std::vector<planet::planet_ptr> &get_planets() const;
+
+private:
+    struct node;
+    void expand(const std::vector<planet::planet_ptr> &, const node &, std::vector<node> &, std::vector<solution> &,
+                double) const;
+
+    std::vector<planet::planet_ptr> m_planets;
+    std::size_t m_departure;
+    std::size_t m_arrival;
+    std::array<double, 2> m_t0;
+    unsigned m_n_t0;
+    std::array<double, 2> m_tof;
+    unsigned m_n_tof;
+    double m_vinf;
+    unsigned m_max_flybys;
+    unsigned m_beam_width;
+    double m_bound_factor;
+    double m_max_fb_dv;
+    // Three impulses estimate of the transfer from each planet to the arrival one
+    std::vector<double> m_estimate;
+};
+} // namespace trajopt
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_TRAJOPT_MGA_SEQUENCE_SEARCH_H
@@ -0,0 +1,102 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_TRAJOPT_PL2PL_N_IMPULSES_EVALUATOR_H
+#define KEP_TOOLBOX_TRAJOPT_PL2PL_N_IMPULSES_EVALUATOR_H
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include <keplerian_toolbox/detail/visibility.hpp>
+#include <keplerian_toolbox/planet/base.hpp>
+
+namespace kep_toolbox
+{
+namespace trajopt
+{
+
+/// Planet to planet transfer with up to N impulses
+/**
+ * This class evaluates the trajectory of pykep.trajopt.pl2pl_N_impulses, which is also the kernel of the
+ * Earth-Mars N impulses problems of the trajectory optimisation gym. The spacecraft leaves the start planet with
+ * its velocity, applies N - 2 impulses each followed by a Keplerian arc, and reaches the target planet with a
+ * Lambert arc (zero revolutions, retrograde if the orbit before the last arc is). The objective is the total DV
+ * (m/s): the N - 2 impulses, the DV at the start of the Lambert arc and the arrival relative velocity (or, if
+ * orbit insertion is selected, the pericenter burn acquiring the target orbit). If multi-objective, the time of
+ * flight (days) is the second objective.
+ *
+ * The decision vector is
+ * \f$ [t_0, T] + [\alpha_1, u_1, v_1, \Delta V_1] + ... + [\alpha_{N-2}, u_{N-2}, v_{N-2}, \Delta V_{N-2}] +
+ * [\alpha_{N-1}] \f$, with \f$ t_0 \f$ in mjd2000, \f$ T \f$ in days and the \f$ \Delta V_i \f$ in m/s. When the
+ * phase is free, the arrival epoch \f$ t_f \f$ (mjd2000) is appended and the target position does not depend on
+ * \f$ t_0 + T \f$, so that the start and arrival anomalies are free. The times of flight of the arcs are
+ * \f$ T_i = T \log\alpha_i / \sum_n \log\alpha_n \f$ and the impulses have the direction
+ * \f$ \theta = 2\pi u_i \f$, \f$ \phi = \arccos(2v_i - 1) - \pi/2 \f$ (uniform on the sphere).
+ *
+ * The evaluation does not allocate memory (apart from the returned vector of the convenience overload).
+ *
+ * Copies clone the planets, so that each copy can be used by its own thread (see batch_fitness).
+ */
+class KEP_TOOLBOX_DLL_PUBLIC pl2pl_N_impulses_evaluator
+{
+public:
+    pl2pl_N_impulses_evaluator(const planet::base &start, const planet::base &target, unsigned N_max,
+                               const std::array<double, 2> &tof, const std::array<double, 2> &vinf,
+                               bool phase_free = true, bool multi_objective = false,
+                               const std::array<double, 2> &t0 = {{0., 1000.}}, bool orbit_insertion = false,
+                               double e_target = 0., double rp_target = 0.);
+    pl2pl_N_impulses_evaluator(const pl2pl_N_impulses_evaluator &);
+    pl2pl_N_impulses_evaluator(pl2pl_N_impulses_evaluator &&) = default;
+    pl2pl_N_impulses_evaluator &operator=(const pl2pl_N_impulses_evaluator &);
+    pl2pl_N_impulses_evaluator &operator=(pl2pl_N_impulses_evaluator &&) = default;
+
+    void fitness(const std::vector<double> &x, std::vector<double> &f) const;
+    std::vector<double> fitness(const std::vector<double> &x) const;
+    void decode_tofs(const std::vector<double> &x, std::vector<double> &T) const;
+
+    std::size_t get_nx() const;
+    std::size_t get_nobj() const;
+    std::size_t get_nf() const;
+    const std::vector<double> &get_lb() const;
+    const std::vector<double> &get_ub() const;
+    const std::vector<planet::planet_ptr> &get_seq() const;
+
+private:
+    std::vector<planet::planet_ptr> m_seq;
+    unsigned m_N_max;
+    bool m_phase_free;
+    bool m_multi_objective;
+    bool m_orbit_insertion;
+    double m_e_target;
+    double m_rp_target;
+    double m_mu;
+    std::vector<double> m_lb;
+    std::vector<double> m_ub;
+};
+} // namespace trajopt
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_TRAJOPT_PL2PL_N_IMPULSES_EVALUATOR_H
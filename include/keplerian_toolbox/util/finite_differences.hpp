@@ -0,0 +1,154 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_UTIL_FINITE_DIFFERENCES_H
+#define KEP_TOOLBOX_UTIL_FINITE_DIFFERENCES_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include <keplerian_toolbox/exceptions.hpp>
+
+namespace kep_toolbox
+{
+namespace util
+{
+
+/// Sparsity pattern of a Jacobian, as a list of (row, column) pairs
+typedef std::vector<std::pair<std::size_t, std::size_t>> sparsity_pattern;
+
+/// Column colouring of a sparsity pattern
+/**
+ * Assigns a colour to each column of a Jacobian so that no two columns of the same colour have a non-zero entry
+ * in the same row (Curtis-Powell-Reid). The columns of one colour can then be perturbed together and their
+ * derivatives recovered from a single function evaluation. The colouring is greedy, in column order, with the
+ * smallest colour available for each column.
+ *
+ * \param[in] sp the sparsity pattern
+ * \param[in] n_cols the number of columns of the Jacobian
+ *
+ * @return the colour of each column (from zero, columns without non-zeros get the colour zero)
+ *
+ * \throws value_error if the pattern contains a column index not smaller than n_cols
+ */
+inline std::vector<std::size_t> colour_columns(const sparsity_pattern &sp, std::size_t n_cols)
+{
+    std::size_t n_rows = 0u;
+    for (const auto &p : sp) {
+        if (p.second >= n_cols) {
+            throw_value_error("The sparsity pattern has a column index out of range");
+        }
+        n_rows = std::max(n_rows, p.first + 1u);
+    }
+    std::vector<std::vector<std::size_t>> rows_of(n_cols), cols_of(n_rows);
+    for (const auto &p : sp) {
+        rows_of[p.second].push_back(p.first);
+        cols_of[p.first].push_back(p.second);
+    }
+    const std::size_t none = static_cast<std::size_t>(-1);
+    std::vector<std::size_t> colour(n_cols, none);
+    // forbidden[c] == j marks the colour c as already used by a column sharing a row with column j
+    std::vector<std::size_t> forbidden;
+    for (std::size_t j = 0u; j < n_cols; ++j) {
+        for (auto r : rows_of[j]) {
+            for (auto k : cols_of[r]) {
+                if (colour[k] != none) {
+                    forbidden[colour[k]] = j;
+                }
+            }
+        }
+        std::size_t c = 0u;
+        while (c < forbidden.size() && forbidden[c] == j) {
+            ++c;
+        }
+        if (c == forbidden.size()) {
+            forbidden.push_back(none);
+        }
+        colour[j] = c;
+    }
+    return colour;
+}
+
+/// Coloured forward finite differences
+/**
+ * Estimates the non-zero entries of the Jacobian of f at x with forward differences, perturbing at once all the
+ * columns of one colour: the cost is one evaluation of f per colour (plus one at x) instead of one per column.
+ * The perturbation of column j is \f$ h_j = dx \max(1, |x_j|) \f$.
+ *
+ * \param[in] f callable returning a std::vector<double> from a const std::vector<double> &
+ * \param[in] x the point where the Jacobian is estimated
+ * \param[in] sp the sparsity pattern
+ * \param[in] colours the column colours, as returned by colour_columns
+ * \param[out] values the Jacobian entries, in the order of sp
+ * \param[in] dx the relative perturbation
+ *
+ * \throws value_error if the colours are not one per component of x
+ */
+template <typename F>
+inline void coloured_finite_differences(const F &f, const std::vector<double> &x, const sparsity_pattern &sp,
+                                        const std::vector<std::size_t> &colours, std::vector<double> &values,
+                                        double dx = 1e-8)
+{
+    if (colours.size() != x.size()) {
+        throw_value_error("The number of colours must be the dimension of x");
+    }
+    const std::size_t n_colours = colours.empty() ? 0u : *std::max_element(colours.begin(), colours.end()) + 1u;
+    // The non-zeros of each colour
+    std::vector<std::vector<std::size_t>> entries(n_colours);
+    for (std::size_t k = 0u; k < sp.size(); ++k) {
+        entries[colours[sp[k].second]].push_back(k);
+    }
+    std::vector<double> h(x.size());
+    for (std::size_t j = 0u; j < x.size(); ++j) {
+        // The step actually taken, after rounding
+        h[j] = (x[j] + dx * std::max(1., std::abs(x[j]))) - x[j];
+    }
+    values.assign(sp.size(), 0.);
+    const std::vector<double> f0 = f(x);
+    std::vector<double> xp;
+    for (std::size_t c = 0u; c < n_colours; ++c) {
+        if (entries[c].empty()) {
+            continue;
+        }
+        xp = x;
+        for (std::size_t j = 0u; j < x.size(); ++j) {
+            if (colours[j] == c) {
+                xp[j] += h[j];
+            }
+        }
+        const std::vector<double> fp = f(xp);
+        for (auto k : entries[c]) {
+            const std::size_t r = sp[k].first, j = sp[k].second;
+            values[k] = (fp[r] - f0[r]) / h[j];
+        }
+    }
+}
+} // namespace util
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_UTIL_FINITE_DIFFERENCES_H
@@ -0,0 +1,51 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_UTIL_GRID_H
+#define KEP_TOOLBOX_UTIL_GRID_H
+
+#include <array>
+
+namespace kep_toolbox
+{
+namespace util
+{
+
+/// Point of a uniform grid
+/**
+ * \param[in] bounds the first and the last point of the grid
+ * \param[in] k index of the point
+ * \param[in] n number of points of the grid (with n equal to one the grid is the first bound only)
+ *
+ * @return the k-th point of the uniform grid of n points over bounds
+ */
+inline double grid_point(const std::array<double, 2> &bounds, unsigned k, unsigned n)
+{
+    return (n == 1u) ? bounds[0] : bounds[0] + (bounds[1] - bounds[0]) * k / (n - 1u);
+}
+} // namespace util
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_UTIL_GRID_H
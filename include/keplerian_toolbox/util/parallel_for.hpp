@@ -0,0 +1,121 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_UTIL_PARALLEL_FOR_H
+#define KEP_TOOLBOX_UTIL_PARALLEL_FOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace kep_toolbox
+{
+namespace util
+{
+
+/// Default number of threads
+/**
+ * \returns the number of concurrent threads supported by the hardware (at least one)
+ */
+inline unsigned default_n_threads()
+{
+    unsigned n = std::thread::hardware_concurrency();
+    return n ? n : 1u;
+}
+
+/// Parallel loop over an index range
+/**
+ * Splits [begin, end) into contiguous blocks and calls f(block_begin, block_end) on each of them from a
+ * set of std::thread. With grain equal to zero the range is split statically into one block per thread,
+ * otherwise the threads dynamically pick blocks of grain indices, which balances uneven workloads.
+ * If a call to f throws, the remaining blocks are skipped and the first exception is rethrown in the
+ * calling thread once all threads have joined.
+ *
+ * \param[in] begin first index
+ * \param[in] end one past the last index
+ * \param[in] f callable with signature void(std::size_t, std::size_t)
+ * \param[in] n_threads number of threads to use (0 means default_n_threads())
+ * \param[in] grain block size for dynamic scheduling (0 means static scheduling)
+ */
+template <typename F>
+void parallel_for(std::size_t begin, std::size_t end, const F &f, unsigned n_threads = 0u, std::size_t grain = 0u)
+{
+    if (end <= begin) {
+        return;
+    }
+    const std::size_t n = end - begin;
+    if (n_threads == 0u) {
+        n_threads = default_n_threads();
+    }
+    if (grain == 0u) {
+        grain = (n + n_threads - 1u) / n_threads;
+    }
+    const std::size_t n_blocks = (n + grain - 1u) / grain;
+    n_threads = static_cast<unsigned>(std::min<std::size_t>(n_threads, n_blocks));
+    if (n_threads <= 1u) {
+        f(begin, end);
+        return;
+    }
+
+    std::atomic<std::size_t> next_block(0u);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto worker = [&]() {
+        for (std::size_t b = next_block++; b < n_blocks && !failed; b = next_block++) {
+            const std::size_t block_begin = begin + b * grain;
+            try {
+                f(block_begin, std::min(block_begin + grain, end));
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!failed) {
+                    error = std::current_exception();
+                    failed = true;
+                }
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(n_threads - 1u);
+    for (unsigned i = 0u; i + 1u < n_threads; ++i) {
+        threads.emplace_back(worker);
+    }
+    // The calling thread works too.
+    worker();
+    for (auto &t : threads) {
+        t.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+} // namespace util
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_UTIL_PARALLEL_FOR_H
@@ -26,10 +26,12 @@
 #ifndef KEP_TOOLBOX_SPICE_UTILS_H
 #define KEP_TOOLBOX_SPICE_UTILS_H
 
+#include <mutex>
 #include <sstream>
 #include <string>
 
 #include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/detail/visibility.hpp>
 #include <keplerian_toolbox/epoch.hpp>
 #include <keplerian_toolbox/exceptions.hpp>
 #include <keplerian_toolbox/third_party/cspice/SpiceUsr.h>
@@ -44,6 +46,8 @@ namespace util
 KEP_TOOLBOX_DLL_PUBLIC void load_spice_kernel(std::string file_name);
 KEP_TOOLBOX_DLL_PUBLIC SpiceDouble epoch_to_spice(kep_toolbox::epoch ep);
 KEP_TOOLBOX_DLL_PUBLIC SpiceDouble epoch_to_spice(double mjd2000);
+KEP_TOOLBOX_DLL_PUBLIC std::mutex &spice_mutex();
+KEP_TOOLBOX_DLL_PUBLIC unsigned long long spice_kernel_generation();
 } // namespace util
 } // namespace kep_toolbox
 #endif // KEP_TOOLBOX_SPICE_UTILS_H
@@ -0,0 +1,53 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#ifndef KEP_TOOLBOX_TRAJECTORY_SAMPLING_H
+#define KEP_TOOLBOX_TRAJECTORY_SAMPLING_H
+
+#include <vector>
+
+#include <keplerian_toolbox/detail/visibility.hpp>
+#include <keplerian_toolbox/lambert_problem.hpp>
+#include <keplerian_toolbox/planet/base.hpp>
+
+namespace kep_toolbox
+{
+namespace util
+{
+
+KEP_TOOLBOX_DLL_PUBLIC void sample_planet(const planet::base &pl, double t0, double tf, unsigned N,
+                                          std::vector<array3D> &r, std::vector<array3D> &v);
+KEP_TOOLBOX_DLL_PUBLIC void sample_kepler(const array3D &r0, const array3D &v0, double tof, double mu, unsigned N,
+                                          std::vector<array3D> &r, std::vector<array3D> &v);
+KEP_TOOLBOX_DLL_PUBLIC void sample_lambert(const lambert_problem &l, unsigned sol, unsigned N,
+                                           std::vector<array3D> &r, std::vector<array3D> &v);
+KEP_TOOLBOX_DLL_PUBLIC void sample_taylor(const array3D &r0, const array3D &v0, double m0, const array3D &thrust,
+                                          double tof, double mu, double veff, unsigned N, std::vector<array3D> &r,
+                                          std::vector<array3D> &v, std::vector<double> &m, int log10tolerance = -10,
+                                          int log10rtolerance = -10);
+} // namespace util
+} // namespace kep_toolbox
+
+#endif // KEP_TOOLBOX_TRAJECTORY_SAMPLING_H
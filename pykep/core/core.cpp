@@ -104,6 +104,96 @@ static inline kep_toolbox::array6D ic2eq_wrapper(const kep_toolbox::array3D &r0,
     return EQ;
 }
 
+// Structure-of-arrays functions: the vectors and states are NumPy arrays of shape (N, n), one row per component
+template <std::size_t N>
+static inline std::array<std::vector<double>, N> ndarray_to_soa(const object &x)
+{
+    object arr = import("numpy").attr("asarray")(x, "float64");
+    if (extract<int>(arr.attr("ndim"))() != 2 || extract<std::size_t>(arr.attr("shape")[0])() != N) {
+        throw_value_error("Expected an array of shape (" + std::to_string(N) + ", n)");
+    }
+    // Row-major, the components are contiguous
+    std::vector<double> flat;
+    const std::size_t n = ndarray_to_vector(arr.attr("reshape")(-1), 0u, flat) / N;
+    std::array<std::vector<double>, N> retval;
+    for (std::size_t c = 0u; c < N; ++c) {
+        retval[c].assign(flat.begin() + static_cast<std::ptrdiff_t>(c * n),
+                         flat.begin() + static_cast<std::ptrdiff_t>((c + 1u) * n));
+    }
+    return retval;
+}
+
+static inline kep_toolbox::soa6D ndarray_to_soa6D(const object &x)
+{
+    return ndarray_to_soa<6u>(x);
+}
+
+template <std::size_t N>
+static inline object soa_to_ndarray(const std::array<std::vector<double>, N> &x)
+{
+    std::vector<double> flat;
+    for (const auto &c : x) {
+        flat.insert(flat.end(), c.begin(), c.end());
+    }
+    return to_ndarray(flat, "float64", make_tuple(N, x[0].size()));
+}
+
+static inline object soa6D_to_ndarray(const kep_toolbox::soa6D &x)
+{
+    return soa_to_ndarray(x);
+}
+
+// A per-element parameter: either an array of shape (n,) or a scalar, which is broadcast
+static inline std::vector<double> ndarray_to_parameter(const object &x, std::size_t n)
+{
+    object np = import("numpy");
+    std::vector<double> retval;
+    ndarray_to_vector(np.attr("broadcast_to")(np.attr("asarray")(x, "float64"), make_tuple(n)), 0u, retval);
+    return retval;
+}
+
+static inline object par2ic_soa_wrapper(const object &E, double mu)
+{
+    kep_toolbox::soa6D rv;
+    kep_toolbox::par2ic_soa(ndarray_to_soa6D(E), mu, rv);
+    return soa6D_to_ndarray(rv);
+}
+
+static inline object ic2par_soa_wrapper(const object &rv, double mu)
+{
+    kep_toolbox::soa6D E;
+    kep_toolbox::ic2par_soa(ndarray_to_soa6D(rv), mu, E);
+    return soa6D_to_ndarray(E);
+}
+
+static inline object ic2eq_soa_wrapper(const object &rv, double mu, bool retrograde)
+{
+    kep_toolbox::soa6D EQ;
+    kep_toolbox::ic2eq_soa(ndarray_to_soa6D(rv), mu, EQ, retrograde);
+    return soa6D_to_ndarray(EQ);
+}
+
+static inline object eq2ic_soa_wrapper(const object &EQ, double mu, bool retrograde)
+{
+    kep_toolbox::soa6D rv;
+    kep_toolbox::eq2ic_soa(ndarray_to_soa6D(EQ), mu, rv, retrograde);
+    return soa6D_to_ndarray(rv);
+}
+
+static inline object eq2par_soa_wrapper(const object &EQ, bool retrograde)
+{
+    kep_toolbox::soa6D E;
+    kep_toolbox::eq2par_soa(E, ndarray_to_soa6D(EQ), retrograde);
+    return soa6D_to_ndarray(E);
+}
+
+static inline object par2eq_soa_wrapper(const object &E, bool retrograde)
+{
+    kep_toolbox::soa6D EQ;
+    kep_toolbox::par2eq_soa(EQ, ndarray_to_soa6D(E), retrograde);
+    return soa6D_to_ndarray(EQ);
+}
+
 static inline tuple closest_distance_wrapper(const kep_toolbox::array3D &r0, const kep_toolbox::array3D &v0,
                                              const kep_toolbox::array3D &r1, const kep_toolbox::array3D &v1,
                                              const double &mu)
@@ -113,6 +203,56 @@ static inline tuple closest_distance_wrapper(const kep_toolbox::array3D &r0, con
     return boost::python::make_tuple(min_d, ra);
 }
 
+// Trajectory samples: the positions and velocities are returned as NumPy arrays of shape (N, 3)
+static inline tuple sample_planet_wrapper(const kep_toolbox::planet::base &pl, double t0, double tf, unsigned N)
+{
+    std::vector<kep_toolbox::array3D> r, v;
+    kep_toolbox::util::sample_planet(pl, t0, tf, N, r, v);
+    return boost::python::make_tuple(to_ndarray(r, "float64", make_tuple(N, 3u)),
+                                     to_ndarray(v, "float64", make_tuple(N, 3u)));
+}
+
+static inline tuple sample_kepler_wrapper(const kep_toolbox::array3D &r0, const kep_toolbox::array3D &v0, double tof,
+                                          double mu, unsigned N)
+{
+    std::vector<kep_toolbox::array3D> r, v;
+    kep_toolbox::util::sample_kepler(r0, v0, tof, mu, N, r, v);
+    return boost::python::make_tuple(to_ndarray(r, "float64", make_tuple(N, 3u)),
+                                     to_ndarray(v, "float64", make_tuple(N, 3u)));
+}
+
+static inline tuple sample_lambert_wrapper(const kep_toolbox::lambert_problem &l, unsigned sol, unsigned N)
+{
+    std::vector<kep_toolbox::array3D> r, v;
+    kep_toolbox::util::sample_lambert(l, sol, N, r, v);
+    return boost::python::make_tuple(to_ndarray(r, "float64", make_tuple(N, 3u)),
+                                     to_ndarray(v, "float64", make_tuple(N, 3u)));
+}
+
+static inline tuple sample_taylor_wrapper(const kep_toolbox::array3D &r0, const kep_toolbox::array3D &v0, double m0,
+                                          const kep_toolbox::array3D &thrust, double tof, double mu, double veff,
+                                          unsigned N, int log10tolerance, int log10rtolerance)
+{
+    std::vector<kep_toolbox::array3D> r, v;
+    std::vector<double> m;
+    kep_toolbox::util::sample_taylor(r0, v0, m0, thrust, tof, mu, veff, N, r, v, m, log10tolerance, log10rtolerance);
+    return boost::python::make_tuple(to_ndarray(r, "float64", make_tuple(N, 3u)),
+                                     to_ndarray(v, "float64", make_tuple(N, 3u)),
+                                     to_ndarray(m, "float64", make_tuple(N)));
+}
+
+static inline tuple closest_distance_soa_wrapper(const object &r0, const object &v0, const object &r1,
+                                                 const object &v1, const object &mu)
+{
+    const kep_toolbox::soa3D rs = ndarray_to_soa<3u>(r0);
+    const std::size_t n = rs[0].size();
+    std::vector<double> min_d, ra;
+    kep_toolbox::closest_distance_soa(min_d, ra, rs, ndarray_to_soa<3u>(v0), ndarray_to_soa<3u>(r1),
+                                      ndarray_to_soa<3u>(v1), ndarray_to_parameter(mu, n));
+    return boost::python::make_tuple(to_ndarray(min_d, "float64", make_tuple(min_d.size())),
+                                     to_ndarray(ra, "float64", make_tuple(ra.size())));
+}
+
 static inline tuple propagate_lagrangian_wrapper(const kep_toolbox::array3D &r0, const kep_toolbox::array3D &v0,
                                                  const double &t, const double &mu)
 {
@@ -193,6 +333,38 @@ static inline double fb_vel_wrapper(const kep_toolbox::array3D &vin_rel, const k
     return dV;
 }
 
+static inline tuple fb_con_soa_wrapper(const object &vin_rel, const object &vout_rel, const object &safe_radius,
+                                       const object &mu_self)
+{
+    const kep_toolbox::soa3D in = ndarray_to_soa<3u>(vin_rel), out = ndarray_to_soa<3u>(vout_rel);
+    const std::size_t n = in[0].size();
+    std::vector<double> eq, ineq;
+    kep_toolbox::fb_con_soa(eq, ineq, in, out, ndarray_to_parameter(safe_radius, n), ndarray_to_parameter(mu_self, n));
+    return boost::python::make_tuple(to_ndarray(eq, "float64", make_tuple(n)),
+                                     to_ndarray(ineq, "float64", make_tuple(n)));
+}
+
+static inline object fb_prop_soa_wrapper(const object &v_in, const object &v_pla, const object &rp,
+                                         const object &beta, const object &mu)
+{
+    const kep_toolbox::soa3D in = ndarray_to_soa<3u>(v_in);
+    const std::size_t n = in[0].size();
+    kep_toolbox::soa3D retval;
+    kep_toolbox::fb_prop_soa(retval, in, ndarray_to_soa<3u>(v_pla), ndarray_to_parameter(rp, n),
+                             ndarray_to_parameter(beta, n), ndarray_to_parameter(mu, n));
+    return soa_to_ndarray(retval);
+}
+
+static inline object fb_vel_soa_wrapper(const object &vin_rel, const object &vout_rel, const object &safe_radius,
+                                        const object &mu_self)
+{
+    const kep_toolbox::soa3D in = ndarray_to_soa<3u>(vin_rel), out = ndarray_to_soa<3u>(vout_rel);
+    const std::size_t n = in[0].size();
+    std::vector<double> dV;
+    kep_toolbox::fb_vel_soa(dV, in, out, ndarray_to_parameter(safe_radius, n), ndarray_to_parameter(mu_self, n));
+    return to_ndarray(dV, "float64", make_tuple(n));
+}
+
 static inline tuple damon_wrapper(const kep_toolbox::array3D &v1, const kep_toolbox::array3D &v2, double tof)
 {
     kep_toolbox::array3D a1, a2;
@@ -248,6 +420,7 @@ BOOST_PYTHON_MODULE(core)
     // Register std converters to python lists if not already registered by some
     // other module
     PYKEP_REGISTER_CONVERTER(std::vector<double>, variable_capacity_policy)
+    PYKEP_REGISTER_CONVERTER(std::vector<std::vector<double>>, variable_capacity_policy)
     PYKEP_REGISTER_CONVERTER(kep_toolbox::array3D, fixed_size_policy)
     PYKEP_REGISTER_CONVERTER(kep_toolbox::array6D, fixed_size_policy)
     PYKEP_REGISTER_CONVERTER(kep_toolbox::array7D, fixed_size_policy)
@@ -486,6 +659,42 @@ BOOST_PYTHON_MODULE(core)
         "Example::\n\n"
         "  dV = fb_vel(vin, vout, planet_ss('earth'))\n");
 
+    // Structure-of-arrays versions of the fly-by helper functions
+    def("fb_con_soa", &fb_con_soa_wrapper,
+        "pykep.fb_con_soa(vin, vout, safe_radius, mu_self)\n\n"
+        "- vin: array of shape (3, n), rows are the components of the relative hyperbolic velocities before the "
+        "fly-bys\n"
+        "- vout: array of shape (3, n), rows are the components of the relative hyperbolic velocities after the "
+        "fly-bys\n"
+        "- safe_radius: safe radii of the fly-by planets, array of shape (n,) or scalar\n"
+        "- mu_self: gravitational parameters of the fly-by planets, array of shape (n,) or scalar\n\n"
+        "Returns a tuple containing the arrays (eq, ineq) of shape (n,), as pykep.fb_con\n\n"
+        "Example::\n\n"
+        "  pl = planet.jpl_lp('earth')\n"
+        "  eq, ineq = fb_con_soa(vin, vout, pl.safe_radius, pl.mu_self)\n");
+    def("fb_prop_soa", &fb_prop_soa_wrapper,
+        "pykep.fb_prop_soa(v, v_pla, rp, beta, mu)\n\n"
+        "- v: array of shape (3, n), rows are the components of the spacecraft velocities before the encounters\n"
+        "- v_pla: array of shape (3, n), rows are the components of the planet velocities at the encounters\n"
+        "- rp: fly-by radii, array of shape (n,) or scalar\n"
+        "- beta: fly-by plane orientations, array of shape (n,) or scalar\n"
+        "- mu: planet gravitational constants, array of shape (n,) or scalar\n\n"
+        "Returns the array of shape (3, n) of the spacecraft velocities after the encounters, as pykep.fb_prop\n\n"
+        "Example::\n\n"
+        "  vout = fb_prop_soa(v, v_pla, 2, np.linspace(0, 3.1415, v.shape[1]), 1)\n");
+    def("fb_vel_soa", &fb_vel_soa_wrapper,
+        "pykep.fb_vel_soa(vin, vout, safe_radius, mu_self)\n\n"
+        "- vin: array of shape (3, n), rows are the components of the relative hyperbolic velocities before the "
+        "fly-bys\n"
+        "- vout: array of shape (3, n), rows are the components of the relative hyperbolic velocities after the "
+        "fly-bys\n"
+        "- safe_radius: safe radii of the fly-by planets, array of shape (n,) or scalar\n"
+        "- mu_self: gravitational parameters of the fly-by planets, array of shape (n,) or scalar\n\n"
+        "Returns the array of shape (n,) of the dVs needed to make the fly-bys possible, as pykep.fb_vel\n\n"
+        "Example::\n\n"
+        "  pl = planet.jpl_lp('earth')\n"
+        "  dV = fb_vel_soa(vin, vout, pl.safe_radius, pl.mu_self)\n");
+
     // Basic Astrodynamics
     def("closest_distance", &closest_distance_wrapper,
         "pykep.closest_distance(r1,v1,r2,v2,mu = 1.0)\n\n"
@@ -500,6 +709,72 @@ BOOST_PYTHON_MODULE(core)
         "Example::\n\n"
         "  d,ra = closest_distance([1,0,0],[0,1,0],[0,1,0],[-1,0,0],1.0)\n",
         (arg("r1"), arg("v1"), arg("r2"), arg("v2"), arg("mu") = 1.0));
+    // Trajectory samplers
+    def("sample_planet", &sample_planet_wrapper,
+        "pykep.sample_planet(pl, t0, tf, N = 60)\n\n"
+        "- pl: the planet\n"
+        "- t0: first epoch (mjd2000)\n"
+        "- tf: last epoch (mjd2000)\n"
+        "- N: number of samples\n\n"
+        "Returns a tuple containing the arrays of shape (N, 3) of the planet positions and velocities at N equally "
+        "spaced epochs in [t0, tf]\n"
+        "Example::\n\n"
+        "  r, v = sample_planet(planet.jpl_lp('earth'), 0, 365.25, 100)\n",
+        (arg("pl"), arg("t0"), arg("tf"), arg("N") = 60u));
+    def("sample_kepler", &sample_kepler_wrapper,
+        "pykep.sample_kepler(r0, v0, tof, mu = 1.0, N = 60)\n\n"
+        "- r0: initial position (cartesian)\n"
+        "- v0: initial velocity (cartesian)\n"
+        "- tof: propagation time\n"
+        "- mu: central body gravity constant\n"
+        "- N: number of samples\n\n"
+        "Returns a tuple containing the arrays of shape (N, 3) of the positions and velocities at N equally spaced "
+        "times along the Keplerian arc, each computed with one Kepler solve from the initial state\n"
+        "Example::\n\n"
+        "  r, v = sample_kepler([1,0,0], [0,1,0], pi / 3, 1.0, 100)\n",
+        (arg("r0"), arg("v0"), arg("tof"), arg("mu") = 1.0, arg("N") = 60u));
+    def("sample_lambert", &sample_lambert_wrapper,
+        "pykep.sample_lambert(l, sol = 0, N = 60)\n\n"
+        "- l: a pykep.lambert_problem\n"
+        "- sol: the solution to sample (must be in 0 .. Nmax*2)\n"
+        "- N: number of samples\n\n"
+        "Returns a tuple containing the arrays of shape (N, 3) of the positions and velocities at N equally spaced "
+        "times along the Lambert solution\n"
+        "Example::\n\n"
+        "  r, v = sample_lambert(l, 0, 100)\n",
+        (arg("l"), arg("sol") = 0u, arg("N") = 60u));
+    def("sample_taylor", &sample_taylor_wrapper,
+        "pykep.sample_taylor(r0, v0, m0, thrust, tof, mu, veff, N = 60, log10tol = -10, log10rtol = -10)\n\n"
+        "- r0: initial position (cartesian)\n"
+        "- v0: initial velocity (cartesian)\n"
+        "- m0: initial mass\n"
+        "- thrust: thrust vector (cartesian)\n"
+        "- tof: propagation time\n"
+        "- mu: central body gravity constant\n"
+        "- veff: the product (Isp g0) defining the engine efficiency\n"
+        "- N: number of samples\n"
+        "- log10tol: the logarithm of the absolute tolerance passed to taylor propagator\n"
+        "- log10rtol: the logarithm of the relative tolerance passed to taylor propagator\n\n"
+        "Returns a tuple containing the arrays of shape (N, 3) of the positions and velocities and the array of "
+        "shape (N,) of the masses at N equally spaced times along the constant thrust arc. The arc is propagated "
+        "once, the samples are evaluated from the Taylor polynomials of the integration steps\n"
+        "Example::\n\n"
+        "  r, v, m = sample_taylor([1,0,0], [0,1,0], 100, [1,1,0], 40, 1, 1, 1000)\n",
+        (arg("r0"), arg("v0"), arg("m0"), arg("thrust"), arg("tof"), arg("mu"), arg("veff"), arg("N") = 60u,
+         arg("log10tol") = -10, arg("log10rtol") = -10));
+
+    def("closest_distance_soa", &closest_distance_soa_wrapper,
+        "pykep.closest_distance_soa(r1,v1,r2,v2,mu = 1.0)\n\n"
+        "- r1: array of shape (3, n), rows are the components of the initial positions of n arcs\n"
+        "- v1: array of shape (3, n), rows are the components of the initial velocities\n"
+        "- r2: array of shape (3, n), rows are the components of the final positions\n"
+        "- v2: array of shape (3, n), rows are the components of the final velocities\n"
+        "- mu: central body gravitational parameter(s), a float or an array of shape (n,)\n\n"
+        "Returns a tuple containing the arrays of shape (n,) of the closest distances and of the apoapsis radii, "
+        "as pykep.closest_distance\n"
+        "Example::\n\n"
+        "  d,ra = closest_distance_soa(r1, v1, r2, v2, MU_SUN)\n",
+        (arg("r1"), arg("v1"), arg("r2"), arg("v2"), arg("mu") = 1.0));
 
     def("barker", &kep_toolbox::barker,
         "pykep.barker(r1,r2,mu = 1.0)\n\n"
@@ -579,6 +854,65 @@ BOOST_PYTHON_MODULE(core)
         "  E = pk.par2eq(E = [1.0,0.1,0.2,0.3,0.4,0.5], retrograde = False)",
         (arg("E"), arg("retrograde") = false));
 
+    // Structure-of-arrays versions of the conversions
+    def("par2ic_soa", &par2ic_soa_wrapper,
+        "pykep.par2ic_soa(E, mu = 1.0)\n\n"
+        "- E: array of shape (6, n), rows are the osculating keplerian elements a,e,i,W,w,E of n orbits\n"
+        "- mu: gravity parameter (l^3/s^2)\n\n"
+        "Returns the array of shape (6, n) of the cartesian states x,y,z,vx,vy,vz, as pykep.par2ic\n"
+        "Example:: \n\n"
+        "  rv = pk.par2ic_soa(np.array([[1,0.3,0.1,0.1,0.2,0.2], [2,0.1,0.1,0.1,0.2,0.2]]).T, 1)",
+        (arg("E"), arg("mu") = 1.0));
+
+    def("ic2par_soa", &ic2par_soa_wrapper,
+        "pykep.ic2par_soa(rv, mu = 1.0)\n\n"
+        "- rv: array of shape (6, n), rows are the cartesian components x,y,z,vx,vy,vz of n states\n"
+        "- mu: gravity parameter\n\n"
+        "Returns the array of shape (6, n) of the osculating keplerian elements a,e,i,W,w,E, as pykep.ic2par\n"
+        "Example:: \n\n"
+        "  E = pk.ic2par_soa(rv, 1.0)",
+        (arg("rv"), arg("mu") = 1.0));
+
+    def("ic2eq_soa", &ic2eq_soa_wrapper,
+        "pykep.ic2eq_soa(rv, mu = 1.0, retrograde = False)\n\n"
+        "- rv: array of shape (6, n), rows are the cartesian components x,y,z,vx,vy,vz of n states\n"
+        "- mu: gravity parameter\n"
+        "- retrogade: uses the retrograde parameters. Default value is False.\n\n"
+        "Returns the array of shape (6, n) of the modified equinoctial elements a(1-e^2),f,g,h,k,L, as "
+        "pykep.ic2eq\n"
+        "Example:: \n\n"
+        "  EQ = pk.ic2eq_soa(rv, 1.0)",
+        (arg("rv"), arg("mu") = 1.0, arg("retrograde") = false));
+
+    def("eq2ic_soa", &eq2ic_soa_wrapper,
+        "pykep.eq2ic_soa(EQ, mu = 1.0, retrograde = False)\n\n"
+        "- EQ: array of shape (6, n), rows are the modified equinoctial elements a(1-e^2),f,g,h,k,L of n orbits\n"
+        "- mu: gravity parameter (l^3/s^2)\n"
+        "- retrogade: uses the retrograde parameters. Default value is False.\n\n"
+        "Returns the array of shape (6, n) of the cartesian states x,y,z,vx,vy,vz, as pykep.eq2ic\n"
+        "Example:: \n\n"
+        "  rv = pk.eq2ic_soa(EQ, 1.0)",
+        (arg("eq"), arg("mu") = 1.0, arg("retrograde") = false));
+
+    def("eq2par_soa", &eq2par_soa_wrapper,
+        "pykep.eq2par_soa(EQ, retrograde = False)\n\n"
+        "- EQ: array of shape (6, n), rows are the modified equinoctial elements a(1-e^2),f,g,h,k,L of n orbits\n"
+        "- retrogade: uses the retrograde parameters. Default value is False.\n\n"
+        "Returns the array of shape (6, n) of the osculating keplerian elements a,e,i,W,w,E, as pykep.eq2par\n"
+        "Example:: \n\n"
+        "  E = pk.eq2par_soa(EQ)",
+        (arg("eq"), arg("retrograde") = false));
+
+    def("par2eq_soa", &par2eq_soa_wrapper,
+        "pykep.par2eq_soa(E, retrograde = False)\n\n"
+        "- E: array of shape (6, n), rows are the osculating keplerian elements a,e,i,W,w,E of n orbits\n"
+        "- retrogade: uses the retrograde parameters. Default value is False.\n\n"
+        "Returns the array of shape (6, n) of the modified equinoctial elements a(1-e^2),f,g,h,k,L, as "
+        "pykep.par2eq\n"
+        "Example:: \n\n"
+        "  EQ = pk.par2eq_soa(E)",
+        (arg("E"), arg("retrograde") = false));
+
     def("damon", &damon_wrapper,
         "pykep.damon(v1,v2,tof)\n\n"
         "- v1: starting velocity relative to the departure body. This is\n"
@@ -26,7 +26,7 @@ def plot_planet(plnt, t0=0, tf=None, N=60, units=1.0, color='k', alpha=1.0, s=40
 	t_plot = pk.epoch(219)
 	ax = pk.orbit_plots.plot_planet(pl, ax = ax, color='b')
     """
-    from pykep import MU_SUN, SEC2DAY, epoch, AU, RAD2DEG
+    from pykep import MU_SUN, SEC2DAY, epoch, AU, RAD2DEG, sample_planet
     from pykep.planet import keplerian
     from math import pi, sqrt
     import numpy as np
@@ -56,19 +56,9 @@ def plot_planet(plnt, t0=0, tf=None, N=60, units=1.0, color='k', alpha=1.0, s=40
         if T < 0:
             raise ValueError("tf should be after t0 when plotting an orbit")
 
-       # points where the orbit will be plotted
-    when = np.linspace(0, T, N)
-
-    # Ephemerides Calculation for the given planet
-    x = np.array([0.0] * N)
-    y = np.array([0.0] * N)
-    z = np.array([0.0] * N)
-
-    for i, day in enumerate(when):
-        r, v = plnt.eph(epoch(t0.mjd2000 + day))
-        x[i] = r[0] / units
-        y[i] = r[1] / units
-        z[i] = r[2] / units
+    # Ephemerides Calculation for the given planet at the points where the orbit will be plotted
+    r, v = sample_planet(plnt, t0.mjd2000, t0.mjd2000 + T, N)
+    x, y, z = r.T / units
 
     # Actual plot commands
     if (legend[0] is True):
@@ -139,7 +129,7 @@ def plot_lambert(l, N=60, sol=0, units=1.0, color='b', legend=False, axes=None,
 
       plt.show()
     """
-    from pykep import propagate_lagrangian, AU
+    from pykep import sample_lambert, AU
     import numpy as np
     import matplotlib.pylab as plt
     from mpl_toolkits.mplot3d import Axes3D
@@ -153,26 +143,9 @@ def plot_lambert(l, N=60, sol=0, units=1.0, color='b', legend=False, axes=None,
     if sol > l.get_Nmax() * 2:
         raise ValueError("sol must be in 0 .. NMax*2 \n * Nmax is the maximum number of revolutions for which there exist a solution to the Lambert's problem \n * You can compute Nmax calling the get_Nmax() method of the lambert_problem object")
 
-    # We extract the relevant information from the Lambert's problem
-    r = l.get_r1()
-    v = l.get_v1()[sol]
-    T = l.get_tof()
-    mu = l.get_mu()
-
-    # We define the integration time ...
-    dt = T / (N - 1)
-
-    # ... and alocate the cartesian components for r
-    x = np.array([0.0] * N)
-    y = np.array([0.0] * N)
-    z = np.array([0.0] * N)
-
-    # We calculate the spacecraft position at each dt
-    for i in range(N):
-        x[i] = r[0] / units
-        y[i] = r[1] / units
-        z[i] = r[2] / units
-        r, v = propagate_lagrangian(r, v, dt, mu)
+    # We calculate the spacecraft position at N equally spaced times
+    r, v = sample_lambert(l, sol, N)
+    x, y, z = r.T / units
 
     # And we plot
     if legend:
@@ -210,10 +183,9 @@ def plot_kepler(r0, v0, tof, mu, N=60, units=1, color='b', label=None, axes=None
         pk.orbit_plots.plot_kepler(r0 = [1,0,0], v0 = [0,1,0], tof = pi/3, mu = 1)
     """
 
-    from pykep import propagate_lagrangian
+    from pykep import sample_kepler
     import matplotlib.pylab as plt
     from mpl_toolkits.mplot3d import Axes3D
-    from copy import deepcopy
 
     if axes is None:
         fig = plt.figure()
@@ -221,22 +193,9 @@ def plot_kepler(r0, v0, tof, mu, N=60, units=1, color='b', label=None, axes=None
     else:
         ax = axes
 
-    # We define the integration time ...
-    dt = tof / (N - 1)
-
-    # ... and calculate the cartesian components for r
-    x = [0.0] * N
-    y = [0.0] * N
-    z = [0.0] * N
-
-    # We calculate the spacecraft position at each dt
-    r = deepcopy(r0)
-    v = deepcopy(v0)
-    for i in range(N):
-        x[i] = r[0] / units
-        y[i] = r[1] / units
-        z[i] = r[2] / units
-        r, v = propagate_lagrangian(r, v, dt, mu)
+    # We calculate the spacecraft position at N equally spaced times
+    r, v = sample_kepler(r0, v0, tof, mu, N)
+    x, y, z = r.T / units
 
     # And we plot
     ax.plot(x, y, z, c=color, label=label)
@@ -274,7 +233,7 @@ def plot_taylor(r0, v0, m0, thrust, tof, mu, veff, N=60, units=1, color='b', leg
 	plt.show()
     """
 
-    from pykep import propagate_taylor
+    from pykep import sample_taylor
     import matplotlib.pyplot as plt
 
     if axes is None:
@@ -283,20 +242,9 @@ def plot_taylor(r0, v0, m0, thrust, tof, mu, veff, N=60, units=1, color='b', leg
     else:
         ax = axes
 
-    # We define the integration time ...
-    dt = tof / (N - 1)
-
-    # ... and calcuate the cartesian components for r
-    x = [0.0] * N
-    y = [0.0] * N
-    z = [0.0] * N
-
-    # We calculate the spacecraft position at each dt
-    for i in range(N):
-        x[i] = r[0] / units
-        y[i] = r[1] / units
-        z[i] = r[2] / units
-        r, v, m = propagate_taylor(r0, v0, m0, u, dt, mu, veff, -10, -10)
+    # We calculate the spacecraft position at N equally spaced times
+    r, v, m = sample_taylor(r0, v0, m0, thrust, tof, mu, veff, N, -10, -10)
+    x, y, z = r.T / units
 
     # And we plot
     if legend:
@@ -406,10 +354,8 @@ def plot_sf_leg(leg, N=5, units=1, color='b', legend=False, plot_line=True, plot
 
         plot_sf_leg(l, units=AU, axes=ax)
     """
-    from pykep import propagate_lagrangian, AU, DAY2SEC, G0, propagate_taylor
     import numpy as np
     from scipy.linalg import norm
-    from math import exp
     import matplotlib.pylab as plt
     from mpl_toolkits.mplot3d import Axes3D
 
@@ -420,166 +366,39 @@ def plot_sf_leg(leg, N=5, units=1, color='b', legend=False, plot_line=True, plot
         ax = axes
 
     # We compute the number of segments for forward and backward propagation
-    n_seg = len(leg.get_throttles())
+    throttles = leg.get_throttles()
+    n_seg = len(throttles)
     fwd_seg = (n_seg + 1) // 2
     back_seg = n_seg // 2
 
-    # We extract information on the spacecraft
-    sc = leg.get_spacecraft()
-    isp = sc.isp
-    max_thrust = sc.thrust
+    # The trajectory, sampled natively with N points along each half segment (arcs 2i and 2i + 1 of segment i)
+    r_samples, _, _ = leg.sample_trajectory(N)
+    r_samples = r_samples / units
 
-    # And on the leg
-    throttles = leg.get_throttles()
-    mu = leg.get_mu()
-
-    # Forward propagation
-
-    # x,y,z contain the cartesian components of all points (grid+midpints)
-    x = [0.0] * (fwd_seg * 2 + 1)
-    y = [0.0] * (fwd_seg * 2 + 1)
-    z = [0.0] * (fwd_seg * 2 + 1)
-
-    state = leg.get_xi()
-
-    # Initial conditions
-    r = state.r
-    v = state.v
-    m = state.m
-    x[0] = r[0] / units
-    y[0] = r[1] / units
-    z[0] = r[2] / units
-
-    # We compute all points by propagation
-    for i, t in enumerate(throttles[:fwd_seg]):
-        dt = (t.end.mjd - t.start.mjd) * DAY2SEC
-        alpha = min(norm(t.value), 1.0)
-        # Keplerian propagation and dV application
-        if leg.high_fidelity is False:
-            dV = [max_thrust / m * dt * dumb for dumb in t.value]
-            if plot_line:
-                plot_kepler(r, v, dt / 2, mu, N=N, units=units,
-                            color=(alpha, 0, 1 - alpha), axes=ax)
-            r, v = propagate_lagrangian(r, v, dt / 2, mu)
-            x[2 * i + 1] = r[0] / units
-            y[2 * i + 1] = r[1] / units
-            z[2 * i + 1] = r[2] / units
-            # v= v+dV
-            v = [a + b for a, b in zip(v, dV)]
-            if plot_line:
-                plot_kepler(r, v, dt / 2, mu, N=N, units=units,
-                            color=(alpha, 0, 1 - alpha), axes=ax)
-            r, v = propagate_lagrangian(r, v, dt / 2, mu)
-            x[2 * i + 2] = r[0] / units
-            y[2 * i + 2] = r[1] / units
-            z[2 * i + 2] = r[2] / units
-            m *= exp(-norm(dV) / isp / G0)
-        # Taylor propagation of constant thrust u
-        else:
-            u = [max_thrust * dumb for dumb in t.value]
-            if plot_line:
-                plot_taylor(r, v, m, u, dt / 2, mu, isp * G0, N=N,
-                            units=units, color=(alpha, 0, 1 - alpha), axes=ax)
-            r, v, m = propagate_taylor(
-                r, v, m, u, dt / 2, mu, isp * G0, -12, -12)
-            x[2 * i + 1] = r[0] / units
-            y[2 * i + 1] = r[1] / units
-            z[2 * i + 1] = r[2] / units
-            if plot_line:
-                plot_taylor(r, v, m, u, dt / 2, mu, isp * G0, N=N,
-                            units=units, color=(alpha, 0, 1 - alpha), axes=ax)
-            r, v, m = propagate_taylor(
-                r, v, m, u, dt / 2, mu, isp * G0, -12, -12)
-            x[2 * i + 2] = r[0] / units
-            y[2 * i + 2] = r[1] / units
-            z[2 * i + 2] = r[2] / units
-
-    x_grid = x[::2]
-    y_grid = y[::2]
-    z_grid = z[::2]
-    x_midpoint = x[1::2]
-    y_midpoint = y[1::2]
-    z_midpoint = z[1::2]
-    if plot_segments:
-        ax.scatter(x_grid[:-1], y_grid[:-1], z_grid[:-1],
-                     label='nodes', marker='o')
-        ax.scatter(x_midpoint, y_midpoint, z_midpoint,
-                     label='mid-points', marker='x')
-        ax.scatter(x_grid[-1], y_grid[-1], z_grid[-1],
-                     marker='^', c='y', label='mismatch point')
-
-    # Backward propagation
-
-    # x,y,z will contain the cartesian components of
-    x = [0.0] * (back_seg * 2 + 1)
-    y = [0.0] * (back_seg * 2 + 1)
-    z = [0.0] * (back_seg * 2 + 1)
-
-    state = leg.get_xf()
-
-    # Final conditions
-    r = state.r
-    v = state.v
-    m = state.m
-    x[-1] = r[0] / units
-    y[-1] = r[1] / units
-    z[-1] = r[2] / units
-
-    for i, t in enumerate(throttles[-1:-back_seg - 1:-1]):
-        dt = (t.end.mjd - t.start.mjd) * DAY2SEC
-        alpha = min(norm(t.value), 1.0)
-        if leg.high_fidelity is False:
-            dV = [max_thrust / m * dt * dumb for dumb in t.value]
-            if plot_line:
-                plot_kepler(r, v, -dt / 2, mu, N=N, units=units,
-                            color=(alpha, 0, 1 - alpha), axes=ax)
-            r, v = propagate_lagrangian(r, v, -dt / 2, mu)
-            x[-2 * i - 2] = r[0] / units
-            y[-2 * i - 2] = r[1] / units
-            z[-2 * i - 2] = r[2] / units
-            # v= v+dV
-            v = [a - b for a, b in zip(v, dV)]
-            if plot_line:
-                plot_kepler(r, v, -dt / 2, mu, N=N, units=units,
-                            color=(alpha, 0, 1 - alpha), axes=ax)
-            r, v = propagate_lagrangian(r, v, -dt / 2, mu)
-            x[-2 * i - 3] = r[0] / units
-            y[-2 * i - 3] = r[1] / units
-            z[-2 * i - 3] = r[2] / units
-            m *= exp(norm(dV) / isp / G0)
-        else:
-            u = [max_thrust * dumb for dumb in t.value]
-            if plot_line:
-                plot_taylor(r, v, m, u, -dt / 2, mu, isp * G0, N=N,
-                            units=units, color=(alpha, 0, 1 - alpha), axes=ax)
-            r, v, m = propagate_taylor(
-                r, v, m, u, -dt / 2, mu, isp * G0, -12, -12)
-            x[-2 * i - 2] = r[0] / units
-            y[-2 * i - 2] = r[1] / units
-            z[-2 * i - 2] = r[2] / units
-            if plot_line:
-                plot_taylor(r, v, m, u, -dt / 2, mu, isp * G0, N=N,
-                            units=units, color=(alpha, 0, 1 - alpha), axes=ax)
-            r, v, m = propagate_taylor(
-                r, v, m, u, -dt / 2, mu, isp * G0, -12, -12)
-            x[-2 * i - 3] = r[0] / units
-            y[-2 * i - 3] = r[1] / units
-            z[-2 * i - 3] = r[2] / units
-
-    x_grid = x[::2]
-    y_grid = y[::2]
-    z_grid = z[::2]
-    x_midpoint = x[1::2]
-    y_midpoint = y[1::2]
-    z_midpoint = z[1::2]
+    # The trajectory, coloured by the throttle magnitude
+    if plot_line:
+        for i, t in enumerate(throttles):
+            alpha = min(norm(t.value), 1.0)
+            for arc in (2 * i, 2 * i + 1):
+                xs, ys, zs = r_samples[arc * N:(arc + 1) * N].T
+                ax.plot(xs, ys, zs, c=(alpha, 0, 1 - alpha))
 
+    # The grid points and mid-points are the endpoints of the arcs: the forward segments are propagated from their
+    # first sample, the backward ones from their last
     if plot_segments:
-        ax.scatter(x_grid[1:], y_grid[1:], z_grid[
-                     1:], marker='o', label='nodes')
-        ax.scatter(x_midpoint, y_midpoint, z_midpoint,
-                     marker='x', label='mid-points')
-        ax.scatter(x_grid[0], y_grid[0], z_grid[0],
-                     marker='^', c='y', label='mismatch point')
+        first = r_samples[::N]
+        last = r_samples[N - 1::N]
+
+        # Forward propagation
+        ax.scatter(*first[0:2 * fwd_seg:2].T, label='nodes', marker='o')
+        ax.scatter(*first[1:2 * fwd_seg:2].T, label='mid-points', marker='x')
+        ax.scatter(*last[2 * fwd_seg - 1], marker='^', c='y', label='mismatch point')
+
+        # Backward propagation
+        mismatch = first[2 * fwd_seg] if back_seg else np.array(leg.get_xf().r) / units
+        ax.scatter(*last[2 * fwd_seg + 1::2].T, marker='o', label='nodes')
+        ax.scatter(*last[2 * fwd_seg::2].T, marker='x', label='mid-points')
+        ax.scatter(*mismatch, marker='^', c='y', label='mismatch point')
 
     if legend:
         ax.legend()
@@ -3,12 +3,10 @@ This module contains functions that allow to study the planetary phasing.
 That is the relative planetary position
 """
 from pykep import __extensions__
-
-if (__extensions__['scipy']):
-    from ._knn import *
-
-if (__extensions__['scikit-learn']):
-    from ._dbscan import *
+# Importing the native kd-tree and transfer cost matrices
+from pykep.phasing.phasing import kdtree, lambert_matrix, damon_batch, lambert_damon_matrix, three_impulses_matrix
+from ._knn import *
+from ._dbscan import *
 
 # if (__extensions__['pygmo'] and __extensions__['mplot3d']):
 #    from ._lambert import lambert_metric
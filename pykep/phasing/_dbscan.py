@@ -28,12 +28,8 @@ class dbscan():
         self.n_clusters = None
         self.members = None
         self.core_members = None
-
-    def _orbital_metric(self, r, v):
-        from pykep.core import DAY2SEC
-        DV2 = [a / (self._T * DAY2SEC) for a in r]
-        DV1 = [a + b for a, b in zip(DV2, v)]
-        return DV1 + DV2
+        self._kdtree = None
+        self._kdtree_params = None
 
     def cluster(self, t, eps=0.125, min_samples=10, metric='orbital', T=180, ref_r=AU, ref_v=EARTH_VELOCITY):
         """
@@ -46,35 +42,24 @@ class dbscan():
         - T: average transfer time (used in the definition of the 'orbital' metric)
         - ref_r         reference radius   (used as a scaling factor for r if the metric is 'euclidean' or 'euclidean_r')
         - ref_v         reference velocity (used as a scaling factor for v if the metric is 'euclidean')
+
+        The clustering is native (see pykep.phasing.kdtree and pykep.phasing.phasing.dbscan). When the same metric is
+        used at a new epoch, the kd-tree of the previous call is moved there instead of being rebuilt.
         """
         import pykep
         import numpy
-        from sklearn.cluster import DBSCAN
+        from pykep.phasing.phasing import kdtree, dbscan as _native_dbscan
 
         self._epoch = pykep.epoch(t)
 
-        if metric == 'euclidean':
-            self._X = [
-                [elem for tupl in p.eph(self._epoch) for elem in tupl] for p in self._asteroids]
-            scaling_vector = [ref_r] * 3
-            scaling_vector += [ref_v] * 3
-        elif metric == 'euclidean_r':
-            self._X = [list(p.eph(self._epoch)[0]) for p in self._asteroids]
-            scaling_vector = [ref_r] * 3
-        elif metric == 'orbital':
-            self._T = T
-            self._X = [self._orbital_metric(
-                *p.eph(self._epoch)) for p in self._asteroids]
-            scaling_vector = [1.] * 6  # no scaling
-        self._X = numpy.array(self._X)
-
-        scaling_vector = numpy.array(scaling_vector)
-        self._X = self._X / scaling_vector[None, :]
-
-        self._db = DBSCAN(eps=eps, min_samples=min_samples).fit(self._X)
-        self._core_samples = self._db.core_sample_indices_
-
-        self.labels = self._db.labels_
+        params = (metric, T, ref_r, ref_v)
+        if self._kdtree is not None and self._kdtree_params == params:
+            self._kdtree.update(self._epoch.mjd2000)
+        else:
+            self._kdtree = kdtree(list(self._asteroids), self._epoch.mjd2000, metric, T, ref_r, ref_v)
+            self._kdtree_params = params
+
+        self.labels, self._core_samples = _native_dbscan(self._kdtree, eps, min_samples)
         self.n_clusters = len(
             set(self.labels)) - (1 if -1 in self.labels else 0)
 
@@ -88,7 +73,16 @@ class dbscan():
             self.core_members[int(label)] = [
                 index for index in self._core_samples if self.labels[index] == label]
 
-        self._X = self._X * scaling_vector[None, :]
+        # The points of the embedding, without the scaling
+        if metric == 'euclidean':
+            self._scaling = numpy.array([ref_r] * 3 + [ref_v] * 3)
+            self._X = self._kdtree.get_points() * self._scaling[None, :]
+        elif metric == 'euclidean_r':
+            self._scaling = numpy.array([ref_r] * 3)
+            self._X = self._kdtree.get_points()[:, :3] * self._scaling[None, :]
+        else:
+            self._scaling = numpy.array([1.] * 6)  # no scaling
+            self._X = self._kdtree.get_points()
 
     def pretty(self):
         """Prints the cluster lists."""
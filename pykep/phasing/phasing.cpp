@@ -0,0 +1,522 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pagmo development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *   http://apps.sourceforge.net/mediawiki/pagmo                             *
+ *   http://apps.sourceforge.net/mediawiki/pagmo/index.php?title=Developers  *
+ *   http://apps.sourceforge.net/mediawiki/pagmo/index.php?title=Credits     *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 3 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+// Workaround for http://mail.python.org/pipermail/new-bugs-announce/2011-March/010395.html
+#ifdef _WIN32
+#include <cmath>
+#endif
+
+#include <boost/python/class.hpp>
+#include <boost/python/def.hpp>
+#include <boost/python/docstring_options.hpp>
+#include <boost/python/extract.hpp>
+#include <boost/python/list.hpp>
+#include <boost/python/make_constructor.hpp>
+#include <boost/python/module.hpp>
+#include <boost/python/tuple.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <keplerian_toolbox/keplerian_toolbox.hpp>
+#include "../boost_python_container_conversions.h"
+#include "../utils.h"
+
+using namespace boost::python;
+
+static inline kep_toolbox::phasing::kdtree::metric metric_from_string(const std::string &metric)
+{
+    if (metric == "euclidean") {
+        return kep_toolbox::phasing::kdtree::EUCLIDEAN;
+    } else if (metric == "euclidean_r") {
+        return kep_toolbox::phasing::kdtree::EUCLIDEAN_R;
+    } else if (metric != "orbital") {
+        throw_value_error("metric must be one of 'euclidean', 'euclidean_r', 'orbital'");
+    }
+    return kep_toolbox::phasing::kdtree::ORBITAL;
+}
+
+// Ephemerides of planets implemented in Python call back into Python: they are computed serially, with the GIL
+static inline bool has_python_planets(const std::vector<kep_toolbox::planet::planet_ptr> &planets)
+{
+    for (const auto &p : planets) {
+        if (is_python_implemented(*p)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static inline boost::shared_ptr<kep_toolbox::phasing::kdtree> kdtree_init(const list &planets, double mjd2000,
+                                                                           const std::string &metric, double T,
+                                                                           double ref_r, double ref_v,
+                                                                           unsigned n_threads)
+{
+    const auto planets_ = planet_list_to_vector(planets);
+    const auto m = metric_from_string(metric);
+    if (has_python_planets(planets_)) {
+        return boost::shared_ptr<kep_toolbox::phasing::kdtree>(
+            new kep_toolbox::phasing::kdtree(planets_, mjd2000, m, T, ref_r, ref_v, 1u));
+    }
+    gil_releaser release;
+    return boost::shared_ptr<kep_toolbox::phasing::kdtree>(
+        new kep_toolbox::phasing::kdtree(planets_, mjd2000, m, T, ref_r, ref_v, n_threads));
+}
+
+static inline bool kdtree_update_wrapper(kep_toolbox::phasing::kdtree &t, double mjd2000, double rebuild_factor,
+                                         unsigned n_threads)
+{
+    if (has_python_planets(t.get_planets())) {
+        return t.update(mjd2000, rebuild_factor, 1u);
+    }
+    gil_releaser release;
+    return t.update(mjd2000, rebuild_factor, n_threads);
+}
+
+// Queries carrying an epoch (a pykep.epoch or a mjd2000) first move the tree there
+static inline void move_to(kep_toolbox::phasing::kdtree &t, const object &when)
+{
+    if (when.is_none()) {
+        return;
+    }
+    extract<const kep_toolbox::epoch &> ep(when);
+    const double mjd2000 = ep.check() ? ep().mjd2000() : extract<double>(when)();
+    if (mjd2000 != t.get_mjd2000()) {
+        kdtree_update_wrapper(t, mjd2000, 2., 0u);
+    }
+}
+
+// A query point can be a planet (its state at the epoch of the tree), the index of a planet in the tree or a point
+// of the embedding
+static inline kep_toolbox::phasing::kdtree::point_type query_point(const kep_toolbox::phasing::kdtree &t,
+                                                                   const object &x)
+{
+    extract<const kep_toolbox::planet::base &> pl(x);
+    if (pl.check()) {
+        return t.embed(pl());
+    }
+    extract<std::size_t> idx(x);
+    if (idx.check()) {
+        return t.get_point(idx());
+    }
+    if (len(x) != 6) {
+        throw_value_error("The query must be a planet, a planet index or a point of the embedding (6 floats)");
+    }
+    kep_toolbox::phasing::kdtree::point_type retval;
+    for (unsigned k = 0u; k < 6u; ++k) {
+        retval[k] = extract<double>(x[k]);
+    }
+    return retval;
+}
+
+static inline tuple query_results(const std::vector<std::size_t> &ids, const std::vector<double> &dists,
+                                  const tuple &shape)
+{
+    return make_tuple(to_ndarray(ids, "uintp", shape), to_ndarray(dists, "float64", shape));
+}
+
+static inline tuple kdtree_query_knn_wrapper(kep_toolbox::phasing::kdtree &t, const object &x, std::size_t k,
+                                             const object &when)
+{
+    move_to(t, when);
+    std::vector<std::size_t> ids;
+    std::vector<double> dists;
+    t.query_knn(query_point(t, x), k, ids, dists);
+    return query_results(ids, dists, make_tuple(ids.size()));
+}
+
+static inline tuple kdtree_query_ball_wrapper(kep_toolbox::phasing::kdtree &t, const object &x, double r,
+                                              const object &when)
+{
+    move_to(t, when);
+    std::vector<std::size_t> ids;
+    std::vector<double> dists;
+    t.query_ball(query_point(t, x), r, ids, dists);
+    return query_results(ids, dists, make_tuple(ids.size()));
+}
+
+static inline tuple kdtree_query_knn_batch_wrapper(kep_toolbox::phasing::kdtree &t,
+                                                   const std::vector<std::size_t> &idxs, std::size_t k,
+                                                   unsigned n_threads, const object &when)
+{
+    move_to(t, when);
+    std::vector<std::size_t> ids;
+    std::vector<double> dists;
+    {
+        gil_releaser release;
+        t.query_knn(idxs, k, ids, dists, n_threads);
+    }
+    return query_results(ids, dists, make_tuple(idxs.size(), idxs.empty() ? 0u : ids.size() / idxs.size()));
+}
+
+static inline object kdtree_get_points_wrapper(const kep_toolbox::phasing::kdtree &t)
+{
+    std::vector<double> points;
+    points.reserve(6u * t.size());
+    for (std::size_t i = 0u; i < t.size(); ++i) {
+        points.insert(points.end(), t.get_point(i).begin(), t.get_point(i).end());
+    }
+    return to_ndarray(points, "float64", make_tuple(t.size(), 6u));
+}
+
+static inline tuple kdtree_embed_wrapper(const kep_toolbox::phasing::kdtree &t, const kep_toolbox::planet::base &pl)
+{
+    const auto p = t.embed(pl);
+    return make_tuple(p[0], p[1], p[2], p[3], p[4], p[5]);
+}
+
+static inline tuple dbscan_wrapper(const kep_toolbox::phasing::kdtree &t, double eps, std::size_t min_samples,
+                                   unsigned n_threads)
+{
+    std::vector<long> labels;
+    std::vector<std::size_t> core_samples;
+    {
+        gil_releaser release;
+        kep_toolbox::phasing::dbscan(t, eps, min_samples, labels, core_samples, n_threads);
+    }
+    return make_tuple(to_ndarray(labels, "long", make_tuple(labels.size())),
+                      to_ndarray(core_samples, "uintp", make_tuple(core_samples.size())));
+}
+
+// As for the kd-tree, the matrix is computed serially with the GIL if some planet is implemented in Python
+static inline tuple lambert_matrix_wrapper(const list &planets, const list &t0, unsigned n_t0, const list &tof,
+                                           unsigned n_tof, double dv_max, unsigned n_threads)
+{
+    if (len(t0) != 2 || len(tof) != 2) {
+        throw_value_error("t0 and tof must be lists of two floats (lower and upper bounds)");
+    }
+    const auto planets_ = planet_list_to_vector(planets);
+    const std::array<double, 2> t0_{{extract<double>(t0[0]), extract<double>(t0[1])}};
+    const std::array<double, 2> tof_{{extract<double>(tof[0]), extract<double>(tof[1])}};
+    std::vector<float> dv, best_t0, best_tof;
+    if (has_python_planets(planets_)) {
+        kep_toolbox::phasing::lambert_matrix(planets_, t0_, n_t0, tof_, n_tof, dv, best_t0, best_tof, dv_max, 1u);
+    } else {
+        gil_releaser release;
+        kep_toolbox::phasing::lambert_matrix(planets_, t0_, n_t0, tof_, n_tof, dv, best_t0, best_tof, dv_max,
+                                             n_threads);
+    }
+    const auto shape = make_tuple(planets_.size(), planets_.size());
+    return make_tuple(to_ndarray(dv, "float32", shape), to_ndarray(best_t0, "float32", shape),
+                      to_ndarray(best_tof, "float32", shape));
+}
+
+static inline tuple damon_batch_wrapper(const object &v1, const object &v2, const object &tof, double T_max,
+                                        double Isp, double m0, unsigned n_threads)
+{
+    std::vector<double> v1_, v2_;
+    kep_toolbox::phasing::lambert_arcs arcs;
+    const std::size_t n = ndarray_to_vector(tof, 0u, arcs.tof);
+    if (ndarray_to_vector(v1, 3u, v1_) != n || ndarray_to_vector(v2, 3u, v2_) != n) {
+        throw_value_error("v1, v2 and tof must have the same length");
+    }
+    arcs.resize(n);
+    for (std::size_t i = 0u; i < n; ++i) {
+        arcs.v1x[i] = v1_[3u * i];
+        arcs.v1y[i] = v1_[3u * i + 1u];
+        arcs.v1z[i] = v1_[3u * i + 2u];
+        arcs.v2x[i] = v2_[3u * i];
+        arcs.v2y[i] = v2_[3u * i + 1u];
+        arcs.v2z[i] = v2_[3u * i + 2u];
+    }
+    std::vector<double> acc, dv;
+    std::vector<char> feasible;
+    {
+        gil_releaser release;
+        kep_toolbox::phasing::damon_batch(arcs, T_max, Isp, m0, acc, dv, feasible, n_threads);
+    }
+    const auto shape = make_tuple(n);
+    return make_tuple(to_ndarray(acc, "float64", shape), to_ndarray(dv, "float64", shape),
+                      to_ndarray(feasible, "bool", shape));
+}
+
+static inline tuple lambert_damon_matrix_wrapper(const list &planets, const list &departures, const list &t0,
+                                                 unsigned n_t0, const list &tof, unsigned n_tof, double T_max,
+                                                 double Isp, double m0, unsigned n_threads)
+{
+    if (len(t0) != 2 || len(tof) != 2) {
+        throw_value_error("t0 and tof must be lists of two floats (lower and upper bounds)");
+    }
+    const auto planets_ = planet_list_to_vector(planets);
+    std::vector<std::size_t> departures_;
+    for (int i = 0; i < len(departures); ++i) {
+        departures_.push_back(extract<std::size_t>(departures[i]));
+    }
+    const std::array<double, 2> t0_{{extract<double>(t0[0]), extract<double>(t0[1])}};
+    const std::array<double, 2> tof_{{extract<double>(tof[0]), extract<double>(tof[1])}};
+    std::vector<float> dv, best_t0, best_tof;
+    if (has_python_planets(planets_)) {
+        kep_toolbox::phasing::lambert_damon_matrix(planets_, departures_, t0_, n_t0, tof_, n_tof, T_max, Isp, m0, dv,
+                                                   best_t0, best_tof, 1u);
+    } else {
+        gil_releaser release;
+        kep_toolbox::phasing::lambert_damon_matrix(planets_, departures_, t0_, n_t0, tof_, n_tof, T_max, Isp, m0, dv,
+                                                   best_t0, best_tof, n_threads);
+    }
+    const auto shape = make_tuple(departures_.size(), planets_.size());
+    return make_tuple(to_ndarray(dv, "float32", shape), to_ndarray(best_t0, "float32", shape),
+                      to_ndarray(best_tof, "float32", shape));
+}
+
+// Orbital elements from a list of planets (osculating at the epoch t) or from an array-like of shape (n, 6)
+static inline kep_toolbox::phasing::soa_elements soa_elements_from(const object &x, double mu, const object &t,
+                                                                   unsigned n_threads)
+{
+    extract<list> planets(x);
+    if (planets.check()) {
+        const auto planets_ = planet_list_to_vector(planets());
+        extract<const kep_toolbox::epoch &> ep(t);
+        const double mjd2000 = ep.check() ? ep().mjd2000() : extract<double>(t)();
+        if (has_python_planets(planets_)) {
+            return kep_toolbox::phasing::soa_elements(planets_, mjd2000, 1u);
+        }
+        gil_releaser release;
+        return kep_toolbox::phasing::soa_elements(planets_, mjd2000, n_threads);
+    }
+    std::vector<double> el;
+    const std::size_t n = ndarray_to_vector(x, 6u, el);
+    kep_toolbox::phasing::soa_elements retval;
+    retval.resize(n);
+    retval.mu = mu;
+    for (std::size_t i = 0u; i < n; ++i) {
+        retval.a[i] = el[6u * i];
+        retval.e[i] = el[6u * i + 1u];
+        retval.i[i] = el[6u * i + 2u];
+        retval.W[i] = el[6u * i + 3u];
+        retval.w[i] = el[6u * i + 4u];
+        retval.M[i] = el[6u * i + 5u];
+    }
+    return retval;
+}
+
+static inline object three_impulses_matrix_wrapper(const object &A, const object &B, double mu, std::size_t k,
+                                                   const object &t, unsigned n_threads)
+{
+    const auto from = soa_elements_from(A, mu, t, n_threads);
+    const auto to = B.is_none() ? from : soa_elements_from(B, mu, t, n_threads);
+    std::vector<float> dv;
+    if (k == 0u) {
+        {
+            gil_releaser release;
+            kep_toolbox::phasing::three_impulses_matrix(from, to, dv, n_threads);
+        }
+        return to_ndarray(dv, "float32", make_tuple(from.size(), to.size()));
+    }
+    std::vector<std::size_t> ids;
+    {
+        gil_releaser release;
+        kep_toolbox::phasing::three_impulses_knn(from, to, k, ids, dv, B.is_none(), n_threads);
+    }
+    const auto shape = make_tuple(from.size(), k);
+    return make_tuple(to_ndarray(ids, "uintp", shape), to_ndarray(dv, "float32", shape));
+}
+
+BOOST_PYTHON_MODULE(phasing)
+{
+    // Disable docstring c++ signature to allow sphinx autodoc to work properly
+    docstring_options doc_options;
+    doc_options.disable_signatures();
+
+    // Kd-tree
+    class_<kep_toolbox::phasing::kdtree>("kdtree", "Kd-tree over the phasing embedding of a set of planets",
+                                         no_init)
+        .def("__init__",
+             make_constructor(&kdtree_init, default_call_policies(),
+                              (arg("planets"), arg("mjd2000"), arg("metric") = "orbital", arg("T") = 180.,
+                               arg("ref_r") = ASTRO_AU, arg("ref_v") = ASTRO_EARTH_VELOCITY, arg("n_threads") = 0u)),
+             "pykep.phasing.kdtree(planets, mjd2000, metric = 'orbital', T = 180., ref_r = AU, "
+             "ref_v = EARTH_VELOCITY, n_threads = 0)\n\n"
+             "- planets: list of pykep.planet (typically thousands)\n"
+             "- mjd2000: epoch of the ephemerides (mjd2000)\n"
+             "- metric: one of 'euclidean', 'euclidean_r', 'orbital'\n"
+             "- T: average transfer time (days), used in the definition of the 'orbital' metric\n"
+             "- ref_r: reference radius, scaling r if the metric is 'euclidean'\n"
+             "- ref_v: reference velocity, scaling v if the metric is 'euclidean'\n"
+             "- n_threads: number of threads computing the ephemerides and the tree (0 uses all the available "
+             "cores)\n\n"
+             "The 'orbital' metric is the Euclidean distance over (r/T + v, r/T), i.e. the DV (m/s) of a linear "
+             "model of the orbital transfer, the 'euclidean' one is the distance over (r/ref_r, v/ref_v) and the "
+             "'euclidean_r' one the distance over r/ref_r\n\n"
+             "Example::\n\n"
+             "  ast = [planet.gtoc7(i) for i in range(16257)]\n"
+             "  kdt = phasing.kdtree(ast, 7000, metric = 'orbital', T = 180)")
+        .def("query_knn", &kdtree_query_knn_wrapper, (arg("x"), arg("k") = 1u, arg("t") = object()),
+             "kdt.query_knn(x, k = 1, t = None)\n\n"
+             "- x: a pykep.planet, the index of a planet in the tree or a point of the embedding (6 floats)\n"
+             "- k: number of neighbours\n"
+             "- t: epoch of the query (pykep.epoch or mjd2000), if given the tree is first moved there (see "
+             "update)\n\n"
+             "Returns the arrays (ids, dists) of the indices and of the distances of the k nearest planets, sorted by "
+             "distance\n\n"
+             "Example::\n\n"
+             "  ids, dists = kdt.query_knn(ast[0], 10)")
+        .def("query_ball", &kdtree_query_ball_wrapper, (arg("x"), arg("r"), arg("t") = object()),
+             "kdt.query_ball(x, r, t = None)\n\n"
+             "- x: a pykep.planet, the index of a planet in the tree or a point of the embedding (6 floats)\n"
+             "- r: radius of the query (m/s for the 'orbital' metric)\n"
+             "- t: epoch of the query (pykep.epoch or mjd2000), if given the tree is first moved there (see "
+             "update)\n\n"
+             "Returns the arrays (ids, dists) of the indices and of the distances of the planets within r, sorted "
+             "by distance\n\n"
+             "Example::\n\n"
+             "  ids, dists = kdt.query_ball(0, 5000)")
+        .def("query_knn_batch", &kdtree_query_knn_batch_wrapper,
+             (arg("idxs"), arg("k"), arg("n_threads") = 0u, arg("t") = object()),
+             "kdt.query_knn_batch(idxs, k, n_threads = 0, t = None)\n\n"
+             "- idxs: indices of the query planets in the tree\n"
+             "- k: number of neighbours\n"
+             "- n_threads: number of threads (0 uses all the available cores)\n"
+             "- t: epoch of the query (pykep.epoch or mjd2000), if given the tree is first moved there (see "
+             "update)\n\n"
+             "Returns the arrays (ids, dists) of shape (len(idxs), k) with the k nearest neighbours of each query "
+             "planet, computed in parallel\n\n"
+             "Example::\n\n"
+             "  ids, dists = kdt.query_knn_batch(range(100), 10)")
+        .def("update", &kdtree_update_wrapper, (arg("mjd2000"), arg("rebuild_factor") = 2., arg("n_threads") = 0u),
+             "kdt.update(mjd2000, rebuild_factor = 2., n_threads = 0)\n\n"
+             "- mjd2000: the new epoch of the ephemerides\n"
+             "- rebuild_factor: the tree is rebuilt when its degradation exceeds this factor\n"
+             "- n_threads: number of threads (0 uses all the available cores)\n\n"
+             "Moves the tree to a new epoch recomputing the points and refitting the bounding boxes of its nodes, "
+             "without rebuilding it unless it degraded too much. The degradation is the ratio between the total "
+             "size of the boxes of the leaves and its value when the tree was built. Returns True if the tree was "
+             "rebuilt\n\n"
+             "Example::\n\n"
+             "  for t in range(7500, 8400, 10):\n"
+             "      kdt.update(t)\n"
+             "      ids, dists = kdt.query_ball(0, 5000)")
+        .def("embed", &kdtree_embed_wrapper, (arg("planet")),
+             "kdt.embed(planet)\n\n"
+             "Returns the point of the embedding of the state of planet at the epoch of the tree\n\n"
+             "Example::\n\n"
+             "  x = kdt.embed(planet.jpl_lp('earth'))")
+        .def("get_points", &kdtree_get_points_wrapper,
+             "kdt.get_points()\n\n"
+             "Returns the array of shape (n, 6) of the points of the embedding of the indexed planets\n\n"
+             "Example::\n\n"
+             "  X = kdt.get_points()")
+        .def("__len__", &kep_toolbox::phasing::kdtree::size)
+        .add_property("mjd2000", &kep_toolbox::phasing::kdtree::get_mjd2000, "Epoch of the ephemerides (mjd2000)")
+        .add_property("degradation", &kep_toolbox::phasing::kdtree::get_degradation,
+                      "Degradation of the tree (1 when just built, see update)");
+
+    // DBSCAN
+    def("dbscan", &dbscan_wrapper, (arg("kdtree"), arg("eps"), arg("min_samples"), arg("n_threads") = 0u),
+        "pykep.phasing.phasing.dbscan(kdtree, eps, min_samples, n_threads = 0)\n\n"
+        "- kdtree: a pykep.phasing.kdtree\n"
+        "- eps: max distance between two neighbours (m/s for the 'orbital' metric)\n"
+        "- min_samples: minimum number of neighbours of a core sample (itself included)\n"
+        "- n_threads: number of threads (0 uses all the available cores)\n\n"
+        "Clusters the planets of the kd-tree with DBSCAN (same semantics as sklearn.cluster.DBSCAN), with "
+        "parallel region queries on the tree. Returns the arrays (labels, core_samples) of the cluster of each "
+        "planet (-1 for noise) and of the indices of the core samples\n\n"
+        "Example::\n\n"
+        "  labels, core = phasing.phasing.dbscan(kdt, 0.125, 10)");
+
+    // Lambert transfer cost matrix
+    def("lambert_matrix", &lambert_matrix_wrapper,
+        (arg("planets"), arg("t0"), arg("n_t0"), arg("tof"), arg("n_tof"),
+         arg("dv_max") = std::numeric_limits<double>::infinity(), arg("n_threads") = 0u),
+        "pykep.phasing.lambert_matrix(planets, t0, n_t0, tof, n_tof, dv_max = inf, n_threads = 0)\n\n"
+        "- planets: list of pykep.planet (e.g. the members of a cluster), orbiting the same central body\n"
+        "- t0: bounds [lb, ub] of the departure epochs (mjd2000)\n"
+        "- n_t0: number of departure epochs in the grid\n"
+        "- tof: bounds [lb, ub] of the times of flight (days)\n"
+        "- n_tof: number of times of flight in the grid\n"
+        "- dv_max: maximum DV of interest (m/s)\n"
+        "- n_threads: number of threads (0 uses all the available cores)\n\n"
+        "Computes, for every ordered pair of planets, the minimum DV of the zero revolutions prograde Lambert "
+        "rendezvous over the grid of departure epochs and times of flight (the same DV of "
+        "pykep.phasing.lambert_metric). Pairs that cannot be cheaper than dv_max, according to a lower bound "
+        "based on the angular momenta of the planets, are skipped. Returns the float32 arrays (dv, t0, tof) of "
+        "shape (n, n) with the minimum DVs and the departure epochs and times of flight achieving them (inf and nan "
+        "on the diagonal and where the DV exceeds dv_max)\n\n"
+        "Example::\n\n"
+        "  dv, t0, tof = phasing.lambert_matrix(cluster, [7000, 7365], 74, [100, 400], 31, dv_max = 5000)");
+
+    // Damon's low-thrust approximation
+    def("damon_batch", &damon_batch_wrapper,
+        (arg("v1"), arg("v2"), arg("tof"), arg("T_max"), arg("Isp"), arg("m0"), arg("n_threads") = 0u),
+        "pykep.phasing.damon_batch(v1, v2, tof, T_max, Isp, m0, n_threads = 0)\n\n"
+        "- v1: array of shape (n, 3), starting velocities relative to the departure bodies (m/s)\n"
+        "- v2: array of shape (n, 3), ending velocities relative to the arrival bodies (m/s)\n"
+        "- tof: array of shape (n,), times of flight (s)\n"
+        "- T_max: maximum thrust of the NEP propulsion system (N)\n"
+        "- Isp: specific impulse of the NEP propulsion system (s)\n"
+        "- m0: spacecraft mass at the start of the arcs (kg)\n"
+        "- n_threads: number of threads (0 uses all the available cores)\n\n"
+        "Applies pykep.damon and pykep.max_start_mass to n Lambert arcs at once. Returns the arrays (acc, dv, "
+        "feasible) of the required accelerations (m/s^2), of the DVs of Damon's model (m/s) and of the arcs that a "
+        "spacecraft of mass m0 can fly\n\n"
+        "Example::\n\n"
+        "  acc, dv, feasible = phasing.damon_batch(V1, V2, TOF, T_max = 0.3, Isp = 3000, m0 = 1500)");
+
+    // Fused Lambert and Damon reachability matrix
+    def("lambert_damon_matrix", &lambert_damon_matrix_wrapper,
+        (arg("planets"), arg("departures"), arg("t0"), arg("n_t0"), arg("tof"), arg("n_tof"), arg("T_max") = 0.3,
+         arg("Isp") = 3000., arg("m0") = 1500., arg("n_threads") = 0u),
+        "pykep.phasing.lambert_damon_matrix(planets, departures, t0, n_t0, tof, n_tof, T_max = 0.3, Isp = 3000, "
+        "m0 = 1500, n_threads = 0)\n\n"
+        "- planets: list of pykep.planet (e.g. a whole catalog), orbiting the same central body\n"
+        "- departures: indices in planets of the departure planets\n"
+        "- t0: bounds [lb, ub] of the departure epochs (mjd2000)\n"
+        "- n_t0: number of departure epochs in the grid\n"
+        "- tof: bounds [lb, ub] of the times of flight (days)\n"
+        "- n_tof: number of times of flight in the grid\n"
+        "- T_max: maximum thrust of the NEP propulsion system (N)\n"
+        "- Isp: specific impulse of the NEP propulsion system (s)\n"
+        "- m0: spacecraft mass at departure (kg)\n"
+        "- n_threads: number of threads (0 uses all the available cores)\n\n"
+        "Low-thrust reachability screening: as pykep.phasing.lambert_matrix, but each Lambert arc of the grid is "
+        "converted to a low-thrust transfer with Damon's model, and only the transfers the spacecraft can fly are "
+        "retained (as in pykep.phasing.lambert_metric). Returns the float32 arrays (dv, t0, tof) of shape "
+        "(len(departures), len(planets)) with the minimum DVs of Damon's model and the departure epochs and times "
+        "of flight achieving them (inf and nan for the unreachable planets)\n\n"
+        "Example::\n\n"
+        "  dv, t0, tof = phasing.lambert_damon_matrix(ast, [0], [7000, 7365], 74, [100, 400], 31)");
+
+    // Three impulses transfer cost matrix
+    def("three_impulses_matrix", &three_impulses_matrix_wrapper,
+        (arg("A"), arg("B") = object(), arg("mu") = ASTRO_MU_SUN, arg("k") = 0u, arg("t") = 0.,
+         arg("n_threads") = 0u),
+        "pykep.phasing.three_impulses_matrix(A, B = None, mu = MU_SUN, k = 0, t = 0, n_threads = 0)\n\n"
+        "- A: departure orbits, a list of pykep.planet or an array of shape (n, 6) of orbital elements (a, e, i, W, "
+        "w, M) in SI units\n"
+        "- B: arrival orbits, as A (None means the same orbits as A)\n"
+        "- mu: gravitational parameter of the central body, if A and B are arrays\n"
+        "- k: if positive only the k cheapest transfers from each departure orbit are returned\n"
+        "- t: epoch (pykep.epoch or mjd2000) of the osculating elements of the planets\n"
+        "- n_threads: number of threads (0 uses all the available cores)\n\n"
+        "Computes pykep.phasing.three_impulses_approx for all the pairs of departure and arrival orbits, in "
+        "parallel tiles. Returns the float32 array of shape (n, m) of the DVs (m/s) if k is 0, otherwise the arrays "
+        "(ids, dv) of shape (n, k) of the indices and of the DVs of the k cheapest arrival orbits of each departure "
+        "orbit (excluding itself if B is None)\n\n"
+        "Example::\n\n"
+        "  ast = [planet.gtoc7(i) for i in range(16257)]\n"
+        "  ids, dv = phasing.three_impulses_matrix(ast, k = 50)");
+}
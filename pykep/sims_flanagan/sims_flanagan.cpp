@@ -38,6 +38,7 @@
 #include <boost/python/overloads.hpp>
 #include <boost/python/register_ptr_to_python.hpp>
 #include <boost/python/self.hpp>
+#include <boost/python/tuple.hpp>
 #include <boost/utility.hpp>
 
 #include <keplerian_toolbox/keplerian_toolbox.hpp>
@@ -60,6 +61,56 @@ static inline std::vector<double> get_throttles_con_wrapper(const kep_toolbox::s
     return ceq;
 }
 
+static inline std::vector<double> get_closest_distances_wrapper(const kep_toolbox::sims_flanagan::leg &l)
+{
+    std::vector<double> d_min;
+    l.get_closest_distances(d_min);
+    return d_min;
+}
+
+static inline std::vector<double> get_min_radius_con_wrapper(const kep_toolbox::sims_flanagan::leg &l, double r_min)
+{
+    std::vector<double> c(l.get_throttles_size());
+    l.get_min_radius_con(c.begin(), c.end(), r_min);
+    return c;
+}
+
+static inline tuple sample_trajectory_wrapper(const kep_toolbox::sims_flanagan::leg &l, unsigned N)
+{
+    std::vector<kep_toolbox::array3D> r, v;
+    std::vector<double> m;
+    l.sample_trajectory(N, r, v, m);
+    return boost::python::make_tuple(to_ndarray(r, "float64", make_tuple(r.size(), 3u)),
+                                     to_ndarray(v, "float64", make_tuple(v.size(), 3u)),
+                                     to_ndarray(m, "float64", make_tuple(m.size())));
+}
+
+static inline std::vector<std::vector<double>> get_constraints_jacobian_wrapper(
+    const kep_toolbox::sims_flanagan::leg &l)
+{
+    std::vector<double> jac;
+    l.get_constraints_jacobian(jac);
+    const std::size_t n_cols = 3u * l.get_throttles_size() + 16u;
+    std::vector<std::vector<double>> retval;
+    for (auto it = jac.begin(); it != jac.end(); it += n_cols) {
+        retval.emplace_back(it, it + n_cols);
+    }
+    return retval;
+}
+
+static inline list get_constraints_jacobian_sparsity_wrapper(const kep_toolbox::sims_flanagan::leg &l)
+{
+    return sparsity_to_list(l.get_constraints_jacobian_sparsity());
+}
+
+static inline tuple propulsion_model_eval_wrapper(const kep_toolbox::sims_flanagan::propulsion_model &p, double r,
+                                                  double nominal_thrust, double nominal_isp)
+{
+    double thrust, isp;
+    p.eval(r, nominal_thrust, nominal_isp, thrust, isp);
+    return make_tuple(thrust, isp);
+}
+
 BOOST_PYTHON_MODULE(sims_flanagan)
 {
     // Disable docstring c++ signature to allow sphinx autodoc to work properly
@@ -70,6 +121,52 @@ BOOST_PYTHON_MODULE(sims_flanagan)
     to_tuple_mapping<std::vector<kep_toolbox::sims_flanagan::throttle>>();
     from_python_sequence<std::vector<kep_toolbox::sims_flanagan::throttle>, variable_capacity_policy>();
 
+    // Propulsion model class
+    class_<kep_toolbox::sims_flanagan::propulsion_model>(
+        "propulsion_model", "Dependency of the thrust and specific impulse on the distance from the Sun",
+        init<>("pykep.sims_flanagan.propulsion_model()\n\n"
+               "Constructs the constant propulsion model (the spacecraft nominal thrust and isp are used)\n\n"
+               "Examples::\n\n"
+               " model = sims_flanagan.propulsion_model()"))
+        .def("__repr__", &kep_toolbox::sims_flanagan::propulsion_model::human_readable)
+        .def("solar_polynomial", &kep_toolbox::sims_flanagan::propulsion_model::solar_polynomial,
+             (arg("power"), arg("bus_power"), arg("bus_demand"), arg("efficiency"), arg("max_power"), arg("thrust"),
+              arg("isp")),
+             "pykep.sims_flanagan.propulsion_model.solar_polynomial(power, bus_power, bus_demand, efficiency, "
+             "max_power, thrust, isp)\n\n"
+             "- power: coefficients (increasing degree) of the power generated as a function of the distance (AU)\n"
+             "- bus_power: coefficients of the power available to the bus as a function of the distance (may be "
+             "empty)\n"
+             "- bus_demand: power demand of the bus, the deficit is taken from the power generated\n"
+             "- efficiency: power conversion efficiency\n"
+             "- max_power: maximum power fed to the engine (thermal cap)\n"
+             "- thrust: coefficients of the thrust (N) as a function of the input power\n"
+             "- isp: coefficients of the specific impulse (s) as a function of the input power\n\n"
+             "Returns a solar electric propulsion model. The thrust is clipped at zero.\n\n"
+             "Examples::\n\n"
+             " model = sims_flanagan.propulsion_model.solar_polynomial([1000, -500], [], 0, 0.9, 600, "
+             "[0, 1e-4], [3000])")
+        .staticmethod("solar_polynomial")
+        .def("tabulated", &kep_toolbox::sims_flanagan::propulsion_model::tabulated,
+             (arg("r"), arg("thrust"), arg("isp")),
+             "pykep.sims_flanagan.propulsion_model.tabulated(r, thrust, isp)\n\n"
+             "- r: distances from the Sun (AU), strictly increasing\n"
+             "- thrust: thrust (N) at each distance\n"
+             "- isp: specific impulse (s) at each distance\n\n"
+             "Returns a model interpolating linearly the table (and constant outside of it)\n\n"
+             "Examples::\n\n"
+             " model = sims_flanagan.propulsion_model.tabulated([1, 2], [0.2, 0.05], [3000, 2500])")
+        .staticmethod("tabulated")
+        .def("eval", &propulsion_model_eval_wrapper,
+             (arg("r"), arg("nominal_thrust") = 0., arg("nominal_isp") = 0.),
+             "model.eval(r, nominal_thrust = 0, nominal_isp = 0)\n\n"
+             "- r: distance from the Sun (AU)\n"
+             "- nominal_thrust, nominal_isp: values returned by the constant model\n\n"
+             "Returns the tuple (thrust, isp)\n\n"
+             "Examples::\n\n"
+             " T, isp = model.eval(1.2)")
+        .def_pickle(python_class_pickle_suite<kep_toolbox::sims_flanagan::propulsion_model>());
+
     // Spacecraft class
     class_<kep_toolbox::sims_flanagan::spacecraft>(
         "spacecraft", "Contains design parameters of a NEP spacecraft",
@@ -98,6 +195,14 @@ BOOST_PYTHON_MODULE(sims_flanagan)
                       "Example::\n\n"
                       "  T = sc.isp"
                       "  sc.isp = 2000")
+        .add_property("propulsion_model",
+                      make_function(&kep_toolbox::sims_flanagan::spacecraft::get_propulsion_model,
+                                    return_value_policy<copy_const_reference>()),
+                      &kep_toolbox::sims_flanagan::spacecraft::set_propulsion_model,
+                      "The spacecraft propulsion model, used by the legs at each segment\n\n"
+                      "Example::\n\n"
+                      "  sc.propulsion_model = sims_flanagan.propulsion_model.tabulated([1, 2], [0.2, 0.05], "
+                      "[3000, 2500])")
         .def_pickle(python_class_pickle_suite<kep_toolbox::sims_flanagan::spacecraft>())
         .def(init<>());
 
@@ -275,6 +380,35 @@ BOOST_PYTHON_MODULE(sims_flanagan)
              "Returns a tuple containing the throttle magnitudes minus one\n\n"
              "Example::\n\n"
              " c = l.throttles_constraints()\n")
+        .def("closest_distances", &get_closest_distances_wrapper,
+             "Returns a tuple containing the closest distance to the central body along each segment (high "
+             "fidelity must be off)\n\n"
+             "Example::\n\n"
+             " d = l.closest_distances()\n")
+        .def("min_radius_constraints", &get_min_radius_con_wrapper,
+             "Returns a tuple containing, for each segment, r_min minus the closest distance to the central body "
+             "(needs to be all negative for the leg to be feasible, high fidelity must be off)\n\n"
+             "Example::\n\n"
+             " c = l.min_radius_constraints(0.3 * AU)\n",
+             (arg("r_min")))
+        .def("sample_trajectory", &sample_trajectory_wrapper,
+             "Returns a tuple containing the arrays of shape (2 N n_seg, 3) of the positions and velocities and the "
+             "array of shape (2 N n_seg,) of the masses sampled with N points along each half segment, in "
+             "chronological order (the first half of the segments is propagated forward, the second backward)\n\n"
+             "Example::\n\n"
+             " r, v, m = l.sample_trajectory(10)\n",
+             (arg("N") = 5u))
+        .def("constraints_jacobian", &get_constraints_jacobian_wrapper,
+             "Returns the analytical Jacobian of the mismatch constraints followed by the throttles constraints, with "
+             "respect to [t_i, x_i, y_i, z_i, vx_i, vy_i, vz_i, m_i, throttles, t_f, x_f, y_f, z_f, vx_f, vy_f, vz_f, "
+             "m_f] (epochs in days), as a tuple of rows. The throttle epochs are assumed to move with the leg epochs, "
+             "as for the equally spaced segments created by set\n\n"
+             "Example::\n\n"
+             " J = l.constraints_jacobian()\n")
+        .def("constraints_jacobian_sparsity", &get_constraints_jacobian_sparsity_wrapper,
+             "Returns the [row, column] indices of the structurally non-zero entries of constraints_jacobian\n\n"
+             "Example::\n\n"
+             " sp = l.constraints_jacobian_sparsity()\n")
         .def("__repr__", &kep_toolbox::sims_flanagan::leg::human_readable)
         .def_pickle(python_class_pickle_suite<kep_toolbox::sims_flanagan::leg>());
 
@@ -4,6 +4,9 @@ of pygmo.archipelago and pygmo.island with these may result in slow execution as
 be handled by python multiprocessing module, which is far slower than boost::threads (used instead when the pygmo problems
 are implemented in c++)
 """
+# Importing the native evaluators
+from pykep.trajopt.trajopt import mga_evaluator, mga_1dsm_evaluator, mga_lt_nep_evaluator, mga_sequence_search, \
+    pl2pl_N_impulses_evaluator
 from pykep.trajopt._lt_margo import lt_margo
 from pykep.trajopt._mga_1dsm import mga_1dsm
 from pykep.trajopt._mga import mga
@@ -1,5 +1,6 @@
 import pykep as pk
 import numpy as np
+from pykep.trajopt.trajopt import mga_lt_nep_evaluator
 
 class _direct_base(object):
     """Base class for direct trajectory optimisation problems with one only leg.
@@ -248,6 +249,24 @@ class direct_pl2pl(_direct_base):
         # SUN
         self.mu = pk.MU_SUN
 
+        # The problem is a single leg mga_lt_nep (same decision vector and fitness), so the batches of decision
+        # vectors are evaluated natively by its evaluator (see batch_fitness)
+        self._evaluator = self._make_evaluator()
+
+    def _make_evaluator(self):
+        return mga_lt_nep_evaluator([self.p0, self.pf], [self.nseg], self.vinf_dep, self.vinf_arr, self.sc.mass,
+                                    self.sc.thrust, self.sc.isp, False, self.leg.high_fidelity, self.mu)
+
+    # The native evaluator is not picklable, it is rebuilt when the problem is copied
+    def __getstate__(self):
+        state = self.__dict__.copy()
+        del state['_evaluator']
+        return state
+
+    def __setstate__(self, state):
+        self.__dict__.update(state)
+        self._evaluator = self._make_evaluator()
+
     def fitness(self, z):
 
         # epochs (mjd2000)
@@ -296,6 +315,10 @@ class direct_pl2pl(_direct_base):
 
         return np.hstack(([-mf], ceq, cineq, [v_dep_con, v_arr_con]))
 
+    def batch_fitness(self, dvs):
+        # The decision vectors are evaluated natively in parallel (see mga_lt_nep_evaluator.batch_fitness)
+        return self._evaluator.batch_fitness(dvs)
+
     def get_nic(self):
         return super().get_nic() + 2
 
@@ -5,6 +5,19 @@ import math
 mpcorbline = "K14Y00D 24.3   0.15 K1794 105.44160   34.12337  117.64264    1.73560  0.0865962  0.88781021   1.0721510  2 MPO369254   104   1  194 days 0.24 M-v 3Eh MPCALB     2803          2014 YD            20150618"
 
 
+def _sep_propulsion_model():
+    # The M-ARGO solar electric propulsion model (6 panels, zero solar aspect angle), the 8 panels
+    # version has power coefficients [864.32, -1412.3, 878.03, -195.02]
+    return pk.sims_flanagan.propulsion_model.solar_polynomial(
+        power=[648.24, -1059.2, 658.52, -146.26],
+        bus_power=[141.86, -259.19, 173.49, -40.558],
+        bus_demand=13.75,
+        efficiency=0.92,
+        max_power=120.,
+        thrust=[-708.973e-6, 26.27127e-6],
+        isp=[2037.213, 4.193797, 0.175971, -0.0011])
+
+
 class lt_margo:
     """
     This class can be used as a User Defined Problem (UDP) in the pygmo2 software and if successfully solved,
@@ -74,6 +87,8 @@ class lt_margo:
         self.__n_seg = n_seg
         self.__grid_type = grid_type
         self.__sc = pk.sims_flanagan.spacecraft(m0, Tmax, Isp)
+        if sep:
+            self.__sc.propulsion_model = _sep_propulsion_model()
         self.__earth = pk.planet.jpl_lp('earth')
         self.__earth_gravity = earth_gravity
         self.__sep = sep
@@ -206,27 +221,7 @@ class lt_margo:
 
     # SEP model
     def _sep_model(self, r):
-        SAA = 0
-        Psupply = 13.75
-        eff = 0.92
-
-        Pbmp = (-40.558 * r**3 + 173.49 * r**2 -
-                259.19 * r + 141.86) * math.cos(SAA)
-        P = -146.26 * r**3 + 658.52 * r**2 - 1059.2 * r + 648.24  # 6 panels
-        # P = -195.02 * r**3 + 878.03 * r**2 - 1412.3 * r + 864.32 # 8 panels
-        if Pbmp < Psupply:
-            P -= (Psupply - Pbmp)
-        Pin = eff * P
-        if Pin > 120:
-            Pin = 120  # thermal max 120W
-
-        Tmax = (26.27127 * Pin - 708.973) / 1000000
-        if Tmax < 0:
-            Tmax = 0
-
-        Isp = -0.0011 * Pin**3 + 0.175971 * Pin**2 + 4.193797 * Pin + 2037.213
-
-        return Tmax, Isp
+        return self.__sc.propulsion_model.eval(r)
 
     # Propagates the trajectory
     def _propagate(self, x):
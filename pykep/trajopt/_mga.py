@@ -1,5 +1,6 @@
 from pykep.core import epoch, lambert_problem, DAY2SEC, fb_vel, AU
 from pykep.planet import jpl_lp
+from pykep.trajopt.trajopt import mga_evaluator
 
 import numpy as np
 
@@ -123,6 +124,25 @@ class mga:
         self._n_legs = len(seq) - 1
         self._common_mu = seq[0].mu_central_body
 
+        # The fitness is evaluated natively (see mga_evaluator)
+        self._evaluator = self._make_evaluator()
+
+    def _make_evaluator(self):
+        return mga_evaluator(self.seq, self.tof_encoding, self.tof if self.tof_encoding == 'eta' else 0.,
+                             self.vinf, self.multi_objective, self.orbit_insertion,
+                             self.e_target if self.orbit_insertion else 0.,
+                             self.rp_target if self.orbit_insertion else 0.)
+
+    # The native evaluator is not picklable, it is rebuilt when the problem is copied
+    def __getstate__(self):
+        state = self.__dict__.copy()
+        del state['_evaluator']
+        return state
+
+    def __setstate__(self, state):
+        self.__dict__.update(state)
+        self._evaluator = self._make_evaluator()
+
     def get_nobj(self):
         return self.multi_objective + 1
 
@@ -278,17 +298,12 @@ class mga:
 
     # Objective function
     def fitness(self, x):
-        DVlaunch, DVfb, DVarrival, _, _ = self._compute_dvs(x)
-        if self.tof_encoding == 'direct':
-            T = sum(x[1:])
-        elif self.tof_encoding == 'alpha':
-            T = x[1]
-        elif self.tof_encoding == 'eta':
-            T = sum(self.eta2direct(x)[1:])
-        if self.multi_objective:
-            return [DVlaunch + np.sum(DVfb) + DVarrival, T]
-        else:
-            return [DVlaunch + np.sum(DVfb) + DVarrival]
+        # The times of flight are decoded and the Lambert legs and fly-bys evaluated natively (see mga_evaluator)
+        return self._evaluator.fitness(x)
+
+    def batch_fitness(self, dvs):
+        # The decision vectors are evaluated natively in parallel (see mga_evaluator.batch_fitness)
+        return self._evaluator.batch_fitness(dvs)
 
     def pretty(self, x):
         """pretty(x)
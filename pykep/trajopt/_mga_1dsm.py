@@ -1,5 +1,6 @@
 from pykep.core import epoch, DAY2SEC, MU_SUN, lambert_problem, propagate_lagrangian, fb_prop, AU, epoch
 from pykep.planet import jpl_lp
+from pykep.trajopt.trajopt import mga_1dsm_evaluator
 from math import pi, cos, sin, acos, log, sqrt
 import numpy as np
 
@@ -137,6 +138,25 @@ class mga_1dsm:
         self.n_legs = len(seq) - 1
         self.common_mu = seq[0].mu_central_body
 
+        # The fitness is evaluated natively (see mga_1dsm_evaluator)
+        self._evaluator = self._make_evaluator()
+
+    def _make_evaluator(self):
+        return mga_1dsm_evaluator(self._seq, self._tof_encoding, self._tof if self._tof_encoding == 'eta' else 0.,
+                                  self._add_vinf_dep, self._add_vinf_arr, self._multi_objective,
+                                  self._orbit_insertion, self._e_target if self._orbit_insertion else 0.,
+                                  self._rp_target if self._orbit_insertion else 0.)
+
+    # The native evaluator is not picklable, it is rebuilt when the problem is copied
+    def __getstate__(self):
+        state = self.__dict__.copy()
+        del state['_evaluator']
+        return state
+
+    def __setstate__(self, state):
+        self.__dict__.update(state)
+        self._evaluator = self._make_evaluator()
+
     def get_nobj(self):
         return self._multi_objective + 1
 
@@ -165,101 +185,20 @@ class mga_1dsm:
         return (lb, ub)
 
     def _decode_times_and_vinf(self, x):
-        # 1 - we decode the times of flight
-        if self._tof_encoding == 'alpha':
-            # decision vector is  [t0] + [u, v, Vinf, eta1, a1] + [beta, rp/rV, eta2, a2] + ... + [T]
-            T = list([0] * (self.n_legs))
-            for i in range(len(T)):
-                T[i] = -log(x[5 + 4 * i])
-            alpha_sum = sum(T)
-            retval_T = [x[-1] * time / alpha_sum for time in T]
-        elif self._tof_encoding == 'direct':
-            # decision vector is  [t0] + [u, v, Vinf, eta1, T1] + [beta, rp/rV, eta2, T2] + ...
-            retval_T = x[5::4]
-        elif self._tof_encoding == 'eta':
-            # decision vector is  [t0] + [u, v, Vinf, eta1, n1] + [beta, rp/rV, eta2, n2] + ...
-            dt = self._tof
-            T = [0] * self.n_legs
-            for i in range(self.n_legs):
-                T[i] = (dt - sum(T[:i])) * x[5 + 4*i]
-            retval_T = T
-
-        # 2 - we decode the hyperbolic velocity at departure
-        theta = 2 * pi * x[1]
-        phi = acos(2 * x[2] - 1) - pi / 2
-
-        Vinfx = x[3] * cos(phi) * cos(theta)
-        Vinfy = x[3] * cos(phi) * sin(theta)
-        Vinfz = x[3] * sin(phi)
-
-        return (retval_T, Vinfx, Vinfy, Vinfz)
+        # The times of flight (days) and the cartesian components of the launch vinf are decoded natively
+        # (see mga_1dsm_evaluator)
+        Vinfx, Vinfy, Vinfz = self._evaluator.decode_vinf(x)
+        return (self._evaluator.decode_tofs(x), Vinfx, Vinfy, Vinfz)
 
     # Objective function
     def fitness(self, x):
-        # 1 -  we 'decode' the chromosome recording the various times of flight
-        # (days) in the list T and the cartesian components of vinf
-        T, Vinfx, Vinfy, Vinfz = self._decode_times_and_vinf(x)
-
-        # 2 - We compute the epochs and ephemerides of the planetary encounters
-        t_P = list([None] * (self.n_legs + 1))
-        r_P = list([None] * (self.n_legs + 1))
-        v_P = list([None] * (self.n_legs + 1))
-        DV = list([0.0] * (self.n_legs + 1))
-        for i in range(len(self._seq)):
-            t_P[i] = epoch(x[0] + sum(T[0:i]))
-            r_P[i], v_P[i] = self._seq[i].eph(t_P[i])
-
-        # 3 - We start with the first leg
-        v0 = [a + b for a, b in zip(v_P[0], [Vinfx, Vinfy, Vinfz])]
-        r, v = propagate_lagrangian(
-            r_P[0], v0, x[4] * T[0] * DAY2SEC, self.common_mu)
-
-        # Lambert arc to reach seq[1]
-        dt = (1 - x[4]) * T[0] * DAY2SEC
-        l = lambert_problem(
-            r, r_P[1], dt, self.common_mu, cw = False, max_revs = 0)
-        v_end_l = l.get_v2()[0]
-        v_beg_l = l.get_v1()[0]
-
-        # First DSM occuring at time nu1*T1
-        DV[0] = norm([a - b for a, b in zip(v_beg_l, v)])
-
-        # 4 - And we proceed with each successive leg
-        for i in range(1, self.n_legs):
-            # Fly-by
-            v_out = fb_prop(v_end_l, v_P[i], x[
-                            7 + (i - 1) * 4] * self._seq[i].radius, x[6 + (i - 1) * 4], self._seq[i].mu_self)
-            # s/c propagation before the DSM
-            r, v = propagate_lagrangian(
-                r_P[i], v_out, x[8 + (i - 1) * 4] * T[i] * DAY2SEC, self.common_mu)
-            # Lambert arc to reach Earth during (1-nu2)*T2 (second segment)
-            dt = (1 - x[8 + (i - 1) * 4]) * T[i] * DAY2SEC
-            l = lambert_problem(r, r_P[i + 1], dt,
-                                self.common_mu, cw=False, max_revs=0)
-            v_end_l = l.get_v2()[0]
-            v_beg_l = l.get_v1()[0]
-            # DSM occuring at time nu2*T2
-            DV[i] = norm([a - b for a, b in zip(v_beg_l, v)])
+        # The decoding, the Keplerian and Lambert arcs, the DSMs and the fly-bys are evaluated natively
+        # (see mga_1dsm_evaluator)
+        return self._evaluator.fitness(x)
 
-        # Last Delta-v
-        if self._add_vinf_arr:
-            DV[-1] = norm([a - b for a, b in zip(v_end_l, v_P[-1])])
-            if self._orbit_insertion:
-                # In this case we compute the insertion DV as a single pericenter
-                # burn
-                DVper = np.sqrt(DV[-1] * DV[-1] + 2 *
-                                self._seq[-1].mu_self / self._rp_target)
-                DVper2 = np.sqrt(2 * self._seq[-1].mu_self / self._rp_target -
-                                self._seq[-1].mu_self / self._rp_target * (1. - self._e_target))
-                DV[-1] = np.abs(DVper - DVper2)
-
-        if self._add_vinf_dep:
-            DV[0] += x[3]
-
-        if not self._multi_objective:
-            return (sum(DV),)
-        else:
-            return (sum(DV), sum(T))
+    def batch_fitness(self, dvs):
+        # The decision vectors are evaluated natively in parallel (see mga_1dsm_evaluator.batch_fitness)
+        return self._evaluator.batch_fitness(dvs)
 
     def pretty(self, x):
         """
@@ -4,6 +4,7 @@ from math import sqrt, asin, acos
 from pykep.core import epoch, fb_con, EARTH_VELOCITY, AU, MU_SUN
 from pykep.planet import jpl_lp
 from pykep.sims_flanagan import leg, spacecraft, sc_state
+from pykep.trajopt.trajopt import mga_lt_nep_evaluator
 
 class mga_lt_nep:
     """
@@ -74,6 +75,23 @@ class mga_lt_nep:
         self._leg = leg()
         self._leg.set_mu(MU_SUN)
         self._leg.set_spacecraft(self._sc)
+        self._Isp = Isp
+        # The fitness is evaluated natively (see mga_lt_nep_evaluator)
+        self._evaluator = self._make_evaluator()
+
+    def _make_evaluator(self):
+        return mga_lt_nep_evaluator(self._seq, self._n_seg, self._vinf_dep, self._vinf_arr, self._mass[1],
+                                    self._Tmax, self._Isp, self._multiobjective, self._high_fidelity, MU_SUN)
+
+    # The native evaluator is not picklable, it is rebuilt when the problem is copied
+    def __getstate__(self):
+        state = self.__dict__.copy()
+        del state['_evaluator']
+        return state
+
+    def __setstate__(self, state):
+        self.__dict__.update(state)
+        self._evaluator = self._make_evaluator()
 
     def get_bounds(self):
         # Convenience aliases
@@ -103,63 +121,20 @@ class mga_lt_nep:
         return (lb, ub)
 
     def fitness(self, x):
-        # The final mass is the fitness
-        objfun = [-x[2 + 8 * (self._n_legs - 1)]]
-        eq_c = []
-        ineq_c = []
-        if self._multiobjective:
-            objfun = objfun + [sum(x[1:8*self._n_legs:8])]
-        # We compute the epochs and ephemerides of the planetary encounters
-        t_P = list([None] * (self._n_legs + 1))
-        r_P = list([None] * (self._n_legs + 1))
-        v_P = list([None] * (self._n_legs + 1))
-        for i in range(len(self._seq)):
-            t_P[i] = epoch(x[0] + sum(x[1:i*8:8]))
-            r_P[i], v_P[i] = self._seq[i].eph(t_P[i])
-        # We assemble the constraints. 
-        # 1 - Mismatch Constraints
-        for i in range(self._n_legs):
-            # Departure velocity of the spacecraft in the heliocentric frame
-            v0 = [a + b for a, b in zip(v_P[i], x[3 + 8 * i:6 + 8 * i])]
-            if i==0:
-                m0 = self._mass[1]
-            else:
-                m0 = x[2 + 8 * (i-1)]
-            x0 = sc_state(r_P[i], v0, m0)
-            vf = [a + b for a, b in zip(v_P[i+1], x[6 + 8 * i:9 + 8 * i])]
-            xf = sc_state(r_P[i+1], vf, x[2 + 8 * i])
-            idx_start = 1 + 8 * self._n_legs + sum(self._n_seg[:i]) * 3
-            idx_end   = 1 + 8 * self._n_legs + sum(self._n_seg[:i+1]) * 3
-            self._leg.set(t_P[i], x0, x[idx_start:idx_end], t_P[i+1], xf)
-            mismatch = list(self._leg.mismatch_constraints())
-            # Making the mismatch non dimensional (assumes an heliocentric interplanetary trajectory)
-            mismatch[0] /= AU
-            mismatch[1] /= AU
-            mismatch[2] /= AU
-            mismatch[3] /= EARTH_VELOCITY
-            mismatch[4] /= EARTH_VELOCITY
-            mismatch[5] /= EARTH_VELOCITY
-            mismatch[6] /= self._mass[1]
-            eq_c = eq_c + mismatch
-            ineq_c = ineq_c + list(self._leg.throttles_constraints())
-
-        # 2 - Fly-by constraints
-        for i in range(self._n_legs - 1):
-            DV_eq, alpha_ineq = fb_con(x[6 + i * 8:9 + i * 8], x[11 + i * 8:14 + i * 8], self._seq[i+1])
-            eq_c = eq_c + [DV_eq / (EARTH_VELOCITY * EARTH_VELOCITY)]
-            ineq_c = ineq_c + [alpha_ineq]
-
-        # 3 - Departure and arrival Vinf
-        # departure
-        v_dep_con = (x[3] * x[3] + x[4] * x[4] + x[5] * x[5] -
-                     self._vinf_dep * self._vinf_dep) / (EARTH_VELOCITY * EARTH_VELOCITY)
-        # arrival
-        n_fb = self._n_legs - 1
-        v_arr_con = (x[6 + n_fb * 8] * x[6 + n_fb * 8] + x[7 + n_fb * 8] * x[7 + n_fb * 8] + x[8 + n_fb * 8] * x[8 + n_fb * 8] -
-                     self._vinf_arr * self._vinf_arr) / (EARTH_VELOCITY * EARTH_VELOCITY)
-        ineq_c = ineq_c + [v_dep_con, v_arr_con]
-
-        return objfun + eq_c + ineq_c
+        # The final mass is the fitness, the constraints are the legs mismatches and throttles,
+        # the fly-bys and the departure and arrival Vinf (see mga_lt_nep_evaluator)
+        return self._evaluator.fitness(x)
+
+    def batch_fitness(self, dvs):
+        # The decision vectors are evaluated natively in parallel (see mga_lt_nep_evaluator.batch_fitness)
+        return self._evaluator.batch_fitness(dvs)
+
+    def gradient_sparsity(self):
+        return self._evaluator.gradient_sparsity()
+
+    def gradient(self, x):
+        # Coloured finite differences on the sparsity pattern (see mga_lt_nep_evaluator)
+        return self._evaluator.gradient(x)
 
     def get_nec(self):
         return self._n_legs * 7 + (self._n_legs - 1)
@@ -241,4 +216,6 @@ class mga_lt_nep:
           prob.high_fidelity(True)
         """
         # We set the propagation fidelity
-        self._leg.high_fidelity = status
\ No newline at end of file
+        self._leg.high_fidelity = status
+        self._high_fidelity = status
+        self._evaluator.high_fidelity = status
\ No newline at end of file
@@ -1,6 +1,7 @@
 from pykep.core import epoch, DAY2SEC, lambert_problem, propagate_lagrangian, SEC2DAY, AU, ic2par
 from pykep.planet import jpl_lp
-from math import pi, cos, sin, log, acos
+from pykep.trajopt.trajopt import pl2pl_N_impulses_evaluator
+from math import pi, cos, sin, log, acos, sqrt
 from scipy.linalg import norm
 
 
@@ -30,10 +31,13 @@ class pl2pl_N_impulses(object):
                  vinf=[0., 4.],
                  phase_free=True,
                  multi_objective=False,
-                 t0=None
+                 t0=None,
+                 orbit_insertion=False,
+                 e_target=None,
+                 rp_target=None
                  ):
         """
-        prob = pykep.trajopt.pl2pl_N_impulses(start=jpl_lp('earth'), target=jpl_lp('venus'), N_max=3, tof=[20., 400.], vinf=[0., 4.], phase_free=True, multi_objective=False, t0=None)
+        prob = pykep.trajopt.pl2pl_N_impulses(start=jpl_lp('earth'), target=jpl_lp('venus'), N_max=3, tof=[20., 400.], vinf=[0., 4.], phase_free=True, multi_objective=False, t0=None, orbit_insertion=False, e_target=None, rp_target=None)
 
         Args: 
             - start (``pykep.planet``): the starting planet
@@ -44,6 +48,9 @@ class pl2pl_N_impulses(object):
             - phase_free (``bool``): when True, no randezvous condition are enforced and start and arrival anomalies will be free
             - multi_objective (``bool``):  when True, a multi-objective problem is constructed with DV and time of flight as objectives
             - t0 (``list``):  the box bounds on the launch window containing two pykep.epoch. This is not needed if phase_free is True.
+            - orbit_insertion (``bool``): when True the arrival DV is the pericenter burn acquiring the target orbit
+            - e_target (``float``): if orbit_insertion is True this is the eccentricity of the target orbit around the target planet
+            - rp_target (``float``): if orbit_insertion is True this is the pericenter of the target orbit around the target planet (m)
         """
 
         # Sanity checks
@@ -59,10 +66,14 @@ class pl2pl_N_impulses(object):
             t0 = [epoch(0), epoch(1000)]
         if (t0 is not None and phase_free):
             raise ValueError('When phase_free is True no t0 can be specified')
-        if (type(t0[0]) != type(epoch(0))):
-            t0[0] = epoch(t0[0])
-        if (type(t0[1]) != type(epoch(0))):
-            t0[1] = epoch(t0[1])
+        if t0 is not None:
+            if (type(t0[0]) != type(epoch(0))):
+                t0[0] = epoch(t0[0])
+            if (type(t0[1]) != type(epoch(0))):
+                t0[1] = epoch(t0[1])
+        # 4) Orbit insertion needs the target orbit
+        if orbit_insertion and (e_target is None or rp_target is None):
+            raise ValueError('When orbit_insertion is True e_target and rp_target must be specified')
 
         self.obj_dim = multi_objective + 1
         # We then define all class data members
@@ -73,19 +84,34 @@ class pl2pl_N_impulses(object):
         self.multi_objective = multi_objective
         self.vinf = [s * 1000 for s in vinf]
 
+        self.orbit_insertion = orbit_insertion
+        self.e_target = e_target
+        self.rp_target = rp_target
+        self._tof = tof
+        self._t0 = None if t0 is None else [t0[0].mjd2000, t0[1].mjd2000]
+
         self.__common_mu = start.mu_central_body
 
-        # And we compute the bounds
-        if phase_free:
-            self._lb = [0, tof[0]] + [1e-3, 0.0, 0.0,
-                                      vinf[0] * 1000] * (N_max - 2) + [1e-3] + [0]
-            self._ub = [2 * start.compute_period(epoch(0)) * SEC2DAY, tof[1]] + [1.0-1e-3, 1.0, 1.0, vinf[
-                1] * 1000] * (N_max - 2) + [1.0-1e-3] + [2 * target.compute_period(epoch(0)) * SEC2DAY]
-        else:
-            self._lb = [t0[0].mjd2000, tof[0]] + \
-                [1e-3, 0.0, 0.0, vinf[0] * 1000] * (N_max - 2) + [1e-3]
-            self._ub = [t0[1].mjd2000, tof[1]] + \
-                [1.0-1e-3, 1.0, 1.0, vinf[1] * 1000] * (N_max - 2) + [1.0-1e-3]
+        # The fitness and the bounds (which, when the phase is free, span two periods of the start and target
+        # planets) are computed natively (see pl2pl_N_impulses_evaluator)
+        self._evaluator = self._make_evaluator()
+        self._lb, self._ub = [list(b) for b in self._evaluator.get_bounds()]
+
+    def _make_evaluator(self):
+        return pl2pl_N_impulses_evaluator(self.start, self.target, self.N_max, self._tof, self.vinf, self.phase_free,
+                                          self.multi_objective, [] if self._t0 is None else self._t0,
+                                          self.orbit_insertion, self.e_target if self.orbit_insertion else 0.,
+                                          self.rp_target if self.orbit_insertion else 0.)
+
+    # The native evaluator is not picklable, it is rebuilt when the problem is copied
+    def __getstate__(self):
+        state = self.__dict__.copy()
+        del state['_evaluator']
+        return state
+
+    def __setstate__(self, state):
+        self.__dict__.update(state)
+        self._evaluator = self._make_evaluator()
 
     def get_nobj(self):
         return self.obj_dim
@@ -94,54 +120,13 @@ class pl2pl_N_impulses(object):
         return (self._lb, self._ub)
 
     def fitness(self, x):
-        # 1 -  we 'decode' the chromosome into the various deep space
-        # manouvres times (days) in the list T
-        T = list([0] * (self.N_max - 1))
-
-        for i in range(len(T)):
-            T[i] = log(x[2 + 4 * i])
-        total = sum(T)
-        T = [x[1] * time / total for time in T]
-
-        # 2 - We compute the starting and ending position
-        r_start, v_start = self.start.eph(epoch(x[0]))
-        if self.phase_free:
-            r_target, v_target = self.target.eph(epoch(x[-1]))
-        else:
-            r_target, v_target = self.target.eph(epoch(x[0] + x[1]))
-
-        # 3 - We loop across inner impulses
-        rsc = r_start
-        vsc = v_start
-        for i, time in enumerate(T[:-1]):
-            theta = 2 * pi * x[3 + 4 * i]
-            phi = acos(2 * x[4 + 4 * i] - 1) - pi / 2
-
-            Vinfx = x[5 + 4 * i] * cos(phi) * cos(theta)
-            Vinfy = x[5 + 4 * i] * cos(phi) * sin(theta)
-            Vinfz = x[5 + 4 * i] * sin(phi)
-
-            # We apply the (i+1)-th impulse
-            vsc = [a + b for a, b in zip(vsc, [Vinfx, Vinfy, Vinfz])]
-            rsc, vsc = propagate_lagrangian(
-                rsc, vsc, T[i] * DAY2SEC, self.__common_mu)
-        cw = (ic2par(rsc, vsc, self.start.mu_central_body)[2] > pi / 2)
+        # The decoding, the impulses, the Keplerian and Lambert arcs are evaluated natively
+        # (see pl2pl_N_impulses_evaluator)
+        return self._evaluator.fitness(x)
 
-        # We now compute the remaining two final impulses
-        # Lambert arc to reach seq[1]
-        dt = T[-1] * DAY2SEC
-        l = lambert_problem(rsc, r_target, dt, self.__common_mu, cw, False)
-        v_end_l = l.get_v2()[0]
-        v_beg_l = l.get_v1()[0]
-
-        DV1 = norm([a - b for a, b in zip(v_beg_l, vsc)])
-        DV2 = norm([a - b for a, b in zip(v_end_l, v_target)])
-
-        DV_others = sum(x[5::4])
-        if self.obj_dim == 1:
-            return (DV1 + DV2 + DV_others,)
-        else:
-            return (DV1 + DV2 + DV_others, x[1])
+    def batch_fitness(self, dvs):
+        # The decision vectors are evaluated natively in parallel (see pl2pl_N_impulses_evaluator.batch_fitness)
+        return self._evaluator.batch_fitness(dvs)
 
     def plot(self, x, axes=None):
         """
@@ -274,6 +259,11 @@ class pl2pl_N_impulses(object):
 
         DV1 = norm([a - b for a, b in zip(v_beg_l, vsc)])
         DV2 = norm([a - b for a, b in zip(v_end_l, v_target)])
+        if self.orbit_insertion:
+            # Single pericenter burn from the incoming hyperbola to the target orbit
+            mu = self.target.mu_self
+            DV2 = abs(sqrt(DV2 ** 2 + 2 * mu / self.rp_target) -
+                      sqrt(2 * mu / self.rp_target - mu / self.rp_target * (1. - self.e_target)))
 
         DV_others = list(x[5::4])
         DV_others.extend([DV1, DV2])
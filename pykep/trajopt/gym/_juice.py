@@ -52,6 +52,19 @@ class _juice_udp(mga_1dsm):
             rp_ub=10)
 
     def fitness(self, x):
+        return self._launcher_fitness(x, super().fitness(x))
+
+    def batch_fitness(self, dvs):
+        # The DVs are evaluated natively in parallel, the launcher model is then applied to each decision vector
+        nx = len(self.get_bounds()[0])
+        nobj = self.get_nobj()
+        f = super().batch_fitness(dvs)
+        retval = []
+        for i in range(len(f) // nobj):
+            retval.extend(self._launcher_fitness(dvs[i * nx:(i + 1) * nx], f[i * nobj:(i + 1) * nobj]))
+        return retval
+
+    def _launcher_fitness(self, x, f):
         T, Vinfx, Vinfy, Vinfz = self._decode_times_and_vinf(x)
         # We transform it (only the needed component) to an equatorial system rotating along x
         # (this is an approximation, assuming vernal equinox is roughly x and the ecliptic plane is roughly xy)
@@ -68,9 +81,9 @@ class _juice_udp(mga_1dsm):
         g0 = 9.80665
 
         if self._multi_objective:
-            DV, T = super().fitness(x)
+            DV, T = f
         else:
-            DV, = super().fitness(x)
+            DV, = f
 
         DV = DV + 275.  # losses for 5 swingbys + insertion
         m_final = m_initial * exp(-DV / Isp / g0)
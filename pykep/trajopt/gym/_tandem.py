@@ -108,6 +108,18 @@ class _tandem_udp(mga_1dsm):
         self.constrained = constrained
 
     def fitness(self, x):
+        return self._launcher_fitness(x, super().fitness(x))
+
+    def batch_fitness(self, dvs):
+        # The DVs are evaluated natively in parallel, the launcher model is then applied to each decision vector
+        nx = len(self.get_bounds()[0])
+        f = super().batch_fitness(dvs)
+        retval = []
+        for i in range(len(f)):
+            retval.extend(self._launcher_fitness(dvs[i * nx:(i + 1) * nx], f[i:i + 1]))
+        return retval
+
+    def _launcher_fitness(self, x, f):
         T, Vinfx, Vinfy, Vinfz = self._decode_times_and_vinf(x)
         # We transform it (only the needed component) to an equatorial system rotating along x 
         # (this is an approximation, assuming vernal equinox is roughly x and the ecliptic plane is roughly xy)
@@ -122,7 +134,7 @@ class _tandem_udp(mga_1dsm):
         # And we can evaluate the final mass via Tsiolkowsky
         Isp = 312.
         g0 = 9.80665
-        DV = super().fitness(x)[0]
+        DV = f[0]
         DV = DV + 165.  # losses for 3 swgbys + insertion
         m_final = m_initial * exp(-DV / Isp / g0)
         # Numerical guard for the exponential
@@ -0,0 +1,487 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pagmo development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *   http://apps.sourceforge.net/mediawiki/pagmo                             *
+ *   http://apps.sourceforge.net/mediawiki/pagmo/index.php?title=Developers  *
+ *   http://apps.sourceforge.net/mediawiki/pagmo/index.php?title=Credits     *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 3 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+// Workaround for http://mail.python.org/pipermail/new-bugs-announce/2011-March/010395.html
+#ifdef _WIN32
+#include <cmath>
+#endif
+
+#include <boost/python/class.hpp>
+#include <boost/python/docstring_options.hpp>
+#include <boost/python/extract.hpp>
+#include <boost/python/list.hpp>
+#include <boost/python/make_constructor.hpp>
+#include <boost/python/module.hpp>
+#include <boost/python/tuple.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <array>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <keplerian_toolbox/keplerian_toolbox.hpp>
+#include "../boost_python_container_conversions.h"
+#include "../utils.h"
+
+using namespace boost::python;
+
+// Converts the names of the tof encodings used by the Python problems to the enum of the evaluators
+template <typename Evaluator>
+static inline typename Evaluator::tof_encoding tof_encoding_from_string(const std::string &tof_encoding)
+{
+    if (tof_encoding == "direct") {
+        return Evaluator::DIRECT;
+    } else if (tof_encoding == "alpha") {
+        return Evaluator::ALPHA;
+    } else if (tof_encoding != "eta") {
+        throw_value_error("tof_encoding must be one of 'alpha', 'eta', 'direct'");
+    }
+    return Evaluator::ETA;
+}
+
+static inline boost::shared_ptr<kep_toolbox::trajopt::mga_lt_nep_evaluator>
+mga_lt_nep_evaluator_init(const list &seq, const list &n_seg, double vinf_dep, double vinf_arr, double mass,
+                          double thrust, double isp, bool multi_objective, bool high_fidelity, double mu)
+{
+    const auto seq_ = planet_list_to_vector(seq);
+    std::vector<unsigned> n_seg_;
+    for (int i = 0; i < len(n_seg); ++i) {
+        n_seg_.push_back(extract<unsigned>(n_seg[i]));
+    }
+    return boost::shared_ptr<kep_toolbox::trajopt::mga_lt_nep_evaluator>(
+        new kep_toolbox::trajopt::mga_lt_nep_evaluator(seq_, n_seg_, vinf_dep, vinf_arr, mass, thrust, isp,
+                                                        multi_objective, high_fidelity, mu));
+}
+
+static inline boost::shared_ptr<kep_toolbox::trajopt::mga_evaluator>
+mga_evaluator_init(const list &seq, const std::string &tof_encoding, double tof_max, double vinf, bool multi_objective,
+                   bool orbit_insertion, double e_target, double rp_target)
+{
+    const auto seq_ = planet_list_to_vector(seq);
+    return boost::shared_ptr<kep_toolbox::trajopt::mga_evaluator>(new kep_toolbox::trajopt::mga_evaluator(
+        seq_, tof_encoding_from_string<kep_toolbox::trajopt::mga_evaluator>(tof_encoding), tof_max, vinf,
+        multi_objective, orbit_insertion, e_target, rp_target));
+}
+
+static inline std::vector<double> mga_fitness_wrapper(const kep_toolbox::trajopt::mga_evaluator &e,
+                                                      const std::vector<double> &x)
+{
+    return e.fitness(x);
+}
+
+// Also used by the MGA-1DSM and N impulses evaluators
+template <typename Evaluator>
+static inline std::vector<double> decode_tofs_wrapper(const Evaluator &e, const std::vector<double> &x)
+{
+    std::vector<double> retval;
+    e.decode_tofs(x, retval);
+    return retval;
+}
+
+static inline boost::shared_ptr<kep_toolbox::trajopt::mga_1dsm_evaluator>
+mga_1dsm_evaluator_init(const list &seq, const std::string &tof_encoding, double tof_max, bool add_vinf_dep,
+                        bool add_vinf_arr, bool multi_objective, bool orbit_insertion, double e_target,
+                        double rp_target)
+{
+    return boost::shared_ptr<kep_toolbox::trajopt::mga_1dsm_evaluator>(new kep_toolbox::trajopt::mga_1dsm_evaluator(
+        planet_list_to_vector(seq), tof_encoding_from_string<kep_toolbox::trajopt::mga_1dsm_evaluator>(tof_encoding),
+        tof_max, add_vinf_dep, add_vinf_arr, multi_objective, orbit_insertion, e_target, rp_target));
+}
+
+static inline std::vector<double> mga_1dsm_fitness_wrapper(const kep_toolbox::trajopt::mga_1dsm_evaluator &e,
+                                                           const std::vector<double> &x)
+{
+    return e.fitness(x);
+}
+
+static inline kep_toolbox::array3D mga_1dsm_decode_vinf_wrapper(const kep_toolbox::trajopt::mga_1dsm_evaluator &e,
+                                                                const std::vector<double> &x)
+{
+    if (x.size() != e.get_nx()) {
+        throw_value_error("The decision vector has the wrong size");
+    }
+    kep_toolbox::array3D retval;
+    e.decode_vinf(x, retval);
+    return retval;
+}
+
+static inline std::vector<double> mga_lt_nep_fitness_wrapper(const kep_toolbox::trajopt::mga_lt_nep_evaluator &e,
+                                                             const std::vector<double> &x, unsigned n_threads)
+{
+    return e.fitness(x, n_threads);
+}
+
+// Batch fitness of the evaluators, in parallel and with the GIL released (unless some planet is implemented in
+// Python, in which case the evaluation is serial and keeps the GIL)
+template <typename Evaluator>
+static inline std::vector<double> batch_fitness_wrapper(const Evaluator &e, const std::vector<double> &dvs,
+                                                        unsigned n_threads)
+{
+    for (const auto &p : e.get_seq()) {
+        if (is_python_implemented(*p)) {
+            return kep_toolbox::trajopt::batch_fitness(e, dvs, 1u);
+        }
+    }
+    gil_releaser release;
+    return kep_toolbox::trajopt::batch_fitness(e, dvs, n_threads);
+}
+
+static inline boost::shared_ptr<kep_toolbox::trajopt::pl2pl_N_impulses_evaluator>
+pl2pl_N_impulses_evaluator_init(const kep_toolbox::planet::base &start, const kep_toolbox::planet::base &target,
+                                unsigned N_max, const list &tof, const list &vinf, bool phase_free,
+                                bool multi_objective, const list &t0, bool orbit_insertion, double e_target,
+                                double rp_target)
+{
+    if (len(tof) != 2 || len(vinf) != 2 || (len(t0) != 2 && len(t0) != 0)) {
+        throw_value_error("tof, vinf and t0 must be lists of two floats (lower and upper bounds)");
+    }
+    // An empty t0 is the default launch window of the C++ constructor
+    std::array<double, 2> t0_ = {{0., 1000.}};
+    if (len(t0) == 2) {
+        t0_ = {{extract<double>(t0[0]), extract<double>(t0[1])}};
+    }
+    return boost::shared_ptr<kep_toolbox::trajopt::pl2pl_N_impulses_evaluator>(
+        new kep_toolbox::trajopt::pl2pl_N_impulses_evaluator(
+            start, target, N_max, {{extract<double>(tof[0]), extract<double>(tof[1])}},
+            {{extract<double>(vinf[0]), extract<double>(vinf[1])}}, phase_free, multi_objective, t0_,
+            orbit_insertion, e_target, rp_target));
+}
+
+static inline std::vector<double>
+pl2pl_N_impulses_fitness_wrapper(const kep_toolbox::trajopt::pl2pl_N_impulses_evaluator &e,
+                                 const std::vector<double> &x)
+{
+    return e.fitness(x);
+}
+
+static inline tuple pl2pl_N_impulses_bounds_wrapper(const kep_toolbox::trajopt::pl2pl_N_impulses_evaluator &e)
+{
+    return boost::python::make_tuple(e.get_lb(), e.get_ub());
+}
+
+static inline boost::shared_ptr<kep_toolbox::trajopt::mga_sequence_search>
+mga_sequence_search_init(const list &planets, std::size_t departure, std::size_t arrival, const list &t0, unsigned n_t0,
+                         const list &tof, unsigned n_tof, double vinf, unsigned max_flybys, unsigned beam_width,
+                         double bound_factor, double max_fb_dv)
+{
+    if (len(t0) != 2 || len(tof) != 2) {
+        throw_value_error("t0 and tof must be lists of two floats (lower and upper bounds)");
+    }
+    return boost::shared_ptr<kep_toolbox::trajopt::mga_sequence_search>(new kep_toolbox::trajopt::mga_sequence_search(
+        planet_list_to_vector(planets), departure, arrival, {{extract<double>(t0[0]), extract<double>(t0[1])}},
+        n_t0, {{extract<double>(tof[0]), extract<double>(tof[1])}}, n_tof, vinf, max_flybys, beam_width,
+        bound_factor, max_fb_dv));
+}
+
+// As batch_fitness_wrapper, the search runs in parallel with the GIL released unless some planet is implemented in
+// Python
+static inline list mga_sequence_search_run_wrapper(const kep_toolbox::trajopt::mga_sequence_search &s, unsigned top_k,
+                                                   unsigned n_threads)
+{
+    std::vector<kep_toolbox::trajopt::mga_sequence_search::solution> sols;
+    bool python_planets = false;
+    for (const auto &p : s.get_planets()) {
+        python_planets = python_planets || is_python_implemented(*p);
+    }
+    if (python_planets) {
+        sols = s.run(top_k, 1u);
+    } else {
+        gil_releaser release;
+        sols = s.run(top_k, n_threads);
+    }
+    list retval;
+    for (const auto &sol : sols) {
+        list seq;
+        for (auto i : sol.seq) {
+            seq.append(i);
+        }
+        retval.append(boost::python::make_tuple(seq, sol.x, sol.dv));
+    }
+    return retval;
+}
+
+static inline list mga_lt_nep_gradient_sparsity_wrapper(const kep_toolbox::trajopt::mga_lt_nep_evaluator &e)
+{
+    return sparsity_to_list(e.get_gradient_sparsity());
+}
+
+BOOST_PYTHON_MODULE(trajopt)
+{
+    // Disable docstring c++ signature to allow sphinx autodoc to work properly
+    docstring_options doc_options;
+    doc_options.disable_signatures();
+
+    // MGA evaluator
+    class_<kep_toolbox::trajopt::mga_evaluator>("mga_evaluator", "Native evaluator of the pykep.trajopt.mga fitness",
+                                                no_init)
+        .def("__init__", make_constructor(&mga_evaluator_init, default_call_policies(),
+                                          (arg("seq"), arg("tof_encoding") = "direct", arg("tof_max") = 0.,
+                                           arg("vinf") = 0., arg("multi_objective") = false,
+                                           arg("orbit_insertion") = false, arg("e_target") = 0.,
+                                           arg("rp_target") = 0.)),
+             "pykep.trajopt.mga_evaluator(seq, tof_encoding = 'direct', tof_max = 0., vinf = 0., "
+             "multi_objective = False, orbit_insertion = False, e_target = 0., rp_target = 0.)\n\n"
+             "- seq: list of pykep.planet defining the encounter sequence (including the departure planet)\n"
+             "- tof_encoding: one of 'direct', 'alpha' or 'eta'\n"
+             "- tof_max: upper bound on the total time of flight (days), used by the 'eta' encoding only\n"
+             "- vinf: launch hyperbolic velocity given for free (m/s)\n"
+             "- multi_objective: when True the total time of flight is a second objective\n"
+             "- orbit_insertion: when True the arrival DV is the pericenter burn acquiring the target orbit\n"
+             "- e_target: eccentricity of the target orbit around the last planet\n"
+             "- rp_target: pericenter radius of the target orbit around the last planet (m)\n\n"
+             "Example::\n\n"
+             "  ev = trajopt.mga_evaluator([planet.jpl_lp('earth'), planet.jpl_lp('venus'), planet.jpl_lp('earth')])")
+        .def("fitness", &mga_fitness_wrapper, (arg("x")),
+             "ev.fitness(x)\n\n"
+             "- x: decision vector of pykep.trajopt.mga\n\n"
+             "Returns the total DV (m/s) and, if multi-objective, the total time of flight (days)\n\n"
+             "Example::\n\n"
+             "  f = ev.fitness(x)")
+        .def("batch_fitness", &batch_fitness_wrapper<kep_toolbox::trajopt::mga_evaluator>,
+             (arg("dvs"), arg("n_threads") = 0u),
+             "ev.batch_fitness(dvs, n_threads = 0)\n\n"
+             "- dvs: decision vectors of pykep.trajopt.mga, concatenated\n"
+             "- n_threads: number of threads (0 uses all the available cores)\n\n"
+             "Returns the fitness vectors, concatenated (as in the pygmo batch_fitness interface)\n\n"
+             "Example::\n\n"
+             "  f = ev.batch_fitness(dvs)")
+        .def("decode_tofs", &decode_tofs_wrapper<kep_toolbox::trajopt::mga_evaluator>, (arg("x")),
+             "ev.decode_tofs(x)\n\n"
+             "- x: decision vector of pykep.trajopt.mga\n\n"
+             "Returns the times of flight of the legs (days)\n\n"
+             "Example::\n\n"
+             "  T = ev.decode_tofs(x)")
+        .def("get_nx", &kep_toolbox::trajopt::mga_evaluator::get_nx, "Dimension of the decision vector")
+        .def("get_nobj", &kep_toolbox::trajopt::mga_evaluator::get_nobj, "Number of objectives");
+
+    // MGA-1DSM evaluator
+    class_<kep_toolbox::trajopt::mga_1dsm_evaluator>(
+        "mga_1dsm_evaluator", "Native evaluator of the pykep.trajopt.mga_1dsm fitness", no_init)
+        .def("__init__", make_constructor(&mga_1dsm_evaluator_init, default_call_policies(),
+                                          (arg("seq"), arg("tof_encoding") = "direct", arg("tof_max") = 0.,
+                                           arg("add_vinf_dep") = false, arg("add_vinf_arr") = true,
+                                           arg("multi_objective") = false, arg("orbit_insertion") = false,
+                                           arg("e_target") = 0., arg("rp_target") = 0.)),
+             "pykep.trajopt.mga_1dsm_evaluator(seq, tof_encoding = 'direct', tof_max = 0., add_vinf_dep = False, "
+             "add_vinf_arr = True, multi_objective = False, orbit_insertion = False, e_target = 0., rp_target = 0.)"
+             "\n\n"
+             "- seq: list of pykep.planet defining the encounter sequence (including the departure planet)\n"
+             "- tof_encoding: one of 'direct', 'alpha' or 'eta'\n"
+             "- tof_max: upper bound on the total time of flight (days), used by the 'eta' encoding only\n"
+             "- add_vinf_dep: when True the launch hyperbolic velocity is added to the DV\n"
+             "- add_vinf_arr: when True the arrival relative velocity is added to the DV\n"
+             "- multi_objective: when True the total time of flight is a second objective\n"
+             "- orbit_insertion: when True the arrival DV is the pericenter burn acquiring the target orbit\n"
+             "- e_target: eccentricity of the target orbit around the last planet\n"
+             "- rp_target: pericenter radius of the target orbit around the last planet (m)\n\n"
+             "Example::\n\n"
+             "  ev = trajopt.mga_1dsm_evaluator([planet.jpl_lp('earth'), planet.jpl_lp('venus'), "
+             "planet.jpl_lp('earth')])")
+        .def("fitness", &mga_1dsm_fitness_wrapper, (arg("x")),
+             "ev.fitness(x)\n\n"
+             "- x: decision vector of pykep.trajopt.mga_1dsm\n\n"
+             "Returns the total DV (m/s) and, if multi-objective, the total time of flight (days)\n\n"
+             "Example::\n\n"
+             "  f = ev.fitness(x)")
+        .def("batch_fitness", &batch_fitness_wrapper<kep_toolbox::trajopt::mga_1dsm_evaluator>,
+             (arg("dvs"), arg("n_threads") = 0u),
+             "ev.batch_fitness(dvs, n_threads = 0)\n\n"
+             "- dvs: decision vectors of pykep.trajopt.mga_1dsm, concatenated\n"
+             "- n_threads: number of threads (0 uses all the available cores)\n\n"
+             "Returns the fitness vectors, concatenated (as in the pygmo batch_fitness interface)\n\n"
+             "Example::\n\n"
+             "  f = ev.batch_fitness(dvs)")
+        .def("decode_tofs", &decode_tofs_wrapper<kep_toolbox::trajopt::mga_1dsm_evaluator>, (arg("x")),
+             "ev.decode_tofs(x)\n\n"
+             "- x: decision vector of pykep.trajopt.mga_1dsm\n\n"
+             "Returns the times of flight of the legs (days)\n\n"
+             "Example::\n\n"
+             "  T = ev.decode_tofs(x)")
+        .def("decode_vinf", &mga_1dsm_decode_vinf_wrapper, (arg("x")),
+             "ev.decode_vinf(x)\n\n"
+             "- x: decision vector of pykep.trajopt.mga_1dsm\n\n"
+             "Returns the cartesian components of the launch hyperbolic velocity (m/s)\n\n"
+             "Example::\n\n"
+             "  vinf = ev.decode_vinf(x)")
+        .def("get_nx", &kep_toolbox::trajopt::mga_1dsm_evaluator::get_nx, "Dimension of the decision vector")
+        .def("get_nobj", &kep_toolbox::trajopt::mga_1dsm_evaluator::get_nobj, "Number of objectives");
+
+    // Planet to planet N impulses evaluator
+    class_<kep_toolbox::trajopt::pl2pl_N_impulses_evaluator>(
+        "pl2pl_N_impulses_evaluator", "Native evaluator of the pykep.trajopt.pl2pl_N_impulses fitness", no_init)
+        .def("__init__",
+             make_constructor(&pl2pl_N_impulses_evaluator_init, default_call_policies(),
+                              (arg("start"), arg("target"), arg("N_max"), arg("tof"), arg("vinf"),
+                               arg("phase_free") = true, arg("multi_objective") = false,
+                               arg("t0") = boost::python::list(), arg("orbit_insertion") = false,
+                               arg("e_target") = 0., arg("rp_target") = 0.)),
+             "pykep.trajopt.pl2pl_N_impulses_evaluator(start, target, N_max, tof, vinf, phase_free = True, "
+             "multi_objective = False, t0 = [], orbit_insertion = False, e_target = 0., rp_target = 0.)\n\n"
+             "- start: starting pykep.planet\n"
+             "- target: target pykep.planet\n"
+             "- N_max: maximum number of impulses\n"
+             "- tof: bounds [lb, ub] on the time of flight (days)\n"
+             "- vinf: bounds [lb, ub] on the magnitude of each inner impulse (m/s)\n"
+             "- phase_free: when True the start and arrival anomalies are free\n"
+             "- multi_objective: when True the time of flight is a second objective\n"
+             "- t0: bounds [lb, ub] on the launch epoch (mjd2000), not used when the phase is free ([] is [0, 1000])\n"
+             "- orbit_insertion: when True the arrival DV is the pericenter burn acquiring the target orbit\n"
+             "- e_target: eccentricity of the target orbit around the target planet\n"
+             "- rp_target: pericenter radius of the target orbit around the target planet (m)\n\n"
+             "Example::\n\n"
+             "  ev = trajopt.pl2pl_N_impulses_evaluator(planet.jpl_lp('earth'), planet.jpl_lp('mars'), 3, "
+             "[200, 700], [0, 4000], False, False, [10000, 11000])")
+        .def("fitness", &pl2pl_N_impulses_fitness_wrapper, (arg("x")),
+             "ev.fitness(x)\n\n"
+             "- x: decision vector of pykep.trajopt.pl2pl_N_impulses\n\n"
+             "Returns the total DV (m/s) and, if multi-objective, the time of flight (days)\n\n"
+             "Example::\n\n"
+             "  f = ev.fitness(x)")
+        .def("batch_fitness", &batch_fitness_wrapper<kep_toolbox::trajopt::pl2pl_N_impulses_evaluator>,
+             (arg("dvs"), arg("n_threads") = 0u),
+             "ev.batch_fitness(dvs, n_threads = 0)\n\n"
+             "- dvs: decision vectors of pykep.trajopt.pl2pl_N_impulses, concatenated\n"
+             "- n_threads: number of threads (0 uses all the available cores)\n\n"
+             "Returns the fitness vectors, concatenated (as in the pygmo batch_fitness interface)\n\n"
+             "Example::\n\n"
+             "  f = ev.batch_fitness(dvs)")
+        .def("decode_tofs", &decode_tofs_wrapper<kep_toolbox::trajopt::pl2pl_N_impulses_evaluator>, (arg("x")),
+             "ev.decode_tofs(x)\n\n"
+             "- x: decision vector of pykep.trajopt.pl2pl_N_impulses\n\n"
+             "Returns the times of flight of the N - 1 arcs (days)\n\n"
+             "Example::\n\n"
+             "  T = ev.decode_tofs(x)")
+        .def("get_bounds", &pl2pl_N_impulses_bounds_wrapper,
+             "ev.get_bounds()\n\n"
+             "Returns the bounds (lb, ub) of the decision vector. When the phase is free, the launch and arrival "
+             "epochs span two periods of the start and target planets\n\n"
+             "Example::\n\n"
+             "  lb, ub = ev.get_bounds()")
+        .def("get_nx", &kep_toolbox::trajopt::pl2pl_N_impulses_evaluator::get_nx, "Dimension of the decision vector")
+        .def("get_nobj", &kep_toolbox::trajopt::pl2pl_N_impulses_evaluator::get_nobj, "Number of objectives");
+
+    // MGA sequence search
+    class_<kep_toolbox::trajopt::mga_sequence_search>(
+        "mga_sequence_search", "Beam search over the fly-by sequences of an MGA trajectory", no_init)
+        .def("__init__",
+             make_constructor(&mga_sequence_search_init, default_call_policies(),
+                              (arg("planets"), arg("departure"), arg("arrival"), arg("t0"), arg("n_t0"), arg("tof"),
+                               arg("n_tof"), arg("vinf") = 0., arg("max_flybys") = 3u, arg("beam_width") = 100u,
+                               arg("bound_factor") = 0., arg("max_fb_dv") = std::numeric_limits<double>::infinity())),
+             "pykep.trajopt.mga_sequence_search(planets, departure, arrival, t0, n_t0, tof, n_tof, vinf = 0., "
+             "max_flybys = 3, beam_width = 100, bound_factor = 0., max_fb_dv = inf)\n\n"
+             "- planets: list of pykep.planet (departure, arrival and fly-by candidates)\n"
+             "- departure: index of the departure planet in planets\n"
+             "- arrival: index of the arrival planet in planets\n"
+             "- t0: launch window [lb, ub] (mjd2000)\n"
+             "- n_t0: number of launch epochs in the grid\n"
+             "- tof: bounds [lb, ub] on the time of flight of each leg (days)\n"
+             "- n_tof: number of times of flight in the grid of each leg\n"
+             "- vinf: launch hyperbolic velocity given for free (m/s)\n"
+             "- max_flybys: maximum number of fly-bys\n"
+             "- beam_width: number of partial sequences kept at each depth\n"
+             "- bound_factor: weight of the three impulses estimate of the remaining DV in the pruning (0 for an "
+             "exact pruning)\n"
+             "- max_fb_dv: maximum DV of a fly-by (m/s), by default fly-bys are not pruned on their DV\n\n"
+             "Each leg is evaluated over the grid of times of flight (zero revolutions Lambert arcs) keeping the "
+             "least DV one, and the partial sequences are ranked by their DV plus the three impulses estimate of "
+             "the transfer to the arrival planet. The estimate is computed at the start of the launch window and is "
+             "a heuristic, not a lower bound: with bound_factor > 0 the search may prune sequences better than the "
+             "ones it returns. The pruning on the fly-by DV is opt-in, it is active only if max_fb_dv is set\n\n"
+             "Example::\n\n"
+             "  pl = [planet.jpl_lp(name) for name in ['venus', 'earth', 'mars', 'jupiter']]\n"
+             "  s = trajopt.mga_sequence_search(pl, 1, 3, [3000, 4000], 11, [100, 1000], 10, 3000)")
+        .def("run", &mga_sequence_search_run_wrapper, (arg("top_k") = 10u, arg("n_threads") = 0u),
+             "s.run(top_k = 10, n_threads = 0)\n\n"
+             "- top_k: number of sequences to return\n"
+             "- n_threads: number of threads (0 uses all the available cores)\n\n"
+             "Returns a list of (seq, x, dv) sorted by dv, where seq are the indices of the planets of the "
+             "sequence, x the decision vector of pykep.trajopt.mga in the direct encoding and dv its fitness\n\n"
+             "Example::\n\n"
+             "  seq, x, dv = s.run()[0]\n"
+             "  udp = trajopt.mga([pl[i] for i in seq], t0 = [x[0] - 100, x[0] + 100], "
+             "tof = [[T / 2, 2 * T] for T in x[1:]], vinf = 3)");
+
+    // Low-thrust MGA evaluator
+    class_<kep_toolbox::trajopt::mga_lt_nep_evaluator>(
+        "mga_lt_nep_evaluator", "Native evaluator of the pykep.trajopt.mga_lt_nep fitness", no_init)
+        .def("__init__", make_constructor(&mga_lt_nep_evaluator_init, default_call_policies(),
+                                          (arg("seq"), arg("n_seg"), arg("vinf_dep"), arg("vinf_arr"), arg("mass"),
+                                           arg("Tmax"), arg("Isp"), arg("multi_objective") = false,
+                                           arg("high_fidelity") = false, arg("mu") = ASTRO_MU_SUN)),
+             "pykep.trajopt.mga_lt_nep_evaluator(seq, n_seg, vinf_dep, vinf_arr, mass, Tmax, Isp, "
+             "multi_objective = False, high_fidelity = False, mu = MU_SUN)\n\n"
+             "- seq: list of pykep.planet defining the encounter sequence (including the departure planet)\n"
+             "- n_seg: list with the number of segments of each leg\n"
+             "- vinf_dep: maximum launch hyperbolic velocity (m/s)\n"
+             "- vinf_arr: maximum arrival hyperbolic velocity (m/s)\n"
+             "- mass: spacecraft launch mass (kg)\n"
+             "- Tmax: maximum thrust (N)\n"
+             "- Isp: specific impulse (s)\n"
+             "- multi_objective: when True the total time of flight is a second objective\n"
+             "- high_fidelity: when True the legs are propagated with continuous thrust\n"
+             "- mu: gravitational parameter of the central body\n\n"
+             "Example::\n\n"
+             "  ev = trajopt.mga_lt_nep_evaluator([planet.jpl_lp('earth'), planet.jpl_lp('mars')], [10], 3000, 2000, "
+             "1000, 0.3, 3000)")
+        .def("fitness", &mga_lt_nep_fitness_wrapper, (arg("x"), arg("n_threads") = 1u),
+             "ev.fitness(x, n_threads = 1)\n\n"
+             "- x: decision vector of pykep.trajopt.mga_lt_nep\n"
+             "- n_threads: number of threads used to evaluate the legs (0 uses all the available cores)\n\n"
+             "Returns the objectives, the equality and the inequality constraints concatenated in one list\n\n"
+             "Example::\n\n"
+             "  f = ev.fitness(x)")
+        .def("batch_fitness", &batch_fitness_wrapper<kep_toolbox::trajopt::mga_lt_nep_evaluator>,
+             (arg("dvs"), arg("n_threads") = 0u),
+             "ev.batch_fitness(dvs, n_threads = 0)\n\n"
+             "- dvs: decision vectors of pykep.trajopt.mga_lt_nep, concatenated\n"
+             "- n_threads: number of threads (0 uses all the available cores)\n\n"
+             "Returns the fitness vectors, concatenated (as in the pygmo batch_fitness interface). The evaluation "
+             "runs in parallel with the GIL released, unless some planet of the sequence is implemented in Python\n\n"
+             "Example::\n\n"
+             "  f = ev.batch_fitness(dvs)")
+        .def("gradient_sparsity", &mga_lt_nep_gradient_sparsity_wrapper,
+             "ev.gradient_sparsity()\n\n"
+             "Returns the [row, column] indices of the structurally non-zero entries of the fitness Jacobian\n\n"
+             "Example::\n\n"
+             "  sp = ev.gradient_sparsity()")
+        .def("gradient", &kep_toolbox::trajopt::mga_lt_nep_evaluator::gradient,
+             (arg("x"), arg("n_threads") = 1u, arg("dx") = 1e-8),
+             "ev.gradient(x, n_threads = 1, dx = 1e-8)\n\n"
+             "- x: decision vector of pykep.trajopt.mga_lt_nep\n"
+             "- n_threads: number of threads used to evaluate the legs (0 uses all the available cores)\n"
+             "- dx: relative perturbation of the decision vector components\n\n"
+             "Returns the entries of the fitness Jacobian listed by gradient_sparsity, estimated with coloured "
+             "finite differences (one fitness evaluation per group of columns not sharing any row)\n\n"
+             "Example::\n\n"
+             "  g = ev.gradient(x)")
+        .def("get_nx", &kep_toolbox::trajopt::mga_lt_nep_evaluator::get_nx, "Dimension of the decision vector")
+        .def("get_nobj", &kep_toolbox::trajopt::mga_lt_nep_evaluator::get_nobj, "Number of objectives")
+        .def("get_nec", &kep_toolbox::trajopt::mga_lt_nep_evaluator::get_nec, "Number of equality constraints")
+        .def("get_nic", &kep_toolbox::trajopt::mga_lt_nep_evaluator::get_nic, "Number of inequality constraints")
+        .add_property("high_fidelity", &kep_toolbox::trajopt::mga_lt_nep_evaluator::get_high_fidelity,
+                      &kep_toolbox::trajopt::mga_lt_nep_evaluator::set_high_fidelity,
+                      "Propagation fidelity of the legs (True or False)");
+}
@@ -8,10 +8,21 @@
 #include <boost/python/dict.hpp>
 #include <boost/python/docstring_options.hpp>
 #include <boost/python/extract.hpp>
+#include <boost/python/handle.hpp>
+#include <boost/python/import.hpp>
+#include <boost/python/list.hpp>
 #include <boost/python/tuple.hpp>
+#include <boost/python/wrapper.hpp>
 #include <boost/serialization/serialization.hpp>
+#include <cstddef>
+#include <cstring>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/planet/base.hpp>
 
 template <class T>
 inline T Py_copy_from_ctor(const T &x)
@@ -78,6 +89,82 @@ struct python_class_pickle_suite : boost::python::pickle_suite {
     }
 };
 
+// Releases the GIL for the lifetime of the object (the C++ code executed must not touch Python objects)
+struct gil_releaser {
+    gil_releaser() : m_state(PyEval_SaveThread()) {}
+    ~gil_releaser()
+    {
+        PyEval_RestoreThread(m_state);
+    }
+    gil_releaser(const gil_releaser &) = delete;
+    gil_releaser &operator=(const gil_releaser &) = delete;
+    PyThreadState *m_state;
+};
+
+// True if x is an instance of a class implemented in Python (e.g. a planet deriving from pykep.planet._base): its
+// virtual methods call back into Python and need the GIL
+template <class T>
+inline bool is_python_implemented(const T &x)
+{
+    return dynamic_cast<const boost::python::detail::wrapper_base *>(&x) != nullptr;
+}
+
+// Converts a sparsity pattern to a Python list of [row, column] lists (as expected by pygmo)
+inline boost::python::list sparsity_to_list(const std::vector<std::pair<std::size_t, std::size_t>> &sp)
+{
+    boost::python::list retval;
+    for (const auto &p : sp) {
+        boost::python::list entry;
+        entry.append(p.first);
+        entry.append(p.second);
+        retval.append(entry);
+    }
+    return retval;
+}
+
+// Clones the planets of a Python list
+inline std::vector<kep_toolbox::planet::planet_ptr> planet_list_to_vector(const boost::python::list &seq)
+{
+    std::vector<kep_toolbox::planet::planet_ptr> retval;
+    for (int i = 0; i < len(seq); ++i) {
+        retval.push_back(boost::python::extract<const kep_toolbox::planet::base &>(seq[i])().clone());
+    }
+    return retval;
+}
+
+// Copies a vector into a new NumPy array with the given dtype and shape. NumPy is imported at call time, so that
+// the extension modules do not depend on its C API.
+template <class T>
+inline boost::python::object to_ndarray(const std::vector<T> &v, const char *dtype, const boost::python::tuple &shape)
+{
+    using namespace boost::python;
+    object buf(handle<>(PyByteArray_FromStringAndSize(reinterpret_cast<const char *>(v.data()),
+                                                      static_cast<Py_ssize_t>(v.size() * sizeof(T)))));
+    return import("numpy").attr("frombuffer")(buf, dtype).attr("reshape")(shape);
+}
+
+// Copies an array-like of floats of shape (n, n_cols), or (n,) if n_cols is zero, into a row-major vector and returns
+// n. The array-like is converted to a contiguous NumPy array of doubles, then read through the buffer protocol.
+inline std::size_t ndarray_to_vector(const boost::python::object &a, std::size_t n_cols, std::vector<double> &out)
+{
+    using namespace boost::python;
+    object arr = import("numpy").attr("ascontiguousarray")(a, "float64");
+    const int ndim = extract<int>(arr.attr("ndim"));
+    if (n_cols ? (ndim != 2 || extract<std::size_t>(arr.attr("shape")[1])() != n_cols) : ndim != 1) {
+        throw_value_error(n_cols ? "Expected an array of shape (n, " + std::to_string(n_cols) + ")"
+                                 : std::string("Expected an array of shape (n,)"));
+    }
+    const std::size_t n = extract<std::size_t>(arr.attr("shape")[0]);
+    out.resize(n * (n_cols ? n_cols : 1u));
+    Py_buffer view;
+    if (PyObject_GetBuffer(arr.ptr(), &view, PyBUF_SIMPLE) != 0) {
+        throw_error_already_set();
+    }
+    std::memcpy(out.data(), view.buf, out.size() * sizeof(double));
+    PyBuffer_Release(&view);
+    return n;
+}
+
 template <class T>
 inline void py_cpp_loads(T &x, const std::string &s)
 {
@@ -0,0 +1,384 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <boost/cstdint.hpp>
+#include <boost/math/tools/toms748_solve.hpp>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/catalog/conjunctions.hpp>
+#include <keplerian_toolbox/catalog/sgp4_soa.hpp>
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/third_party/libsgp4/Globals.h>
+#include <keplerian_toolbox/third_party/libsgp4/OrbitalElements.h>
+#include <keplerian_toolbox/third_party/libsgp4/Tle.h>
+#include <keplerian_toolbox/util/parallel_for.hpp>
+
+namespace kep_toolbox
+{
+namespace catalog
+{
+
+namespace
+{
+// A pair of objects found within the screening distance at a grid epoch
+struct candidate {
+    std::size_t i;
+    std::size_t j;
+    double d;
+};
+
+bool operator<(const candidate &c1, const candidate &c2)
+{
+    return (c1.i < c2.i) || (c1.i == c2.i && c1.j < c2.j);
+}
+
+// A sampled local minimum of the distance between i and j, bracketed by [a, b] (mjd2000)
+struct refine_task {
+    std::size_t i;
+    std::size_t j;
+    double a;
+    double t;
+    double b;
+};
+
+// Spatial hash: 21 bits per cell coordinate, packed in a 64 bits key.
+const std::int64_t cell_max = (std::int64_t(1) << 21) - 1;
+const std::int64_t cell_offset = std::int64_t(1) << 20;
+
+std::int64_t cell_coord(double x, double cell_size)
+{
+    // Objects out of the hash range are clamped to its border cells, which can only add candidates.
+    double c = std::floor(x / cell_size) + static_cast<double>(cell_offset);
+    return static_cast<std::int64_t>(std::max(0., std::min(c, static_cast<double>(cell_max))));
+}
+
+std::uint64_t cell_key(std::int64_t ix, std::int64_t iy, std::int64_t iz)
+{
+    return (static_cast<std::uint64_t>(ix) << 42) | (static_cast<std::uint64_t>(iy) << 21)
+           | static_cast<std::uint64_t>(iz);
+}
+
+// Distance of the pair (i, j) in a sorted candidate list, infinity if the pair is not there.
+double distance_in(const std::vector<candidate> &list, std::size_t i, std::size_t j)
+{
+    candidate key = {i, j, 0.};
+    auto it = std::lower_bound(list.begin(), list.end(), key);
+    return (it != list.end() && it->i == i && it->j == j) ? it->d : std::numeric_limits<double>::infinity();
+}
+
+struct propagation_failure {
+};
+
+// Position and velocity of j relative to i.
+void relative_state(const tle_catalog &cat, std::size_t i, std::size_t j, double mjd2000, array3D &dr, array3D &dv)
+{
+    array3D ri, vi, rj, vj;
+    if (cat.propagate(i, mjd2000, ri, vi) != tle_catalog::ok || cat.propagate(j, mjd2000, rj, vj) != tle_catalog::ok) {
+        throw propagation_failure();
+    }
+    for (unsigned k = 0u; k < 3u; ++k) {
+        dr[k] = rj[k] - ri[k];
+        dv[k] = vj[k] - vi[k];
+    }
+}
+
+double dot3(const array3D &a, const array3D &b)
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// Finds the time of closest approach as the zero of dr.dv (the derivative of half the squared distance),
+// bracketed by the grid epochs around the sampled minimum. Returns false if SGP4 fails in the bracket.
+bool refine(const tle_catalog &cat, const refine_task &task, conjunction &out)
+{
+    array3D dr, dv;
+    // Seconds from the sampled minimum, for conditioning
+    auto f = [&](double s) {
+        relative_state(cat, task.i, task.j, task.t + s * ASTRO_SEC2DAY, dr, dv);
+        return dot3(dr, dv);
+    };
+    try {
+        double a = (task.a - task.t) * ASTRO_DAY2SEC;
+        double b = (task.b - task.t) * ASTRO_DAY2SEC;
+        double fa = f(a);
+        double da = std::sqrt(dot3(dr, dr));
+        double fb = f(b);
+        double db = std::sqrt(dot3(dr, dr));
+        double s;
+        if (fa <= 0. && fb >= 0. && a < b) {
+            boost::uintmax_t max_iter = ASTRO_MAX_ITER;
+            // One millisecond, i.e. about 10 m along track at LEO relative speeds but far less on the miss distance
+            auto tol = [](double l, double u) { return u - l < 1e-3; };
+            std::pair<double, double> root = boost::math::tools::toms748_solve(f, a, b, fa, fb, tol, max_iter);
+            s = (root.first + root.second) / 2.;
+        } else {
+            // No interior minimum: the distance is monotonic in the bracket (window borders)
+            s = (da <= db) ? a : b;
+        }
+        f(s);
+        out.i = task.i;
+        out.j = task.j;
+        out.tca = task.t + s * ASTRO_SEC2DAY;
+        out.miss_distance = std::sqrt(dot3(dr, dr));
+        out.relative_speed = std::sqrt(dot3(dv, dv));
+        return true;
+    } catch (const propagation_failure &) {
+        return false;
+    }
+}
+} // namespace
+
+/// All-vs-all conjunction screening
+/**
+ * Finds all the close approaches, closer than \p threshold, between any two objects of a TLE catalog within a
+ * time window. The screening proceeds in three phases:
+ *
+ * - an apogee/perigee filter discards the pairs whose radial shells (computed from the mean elements and
+ *   widened by \p pad to account for the SGP4 periodic terms and for drag) do not overlap,
+ * - the catalog is propagated with sgp4_soa on a grid of epochs spaced by \p step. At each epoch the objects are
+ *   binned in a spatial hash and only pairs in neighbouring cells are tested. A pair is kept if its distance is
+ *   within threshold + |dv| step + a step^2 / 2, where dv is the relative velocity and a bounds the relative
+ *   acceleration, so that no encounter closer than \p threshold can fall between two grid epochs undetected.
+ * - for each local minimum of the sampled distance, the time of closest approach (TCA) is found as the zero of
+ *   the range rate in the surrounding grid interval, propagating with SGP4.
+ *
+ * All phases are run in parallel, and only the states at one epoch and the candidates at three consecutive
+ * epochs are kept in memory, so that the memory footprint grows linearly with the catalog size and not with the
+ * number of epochs. The cost of the grid phase grows with the screening distance: steps of a few seconds are
+ * recommended for LEO catalogs.
+ *
+ * Objects that SGP4 cannot propagate at a grid epoch are skipped at that epoch.
+ *
+ * \param[in] cat the TLE catalog
+ * \param[in] start start of the screening window (mjd2000)
+ * \param[in] end end of the screening window (mjd2000)
+ * \param[in] threshold miss distance threshold (m)
+ * \param[in] step spacing of the screening grid (s)
+ * \param[in] n_threads number of threads (0 means all the available cores)
+ * \param[in] pad widening of the perigee/apogee shells (m)
+ *
+ * \return the conjunctions, sorted by pair and TCA
+ *
+ * \throws value_error if the window is empty, or if threshold or step are not positive, or pad is negative
+ */
+std::vector<conjunction> screen_conjunctions(const tle_catalog &cat, double start, double end, double threshold,
+                                             double step, unsigned n_threads, double pad)
+{
+    if (!(end > start)) {
+        throw_value_error("The end of the screening window must follow its start");
+    }
+    if (!(threshold > 0.)) {
+        throw_value_error("The screening threshold must be positive");
+    }
+    if (!(step > 0.)) {
+        throw_value_error("The screening step must be positive");
+    }
+    if (!(pad >= 0.)) {
+        throw_value_error("The apogee/perigee pad cannot be negative");
+    }
+    std::vector<conjunction> retval;
+    const std::size_t n = cat.size();
+    if (n < 2u) {
+        return retval;
+    }
+
+    // 1 - Apogee/perigee filter
+    std::vector<double> perigee(n), apogee(n);
+    util::parallel_for(0u, n,
+                       [&](std::size_t b, std::size_t e) {
+                           for (std::size_t i = b; i < e; ++i) {
+                               OrbitalElements elements(Tle(cat.get_line1(i), cat.get_line2(i)));
+                               double a = elements.RecoveredSemiMajorAxis() * kXKMPER * 1000.;
+                               perigee[i] = a * (1. - elements.Eccentricity()) - pad;
+                               apogee[i] = a * (1. + elements.Eccentricity()) + pad;
+                           }
+                       },
+                       n_threads);
+    auto shells_overlap = [&](std::size_t i, std::size_t j) {
+        return perigee[i] <= apogee[j] + threshold && perigee[j] <= apogee[i] + threshold;
+    };
+    // Objects whose shell does not overlap any other are not screened at all. Sweeping by increasing perigee, an
+    // object overlaps a previous one if its perigee is below their highest apogee, and a following one if the next
+    // perigee is below its apogee.
+    std::vector<std::size_t> by_perigee(n);
+    std::iota(by_perigee.begin(), by_perigee.end(), std::size_t(0u));
+    std::sort(by_perigee.begin(), by_perigee.end(),
+              [&perigee](std::size_t i, std::size_t j) { return perigee[i] < perigee[j]; });
+    std::vector<char> active(n, 0);
+    double max_apogee = -std::numeric_limits<double>::infinity();
+    for (std::size_t k = 0u; k < n; ++k) {
+        std::size_t i = by_perigee[k];
+        bool overlap = perigee[i] <= max_apogee + threshold;
+        if (k + 1u < n) {
+            overlap = overlap || perigee[by_perigee[k + 1u]] <= apogee[i] + threshold;
+        }
+        active[i] = overlap;
+        max_apogee = std::max(max_apogee, apogee[i]);
+    }
+
+    // 2 - Screening grid
+    const sgp4_soa soa(cat);
+    const double step_days = step * ASTRO_SEC2DAY;
+    const std::size_t n_epochs = static_cast<std::size_t>(std::ceil((end - start) / step_days)) + 1u;
+    auto grid_epoch = [&](std::size_t k) { return std::min(start + static_cast<double>(k) * step_days, end); };
+    // Bound on the relative acceleration, both objects being above the Earth surface
+    const double max_acc = 2. * ASTRO_MU_EARTH / (double(ASTRO_EARTH_RADIUS) * ASTRO_EARTH_RADIUS);
+    const double max_dd = max_acc * step * step / 2.;
+
+    soa_states states;
+    std::vector<int> status;
+    std::vector<std::pair<std::uint64_t, std::size_t>> cells;
+    std::vector<candidate> previous, current, next;
+    std::vector<refine_task> tasks;
+    std::mutex mutex;
+    auto cell_less = [](const std::pair<std::uint64_t, std::size_t> &c, std::uint64_t key) { return c.first < key; };
+    auto key_less = [](std::uint64_t key, const std::pair<std::uint64_t, std::size_t> &c) { return key < c.first; };
+
+    // One extra iteration to detect the minima at the last epoch
+    for (std::size_t k = 0u; k <= n_epochs; ++k) {
+        next.clear();
+        if (k < n_epochs) {
+            soa.propagate(grid_epoch(k), states, status, n_threads);
+            double v_max = 0.;
+            cells.clear();
+            for (std::size_t i = 0u; i < n; ++i) {
+                if (active[i] && status[i] == tle_catalog::ok) {
+                    double v2 = states.vx[i] * states.vx[i] + states.vy[i] * states.vy[i] + states.vz[i] * states.vz[i];
+                    v_max = std::max(v_max, std::sqrt(v2));
+                    cells.emplace_back(0u, i);
+                }
+            }
+            const double cell_size = threshold + 2. * v_max * step + max_dd;
+            for (auto &c : cells) {
+                std::size_t i = c.second;
+                c.first = cell_key(cell_coord(states.x[i], cell_size), cell_coord(states.y[i], cell_size),
+                                   cell_coord(states.z[i], cell_size));
+            }
+            std::sort(cells.begin(), cells.end());
+
+            util::parallel_for(
+                0u, cells.size(),
+                [&](std::size_t b, std::size_t e) {
+                    std::vector<candidate> local;
+                    for (std::size_t p = b; p < e; ++p) {
+                        const std::size_t i = cells[p].second;
+                        // Range of the neighbouring cells along each axis
+                        std::int64_t lo[3], hi[3];
+                        for (unsigned axis = 0u; axis < 3u; ++axis) {
+                            std::int64_t c = static_cast<std::int64_t>(cells[p].first >> (42u - 21u * axis)) & cell_max;
+                            lo[axis] = std::max(c - 1, std::int64_t(0));
+                            hi[axis] = std::min(c + 1, cell_max);
+                        }
+                        for (std::int64_t jx = lo[0]; jx <= hi[0]; ++jx) {
+                            for (std::int64_t jy = lo[1]; jy <= hi[1]; ++jy) {
+                                for (std::int64_t jz = lo[2]; jz <= hi[2]; ++jz) {
+                                    const std::uint64_t key = cell_key(jx, jy, jz);
+                                    auto first = std::lower_bound(cells.begin(), cells.end(), key, cell_less);
+                                    auto last = std::upper_bound(first, cells.end(), key, key_less);
+                                    for (auto it = first; it != last; ++it) {
+                                        const std::size_t j = it->second;
+                                        if (j <= i || !shells_overlap(i, j)) {
+                                            continue;
+                                        }
+                                        const double dx = states.x[j] - states.x[i];
+                                        const double dy = states.y[j] - states.y[i];
+                                        const double dz = states.z[j] - states.z[i];
+                                        const double dvx = states.vx[j] - states.vx[i];
+                                        const double dvy = states.vy[j] - states.vy[i];
+                                        const double dvz = states.vz[j] - states.vz[i];
+                                        const double d = std::sqrt(dx * dx + dy * dy + dz * dz);
+                                        const double dv = std::sqrt(dvx * dvx + dvy * dvy + dvz * dvz);
+                                        if (d <= threshold + dv * step + max_dd) {
+                                            candidate c = {i, j, d};
+                                            local.push_back(c);
+                                        }
+                                    }
+                                }
+                            }
+                        }
+                    }
+                    std::lock_guard<std::mutex> lock(mutex);
+                    next.insert(next.end(), local.begin(), local.end());
+                },
+                n_threads);
+            std::sort(next.begin(), next.end());
+        }
+        // The candidates of epoch k - 1 that are local minima of the sampled distance
+        if (k >= 1u) {
+            for (const auto &c : current) {
+                if (c.d <= distance_in(previous, c.i, c.j) && c.d < distance_in(next, c.i, c.j)) {
+                    refine_task task = {c.i, c.j, grid_epoch(k >= 2u ? k - 2u : 0u), grid_epoch(k - 1u),
+                                        grid_epoch(std::min(k, n_epochs - 1u))};
+                    tasks.push_back(task);
+                }
+            }
+        }
+        previous.swap(current);
+        current.swap(next);
+    }
+
+    // 3 - Time of closest approach
+    std::vector<conjunction> refined(tasks.size());
+    std::vector<char> success(tasks.size(), 0);
+    util::parallel_for(0u, tasks.size(),
+                       [&](std::size_t b, std::size_t e) {
+                           for (std::size_t t = b; t < e; ++t) {
+                               success[t] = refine(cat, tasks[t], refined[t]) && refined[t].miss_distance <= threshold;
+                           }
+                       },
+                       n_threads);
+    for (std::size_t t = 0u; t < tasks.size(); ++t) {
+        if (success[t]) {
+            retval.push_back(refined[t]);
+        }
+    }
+    std::sort(retval.begin(), retval.end(), [](const conjunction &c1, const conjunction &c2) {
+        return (c1.i < c2.i) || (c1.i == c2.i && (c1.j < c2.j || (c1.j == c2.j && c1.tca < c2.tca)));
+    });
+    // Two sampled minima can converge to the same encounter, only the closest one is kept.
+    std::vector<conjunction> unique;
+    for (const auto &c : retval) {
+        if (!unique.empty() && unique.back().i == c.i && unique.back().j == c.j
+            && c.tca - unique.back().tca < step_days / 2.) {
+            if (c.miss_distance < unique.back().miss_distance) {
+                unique.back() = c;
+            }
+        } else {
+            unique.push_back(c);
+        }
+    }
+    return unique;
+}
+} // namespace catalog
+} // namespace kep_toolbox
@@ -0,0 +1,472 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <keplerian_toolbox/catalog/mpcorb_catalog.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/util/parallel_for.hpp>
+
+namespace kep_toolbox
+{
+namespace catalog
+{
+
+namespace
+{
+// Same layout as in planet::mpcorb: {offset, width} of the fixed-width fields.
+const std::size_t field_a[2] = {92, 11};
+const std::size_t field_e[2] = {70, 9};
+const std::size_t field_i[2] = {59, 9};
+const std::size_t field_W[2] = {48, 9};
+const std::size_t field_w[2] = {37, 9};
+const std::size_t field_M[2] = {26, 9};
+const std::size_t field_epoch[2] = {20, 5};
+const std::size_t field_name[2] = {166, 28};
+const std::size_t field_H[2] = {8, 5};
+const std::size_t field_n_obs[2] = {117, 5};
+const std::size_t field_n_opp[2] = {123, 3};
+const std::size_t field_year[2] = {127, 4};
+// Lines shorter than this cannot contain the orbital data and are skipped.
+const std::size_t min_line_length = 131u;
+
+// A line is given by [begin, end), end excluding the line terminator. Fields falling (partially)
+// outside the line are treated as blank.
+struct line_view {
+    const char *begin;
+    const char *end;
+    void field(const std::size_t f[2], const char *&b, const char *&e) const
+    {
+        const std::size_t len = static_cast<std::size_t>(end - begin);
+        b = begin + std::min(f[0], len);
+        e = begin + std::min(f[0] + f[1], len);
+        while (b != e && *b == ' ') {
+            ++b;
+        }
+        while (e != b && *(e - 1) == ' ') {
+            --e;
+        }
+    }
+};
+
+bool parse_unsigned(const char *b, const char *e, unsigned &out)
+{
+    if (b == e) {
+        return false;
+    }
+    unsigned retval = 0u;
+    for (; b != e; ++b) {
+        if (*b < '0' || *b > '9') {
+            return false;
+        }
+        retval = retval * 10u + static_cast<unsigned>(*b - '0');
+    }
+    out = retval;
+    return true;
+}
+
+// Parses [+-]ddd[.ddd]. The digits are accumulated in an integer and divided once by an exact power
+// of ten, so that the result is correctly rounded as with boost::lexical_cast.
+bool parse_double(const char *b, const char *e, double &out)
+{
+    static const double pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    if (b == e) {
+        return false;
+    }
+    bool negative = false;
+    if (*b == '-' || *b == '+') {
+        negative = (*b == '-');
+        ++b;
+    }
+    std::uint64_t mantissa = 0u;
+    unsigned n_digits = 0u, n_decimals = 0u;
+    bool dot = false;
+    for (; b != e; ++b) {
+        if (*b == '.' && !dot) {
+            dot = true;
+        } else if (*b >= '0' && *b <= '9') {
+            mantissa = mantissa * 10u + static_cast<std::uint64_t>(*b - '0');
+            n_decimals += dot;
+            ++n_digits;
+        } else {
+            return false;
+        }
+    }
+    // 15 significant digits always fit exactly in a double.
+    if (n_digits == 0u || n_digits > 15u) {
+        return false;
+    }
+    out = static_cast<double>(mantissa) / pow10[n_decimals];
+    if (negative) {
+        out = -out;
+    }
+    return true;
+}
+
+// MPCORB packed date characters: 0-9, then A-V (10-31). Lower case is accepted as in planet::mpcorb.
+int packed_number(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'Z') {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'z') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+// Days from 2000-01-01 to the given gregorian date.
+double days_from_j2000(int y, int m, int d)
+{
+    y -= m <= 2;
+    const int era = (y >= 0 ? y : y - 399) / 400;
+    const int yoe = y - era * 400;
+    const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return static_cast<double>(era * 146097 + doe - 730425);
+}
+
+bool parse_packed_date(const char *b, const char *e, double &mjd2000)
+{
+    if (e - b != 5) {
+        return false;
+    }
+    const int century = packed_number(b[0]), y1 = packed_number(b[1]), y2 = packed_number(b[2]),
+              month = packed_number(b[3]), day = packed_number(b[4]);
+    if (century < 0 || y1 < 0 || y1 > 9 || y2 < 0 || y2 > 9 || month < 1 || month > 12 || day < 1 || day > 31) {
+        return false;
+    }
+    mjd2000 = days_from_j2000(century * 100 + y1 * 10 + y2, month, day);
+    return true;
+}
+
+// Moves p to the beginning of the next line (or to end).
+const char *next_line(const char *p, const char *end)
+{
+    const void *nl = std::memchr(p, '\n', static_cast<std::size_t>(end - p));
+    return nl ? static_cast<const char *>(nl) + 1 : end;
+}
+
+line_view get_line(const char *p, const char *end)
+{
+    const char *nl = static_cast<const char *>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+    line_view retval = {p, nl ? nl : end};
+    if (retval.end != retval.begin && *(retval.end - 1) == '\r') {
+        --retval.end;
+    }
+    return retval;
+}
+
+bool is_data_line(const line_view &l)
+{
+    return static_cast<std::size_t>(l.end - l.begin) >= min_line_length;
+}
+} // namespace
+
+const std::size_t mpcorb_catalog::name_width;
+
+/// Default constructor
+/**
+ * Constructs an empty catalog.
+ */
+mpcorb_catalog::mpcorb_catalog()
+{
+}
+
+/// Constructor from file
+/**
+ * Loads all the minor planets contained in an MPCORB.DAT file.
+ *
+ * \param[in] file_name the MPCORB.DAT file
+ * \param[in] n_threads number of threads used for parsing (0 means all the available cores)
+ *
+ * \throws value_error if the file cannot be opened or contains a malformed line
+ */
+mpcorb_catalog::mpcorb_catalog(const std::string &file_name, unsigned n_threads)
+{
+    // Empty files cannot be mapped.
+    std::ifstream file(file_name, std::ios::binary | std::ios::ate);
+    if (!file.good()) {
+        throw_value_error("Cannot open the MPCORB file: " + file_name);
+    }
+    if (file.tellg() == std::streampos(0)) {
+        return;
+    }
+    file.close();
+    boost::interprocess::file_mapping mapping(file_name.c_str(), boost::interprocess::read_only);
+    boost::interprocess::mapped_region region(mapping, boost::interprocess::read_only);
+    const char *begin = static_cast<const char *>(region.get_address());
+    parse(begin, begin + region.get_size(), n_threads);
+}
+
+void mpcorb_catalog::parse(const char *begin, const char *end, unsigned n_threads)
+{
+    // Skip the header, which is closed by a line of dashes in the first lines of the file.
+    for (const char *p = begin; p != end && p - begin < (1 << 20); p = next_line(p, end)) {
+        if (end - p >= 10 && std::memcmp(p, "----------", 10) == 0) {
+            begin = next_line(p, end);
+            break;
+        }
+    }
+
+    // Chunk boundaries, aligned to the beginning of lines.
+    if (n_threads == 0u) {
+        n_threads = util::default_n_threads();
+    }
+    const std::size_t n_chunks = 4u * n_threads;
+    const std::size_t size = static_cast<std::size_t>(end - begin);
+    std::vector<const char *> bounds(n_chunks + 1u);
+    bounds[0] = begin;
+    for (std::size_t k = 1u; k < n_chunks; ++k) {
+        const char *p = begin + size / n_chunks * k;
+        bounds[k] = (p > bounds[k - 1u] && *(p - 1) != '\n') ? next_line(p, end) : std::max(p, bounds[k - 1u]);
+    }
+    bounds[n_chunks] = end;
+
+    // First pass: count the data lines in each chunk.
+    std::vector<std::size_t> offsets(n_chunks + 1u, 0u);
+    util::parallel_for(0u, n_chunks,
+                       [&](std::size_t cb, std::size_t ce) {
+                           for (std::size_t k = cb; k < ce; ++k) {
+                               std::size_t n = 0u;
+                               for (const char *p = bounds[k]; p < bounds[k + 1u]; p = next_line(p, end)) {
+                                   n += is_data_line(get_line(p, end));
+                               }
+                               offsets[k + 1u] = n;
+                           }
+                       },
+                       n_threads, 1u);
+    for (std::size_t k = 0u; k < n_chunks; ++k) {
+        offsets[k + 1u] += offsets[k];
+    }
+
+    const std::size_t n = offsets.back();
+    m_a.resize(n);
+    m_e.resize(n);
+    m_i.resize(n);
+    m_W.resize(n);
+    m_w.resize(n);
+    m_M.resize(n);
+    m_ref_mjd2000.resize(n);
+    m_H.resize(n);
+    m_n_observations.resize(n);
+    m_n_oppositions.resize(n);
+    m_year_of_discovery.resize(n);
+    m_names.assign(n * name_width, ' ');
+    m_name_lengths.resize(n);
+
+    // Second pass: parse each chunk in its own slots.
+    util::parallel_for(
+        0u, n_chunks,
+        [&](std::size_t cb, std::size_t ce) {
+            const char *b, *e;
+            for (std::size_t k = cb; k < ce; ++k) {
+                std::size_t idx = offsets[k];
+                for (const char *p = bounds[k]; p < bounds[k + 1u]; p = next_line(p, end)) {
+                    const line_view l = get_line(p, end);
+                    if (!is_data_line(l)) {
+                        continue;
+                    }
+                    bool ok = true;
+                    l.field(field_a, b, e);
+                    ok = ok && parse_double(b, e, m_a[idx]);
+                    l.field(field_e, b, e);
+                    ok = ok && parse_double(b, e, m_e[idx]);
+                    l.field(field_i, b, e);
+                    ok = ok && parse_double(b, e, m_i[idx]);
+                    l.field(field_W, b, e);
+                    ok = ok && parse_double(b, e, m_W[idx]);
+                    l.field(field_w, b, e);
+                    ok = ok && parse_double(b, e, m_w[idx]);
+                    l.field(field_M, b, e);
+                    ok = ok && parse_double(b, e, m_M[idx]);
+                    l.field(field_epoch, b, e);
+                    ok = ok && parse_packed_date(b, e, m_ref_mjd2000[idx]);
+                    // Absolute magnitude and number of observations can be missing
+                    l.field(field_H, b, e);
+                    if (b == e) {
+                        m_H[idx] = 0.;
+                    } else {
+                        ok = ok && parse_double(b, e, m_H[idx]);
+                    }
+                    l.field(field_n_obs, b, e);
+                    if (b == e) {
+                        m_n_observations[idx] = 0u;
+                    } else {
+                        ok = ok && parse_unsigned(b, e, m_n_observations[idx]);
+                    }
+                    l.field(field_n_opp, b, e);
+                    ok = ok && parse_unsigned(b, e, m_n_oppositions[idx]);
+                    l.field(field_year, b, e);
+                    ok = ok && parse_unsigned(b, e, m_year_of_discovery[idx]);
+                    if (!ok) {
+                        std::ostringstream msg;
+                        msg << "Malformed MPCORB line: " << std::string(l.begin, l.end);
+                        throw_value_error(msg.str());
+                    }
+                    // Converting orbital elements to SI units, as done in planet::mpcorb.
+                    m_a[idx] *= ASTRO_AU;
+                    m_i[idx] *= ASTRO_DEG2RAD;
+                    m_W[idx] *= ASTRO_DEG2RAD;
+                    m_w[idx] *= ASTRO_DEG2RAD;
+                    m_M[idx] *= ASTRO_DEG2RAD;
+                    // Names are lower case as in planet::mpcorb.
+                    l.field(field_name, b, e);
+                    char *name = &m_names[idx * name_width];
+                    for (const char *c = b; c != e; ++c, ++name) {
+                        *name = (*c >= 'A' && *c <= 'Z') ? static_cast<char>(*c - 'A' + 'a') : *c;
+                    }
+                    m_name_lengths[idx] = static_cast<unsigned char>(e - b);
+                    ++idx;
+                }
+            }
+        },
+        n_threads, 1u);
+}
+
+/// Number of minor planets in the catalog
+std::size_t mpcorb_catalog::size() const
+{
+    return m_a.size();
+}
+
+/// Semi-major axes (m)
+const std::vector<double> &mpcorb_catalog::get_a() const
+{
+    return m_a;
+}
+
+/// Eccentricities
+const std::vector<double> &mpcorb_catalog::get_e() const
+{
+    return m_e;
+}
+
+/// Inclinations (rad)
+const std::vector<double> &mpcorb_catalog::get_i() const
+{
+    return m_i;
+}
+
+/// Longitudes of the ascending node (rad)
+const std::vector<double> &mpcorb_catalog::get_W() const
+{
+    return m_W;
+}
+
+/// Arguments of perigee (rad)
+const std::vector<double> &mpcorb_catalog::get_w() const
+{
+    return m_w;
+}
+
+/// Mean anomalies at the reference epochs (rad)
+const std::vector<double> &mpcorb_catalog::get_M() const
+{
+    return m_M;
+}
+
+/// Reference epochs of the elements (mjd2000)
+const std::vector<double> &mpcorb_catalog::get_ref_mjd2000() const
+{
+    return m_ref_mjd2000;
+}
+
+/// Absolute magnitudes (0 if not available)
+const std::vector<double> &mpcorb_catalog::get_H() const
+{
+    return m_H;
+}
+
+/// Numbers of observations (0 if not available)
+const std::vector<unsigned> &mpcorb_catalog::get_n_observations() const
+{
+    return m_n_observations;
+}
+
+/// Numbers of oppositions
+const std::vector<unsigned> &mpcorb_catalog::get_n_oppositions() const
+{
+    return m_n_oppositions;
+}
+
+/// Years of discovery (arc length in days for single opposition objects)
+const std::vector<unsigned> &mpcorb_catalog::get_year_of_discovery() const
+{
+    return m_year_of_discovery;
+}
+
+/// Keplerian elements of a minor planet
+/**
+ * \param[in] idx index of the minor planet in the catalog
+ * \returns the elements (a, e, i, W, w, M) in SI units
+ */
+array6D mpcorb_catalog::get_elements(std::size_t idx) const
+{
+    check_index(idx);
+    array6D retval = {{m_a[idx], m_e[idx], m_i[idx], m_W[idx], m_w[idx], m_M[idx]}};
+    return retval;
+}
+
+/// Name of a minor planet
+/**
+ * \param[in] idx index of the minor planet in the catalog
+ * \returns the (lower case) name
+ */
+std::string mpcorb_catalog::get_name(std::size_t idx) const
+{
+    check_index(idx);
+    return std::string(&m_names[idx * name_width], m_name_lengths[idx]);
+}
+
+/// Materializes a minor planet
+/**
+ * \param[in] idx index of the minor planet in the catalog
+ * \returns the planet::mpcorb that would be constructed from the corresponding line of MPCORB.DAT
+ */
+planet::mpcorb mpcorb_catalog::get_planet(std::size_t idx) const
+{
+    return planet::mpcorb(get_elements(idx), kep_toolbox::epoch(m_ref_mjd2000[idx]), m_H[idx],
+                          m_n_observations[idx], m_n_oppositions[idx], m_year_of_discovery[idx], get_name(idx));
+}
+
+void mpcorb_catalog::check_index(std::size_t idx) const
+{
+    if (idx >= size()) {
+        throw_value_error("Index out of range in the MPCORB catalog");
+    }
+}
+} // namespace catalog
+} // namespace kep_toolbox
@@ -0,0 +1,547 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <cmath>
+#include <limits>
+
+#include <keplerian_toolbox/catalog/sgp4_soa.hpp>
+#include <keplerian_toolbox/catalog/tle_catalog.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/third_party/libsgp4/DecayedException.h>
+#include <keplerian_toolbox/third_party/libsgp4/Eci.h>
+#include <keplerian_toolbox/third_party/libsgp4/Globals.h>
+#include <keplerian_toolbox/third_party/libsgp4/OrbitalElements.h>
+#include <keplerian_toolbox/third_party/libsgp4/SatelliteException.h>
+#include <keplerian_toolbox/third_party/libsgp4/Tle.h>
+#include <keplerian_toolbox/third_party/libsgp4/TleException.h>
+#include <keplerian_toolbox/util/parallel_for.hpp>
+
+namespace kep_toolbox
+{
+namespace catalog
+{
+
+namespace
+{
+// Fields of the structure-of-arrays constants (names as in libsgp4).
+enum field {
+    f_ref_mjd2000,
+    f_xmo,
+    f_omegao,
+    f_xnodeo,
+    f_eo,
+    f_xincl,
+    f_bstar,
+    f_xnodp,
+    f_aodp,
+    f_cosio,
+    f_sinio,
+    f_eta,
+    f_t2cof,
+    f_x1mth2,
+    f_x3thm1,
+    f_x7thm1,
+    f_aycof,
+    f_xlcof,
+    f_xnodcf,
+    f_c1,
+    f_c4,
+    f_omgdot,
+    f_xnodot,
+    f_xmdot,
+    f_c5,
+    f_omgcof,
+    f_xmcof,
+    f_delmo,
+    f_sinmo,
+    f_d2,
+    f_d3,
+    f_d4,
+    f_t3cof,
+    f_t4cof,
+    f_t5cof,
+    f_simple,
+    n_fields
+};
+
+const double a3ovk2 = -kXJ3 / kCK2 * kAE * kAE * kAE;
+
+// Status codes (as in tle_catalog).
+const int status_ok = 0;
+const int status_sgp4_error = 1;
+const int status_decayed = 2;
+} // namespace
+
+/// Resizes all the arrays
+void soa_states::resize(std::size_t n)
+{
+    x.resize(n);
+    y.resize(n);
+    z.resize(n);
+    vx.resize(n);
+    vy.resize(n);
+    vz.resize(n);
+}
+
+/// Number of states
+std::size_t soa_states::size() const
+{
+    return x.size();
+}
+
+const std::size_t sgp4_soa::lanes;
+
+/// Default constructor
+/**
+ * Constructs an empty propagator.
+ */
+sgp4_soa::sgp4_soa() : m_size(0u), m_n_padded(0u)
+{
+}
+
+/// Constructor from two line elements
+/**
+ * \param[in] line1 first lines of the element sets
+ * \param[in] line2 second lines of the element sets
+ *
+ * \throws value_error if the sizes of line1 and line2 differ or an element set cannot be parsed
+ */
+sgp4_soa::sgp4_soa(const std::vector<std::string> &line1, const std::vector<std::string> &line2)
+    : m_size(0u), m_n_padded(0u)
+{
+    init(line1, line2);
+}
+
+/// Constructor from a TLE catalog
+/**
+ * \param[in] cat the catalog, satellite indices are preserved
+ */
+sgp4_soa::sgp4_soa(const tle_catalog &cat) : m_size(0u), m_n_padded(0u)
+{
+    std::vector<std::string> line1(cat.size()), line2(cat.size());
+    for (std::size_t i = 0u; i < cat.size(); ++i) {
+        line1[i] = cat.get_line1(i);
+        line2[i] = cat.get_line2(i);
+    }
+    init(line1, line2);
+}
+
+void sgp4_soa::init(const std::vector<std::string> &line1, const std::vector<std::string> &line2)
+{
+    if (line1.size() != line2.size()) {
+        throw_value_error("The number of first and second lines of the element sets differ");
+    }
+    m_size = line1.size();
+    m_ref_mjd2000.resize(m_size);
+
+    // Sort the satellites in near-Earth, deep space and invalid ones.
+    std::vector<OrbitalElements> near_elements;
+    for (std::size_t i = 0u; i < m_size; ++i) {
+        try {
+            Tle tle("TLE satellite", line1[i], line2[i]);
+            m_ref_mjd2000[i] = epoch(tle.Epoch().ToJulian(), epoch::JD).mjd2000();
+            OrbitalElements elements(tle);
+            if (elements.Eccentricity() < 0.0 || elements.Eccentricity() > 0.999 || elements.Inclination() < 0.0
+                || elements.Inclination() > kPI) {
+                m_invalid_index.push_back(i);
+            } else if (elements.Period() >= 225.0) {
+                m_deep.push_back(SGP4(tle));
+                m_deep_index.push_back(i);
+            } else {
+                near_elements.push_back(elements);
+                m_near_index.push_back(i);
+            }
+        } catch (const TleException &e) {
+            throw_value_error(e.what());
+        }
+    }
+
+    // Near-Earth constants, as computed in SGP4::Initialise(). Padding lanes replicate the first satellite.
+    m_n_padded = (near_elements.size() + lanes - 1u) / lanes * lanes;
+    m_consts.assign(n_fields * m_n_padded, 0.);
+    for (std::size_t k = 0u; k < m_n_padded; ++k) {
+        const std::size_t src = (k < near_elements.size()) ? k : 0u;
+        const OrbitalElements &el = near_elements[src];
+        auto c = [this, k](std::size_t f) -> double & { return *consts(f, k); };
+
+        c(f_ref_mjd2000) = m_ref_mjd2000[m_near_index[src]];
+        c(f_xmo) = el.MeanAnomoly();
+        c(f_omegao) = el.ArgumentPerigee();
+        c(f_xnodeo) = el.AscendingNode();
+        c(f_eo) = el.Eccentricity();
+        c(f_xincl) = el.Inclination();
+        c(f_bstar) = el.BStar();
+        c(f_xnodp) = el.RecoveredMeanMotion();
+        c(f_aodp) = el.RecoveredSemiMajorAxis();
+
+        c(f_cosio) = cos(el.Inclination());
+        c(f_sinio) = sin(el.Inclination());
+        const double theta2 = c(f_cosio) * c(f_cosio);
+        c(f_x3thm1) = 3.0 * theta2 - 1.0;
+        const double eosq = el.Eccentricity() * el.Eccentricity();
+        const double betao2 = 1.0 - eosq;
+        const double betao = sqrt(betao2);
+        c(f_simple) = (el.Perigee() < 220.0) ? 1. : 0.;
+
+        double s4 = kS;
+        double qoms24 = kQOMS2T;
+        if (el.Perigee() < 156.0) {
+            s4 = el.Perigee() - 78.0;
+            if (el.Perigee() < 98.0) {
+                s4 = 20.0;
+            }
+            qoms24 = pow((120.0 - s4) * kAE / kXKMPER, 4.0);
+            s4 = s4 / kXKMPER + kAE;
+        }
+
+        const double aodp = el.RecoveredSemiMajorAxis();
+        const double xnodp = el.RecoveredMeanMotion();
+        const double pinvsq = 1.0 / (aodp * aodp * betao2 * betao2);
+        const double tsi = 1.0 / (aodp - s4);
+        c(f_eta) = aodp * el.Eccentricity() * tsi;
+        const double eta = c(f_eta);
+        const double etasq = eta * eta;
+        const double eeta = el.Eccentricity() * eta;
+        const double psisq = fabs(1.0 - etasq);
+        const double coef = qoms24 * pow(tsi, 4.0);
+        const double coef1 = coef / pow(psisq, 3.5);
+        const double c2 = coef1 * xnodp
+                          * (aodp * (1.0 + 1.5 * etasq + eeta * (4.0 + etasq))
+                             + 0.75 * kCK2 * tsi / psisq * c(f_x3thm1) * (8.0 + 3.0 * etasq * (8.0 + etasq)));
+        c(f_c1) = el.BStar() * c2;
+        c(f_x1mth2) = 1.0 - theta2;
+        c(f_c4) = 2.0 * xnodp * coef1 * aodp * betao2
+                  * (eta * (2.0 + 0.5 * etasq) + el.Eccentricity() * (0.5 + 2.0 * etasq)
+                     - 2.0 * kCK2 * tsi / (aodp * psisq)
+                           * (-3.0 * c(f_x3thm1) * (1.0 - 2.0 * eeta + etasq * (1.5 - 0.5 * eeta))
+                              + 0.75 * c(f_x1mth2) * (2.0 * etasq - eeta * (1.0 + etasq))
+                                    * cos(2.0 * el.ArgumentPerigee())));
+        const double theta4 = theta2 * theta2;
+        const double temp1 = 3.0 * kCK2 * pinvsq * xnodp;
+        const double temp2 = temp1 * kCK2 * pinvsq;
+        const double temp3 = 1.25 * kCK4 * pinvsq * pinvsq * xnodp;
+        c(f_xmdot) = xnodp + 0.5 * temp1 * betao * c(f_x3thm1)
+                     + 0.0625 * temp2 * betao * (13.0 - 78.0 * theta2 + 137.0 * theta4);
+        const double x1m5th = 1.0 - 5.0 * theta2;
+        c(f_omgdot) = -0.5 * temp1 * x1m5th + 0.0625 * temp2 * (7.0 - 114.0 * theta2 + 395.0 * theta4)
+                      + temp3 * (3.0 - 36.0 * theta2 + 49.0 * theta4);
+        const double xhdot1 = -temp1 * c(f_cosio);
+        c(f_xnodot) = xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * theta2) + 2.0 * temp3 * (3.0 - 7.0 * theta2)) * c(f_cosio);
+        c(f_xnodcf) = 3.5 * betao2 * xhdot1 * c(f_c1);
+        c(f_t2cof) = 1.5 * c(f_c1);
+        if (fabs(c(f_cosio) + 1.0) > 1.5e-12) {
+            c(f_xlcof) = 0.125 * a3ovk2 * c(f_sinio) * (3.0 + 5.0 * c(f_cosio)) / (1.0 + c(f_cosio));
+        } else {
+            c(f_xlcof) = 0.125 * a3ovk2 * c(f_sinio) * (3.0 + 5.0 * c(f_cosio)) / 1.5e-12;
+        }
+        c(f_aycof) = 0.25 * a3ovk2 * c(f_sinio);
+        c(f_x7thm1) = 7.0 * theta2 - 1.0;
+
+        double c3 = 0.0;
+        if (el.Eccentricity() > 1.0e-4) {
+            c3 = coef * tsi * a3ovk2 * xnodp * kAE * c(f_sinio) / el.Eccentricity();
+        }
+        c(f_c5) = 2.0 * coef1 * aodp * betao2 * (1.0 + 2.75 * (etasq + eeta) + eeta * etasq);
+        c(f_omgcof) = el.BStar() * c3 * cos(el.ArgumentPerigee());
+        c(f_xmcof) = 0.0;
+        if (el.Eccentricity() > 1.0e-4) {
+            c(f_xmcof) = -kTWOTHIRD * coef * el.BStar() * kAE / eeta;
+        }
+        c(f_delmo) = pow(1.0 + eta * (cos(el.MeanAnomoly())), 3.0);
+        c(f_sinmo) = sin(el.MeanAnomoly());
+
+        if (c(f_simple) == 0.) {
+            const double c1 = c(f_c1);
+            const double c1sq = c1 * c1;
+            c(f_d2) = 4.0 * aodp * tsi * c1sq;
+            const double temp = c(f_d2) * tsi * c1 / 3.0;
+            c(f_d3) = (17.0 * aodp + s4) * temp;
+            c(f_d4) = 0.5 * temp * aodp * tsi * (221.0 * aodp + 31.0 * s4) * c1;
+            c(f_t3cof) = c(f_d2) + 2.0 * c1sq;
+            c(f_t4cof) = 0.25 * (3.0 * c(f_d3) + c1 * (12.0 * c(f_d2) + 10.0 * c1sq));
+            c(f_t5cof) = 0.2 * (3.0 * c(f_d4) + 12.0 * c1 * c(f_d3) + 6.0 * c(f_d2) * c(f_d2)
+                                + 15.0 * c1sq * (2.0 * c(f_d2) + c1sq));
+        }
+    }
+}
+
+double *sgp4_soa::consts(std::size_t field, std::size_t idx)
+{
+    return &m_consts[field * m_n_padded + idx];
+}
+
+const double *sgp4_soa::consts(std::size_t field, std::size_t idx) const
+{
+    return &m_consts[field * m_n_padded + idx];
+}
+
+/// Number of satellites
+std::size_t sgp4_soa::size() const
+{
+    return m_size;
+}
+
+/// Number of deep space satellites (propagated with the scalar SDP4)
+std::size_t sgp4_soa::get_n_deep_space() const
+{
+    return m_deep.size();
+}
+
+/// Reference epochs of the element sets (mjd2000)
+const std::vector<double> &sgp4_soa::get_ref_mjd2000() const
+{
+    return m_ref_mjd2000;
+}
+
+/// Propagates all satellites to one epoch
+/**
+ * \param[in] mjd2000 the epoch
+ * \param[out] states positions (m) and velocities (m/s) of the satellites, resized to size()
+ * \param[out] status propagation status (tle_catalog::status_code), resized to size(). Element sets rejected by
+ * SGP4 at initialisation have status tle_catalog::sgp4_error.
+ * \param[in] n_threads number of threads (0 means all the available cores)
+ */
+void sgp4_soa::propagate(double mjd2000, soa_states &states, std::vector<int> &status, unsigned n_threads) const
+{
+    states.resize(m_size);
+    status.resize(m_size);
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (auto i : m_invalid_index) {
+        states.x[i] = states.y[i] = states.z[i] = nan;
+        states.vx[i] = states.vy[i] = states.vz[i] = nan;
+        status[i] = status_sgp4_error;
+    }
+    const std::size_t n_blocks = m_n_padded / lanes;
+    // Deep space satellites are appended as blocks of one after the near-Earth blocks.
+    util::parallel_for(0u, n_blocks + m_deep.size(),
+                       [&](std::size_t b, std::size_t e) {
+                           for (std::size_t block = b; block < e; ++block) {
+                               if (block < n_blocks) {
+                                   propagate_block(block, mjd2000, states, status);
+                                   continue;
+                               }
+                               const std::size_t k = block - n_blocks, i = m_deep_index[k];
+                               // A local copy, as SDP4 keeps mutable integrator state
+                               const SGP4 propagator(m_deep[k]);
+                               try {
+                                   Eci eci = propagator.FindPosition((mjd2000 - m_ref_mjd2000[i]) * 24 * 60);
+                                   states.x[i] = eci.Position().x * 1000;
+                                   states.y[i] = eci.Position().y * 1000;
+                                   states.z[i] = eci.Position().z * 1000;
+                                   states.vx[i] = eci.Velocity().x * 1000;
+                                   states.vy[i] = eci.Velocity().y * 1000;
+                                   states.vz[i] = eci.Velocity().z * 1000;
+                                   status[i] = status_ok;
+                                   continue;
+                               } catch (const DecayedException &) {
+                                   status[i] = status_decayed;
+                               } catch (const SatelliteException &) {
+                                   status[i] = status_sgp4_error;
+                               }
+                               states.x[i] = states.y[i] = states.z[i] = nan;
+                               states.vx[i] = states.vy[i] = states.vz[i] = nan;
+                           }
+                       },
+                       n_threads, 64u);
+}
+
+// Propagates one block of near-Earth satellites. Each step is a loop over the lanes, following
+// SGP4::FindPositionSGP4 and SGP4::CalculateFinalPositionVelocity.
+void sgp4_soa::propagate_block(std::size_t block, double mjd2000, soa_states &states, std::vector<int> &status) const
+{
+    const std::size_t W = lanes;
+    const std::size_t i0 = block * W;
+    auto c = [this, i0](std::size_t f) { return consts(f, i0); };
+    const double *ref = c(f_ref_mjd2000), *xmo = c(f_xmo), *omegao = c(f_omegao), *xnodeo = c(f_xnodeo),
+                 *eo = c(f_eo), *xincl = c(f_xincl), *bstar = c(f_bstar), *xnodp = c(f_xnodp), *aodp = c(f_aodp),
+                 *cosio = c(f_cosio), *sinio = c(f_sinio), *eta = c(f_eta), *t2cof = c(f_t2cof),
+                 *x1mth2 = c(f_x1mth2), *x3thm1 = c(f_x3thm1), *x7thm1 = c(f_x7thm1), *aycof = c(f_aycof),
+                 *xlcof = c(f_xlcof), *xnodcf = c(f_xnodcf), *c1 = c(f_c1), *c4 = c(f_c4), *omgdot = c(f_omgdot),
+                 *xnodot = c(f_xnodot), *xmdot = c(f_xmdot), *c5 = c(f_c5), *omgcof = c(f_omgcof),
+                 *xmcof = c(f_xmcof), *delmo = c(f_delmo), *sinmo = c(f_sinmo), *d2 = c(f_d2), *d3 = c(f_d3),
+                 *d4 = c(f_d4), *t3cof = c(f_t3cof), *t4cof = c(f_t4cof), *t5cof = c(f_t5cof),
+                 *simple = c(f_simple);
+
+    double tsince[W], e[W], a[W], omega[W], xl[W], xnode[W];
+    int lane_status[W];
+
+    // Secular gravity and atmospheric drag
+    for (std::size_t l = 0u; l < W; ++l) {
+        tsince[l] = (mjd2000 - ref[l]) * 24 * 60;
+        const double t = tsince[l];
+        const double xmdf = xmo[l] + xmdot[l] * t;
+        const double omgadf = omegao[l] + omgdot[l] * t;
+        const double xnoddf = xnodeo[l] + xnodot[l] * t;
+        const double tsq = t * t;
+        xnode[l] = xnoddf + xnodcf[l] * tsq;
+        double tempa = 1.0 - c1[l] * t;
+        double tempe = bstar[l] * c4[l] * t;
+        double templ = t2cof[l] * tsq;
+
+        // Terms dropped by the simple model, computed for all lanes and masked
+        const double delomg = omgcof[l] * t;
+        const double delm = xmcof[l] * (pow(1.0 + eta[l] * cos(xmdf), 3.0) * -delmo[l]);
+        const double temp = delomg + delm;
+        const double tcube = tsq * t;
+        const double tfour = t * tcube;
+        const double xmp_full = xmdf + temp;
+        const bool full = (simple[l] == 0.);
+        const double xmp = full ? xmp_full : xmdf;
+        omega[l] = full ? omgadf - temp : omgadf;
+        tempa = full ? tempa - d2[l] * tsq - d3[l] * tcube - d4[l] * tfour : tempa;
+        tempe = full ? tempe + bstar[l] * c5[l] * (sin(xmp_full) - sinmo[l]) : tempe;
+        templ = full ? templ + (t3cof[l] * tcube + tfour * (t4cof[l] + t * t5cof[l])) : templ;
+
+        a[l] = aodp[l] * tempa * tempa;
+        e[l] = eo[l] - tempe;
+        xl[l] = xmp + omega[l] + xnode[l] + xnodp[l] * templ;
+
+        // Tolerance for error recognition
+        lane_status[l] = (e[l] <= -0.001) ? status_sgp4_error : status_ok;
+        e[l] = (e[l] < 1.0e-6) ? 1.0e-6 : ((e[l] > (1.0 - 1.0e-6)) ? 1.0 - 1.0e-6 : e[l]);
+    }
+
+    // Long period periodics
+    double xn[W], axn[W], ayn[W], elsq[W], capu[W], epw[W], max_nr[W];
+    for (std::size_t l = 0u; l < W; ++l) {
+        const double beta2 = 1.0 - e[l] * e[l];
+        xn[l] = kXKE / pow(a[l], 1.5);
+        axn[l] = e[l] * cos(omega[l]);
+        const double temp11 = 1.0 / (a[l] * beta2);
+        const double xll = temp11 * xlcof[l] * axn[l];
+        const double aynl = temp11 * aycof[l];
+        const double xlt = xl[l] + xll;
+        ayn[l] = e[l] * sin(omega[l]) + aynl;
+        elsq[l] = axn[l] * axn[l] + ayn[l] * ayn[l];
+        lane_status[l] = (elsq[l] >= 1.0) ? status_sgp4_error : lane_status[l];
+        capu[l] = fmod(xlt - xnode[l], kTWOPI);
+        epw[l] = capu[l];
+        max_nr[l] = 1.25 * fabs(sqrt(elsq[l]));
+    }
+
+    // Kepler equation: all lanes iterate, each lane freezes once converged
+    double sinepw[W], cosepw[W], ecose[W], esine[W];
+    bool running[W];
+    for (std::size_t l = 0u; l < W; ++l) {
+        sinepw[l] = cosepw[l] = ecose[l] = esine[l] = 0.0;
+        running[l] = true;
+    }
+    for (int i = 0; i < 10; ++i) {
+        for (std::size_t l = 0u; l < W; ++l) {
+            const double s = sin(epw[l]);
+            const double co = cos(epw[l]);
+            const double ec = axn[l] * co + ayn[l] * s;
+            const double es = axn[l] * s - ayn[l] * co;
+            const double f = capu[l] - epw[l] + es;
+            const bool run = running[l];
+            sinepw[l] = run ? s : sinepw[l];
+            cosepw[l] = run ? co : cosepw[l];
+            ecose[l] = run ? ec : ecose[l];
+            esine[l] = run ? es : esine[l];
+            const bool converged = fabs(f) < 1.0e-12;
+            const double fdot = 1.0 - ec;
+            double delta = f / fdot;
+            if (i == 0) {
+                // First order correction, bounded
+                delta = (delta > max_nr[l]) ? max_nr[l] : ((delta < -max_nr[l]) ? -max_nr[l] : delta);
+            } else {
+                // Second order correction
+                delta = f / (fdot + 0.5 * es * delta);
+            }
+            const bool update = run && !converged;
+            epw[l] = update ? epw[l] + delta : epw[l];
+            running[l] = update;
+        }
+    }
+
+    // Short period periodics and final position and velocity
+    for (std::size_t l = 0u; l < W; ++l) {
+        const std::size_t k = i0 + l;
+        if (k >= m_near_index.size()) {
+            break;
+        }
+        const std::size_t idx = m_near_index[k];
+        const double temp21 = 1.0 - elsq[l];
+        const double pl = a[l] * temp21;
+        int st = (pl < 0.0) ? status_sgp4_error : lane_status[l];
+
+        const double r = a[l] * (1.0 - ecose[l]);
+        const double temp31 = 1.0 / r;
+        const double rdot = kXKE * sqrt(a[l]) * esine[l] * temp31;
+        const double rfdot = kXKE * sqrt(pl) * temp31;
+        const double temp32 = a[l] * temp31;
+        const double betal = sqrt(temp21);
+        const double temp33 = 1.0 / (1.0 + betal);
+        const double cosu = temp32 * (cosepw[l] - axn[l] + ayn[l] * esine[l] * temp33);
+        const double sinu = temp32 * (sinepw[l] - ayn[l] - axn[l] * esine[l] * temp33);
+        const double u = atan2(sinu, cosu);
+        const double sin2u = 2.0 * sinu * cosu;
+        const double cos2u = 2.0 * cosu * cosu - 1.0;
+
+        const double temp41 = 1.0 / pl;
+        const double temp42 = kCK2 * temp41;
+        const double temp43 = temp42 * temp41;
+
+        const double rk = r * (1.0 - 1.5 * temp43 * betal * x3thm1[l]) + 0.5 * temp42 * x1mth2[l] * cos2u;
+        const double uk = u - 0.25 * temp43 * x7thm1[l] * sin2u;
+        const double xnodek = xnode[l] + 1.5 * temp43 * cosio[l] * sin2u;
+        const double xinck = xincl[l] + 1.5 * temp43 * cosio[l] * sinio[l] * cos2u;
+        const double rdotk = rdot - xn[l] * temp42 * x1mth2[l] * sin2u;
+        const double rfdotk = rfdot + xn[l] * temp42 * (x1mth2[l] * cos2u + 1.5 * x3thm1[l]);
+
+        const double sinuk = sin(uk);
+        const double cosuk = cos(uk);
+        const double sinik = sin(xinck);
+        const double cosik = cos(xinck);
+        const double sinnok = sin(xnodek);
+        const double cosnok = cos(xnodek);
+        const double xmx = -sinnok * cosik;
+        const double xmy = cosnok * cosik;
+        const double ux = xmx * sinuk + cosnok * cosuk;
+        const double uy = xmy * sinuk + sinnok * cosuk;
+        const double uz = sinik * sinuk;
+        const double vx = xmx * cosuk - cosnok * sinuk;
+        const double vy = xmy * cosuk - sinnok * sinuk;
+        const double vz = sinik * cosuk;
+
+        st = (st == status_ok && rk < 1.0) ? status_decayed : st;
+        status[idx] = st;
+        if (st != status_ok) {
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+            states.x[idx] = states.y[idx] = states.z[idx] = nan;
+            states.vx[idx] = states.vy[idx] = states.vz[idx] = nan;
+            continue;
+        }
+        states.x[idx] = rk * ux * kXKMPER * 1000;
+        states.y[idx] = rk * uy * kXKMPER * 1000;
+        states.z[idx] = rk * uz * kXKMPER * 1000;
+        states.vx[idx] = (rdotk * ux + rfdotk * vx) * kXKMPER / 60.0 * 1000;
+        states.vy[idx] = (rdotk * uy + rfdotk * vy) * kXKMPER / 60.0 * 1000;
+        states.vz[idx] = (rdotk * uz + rfdotk * vz) * kXKMPER / 60.0 * 1000;
+    }
+}
+} // namespace catalog
+} // namespace kep_toolbox
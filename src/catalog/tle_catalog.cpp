@@ -0,0 +1,306 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include <keplerian_toolbox/catalog/tle_catalog.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/third_party/libsgp4/DecayedException.h>
+#include <keplerian_toolbox/third_party/libsgp4/Eci.h>
+#include <keplerian_toolbox/third_party/libsgp4/SatelliteException.h>
+#include <keplerian_toolbox/third_party/libsgp4/Tle.h>
+#include <keplerian_toolbox/third_party/libsgp4/TleException.h>
+#include <keplerian_toolbox/util/parallel_for.hpp>
+
+namespace kep_toolbox
+{
+namespace catalog
+{
+
+namespace
+{
+// Removes trailing blanks and carriage returns.
+std::string rtrim(const std::string &in)
+{
+    std::string::size_type end = in.find_last_not_of(" \t\r\n");
+    return (end == std::string::npos) ? std::string() : in.substr(0, end + 1);
+}
+
+bool is_tle_line(const std::string &line, char n)
+{
+    return line.size() >= 69 && line[0] == n && line[1] == ' ';
+}
+
+// Propagates one object, converting to SI units. Errors are reported in the returned status.
+int propagate_one(const SGP4 &propagator, double ref_mjd2000, double mjd2000, array3D &r, array3D &v)
+{
+    double minutes_since = (mjd2000 - ref_mjd2000) * 24 * 60;
+    int retval = tle_catalog::ok;
+    try {
+        Eci eci = propagator.FindPosition(minutes_since);
+        const Vector &position = eci.Position();
+        const Vector &velocity = eci.Velocity();
+        r[0] = position.x * 1000;
+        r[1] = position.y * 1000;
+        r[2] = position.z * 1000;
+        v[0] = velocity.x * 1000;
+        v[1] = velocity.y * 1000;
+        v[2] = velocity.z * 1000;
+        return retval;
+    } catch (const DecayedException &) {
+        retval = tle_catalog::decayed;
+    } catch (const SatelliteException &) {
+        retval = tle_catalog::sgp4_error;
+    }
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    r[0] = r[1] = r[2] = nan;
+    v[0] = v[1] = v[2] = nan;
+    return retval;
+}
+} // namespace
+
+/// Default constructor
+/**
+ * Constructs an empty catalog.
+ */
+tle_catalog::tle_catalog() : m_n_rejected(0u)
+{
+}
+
+/// Constructor from file
+/**
+ * Loads all the objects of a TLE file. Both the two line format and the three line format (with a name line,
+ * optionally starting with "0 ", before each element set) are accepted. Element sets that cannot be parsed or
+ * initialised by SGP4 are skipped (see get_n_rejected()).
+ *
+ * \param[in] file_name the TLE file
+ * \param[in] n_threads number of threads used to initialise SGP4 (0 means all the available cores)
+ *
+ * \throws value_error if the file cannot be opened
+ */
+tle_catalog::tle_catalog(const std::string &file_name, unsigned n_threads) : m_n_rejected(0u)
+{
+    std::ifstream file(file_name);
+    if (!file.good()) {
+        throw_value_error("Cannot open the TLE file: " + file_name);
+    }
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line)) {
+        lines.push_back(line);
+    }
+    load(lines, n_threads);
+}
+
+/// Constructor from lines
+/**
+ * As the constructor from file, but reading the lines of the TLE file from memory.
+ *
+ * \param[in] lines the lines of a TLE file
+ * \param[in] n_threads number of threads used to initialise SGP4 (0 means all the available cores)
+ */
+tle_catalog::tle_catalog(const std::vector<std::string> &lines, unsigned n_threads) : m_n_rejected(0u)
+{
+    load(lines, n_threads);
+}
+
+void tle_catalog::load(const std::vector<std::string> &lines, unsigned n_threads)
+{
+    // Pair the lines (serially, this is cheap).
+    std::vector<std::string> line1, line2, names;
+    std::string name;
+    for (std::size_t i = 0u; i < lines.size(); ++i) {
+        std::string l = rtrim(lines[i]);
+        if (is_tle_line(l, '1') && i + 1u < lines.size() && is_tle_line(rtrim(lines[i + 1u]), '2')) {
+            line1.push_back(l.substr(0, 69));
+            line2.push_back(rtrim(lines[i + 1u]).substr(0, 69));
+            names.push_back(name);
+            name.clear();
+            ++i;
+        } else if (is_tle_line(l, '1') || is_tle_line(l, '2')) {
+            // An orphan line
+            ++m_n_rejected;
+            name.clear();
+        } else {
+            // A name line (three line format) or garbage, the name is kept only if followed by a TLE.
+            name = (l.size() > 2u && l[0] == '0' && l[1] == ' ') ? l.substr(2) : l;
+        }
+    }
+
+    // Initialise the propagators in parallel.
+    const std::size_t n = line1.size();
+    std::vector<std::unique_ptr<SGP4>> propagators(n);
+    std::vector<double> ref_mjd2000(n);
+    util::parallel_for(0u, n,
+                       [&](std::size_t b, std::size_t e) {
+                           for (std::size_t i = b; i < e; ++i) {
+                               try {
+                                   Tle tle("TLE satellite", line1[i], line2[i]);
+                                   propagators[i].reset(new SGP4(tle));
+                                   ref_mjd2000[i] = epoch(tle.Epoch().ToJulian(), epoch::JD).mjd2000();
+                                   if (names[i].empty()) {
+                                       // Same naming as planet::tle (international designator)
+                                       std::string year_str = tle.IntDesignator().substr(0, 2);
+                                       int prefix = (std::stoi(year_str) > 56) ? (19) : (20);
+                                       names[i] = std::to_string(prefix) + year_str + std::string("-")
+                                                  + tle.IntDesignator().substr(2);
+                                   }
+                               } catch (const TleException &) {
+                                   propagators[i].reset();
+                               } catch (const SatelliteException &) {
+                                   propagators[i].reset();
+                               } catch (const std::logic_error &) {
+                                   // std::stoi on a malformed designator
+                                   propagators[i].reset();
+                               }
+                           }
+                       },
+                       n_threads);
+
+    for (std::size_t i = 0u; i < n; ++i) {
+        if (!propagators[i]) {
+            ++m_n_rejected;
+            continue;
+        }
+        m_propagators.push_back(*propagators[i]);
+        m_ref_mjd2000.push_back(ref_mjd2000[i]);
+        m_names.push_back(names[i]);
+        m_line1.push_back(line1[i]);
+        m_line2.push_back(line2[i]);
+    }
+}
+
+/// Number of objects in the catalog
+std::size_t tle_catalog::size() const
+{
+    return m_propagators.size();
+}
+
+/// Number of element sets that could not be loaded
+std::size_t tle_catalog::get_n_rejected() const
+{
+    return m_n_rejected;
+}
+
+/// Reference epochs of the element sets (mjd2000)
+const std::vector<double> &tle_catalog::get_ref_mjd2000() const
+{
+    return m_ref_mjd2000;
+}
+
+/// Object name (from the name line if present, the international designator otherwise)
+std::string tle_catalog::get_name(std::size_t idx) const
+{
+    return m_names.at(idx);
+}
+
+/// First line of the element set
+std::string tle_catalog::get_line1(std::size_t idx) const
+{
+    return m_line1.at(idx);
+}
+
+/// Second line of the element set
+std::string tle_catalog::get_line2(std::size_t idx) const
+{
+    return m_line2.at(idx);
+}
+
+/// Materializes an object as a planet
+/**
+ * \param[in] idx index of the object in the catalog
+ * \returns the planet::tle constructed from the element set
+ */
+planet::tle tle_catalog::get_planet(std::size_t idx) const
+{
+    return planet::tle(m_line1.at(idx), m_line2.at(idx));
+}
+
+/// Propagates all objects to one epoch
+/**
+ * \param[in] mjd2000 the epoch
+ * \param[out] r positions of the objects (SI units), resized to size()
+ * \param[out] v velocities of the objects (SI units), resized to size()
+ * \param[out] status propagation status of the objects (tle_catalog::status_code), resized to size()
+ * \param[in] n_threads number of threads (0 means all the available cores)
+ */
+void tle_catalog::propagate(double mjd2000, std::vector<array3D> &r, std::vector<array3D> &v,
+                            std::vector<int> &status, unsigned n_threads) const
+{
+    propagate(std::vector<double>(1u, mjd2000), r, v, status, n_threads);
+}
+
+/// Propagates each object to many epochs
+/**
+ * Outputs are stored object by object: the state of object i at epoch k is at index i * mjd2000s.size() + k.
+ *
+ * \param[in] mjd2000s the epochs
+ * \param[out] r positions of the objects (SI units), resized to size() * mjd2000s.size()
+ * \param[out] v velocities of the objects (SI units), resized to size() * mjd2000s.size()
+ * \param[out] status propagation status (tle_catalog::status_code), resized to size() * mjd2000s.size()
+ * \param[in] n_threads number of threads (0 means all the available cores)
+ */
+void tle_catalog::propagate(const std::vector<double> &mjd2000s, std::vector<array3D> &r, std::vector<array3D> &v,
+                            std::vector<int> &status, unsigned n_threads) const
+{
+    const std::size_t n_epochs = mjd2000s.size();
+    r.resize(size() * n_epochs);
+    v.resize(size() * n_epochs);
+    status.resize(size() * n_epochs);
+    util::parallel_for(0u, size(),
+                       [&](std::size_t b, std::size_t e) {
+                           for (std::size_t i = b; i < e; ++i) {
+                               // SGP4 keeps mutable integrator state for deep space objects: a local copy
+                               // keeps concurrent calls on the same catalog safe.
+                               const SGP4 propagator(m_propagators[i]);
+                               for (std::size_t k = 0u; k < n_epochs; ++k) {
+                                   const std::size_t idx = i * n_epochs + k;
+                                   status[idx]
+                                       = propagate_one(propagator, m_ref_mjd2000[i], mjd2000s[k], r[idx], v[idx]);
+                               }
+                           }
+                       },
+                       n_threads, 64u);
+}
+
+/// Propagates one object
+/**
+ * \param[in] idx index of the object in the catalog
+ * \param[in] mjd2000 the epoch
+ * \param[out] r position (SI units)
+ * \param[out] v velocity (SI units)
+ * \returns the propagation status (tle_catalog::status_code)
+ */
+int tle_catalog::propagate(std::size_t idx, double mjd2000, array3D &r, array3D &v) const
+{
+    const SGP4 propagator(m_propagators.at(idx));
+    return propagate_one(propagator, m_ref_mjd2000[idx], mjd2000, r, v);
+}
+} // namespace catalog
+} // namespace kep_toolbox
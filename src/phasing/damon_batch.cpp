@@ -0,0 +1,108 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/damon.hpp>
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/phasing/damon_batch.hpp>
+#include <keplerian_toolbox/util/parallel_for.hpp>
+
+namespace kep_toolbox
+{
+namespace phasing
+{
+
+/// Resizes all the arrays
+/**
+ * \param[in] n the number of arcs
+ */
+void lambert_arcs::resize(std::size_t n)
+{
+    for (auto v : {&v1x, &v1y, &v1z, &v2x, &v2y, &v2z, &tof}) {
+        v->resize(n);
+    }
+}
+
+/// Number of arcs
+/**
+ * @return the size of the arrays
+ */
+std::size_t lambert_arcs::size() const
+{
+    return tof.size();
+}
+
+/// Damon's approximation of many Lambert arcs
+/**
+ * Applies kep_toolbox::damon_approx and kep_toolbox::max_start_mass to each arc, in parallel blocks. The required
+ * acceleration is the magnitude of the (constant) acceleration of Damon's model, and an arc is feasible if a
+ * spacecraft of mass m0 with the given propulsion system can fly it, i.e. if max_start_mass is at least m0.
+ *
+ * \param[in] arcs the Lambert arcs
+ * \param[in] T_max maximum thrust of the propulsion system (N)
+ * \param[in] Isp specific impulse of the propulsion system (s)
+ * \param[in] m0 spacecraft mass at the start of the arcs (kg)
+ * \param[out] acc the required accelerations (m/s^2)
+ * \param[out] dv the DVs estimated by Damon's model (m/s)
+ * \param[out] feasible 1 for the feasible arcs, 0 otherwise
+ * \param[in] n_threads number of threads (0 means all the available cores)
+ *
+ * \throws value_error if the arrays have different sizes or T_max, Isp or m0 are not positive
+ */
+void damon_batch(const lambert_arcs &arcs, double T_max, double Isp, double m0, std::vector<double> &acc,
+                 std::vector<double> &dv, std::vector<char> &feasible, unsigned n_threads)
+{
+    const std::size_t n = arcs.size();
+    for (auto v : {&arcs.v1x, &arcs.v1y, &arcs.v1z, &arcs.v2x, &arcs.v2y, &arcs.v2z}) {
+        if (v->size() != n) {
+            throw_value_error("The arrays of the Lambert arcs must have the same size");
+        }
+    }
+    if (!(T_max > 0.) || !(Isp > 0.) || !(m0 > 0.)) {
+        throw_value_error("The thrust, the specific impulse and the mass must be positive");
+    }
+    acc.resize(n);
+    dv.resize(n);
+    feasible.resize(n);
+    util::parallel_for(0u, n,
+                       [&](std::size_t b, std::size_t e) {
+                           array3D v1, v2, a1, a2;
+                           double tau;
+                           for (std::size_t i = b; i < e; ++i) {
+                               v1 = {{arcs.v1x[i], arcs.v1y[i], arcs.v1z[i]}};
+                               v2 = {{arcs.v2x[i], arcs.v2y[i], arcs.v2z[i]}};
+                               damon_approx(v1, v2, arcs.tof[i], a1, a2, tau, dv[i]);
+                               acc[i] = std::sqrt(a1[0] * a1[0] + a1[1] * a1[1] + a1[2] * a1[2]);
+                               feasible[i] = max_start_mass(acc[i], dv[i], T_max, Isp) >= m0;
+                           }
+                       },
+                       n_threads, 4096u);
+}
+} // namespace phasing
+} // namespace kep_toolbox
@@ -0,0 +1,116 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <cstddef>
+#include <vector>
+
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/phasing/dbscan.hpp>
+#include <keplerian_toolbox/phasing/kdtree.hpp>
+#include <keplerian_toolbox/util/parallel_for.hpp>
+
+namespace kep_toolbox
+{
+namespace phasing
+{
+
+/// DBSCAN clustering of the points of a kd-tree
+/**
+ * Clusters the planets indexed by a kd-tree, in the embedding of its metric, with the same semantics of
+ * sklearn.cluster.DBSCAN: a planet is a core sample if at least min_samples planets (itself included) are within
+ * eps, clusters are the sets of core samples connected by steps shorter than eps, together with the non-core
+ * planets within eps of them. The region queries are made in parallel on the kd-tree, then the clusters are
+ * labelled with a depth first search from the core samples, in index order. As in sklearn, a non-core planet within
+ * eps of two clusters takes the label of the first one reaching it.
+ *
+ * \param[in] tree the kd-tree
+ * \param[in] eps the maximum distance between two neighbours (m/s for the ORBITAL metric)
+ * \param[in] min_samples the minimum number of neighbours of a core sample (itself included)
+ * \param[out] labels the cluster of each planet (-1 for noise)
+ * \param[out] core_samples the indices of the core samples, sorted
+ * \param[in] n_threads number of threads (0 means all the available cores)
+ *
+ * @return the number of clusters
+ *
+ * \throws value_error if eps is negative
+ */
+std::size_t dbscan(const kdtree &tree, double eps, std::size_t min_samples, std::vector<long> &labels,
+                   std::vector<std::size_t> &core_samples, unsigned n_threads)
+{
+    if (!(eps >= 0.)) {
+        throw_value_error("eps must not be negative");
+    }
+    const std::size_t n = tree.size();
+
+    // Region queries, only the neighbourhoods of the core samples are kept
+    std::vector<std::vector<std::size_t>> neighbours(n);
+    std::vector<char> is_core(n, 0);
+    util::parallel_for(0u, n,
+                       [&](std::size_t b, std::size_t e) {
+                           std::vector<double> dists;
+                           for (std::size_t i = b; i < e; ++i) {
+                               tree.query_ball(tree.get_point(i), eps, neighbours[i], dists);
+                               is_core[i] = neighbours[i].size() >= min_samples;
+                               if (!is_core[i]) {
+                                   std::vector<std::size_t>().swap(neighbours[i]);
+                               }
+                           }
+                       },
+                       n_threads, 256u);
+
+    // Depth first search from each unlabelled core sample, stopping at the non-core samples
+    labels.assign(n, -1);
+    core_samples.clear();
+    long n_clusters = 0;
+    std::vector<std::size_t> stack;
+    for (std::size_t i = 0u; i < n; ++i) {
+        if (is_core[i]) {
+            core_samples.push_back(i);
+        }
+        if (labels[i] != -1 || !is_core[i]) {
+            continue;
+        }
+        stack.push_back(i);
+        while (!stack.empty()) {
+            const std::size_t j = stack.back();
+            stack.pop_back();
+            if (labels[j] != -1) {
+                continue;
+            }
+            labels[j] = n_clusters;
+            if (is_core[j]) {
+                for (auto nb : neighbours[j]) {
+                    if (labels[nb] == -1) {
+                        stack.push_back(nb);
+                    }
+                }
+            }
+        }
+        ++n_clusters;
+    }
+    return static_cast<std::size_t>(n_clusters);
+}
+} // namespace phasing
+} // namespace kep_toolbox
@@ -0,0 +1,529 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/phasing/kdtree.hpp>
+#include <keplerian_toolbox/util/parallel_for.hpp>
+
+namespace kep_toolbox
+{
+namespace phasing
+{
+
+namespace
+{
+typedef std::pair<double, std::size_t> neighbour;
+
+double distance2(const kdtree::point_type &a, const kdtree::point_type &b)
+{
+    double retval = 0.;
+    for (unsigned k = 0u; k < 6u; ++k) {
+        retval += (a[k] - b[k]) * (a[k] - b[k]);
+    }
+    return retval;
+}
+
+// Squared distance from x to the box [lo, hi] (infinity for the empty box of an empty node)
+double box_distance2(const kdtree::point_type &x, const kdtree::point_type &lo, const kdtree::point_type &hi)
+{
+    double retval = 0.;
+    for (unsigned k = 0u; k < 6u; ++k) {
+        const double d = (x[k] < lo[k]) ? lo[k] - x[k] : ((x[k] > hi[k]) ? x[k] - hi[k] : 0.);
+        retval += d * d;
+    }
+    return retval;
+}
+
+// Keeps the k nearest points seen, as a max-heap on (squared distance, index)
+struct knn_visitor {
+    double bound() const
+    {
+        return heap.size() < k ? std::numeric_limits<double>::infinity() : heap.top().first;
+    }
+    void add(std::size_t idx, double d2)
+    {
+        const neighbour nb(d2, idx);
+        if (heap.size() < k) {
+            heap.push(nb);
+        } else if (nb < heap.top()) {
+            heap.pop();
+            heap.push(nb);
+        }
+    }
+    std::size_t k;
+    std::priority_queue<neighbour> heap;
+};
+
+// Collects the points within a squared distance
+struct ball_visitor {
+    double bound() const
+    {
+        return r2;
+    }
+    void add(std::size_t idx, double d2)
+    {
+        if (d2 <= r2) {
+            found.emplace_back(d2, idx);
+        }
+    }
+    double r2;
+    std::vector<neighbour> found;
+};
+
+void sorted_results(std::vector<neighbour> &nbs, std::vector<std::size_t> &ids, std::vector<double> &dists)
+{
+    std::sort(nbs.begin(), nbs.end());
+    ids.resize(nbs.size());
+    dists.resize(nbs.size());
+    for (std::size_t i = 0u; i < nbs.size(); ++i) {
+        ids[i] = nbs[i].second;
+        dists[i] = std::sqrt(nbs[i].first);
+    }
+}
+
+void knn_results(knn_visitor &v, std::vector<std::size_t> &ids, std::vector<double> &dists)
+{
+    std::vector<neighbour> nbs;
+    nbs.reserve(v.heap.size());
+    while (!v.heap.empty()) {
+        nbs.push_back(v.heap.top());
+        v.heap.pop();
+    }
+    sorted_results(nbs, ids, dists);
+}
+} // namespace
+
+/// Constructor from a list of planets
+/**
+ * \param[in] planets the planets to index (cloned)
+ * \param[in] mjd2000 the epoch of the ephemerides
+ * \param[in] m the metric
+ * \param[in] T average transfer time defining the ORBITAL metric (days)
+ * \param[in] ref_r reference radius scaling the positions in the EUCLIDEAN metrics (m)
+ * \param[in] ref_v reference velocity scaling the velocities in the EUCLIDEAN metric (m/s)
+ * \param[in] n_threads number of threads computing the ephemerides and the tree (0 means all the available cores)
+ *
+ * \throws value_error if T, ref_r or ref_v are not positive
+ */
+kdtree::kdtree(const std::vector<planet::planet_ptr> &planets, double mjd2000, metric m, double T, double ref_r,
+               double ref_v, unsigned n_threads)
+    : m_mjd2000(mjd2000), m_metric(m), m_T(T), m_ref_r(ref_r), m_ref_v(ref_v)
+{
+    if (!(T > 0.) || !(ref_r > 0.) || !(ref_v > 0.)) {
+        throw_value_error("The transfer time and the reference radius and velocity must be positive");
+    }
+    m_planets.reserve(planets.size());
+    for (const auto &p : planets) {
+        m_planets.push_back(p->clone());
+    }
+    compute_points(n_threads);
+    build(n_threads);
+}
+
+/// Constructor from a minor planet catalog
+/**
+ * As the other constructor, indexing the minor planets of a catalog (in the catalog order).
+ *
+ * \param[in] cat the minor planet catalog
+ * \param[in] mjd2000 the epoch of the ephemerides
+ * \param[in] m the metric
+ * \param[in] T average transfer time defining the ORBITAL metric (days)
+ * \param[in] ref_r reference radius scaling the positions in the EUCLIDEAN metrics (m)
+ * \param[in] ref_v reference velocity scaling the velocities in the EUCLIDEAN metric (m/s)
+ * \param[in] n_threads number of threads computing the ephemerides and the tree (0 means all the available cores)
+ *
+ * \throws value_error if T, ref_r or ref_v are not positive
+ */
+kdtree::kdtree(const catalog::mpcorb_catalog &cat, double mjd2000, metric m, double T, double ref_r, double ref_v,
+               unsigned n_threads)
+    : m_mjd2000(mjd2000), m_metric(m), m_T(T), m_ref_r(ref_r), m_ref_v(ref_v)
+{
+    if (!(T > 0.) || !(ref_r > 0.) || !(ref_v > 0.)) {
+        throw_value_error("The transfer time and the reference radius and velocity must be positive");
+    }
+    m_planets.resize(cat.size());
+    util::parallel_for(0u, cat.size(),
+                       [&](std::size_t b, std::size_t e) {
+                           for (std::size_t i = b; i < e; ++i) {
+                               m_planets[i] = cat.get_planet(i).clone();
+                           }
+                       },
+                       n_threads);
+    compute_points(n_threads);
+    build(n_threads);
+}
+
+/// Embedding of a state
+/**
+ * \param[in] r position (m)
+ * \param[in] v velocity (m/s)
+ *
+ * @return the point of the embedding of the metric of the tree
+ */
+kdtree::point_type kdtree::embed(const array3D &r, const array3D &v) const
+{
+    point_type retval;
+    if (m_metric == ORBITAL) {
+        for (unsigned k = 0u; k < 3u; ++k) {
+            retval[k + 3u] = r[k] / (m_T * ASTRO_DAY2SEC);
+            retval[k] = retval[k + 3u] + v[k];
+        }
+    } else {
+        for (unsigned k = 0u; k < 3u; ++k) {
+            retval[k] = r[k] / m_ref_r;
+            retval[k + 3u] = (m_metric == EUCLIDEAN) ? v[k] / m_ref_v : 0.;
+        }
+    }
+    return retval;
+}
+
+/// Embedding of a planet
+/**
+ * \param[in] pl a planet
+ *
+ * @return the point of the embedding of the state of pl at the epoch of the tree
+ */
+kdtree::point_type kdtree::embed(const planet::base &pl) const
+{
+    array3D r, v;
+    pl.eph(m_mjd2000, r, v);
+    return embed(r, v);
+}
+
+void kdtree::compute_points(unsigned n_threads)
+{
+    m_points.resize(m_planets.size());
+    util::parallel_for(0u, m_planets.size(),
+                       [&](std::size_t b, std::size_t e) {
+                           for (std::size_t i = b; i < e; ++i) {
+                               m_points[i] = embed(*m_planets[i]);
+                           }
+                       },
+                       n_threads);
+}
+
+void kdtree::build(unsigned n_threads)
+{
+    const std::size_t n = m_points.size();
+    m_perm.resize(n);
+    std::iota(m_perm.begin(), m_perm.end(), std::size_t(0u));
+    m_depth = 0u;
+    while (((n + (std::size_t(1u) << m_depth) - 1u) >> m_depth) > leaf_size) {
+        ++m_depth;
+    }
+    m_nodes.resize((std::size_t(2u) << m_depth) - 1u);
+
+    // The top levels are split serially, then the subtrees are built in parallel
+    if (n_threads == 0u) {
+        n_threads = util::default_n_threads();
+    }
+    unsigned top = 0u;
+    while (top < m_depth && (std::size_t(1u) << top) < 4u * std::size_t(n_threads)) {
+        ++top;
+    }
+    build_node(0u, 0u, n, 0u, top);
+    const std::size_t first = (std::size_t(1u) << top) - 1u;
+    util::parallel_for(first, 2u * first + 1u,
+                       [&](std::size_t b, std::size_t e) {
+                           for (std::size_t i = b; i < e; ++i) {
+                               build_node(i, m_nodes[i].begin, m_nodes[i].end, top, m_depth);
+                           }
+                       },
+                       n_threads, 1u);
+    m_build_size = leaves_size();
+}
+
+// Recomputes the bounding boxes of the leaves from their points, then those of the other nodes, level by level,
+// as the union of the boxes of their children
+void kdtree::refit(unsigned n_threads)
+{
+    for (unsigned depth = m_depth + 1u; depth-- > 0u;) {
+        const std::size_t first = (std::size_t(1u) << depth) - 1u;
+        util::parallel_for(first, 2u * first + 1u,
+                           [&](std::size_t b, std::size_t e) {
+                               for (std::size_t i = b; i < e; ++i) {
+                                   node &nd = m_nodes[i];
+                                   if (depth == m_depth) {
+                                       build_node(i, nd.begin, nd.end, depth, depth);
+                                       continue;
+                                   }
+                                   const node &l = m_nodes[2u * i + 1u], &r = m_nodes[2u * i + 2u];
+                                   for (unsigned k = 0u; k < 6u; ++k) {
+                                       nd.lo[k] = std::min(l.lo[k], r.lo[k]);
+                                       nd.hi[k] = std::max(l.hi[k], r.hi[k]);
+                                   }
+                               }
+                           },
+                           n_threads, 1024u);
+    }
+}
+
+// Sum over the leaves of the sum of the sides of their boxes
+double kdtree::leaves_size() const
+{
+    double retval = 0.;
+    for (std::size_t i = (std::size_t(1u) << m_depth) - 1u; i < m_nodes.size(); ++i) {
+        const node &nd = m_nodes[i];
+        if (nd.end > nd.begin) {
+            for (unsigned k = 0u; k < 6u; ++k) {
+                retval += nd.hi[k] - nd.lo[k];
+            }
+        }
+    }
+    return retval;
+}
+
+/// Moves the tree to a new epoch
+/**
+ * Recomputes, in parallel, the states of the planets at the new epoch and refits the bounding boxes of the nodes,
+ * keeping the structure of the tree. If the tree has degraded too much (see get_degradation()), it is rebuilt.
+ *
+ * \param[in] mjd2000 the new epoch of the ephemerides
+ * \param[in] rebuild_factor the tree is rebuilt when its degradation exceeds this factor
+ * \param[in] n_threads number of threads (0 means all the available cores)
+ *
+ * @return true if the tree was rebuilt
+ */
+bool kdtree::update(double mjd2000, double rebuild_factor, unsigned n_threads)
+{
+    m_mjd2000 = mjd2000;
+    compute_points(n_threads);
+    refit(n_threads);
+    if (get_degradation() > rebuild_factor) {
+        build(n_threads);
+        return true;
+    }
+    return false;
+}
+
+/// Degradation of the tree
+/**
+ * @return the ratio between the total size of the boxes of the leaves (sum of their sides) and its value at the
+ * last build of the tree (1 for a tree just built)
+ */
+double kdtree::get_degradation() const
+{
+    return m_build_size > 0. ? leaves_size() / m_build_size : 1.;
+}
+
+// Sets the range and the bounding box of the node n and, down to stop_depth, splits it at the median of the
+// widest dimension
+void kdtree::build_node(std::size_t n, std::size_t begin, std::size_t end, unsigned depth, unsigned stop_depth)
+{
+    node &nd = m_nodes[n];
+    nd.begin = begin;
+    nd.end = end;
+    nd.lo.fill(std::numeric_limits<double>::infinity());
+    nd.hi.fill(-std::numeric_limits<double>::infinity());
+    for (std::size_t i = begin; i < end; ++i) {
+        const point_type &p = m_points[m_perm[i]];
+        for (unsigned k = 0u; k < 6u; ++k) {
+            nd.lo[k] = std::min(nd.lo[k], p[k]);
+            nd.hi[k] = std::max(nd.hi[k], p[k]);
+        }
+    }
+    if (depth == stop_depth) {
+        return;
+    }
+    unsigned dim = 0u;
+    for (unsigned k = 1u; k < 6u; ++k) {
+        if (nd.hi[k] - nd.lo[k] > nd.hi[dim] - nd.lo[dim]) {
+            dim = k;
+        }
+    }
+    const std::size_t mid = begin + (end - begin) / 2u;
+    std::nth_element(m_perm.begin() + static_cast<std::ptrdiff_t>(begin),
+                     m_perm.begin() + static_cast<std::ptrdiff_t>(mid),
+                     m_perm.begin() + static_cast<std::ptrdiff_t>(end), [this, dim](std::size_t a, std::size_t b) {
+                         return m_points[a][dim] < m_points[b][dim] || (m_points[a][dim] == m_points[b][dim] && a < b);
+                     });
+    build_node(2u * n + 1u, begin, mid, depth + 1u, stop_depth);
+    build_node(2u * n + 2u, mid, end, depth + 1u, stop_depth);
+}
+
+// Depth first traversal visiting the nearest child first and pruning the nodes farther than the bound of the
+// visitor
+template <typename Visitor>
+void kdtree::visit(const point_type &x, Visitor &v) const
+{
+    std::vector<neighbour> stack;
+    stack.reserve(2u * m_depth + 2u);
+    stack.emplace_back(box_distance2(x, m_nodes[0].lo, m_nodes[0].hi), 0u);
+    const std::size_t first_leaf = (std::size_t(1u) << m_depth) - 1u;
+    while (!stack.empty()) {
+        const neighbour top = stack.back();
+        stack.pop_back();
+        if (top.first > v.bound()) {
+            continue;
+        }
+        const node &nd = m_nodes[top.second];
+        if (top.second >= first_leaf) {
+            for (std::size_t i = nd.begin; i < nd.end; ++i) {
+                v.add(m_perm[i], distance2(x, m_points[m_perm[i]]));
+            }
+            continue;
+        }
+        const std::size_t l = 2u * top.second + 1u, r = l + 1u;
+        const double dl = box_distance2(x, m_nodes[l].lo, m_nodes[l].hi);
+        const double dr = box_distance2(x, m_nodes[r].lo, m_nodes[r].hi);
+        if (dl <= dr) {
+            stack.emplace_back(dr, r);
+            stack.emplace_back(dl, l);
+        } else {
+            stack.emplace_back(dl, l);
+            stack.emplace_back(dr, r);
+        }
+    }
+}
+
+/// K nearest neighbours query
+/**
+ * \param[in] x a point of the embedding (see embed())
+ * \param[in] k the number of neighbours
+ * \param[out] ids the indices of the min(k, size()) nearest points, sorted by distance
+ * \param[out] dists their distances (m/s for the ORBITAL metric)
+ */
+void kdtree::query_knn(const point_type &x, std::size_t k, std::vector<std::size_t> &ids,
+                       std::vector<double> &dists) const
+{
+    knn_visitor v;
+    v.k = k;
+    if (k > 0u) {
+        visit(x, v);
+    }
+    knn_results(v, ids, dists);
+}
+
+/// Ball query
+/**
+ * \param[in] x a point of the embedding (see embed())
+ * \param[in] r the query radius (m/s for the ORBITAL metric)
+ * \param[out] ids the indices of the points within r, sorted by distance
+ * \param[out] dists their distances
+ */
+void kdtree::query_ball(const point_type &x, double r, std::vector<std::size_t> &ids,
+                        std::vector<double> &dists) const
+{
+    ball_visitor v;
+    v.r2 = r * r;
+    if (r >= 0.) {
+        visit(x, v);
+    }
+    sorted_results(v.found, ids, dists);
+}
+
+/// Batch k nearest neighbours query
+/**
+ * Finds, in parallel, the k nearest neighbours of some of the indexed points (each point is its own nearest
+ * neighbour).
+ *
+ * \param[in] idxs the indices of the query points
+ * \param[in] k the number of neighbours
+ * \param[out] ids the indices of the min(k, size()) nearest points of each query point, concatenated
+ * \param[out] dists their distances, concatenated
+ * \param[in] n_threads number of threads (0 means all the available cores)
+ *
+ * \throws value_error if an index is out of range
+ */
+void kdtree::query_knn(const std::vector<std::size_t> &idxs, std::size_t k, std::vector<std::size_t> &ids,
+                       std::vector<double> &dists, unsigned n_threads) const
+{
+    for (auto idx : idxs) {
+        check_index(idx);
+    }
+    const std::size_t kk = std::min(k, size());
+    ids.resize(idxs.size() * kk);
+    dists.resize(idxs.size() * kk);
+    util::parallel_for(0u, idxs.size(),
+                       [&](std::size_t b, std::size_t e) {
+                           std::vector<std::size_t> qi;
+                           std::vector<double> qd;
+                           for (std::size_t q = b; q < e; ++q) {
+                               query_knn(m_points[idxs[q]], kk, qi, qd);
+                               std::copy(qi.begin(), qi.end(), ids.begin() + static_cast<std::ptrdiff_t>(q * kk));
+                               std::copy(qd.begin(), qd.end(), dists.begin() + static_cast<std::ptrdiff_t>(q * kk));
+                           }
+                       },
+                       n_threads);
+}
+
+/// Number of indexed points
+std::size_t kdtree::size() const
+{
+    return m_points.size();
+}
+
+/// Epoch of the ephemerides (mjd2000)
+double kdtree::get_mjd2000() const
+{
+    return m_mjd2000;
+}
+
+/// Metric
+kdtree::metric kdtree::get_metric() const
+{
+    return m_metric;
+}
+
+/// Point of the embedding of an indexed planet
+/**
+ * \param[in] idx the index of the planet
+ *
+ * @return the point of the embedding of its state at the epoch of the tree
+ *
+ * \throws value_error if idx is out of range
+ */
+const kdtree::point_type &kdtree::get_point(std::size_t idx) const
+{
+    check_index(idx);
+    return m_points[idx];
+}
+
+/// Indexed planets
+const std::vector<planet::planet_ptr> &kdtree::get_planets() const
+{
+    return m_planets;
+}
+
+void kdtree::check_index(std::size_t idx) const
+{
+    if (idx >= size()) {
+        throw_value_error("Index out of range in the kd-tree");
+    }
+}
+
+const std::size_t kdtree::leaf_size;
+} // namespace phasing
+} // namespace kep_toolbox
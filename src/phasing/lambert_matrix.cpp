@@ -0,0 +1,301 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/array3D_operations.hpp>
+#include <keplerian_toolbox/core_functions/damon.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/lambert_problem.hpp>
+#include <keplerian_toolbox/phasing/lambert_matrix.hpp>
+#include <keplerian_toolbox/util/grid.hpp>
+#include <keplerian_toolbox/util/parallel_for.hpp>
+
+namespace kep_toolbox
+{
+namespace phasing
+{
+
+namespace
+{
+struct state {
+    array3D r;
+    array3D v;
+};
+
+state get_state(const planet::base &pl, double mjd2000)
+{
+    state retval;
+    pl.eph(epoch(mjd2000), retval.r, retval.v);
+    return retval;
+}
+
+double angular_momentum_distance(const state &a, const state &b)
+{
+    array3D ha, hb, dh;
+    cross(ha, a.r, a.v);
+    cross(hb, b.r, b.v);
+    diff(dh, hb, ha);
+    return norm(dh);
+}
+
+// Minimum cost over the grid of the transfers from the planets in rows (one row each) to all the planets (one column
+// each). cost(dep, arr, v1, v2, tof) is the cost of the Lambert arc with velocities v1, v2 (NaN if the transfer is
+// not acceptable), skip(dep, arr, r_max) is true for the pairs not worth computing, given their states at the first
+// epochs of the grid and the largest distance of the two planets from the central body. Returns the number of pairs
+// computed.
+template <typename Cost, typename Skip>
+std::size_t transfer_matrix(const std::vector<planet::planet_ptr> &planets, const std::vector<std::size_t> &rows,
+                            const std::array<double, 2> &t0, unsigned n_t0, const std::array<double, 2> &tof,
+                            unsigned n_tof, const Cost &cost, const Skip &skip, double cost_max,
+                            std::vector<float> &best_cost, std::vector<float> &best_t0, std::vector<float> &best_tof,
+                            unsigned n_threads)
+{
+    if (n_t0 == 0u || n_tof == 0u) {
+        throw_value_error("The grids of the departure epochs and of the times of flight must not be empty");
+    }
+    if (!(std::min(tof[0], tof[1]) > 0.)) {
+        throw_value_error("The times of flight must be positive");
+    }
+    const std::size_t n = planets.size(), n_rows = rows.size();
+    const double mu = n ? planets[0]->get_mu_central_body() : 0.;
+    for (const auto &p : planets) {
+        if (p->get_mu_central_body() != mu) {
+            throw_value_error("All planets must orbit the same central body");
+        }
+    }
+    for (auto i : rows) {
+        if (i >= n) {
+            throw_value_error("Departure planet index out of range");
+        }
+    }
+    const float inf = std::numeric_limits<float>::infinity();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    best_cost.assign(n_rows * n, inf);
+    best_t0.assign(n_rows * n, nan);
+    best_tof.assign(n_rows * n, nan);
+
+    // Departure states and their largest distance from the central body
+    std::vector<state> departures(n_rows * n_t0);
+    std::vector<double> r_dep(n_rows, 0.);
+    util::parallel_for(0u, n_rows,
+                       [&](std::size_t b, std::size_t e) {
+                           for (std::size_t i = b; i < e; ++i) {
+                               // The ephemerides are computed on a clone: rows may repeat a planet, and the eph of
+                               // some planets (e.g. planet::tle) must not be called concurrently on one object
+                               const planet::planet_ptr pl = planets[rows[i]]->clone();
+                               for (unsigned k = 0u; k < n_t0; ++k) {
+                                   departures[i * n_t0 + k] = get_state(*pl, util::grid_point(t0, k, n_t0));
+                                   r_dep[i] = std::max(r_dep[i], norm(departures[i * n_t0 + k].r));
+                               }
+                           }
+                       },
+                       n_threads, 16u);
+
+    // Columns, i.e. arrival planets, in parallel
+    std::vector<std::size_t> computed(n, 0u);
+    util::parallel_for(0u, n,
+                       [&](std::size_t b, std::size_t e) {
+                           std::vector<state> arrivals(static_cast<std::size_t>(n_t0) * n_tof);
+                           array3D v1, v2;
+                           for (std::size_t j = b; j < e; ++j) {
+                               // Also a clone, as the list may hold the same planet more than once
+                               const planet::planet_ptr pl = planets[j]->clone();
+                               double r_arr = 0.;
+                               for (unsigned k = 0u; k < n_t0; ++k) {
+                                   for (unsigned l = 0u; l < n_tof; ++l) {
+                                       auto &s = arrivals[k * n_tof + l];
+                                       s = get_state(*pl, util::grid_point(t0, k, n_t0)
+                                                              + util::grid_point(tof, l, n_tof));
+                                       r_arr = std::max(r_arr, norm(s.r));
+                                   }
+                               }
+                               for (std::size_t i = 0u; i < n_rows; ++i) {
+                                   if (rows[i] == j
+                                       || skip(departures[i * n_t0], arrivals[0], std::max(r_dep[i], r_arr))) {
+                                       continue;
+                                   }
+                                   double best = std::numeric_limits<double>::infinity();
+                                   unsigned best_k = 0u, best_l = 0u;
+                                   for (unsigned k = 0u; k < n_t0; ++k) {
+                                       const auto &dep = departures[i * n_t0 + k];
+                                       for (unsigned l = 0u; l < n_tof; ++l) {
+                                           const auto &arr = arrivals[k * n_tof + l];
+                                           const double T = util::grid_point(tof, l, n_tof) * ASTRO_DAY2SEC;
+                                           try {
+                                               lambert_problem::solve_0rev(v1, v2, dep.r, arr.r, T, mu);
+                                           } catch (const std::exception &) {
+                                               // Transfer plane containing the z axis, undefined direction
+                                               continue;
+                                           }
+                                           const double c = cost(dep, arr, v1, v2, T);
+                                           if (c < best) {
+                                               best = c;
+                                               best_k = k;
+                                               best_l = l;
+                                           }
+                                       }
+                                   }
+                                   ++computed[j];
+                                   if (best <= cost_max && best < std::numeric_limits<double>::infinity()) {
+                                       best_cost[i * n + j] = static_cast<float>(best);
+                                       best_t0[i * n + j] = static_cast<float>(util::grid_point(t0, best_k, n_t0));
+                                       best_tof[i * n + j] = static_cast<float>(util::grid_point(tof, best_l, n_tof));
+                                   }
+                               }
+                           }
+                       },
+                       n_threads, 1u);
+    std::size_t retval = 0u;
+    for (auto c : computed) {
+        retval += c;
+    }
+    return retval;
+}
+} // namespace
+
+/// All-pairs Lambert transfer cost matrix
+/**
+ * Computes, for every ordered pair (i, j) of planets, the minimum DV (m/s) of the rendezvous transfers from planet i
+ * to planet j along zero revolutions prograde Lambert arcs, over a grid of n_t0 departure epochs in t0 and n_tof
+ * times of flight in tof (both bounds included). The DV of a transfer is the sum of the magnitudes of the departure
+ * and arrival relative velocities, as in pykep.phasing.lambert_metric. The ephemerides of the departure epochs are
+ * computed once per planet, the ones of the arrival epochs once per arrival planet, and the columns of the matrix
+ * are computed in parallel.
+ *
+ * Pairs that cannot be cheaper than dv_max are skipped without solving any Lambert problem. An impulse
+ * \f$ \Delta \mathbf V \f$ at \f$ \mathbf r \f$ changes the angular momentum by \f$ \mathbf r \times \Delta \mathbf
+ * V \f$, hence \f$ \Delta V \ge |\mathbf h_j - \mathbf h_i| / r_{max} \f$, where \f$ r_{max} \f$ is the largest
+ * distance from the central body of the two planets at the epochs of the grid. The angular momenta are taken at
+ * the first epochs of the grid, so that the bound is exact for Keplerian planets.
+ *
+ * \param[in] planets the planets (all orbiting the same central body; the ephemerides are computed on clones, so
+ * that the list may contain the same planet more than once)
+ * \param[in] t0 bounds of the departure epochs (mjd2000)
+ * \param[in] n_t0 number of departure epochs
+ * \param[in] tof bounds of the times of flight (days)
+ * \param[in] n_tof number of times of flight
+ * \param[out] dv the N x N row-major matrix of the minimum DVs (m/s), infinity on the diagonal, for the skipped
+ * pairs and for the transfers more expensive than dv_max
+ * \param[out] best_t0 the departure epochs (mjd2000) of the minimum DV transfers (NaN where dv is infinity)
+ * \param[out] best_tof the times of flight (days) of the minimum DV transfers (NaN where dv is infinity)
+ * \param[in] dv_max the maximum DV of interest (m/s)
+ * \param[in] n_threads number of threads (0 means all the available cores)
+ *
+ * @return the number of pairs for which the Lambert problems were solved
+ *
+ * \throws value_error if the grids are empty, the times of flight not positive, or the planets do not orbit the same
+ * central body
+ */
+std::size_t lambert_matrix(const std::vector<planet::planet_ptr> &planets, const std::array<double, 2> &t0,
+                           unsigned n_t0, const std::array<double, 2> &tof, unsigned n_tof, std::vector<float> &dv,
+                           std::vector<float> &best_t0, std::vector<float> &best_tof, double dv_max,
+                           unsigned n_threads)
+{
+    std::vector<std::size_t> rows(planets.size());
+    for (std::size_t i = 0u; i < rows.size(); ++i) {
+        rows[i] = i;
+    }
+    return transfer_matrix(planets, rows, t0, n_t0, tof, n_tof,
+                           [](const state &dep, const state &arr, const array3D &v1, const array3D &v2, double) {
+                               array3D dv1, dv2;
+                               diff(dv1, v1, dep.v);
+                               diff(dv2, arr.v, v2);
+                               return norm(dv1) + norm(dv2);
+                           },
+                           [dv_max](const state &dep, const state &arr, double r_max) {
+                               return angular_momentum_distance(dep, arr) > dv_max * r_max;
+                           },
+                           dv_max, dv, best_t0, best_tof, n_threads);
+}
+
+/// Low-thrust reachability matrix (Lambert arcs converted with Damon's model)
+/**
+ * As lambert_matrix, but each Lambert arc of the grid is converted to a low-thrust transfer with Damon's model
+ * (kep_toolbox::damon_approx), and only the transfers a spacecraft of mass m0 with the given propulsion system can
+ * fly (kep_toolbox::max_start_mass at least m0) are retained. The cost of a transfer is the DV of Damon's model, and
+ * the matrix has one row for each departure planet, so that the reachability of a whole catalog from a few planets
+ * can be screened without computing all the pairs.
+ *
+ * \param[in] planets the planets (all orbiting the same central body; the ephemerides are computed on clones, so
+ * that the list may contain the same planet more than once)
+ * \param[in] departures the indices in planets of the departure planets (they may repeat)
+ * \param[in] t0 bounds of the departure epochs (mjd2000)
+ * \param[in] n_t0 number of departure epochs
+ * \param[in] tof bounds of the times of flight (days)
+ * \param[in] n_tof number of times of flight
+ * \param[in] T_max maximum thrust of the propulsion system (N)
+ * \param[in] Isp specific impulse of the propulsion system (s)
+ * \param[in] m0 spacecraft mass at departure (kg)
+ * \param[out] dv the row-major matrix, with departures.size() rows and planets.size() columns, of the minimum DVs
+ * (m/s) of the feasible transfers (infinity if there are none)
+ * \param[out] best_t0 the departure epochs (mjd2000) of the minimum DV transfers (NaN where dv is infinity)
+ * \param[out] best_tof the times of flight (days) of the minimum DV transfers (NaN where dv is infinity)
+ * \param[in] n_threads number of threads (0 means all the available cores)
+ *
+ * @return the number of reachable pairs
+ *
+ * \throws value_error as lambert_matrix, if a departure index is out of range or if T_max, Isp or m0 are not
+ * positive
+ */
+std::size_t lambert_damon_matrix(const std::vector<planet::planet_ptr> &planets,
+                                 const std::vector<std::size_t> &departures, const std::array<double, 2> &t0,
+                                 unsigned n_t0, const std::array<double, 2> &tof, unsigned n_tof, double T_max,
+                                 double Isp, double m0, std::vector<float> &dv, std::vector<float> &best_t0,
+                                 std::vector<float> &best_tof, unsigned n_threads)
+{
+    if (!(T_max > 0.) || !(Isp > 0.) || !(m0 > 0.)) {
+        throw_value_error("The thrust, the specific impulse and the mass must be positive");
+    }
+    transfer_matrix(planets, departures, t0, n_t0, tof, n_tof,
+                    [T_max, Isp, m0](const state &dep, const state &arr, const array3D &v1, const array3D &v2,
+                                     double T) {
+                        array3D dv1, dv2, a1, a2;
+                        double tau, damon_dv;
+                        diff(dv1, v1, dep.v);
+                        diff(dv2, v2, arr.v);
+                        damon_approx(dv1, dv2, T, a1, a2, tau, damon_dv);
+                        return (max_start_mass(norm(a1), damon_dv, T_max, Isp) >= m0)
+                                   ? damon_dv
+                                   : std::numeric_limits<double>::quiet_NaN();
+                    },
+                    [](const state &, const state &, double) { return false; },
+                    std::numeric_limits<double>::infinity(), dv, best_t0, best_tof, n_threads);
+    std::size_t retval = 0u;
+    for (auto c : dv) {
+        retval += (c != std::numeric_limits<float>::infinity());
+    }
+    return retval;
+}
+} // namespace phasing
+} // namespace kep_toolbox
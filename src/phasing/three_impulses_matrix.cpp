@@ -0,0 +1,273 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/phasing/three_impulses_matrix.hpp>
+#include <keplerian_toolbox/util/parallel_for.hpp>
+
+namespace kep_toolbox
+{
+namespace phasing
+{
+
+namespace
+{
+// Rows and columns are processed in tiles, so that the terms of a tile of columns stay in cache while a tile of rows
+// is swept over them
+const std::size_t row_tile = 64u;
+const std::size_t col_tile = 1024u;
+
+// The per-orbit terms of kep_toolbox::three_impulses_approx
+struct orbit_terms {
+    explicit orbit_terms(const soa_elements &el)
+        : ra(el.size()), rp(el.size()), ci(el.size()), si(el.size()), cW(el.size()), sW(el.size()), v_apo(el.size()),
+          q(el.size())
+    {
+        for (std::size_t n = 0u; n < el.size(); ++n) {
+            ra[n] = el.a[n] * (1. + el.e[n]);
+            rp[n] = el.a[n] * (1. - el.e[n]);
+            ci[n] = std::cos(el.i[n]);
+            si[n] = std::sin(el.i[n]);
+            cW[n] = std::cos(el.W[n]);
+            sW[n] = std::sin(el.W[n]);
+            // Velocity at the apocenter and (non dimensional) at the pericenter
+            v_apo[n] = std::sqrt(el.mu * (2. / ra[n] - 1. / el.a[n]));
+            q[n] = std::sqrt(2. / rp[n] - 1. / el.a[n]);
+        }
+    }
+    std::vector<double> ra, rp, ci, si, cW, sW, v_apo, q;
+};
+
+// Three impulses DVs from the row orbit r to the column orbits [b, e). The two strategies of
+// kep_toolbox::three_impulses_approx are the same manoeuvre with the roles of the orbits swapped: the plane change
+// and the burn to the transfer orbit are combined at the larger apocenter R, the remaining burn is at the pericenter
+// P of the other orbit. The terms of the column are all loaded and then selected, so that the loop has no control
+// flow: built with -fno-math-errno (see CMakeLists.txt), GCC vectorizes it.
+template <typename T>
+void row_costs(const orbit_terms &from, std::size_t r, const orbit_terms &to, std::size_t b, std::size_t e,
+               double mu, T *out)
+{
+    const double sqrt_mu = std::sqrt(mu);
+    const double ra1 = from.ra[r], rp1 = from.rp[r], ci1 = from.ci[r], si1 = from.si[r], cW1 = from.cW[r],
+                 sW1 = from.sW[r], v1 = from.v_apo[r], q1 = from.q[r];
+    for (std::size_t c = b; c < e; ++c) {
+        const double ra2 = to.ra[c], rp2 = to.rp[c], v2 = to.v_apo[c], q2 = to.q[c];
+        const double cos_rel = ci1 * to.ci[c] + si1 * to.si[c] * (cW1 * to.cW[c] + sW1 * to.sW[c]);
+        const bool apo_first = ra1 > ra2;
+        const double R = apo_first ? ra1 : ra2;
+        const double P = apo_first ? rp2 : rp1;
+        const double v_orbit = apo_first ? v1 : v2;
+        const double q_orbit = apo_first ? q2 : q1;
+        const double v_transfer = std::sqrt(mu * (2. / R - 2. / (P + R)));
+        const double dv_plane
+            = std::sqrt(std::abs(v_orbit * v_orbit + v_transfer * v_transfer - 2. * v_orbit * v_transfer * cos_rel));
+        const double dv_peri = sqrt_mu * std::abs(std::sqrt(2. / P - 2. / (P + R)) - q_orbit);
+        out[c - b] = static_cast<T>(dv_plane + dv_peri);
+    }
+}
+
+void check_catalogs(const soa_elements &from, const soa_elements &to)
+{
+    for (const auto el : {&from, &to}) {
+        for (auto v : {&el->e, &el->i, &el->W}) {
+            if (v->size() != el->a.size()) {
+                throw_value_error("The arrays of the orbital elements must have the same size");
+            }
+        }
+    }
+    if (from.mu != to.mu || (from.size() && !(from.mu > 0.))) {
+        throw_value_error("The catalogs must have the same (positive) central body gravitational parameter");
+    }
+}
+} // namespace
+
+/// Constructor from a list of planets
+/**
+ * \param[in] planets the planets (the elements are computed on clones, so that the list may contain the same planet
+ * more than once)
+ * \param[in] mjd2000 the epoch of the osculating elements
+ * \param[in] n_threads number of threads computing the elements (0 means all the available cores)
+ *
+ * \throws value_error if the planets do not orbit the same central body
+ */
+soa_elements::soa_elements(const std::vector<planet::planet_ptr> &planets, double mjd2000, unsigned n_threads)
+{
+    resize(planets.size());
+    mu = planets.size() ? planets[0]->get_mu_central_body() : 0.;
+    for (const auto &p : planets) {
+        if (p->get_mu_central_body() != mu) {
+            throw_value_error("All planets must orbit the same central body");
+        }
+    }
+    // The elements are computed on clones, as a planet may appear more than once in the list and the ephemerides
+    // of some planets (e.g. planet::tle) are not reentrant
+    util::parallel_for(0u, planets.size(),
+                       [&](std::size_t b, std::size_t e) {
+                           for (std::size_t n = b; n < e; ++n) {
+                               const auto el = planets[n]->clone()->compute_elements(epoch(mjd2000));
+                               a[n] = el[0];
+                               this->e[n] = el[1];
+                               i[n] = el[2];
+                               W[n] = el[3];
+                               w[n] = el[4];
+                               M[n] = el[5];
+                           }
+                       },
+                       n_threads);
+}
+
+/// Resizes all the arrays
+/**
+ * \param[in] n the number of orbits
+ */
+void soa_elements::resize(std::size_t n)
+{
+    for (auto v : {&a, &e, &i, &W, &w, &M}) {
+        v->resize(n);
+    }
+}
+
+/// Number of orbits
+/**
+ * @return the size of the arrays
+ */
+std::size_t soa_elements::size() const
+{
+    return a.size();
+}
+
+/// Three impulses transfer cost matrix
+/**
+ * Computes kep_toolbox::three_impulses_approx (the DV of the transfer matching apocenter, pericenter and orbital
+ * plane, m/s) from each orbit of a catalog to each orbit of another one. Only a, e, i and W are used. The per-orbit
+ * terms are computed once, the matrix is swept in tiles of rows and columns and the tiles of rows are computed in
+ * parallel. Results agree with the scalar function to round-off.
+ *
+ * \param[in] from the departure orbits (N)
+ * \param[in] to the arrival orbits (M)
+ * \param[out] dv the N x M row-major matrix of the DVs (m/s)
+ * \param[in] n_threads number of threads (0 means all the available cores)
+ *
+ * \throws value_error if the arrays have different sizes or the catalogs different central bodies
+ */
+void three_impulses_matrix(const soa_elements &from, const soa_elements &to, std::vector<float> &dv,
+                           unsigned n_threads)
+{
+    check_catalogs(from, to);
+    const orbit_terms f(from), t(to);
+    const std::size_t n = from.size(), m = to.size();
+    dv.resize(n * m);
+    util::parallel_for(0u, (n + row_tile - 1u) / row_tile,
+                       [&](std::size_t b, std::size_t e) {
+                           for (std::size_t rt = b; rt < e; ++rt) {
+                               const std::size_t r_end = std::min(n, (rt + 1u) * row_tile);
+                               for (std::size_t c = 0u; c < m; c += col_tile) {
+                                   for (std::size_t r = rt * row_tile; r < r_end; ++r) {
+                                       row_costs(f, r, t, c, std::min(m, c + col_tile), from.mu, &dv[r * m + c]);
+                                   }
+                               }
+                           }
+                       },
+                       n_threads, 1u);
+}
+
+/// Cheapest three impulses transfers from each orbit of a catalog
+/**
+ * As three_impulses_matrix, but only the k cheapest transfers of each row are kept, so that the memory is linear in
+ * the size of the catalogs (e.g. to build the graph of the preliminary design of a multiple rendezvous mission).
+ * Rows with less than k candidates are padded with the index M and an infinite DV.
+ *
+ * \param[in] from the departure orbits (N)
+ * \param[in] to the arrival orbits (M)
+ * \param[in] k the number of transfers per row
+ * \param[out] ids the N x k row-major matrix of the indices in to of the cheapest transfers, sorted by DV (ties by
+ * index)
+ * \param[out] dv the N x k row-major matrix of their DVs (m/s)
+ * \param[in] exclude_self if true the transfer from r to r is not considered (from and to being the same catalog)
+ * \param[in] n_threads number of threads (0 means all the available cores)
+ *
+ * \throws value_error if the arrays have different sizes or the catalogs different central bodies
+ */
+void three_impulses_knn(const soa_elements &from, const soa_elements &to, std::size_t k,
+                        std::vector<std::size_t> &ids, std::vector<float> &dv, bool exclude_self, unsigned n_threads)
+{
+    check_catalogs(from, to);
+    const orbit_terms f(from), t(to);
+    const std::size_t n = from.size(), m = to.size();
+    ids.assign(n * k, m);
+    dv.assign(n * k, std::numeric_limits<float>::infinity());
+    if (k == 0u) {
+        return;
+    }
+    util::parallel_for(0u, (n + row_tile - 1u) / row_tile,
+                       [&](std::size_t b, std::size_t e) {
+                           typedef std::pair<double, std::size_t> candidate;
+                           std::vector<double> costs(row_tile * col_tile);
+                           std::vector<std::priority_queue<candidate>> heaps(row_tile);
+                           for (std::size_t rt = b; rt < e; ++rt) {
+                               const std::size_t r_begin = rt * row_tile, r_end = std::min(n, r_begin + row_tile);
+                               for (std::size_t c = 0u; c < m; c += col_tile) {
+                                   const std::size_t c_end = std::min(m, c + col_tile);
+                                   for (std::size_t r = r_begin; r < r_end; ++r) {
+                                       double *row = &costs[(r - r_begin) * col_tile];
+                                       row_costs(f, r, t, c, c_end, from.mu, row);
+                                       auto &heap = heaps[r - r_begin];
+                                       for (std::size_t j = c; j < c_end; ++j) {
+                                           if (exclude_self && j == r) {
+                                               continue;
+                                           }
+                                           const candidate cand(row[j - c], j);
+                                           if (heap.size() < k) {
+                                               heap.push(cand);
+                                           } else if (cand < heap.top()) {
+                                               heap.pop();
+                                               heap.push(cand);
+                                           }
+                                       }
+                                   }
+                               }
+                               for (std::size_t r = r_begin; r < r_end; ++r) {
+                                   auto &heap = heaps[r - r_begin];
+                                   for (std::size_t s = heap.size(); s > 0u; --s) {
+                                       ids[r * k + s - 1u] = heap.top().second;
+                                       dv[r * k + s - 1u] = static_cast<float>(heap.top().first);
+                                       heap.pop();
+                                   }
+                               }
+                           }
+                       },
+                       n_threads, 1u);
+}
+} // namespace phasing
+} // namespace kep_toolbox
@@ -98,6 +98,32 @@ void base::eph(const double mjd2000, array3D &r, array3D &v) const
     this->eph_impl(mjd2000, r, v);
 }
 
+/// Gets the planet positions and velocities at many mjd2000
+/**
+* Output vectors are resized to the number of requested epochs. Derived classes whose
+* ephemerides have a per-call overhead (e.g. acquiring a lock) can override eph_batch_impl
+* to pay it only once per batch.
+*
+* \param[in]  mjd2000s epochs (mjd2000) in which ephemerides are required
+* \param[out] r Planet positions at the epochs (SI units)
+* \param[out] v Planet velocities at the epochs (SI units)
+*/
+void base::eph(const std::vector<double> &mjd2000s, std::vector<array3D> &r, std::vector<array3D> &v) const
+{
+    r.resize(mjd2000s.size());
+    v.resize(mjd2000s.size());
+    this->eph_batch_impl(mjd2000s, r, v);
+}
+
+/// Default batch ephemerides: one call to eph_impl per epoch
+void base::eph_batch_impl(const std::vector<double> &mjd2000s, std::vector<array3D> &r,
+                          std::vector<array3D> &v) const
+{
+    for (size_t i = 0; i < mjd2000s.size(); ++i) {
+        this->eph_impl(mjd2000s[i], r[i], v[i]);
+    }
+}
+
 /// Computes the orbital period of the planet at epoch
 /**
 * \param[in]  when mjd2000 in which ephemerides are required
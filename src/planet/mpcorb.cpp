@@ -118,23 +118,47 @@ mpcorb::mpcorb(const std::string &line)
 
     m_year_of_discovery = boost::lexical_cast<unsigned int>(tmp);
 
-    // Now we estimate the asteroid radius, safe_radius and gravity parametes with hyper simplified assumptions
-    double radius = 1329000 * std::pow(10, -m_H * 0.2); // This is assuming an albedo of 0.25
-                                                        // (www.physics.sfasu.edu/astro/asteroids/sizemagnitude.html)
-    double mu_planet = 4. / 3. * M_PI * std::pow(radius, 3) * 2800 * ASTRO_CAVENDISH;
-
     // Record asteroid name.
     tmp.clear();
     tmp.append(&linecopy[mpcorb_format[7][0]], mpcorb_format[7][1]);
     boost::algorithm::trim(tmp);
 
+    setup(elem, epoch, tmp);
+}
+
+/**
+ * Construct a minor planet from data already parsed from MPCORB.DAT (e.g. by kep_toolbox::catalog::mpcorb_catalog).
+ * \param[in] elem keplerian elements (SI units)
+ * \param[in] ref_epoch epoch of the elements
+ * \param[in] H absolute magnitude
+ * \param[in] n_observations number of observations
+ * \param[in] n_oppositions number of oppositions
+ * \param[in] year_of_discovery year of first observation
+ * \param[in] name asteroid readable name
+ */
+mpcorb::mpcorb(const array6D &elem, const kep_toolbox::epoch &ref_epoch, double H, unsigned n_observations,
+               unsigned n_oppositions, unsigned year_of_discovery, const std::string &name)
+    : m_H(H), m_n_observations(n_observations), m_n_oppositions(n_oppositions),
+      m_year_of_discovery(year_of_discovery)
+{
+    setup(elem, ref_epoch, name);
+}
+
+// Sets the base and keplerian data. Requires m_H to be set.
+void mpcorb::setup(const array6D &elem, const kep_toolbox::epoch &ref_epoch, const std::string &name)
+{
+    // Now we estimate the asteroid radius, safe_radius and gravity parametes with hyper simplified assumptions
+    double radius = 1329000 * std::pow(10, -m_H * 0.2); // This is assuming an albedo of 0.25
+                                                        // (www.physics.sfasu.edu/astro/asteroids/sizemagnitude.html)
+    double mu_planet = 4. / 3. * M_PI * std::pow(radius, 3) * 2800 * ASTRO_CAVENDISH;
+
     set_mu_central_body(ASTRO_MU_SUN);
     set_mu_self(mu_planet);
     set_radius(radius);
     set_safe_radius(1.1);
-    set_name(tmp);
+    set_name(name);
     set_elements(elem);
-    set_ref_epoch(epoch);
+    set_ref_epoch(ref_epoch);
 }
 
 kep_toolbox::epoch mpcorb::packed_date2epoch(std::string in)
@@ -23,6 +23,11 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
  *****************************************************************************/
 
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+
 #include <keplerian_toolbox/planet/spice.hpp>
 #include <keplerian_toolbox/exceptions.hpp>
 
@@ -30,6 +35,31 @@ namespace kep_toolbox
 {
 namespace planet
 {
+
+namespace
+{
+// Per-thread, direct-mapped cache of the latest ephemerides computed by SPICE. Entries are valid only
+// for the kernel pool generation they were computed with. An id of zero marks an empty entry.
+struct eph_cache_entry {
+    unsigned long long id;
+    unsigned long long generation;
+    double mjd2000;
+    array3D r;
+    array3D v;
+};
+
+const std::size_t eph_cache_size = 16u;
+thread_local eph_cache_entry eph_cache[eph_cache_size];
+
+eph_cache_entry &eph_cache_slot(unsigned long long id, double mjd2000)
+{
+    std::uint64_t bits;
+    std::memcpy(&bits, &mjd2000, sizeof(bits));
+    std::uint64_t h = (bits ^ (id * 0x9E3779B97F4A7C15ull)) * 0xBF58476D1CE4E5B9ull;
+    return eph_cache[(h >> 59) % eph_cache_size];
+}
+} // namespace
+
 /// Constructor
 /** \param[in] mu_central_body gravitational parameter of the central attracting body [m^3/sec^2]
  * \param[in] mu_self gravitational parameter of the body [m^3/sec^2]
@@ -40,12 +70,21 @@ namespace planet
 spice::spice(const std::string &target, const std::string &observer, const std::string &reference_frame,
              const std::string &aberrations, double mu_central_body, double mu_self, double radius, double safe_radius)
     : base(mu_central_body, mu_self, radius, safe_radius, target + ", " + observer + ", " + reference_frame),
-      m_target(target), m_observer(observer), m_reference_frame(reference_frame), m_aberrations(aberrations)
+      m_target(target), m_observer(observer), m_reference_frame(reference_frame), m_aberrations(aberrations),
+      m_id(new_id())
 {
+    std::lock_guard<std::mutex> lock(util::spice_mutex());
     /// Transferring error handling from SPICE to kep_toolbox
     erract_c("SET", 0, const_cast<char *>("RETURN"));
 }
 
+/// Unique (non zero) identifier for a new SPICE query
+unsigned long long spice::new_id()
+{
+    static std::atomic<unsigned long long> counter(0u);
+    return ++counter;
+}
+
 /// Polymorphic copy constructor.le::clone() const
 planet_ptr spice::clone() const
 {
@@ -54,15 +93,43 @@ planet_ptr spice::clone() const
 
 void spice::eph_impl(double mjd2000, array3D &r, array3D &v) const
 {
+    eph_cache_entry &entry = eph_cache_slot(m_id, mjd2000);
+    if (entry.id == m_id && entry.mjd2000 == mjd2000 && entry.generation == util::spice_kernel_generation()) {
+        r = entry.r;
+        v = entry.v;
+        return;
+    }
+    unsigned long long generation;
+    {
+        std::lock_guard<std::mutex> lock(util::spice_mutex());
+        // Read under the lock, so that it is consistent with the kernel pool used.
+        generation = util::spice_kernel_generation();
+        spkezr_locked(mjd2000, r, v);
+    }
+    entry.id = m_id;
+    entry.generation = generation;
+    entry.mjd2000 = mjd2000;
+    entry.r = r;
+    entry.v = v;
+}
+
+void spice::eph_batch_impl(const std::vector<double> &mjd2000s, std::vector<array3D> &r,
+                           std::vector<array3D> &v) const
+{
+    std::lock_guard<std::mutex> lock(util::spice_mutex());
+    for (size_t i = 0; i < mjd2000s.size(); ++i) {
+        spkezr_locked(mjd2000s[i], r[i], v[i]);
+    }
+}
+
+// Calls spkezr_c and handles its errors. The caller must hold util::spice_mutex().
+void spice::spkezr_locked(double mjd2000, array3D &r, array3D &v) const
+{
+    SpiceDouble state[6];
+    SpiceDouble lt;
     SpiceDouble spice_epoch = kep_toolbox::util::epoch_to_spice(mjd2000);
     spkezr_c(m_target.c_str(), spice_epoch, m_reference_frame.c_str(), m_aberrations.c_str(), m_observer.c_str(),
-             m_state, &m_lt);
-    r[0] = m_state[0] * 1000;
-    r[1] = m_state[1] * 1000;
-    r[2] = m_state[2] * 1000;
-    v[0] = m_state[3] * 1000;
-    v[1] = m_state[4] * 1000;
-    v[2] = m_state[5] * 1000;
+             state, &lt);
     /// Handling errors
     if (failed_c()) {
         std::ostringstream msg;
@@ -70,6 +137,12 @@ void spice::eph_impl(double mjd2000, array3D &r, array3D &v) const
         reset_c();
         throw_value_error(msg.str());
     }
+    r[0] = state[0] * 1000;
+    r[1] = state[1] * 1000;
+    r[2] = state[2] * 1000;
+    v[0] = state[3] * 1000;
+    v[1] = state[4] * 1000;
+    v[2] = state[5] * 1000;
 }
 
 /// Extra informations streamed in human readable format
@@ -23,21 +23,119 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
  *****************************************************************************/
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <numeric>
 #include <vector>
 
 #include <keplerian_toolbox/astro_constants.hpp>
 #include <keplerian_toolbox/core_functions/array3D_operations.hpp>
+#include <keplerian_toolbox/core_functions/closest_distance_soa.hpp>
 #include <keplerian_toolbox/core_functions/propagate_lagrangian.hpp>
+#include <keplerian_toolbox/core_functions/propagate_lagrangian_stm.hpp>
+#include <keplerian_toolbox/core_functions/propagate_taylor_variational.hpp>
 #include <keplerian_toolbox/exceptions.hpp>
 #include <keplerian_toolbox/sims_flanagan/leg.hpp>
 #include <keplerian_toolbox/sims_flanagan/sc_state.hpp>
+#include <keplerian_toolbox/util/trajectory_sampling.hpp>
 
 namespace kep_toolbox
 {
 namespace sims_flanagan
 {
 
+namespace
+{
+// Chains the Jacobian j (7 rows and n_cols columns, by rows) of the state (r, v, m) with respect to the leg
+// decision vector through a step X' = F(X, u, tau), where u is the throttle starting at column col_u and tau a
+// time with derivatives dtau_dti and dtau_dtf with respect to the leg epochs:
+// j <- A j + B (at the throttle columns) + c dtau/d(t_i, t_f). A is 7x7, B 7x3 (by rows) and c has size 7.
+void chain_step(std::vector<double> &j, std::size_t n_cols, const std::array<double, 49> &A,
+                const std::array<double, 21> &B, std::size_t col_u, const std::array<double, 7> &c, double dtau_dti,
+                double dtau_dtf, std::vector<double> &tmp)
+{
+    tmp.assign(7u * n_cols, 0.);
+    for (std::size_t i = 0u; i < 7u; ++i) {
+        for (std::size_t k = 0u; k < 7u; ++k) {
+            const double a = A[i * 7u + k];
+            if (a == 0.) {
+                continue;
+            }
+            for (std::size_t col = 0u; col < n_cols; ++col) {
+                tmp[i * n_cols + col] += a * j[k * n_cols + col];
+            }
+        }
+        for (std::size_t l = 0u; l < 3u; ++l) {
+            tmp[i * n_cols + col_u + l] += B[i * 3u + l];
+        }
+        tmp[i * n_cols] += c[i] * dtau_dti;
+        tmp[i * n_cols + n_cols - 8u] += c[i] * dtau_dtf;
+    }
+    j.swap(tmp);
+}
+
+// Keplerian propagation of (r, v) for dt seconds, chained into j.
+void chain_kepler(array3D &r, array3D &v, double dt, double mu, std::vector<double> &j, std::size_t n_cols,
+                  double ddt_dti, double ddt_dtf, std::vector<double> &tmp)
+{
+    std::array<double, 36> stm;
+    propagate_lagrangian_stm(r, v, dt, mu, stm);
+    std::array<double, 49> A;
+    A.fill(0.);
+    for (std::size_t i = 0u; i < 6u; ++i) {
+        for (std::size_t k = 0u; k < 6u; ++k) {
+            A[i * 7u + k] = stm[i * 6u + k];
+        }
+    }
+    A[48] = 1.;
+    std::array<double, 21> B;
+    B.fill(0.);
+    const double r3 = std::pow(norm(r), 3);
+    std::array<double, 7> c = {{v[0], v[1], v[2], -mu * r[0] / r3, -mu * r[1] / r3, -mu * r[2] / r3, 0.}};
+    chain_step(j, n_cols, A, B, 0u, c, ddt_dti, ddt_dtf, tmp);
+}
+
+// Impulse dv = sign * max_thrust * dur * u / m, with the mass update of the Sims-Flanagan leg, chained into j.
+void chain_impulse(array3D &v, double &m, const array3D &u, double dur, double sign, double max_thrust, double veff,
+                   std::vector<double> &j, std::size_t n_cols, std::size_t col_u, double ddur_dti, double ddur_dtf,
+                   std::vector<double> &tmp)
+{
+    array3D dv, ddv_ddur;
+    for (unsigned k = 0u; k < 3u; ++k) {
+        dv[k] = sign * max_thrust / m * dur * u[k];
+        ddv_ddur[k] = sign * max_thrust / m * u[k];
+    }
+    const double norm_dv = norm(dv);
+    const double E = std::exp(-sign * norm_dv / veff);
+    const double dm_dnorm = -sign * m * E / veff;
+    // The norm is not differentiable at zero, its derivatives are set to zero there
+    const double inv_norm = (norm_dv > 0.) ? 1. / norm_dv : 0.;
+
+    std::array<double, 49> A;
+    A.fill(0.);
+    for (std::size_t i = 0u; i < 7u; ++i) {
+        A[i * 7u + i] = 1.;
+    }
+    std::array<double, 21> B;
+    B.fill(0.);
+    std::array<double, 7> c;
+    c.fill(0.);
+    for (unsigned k = 0u; k < 3u; ++k) {
+        A[(3u + k) * 7u + 6u] = -dv[k] / m;
+        B[(3u + k) * 3u + k] = sign * max_thrust / m * dur;
+        c[3u + k] = ddv_ddur[k];
+        B[18u + k] = dm_dnorm * dv[k] * inv_norm * sign * max_thrust / m * dur;
+    }
+    A[48] = E * (1. + sign * norm_dv / veff);
+    c[6] = dm_dnorm * (dv[0] * ddv_ddur[0] + dv[1] * ddv_ddur[1] + dv[2] * ddv_ddur[2]) * inv_norm;
+    chain_step(j, n_cols, A, B, col_u, c, ddur_dti, ddur_dtf, tmp);
+
+    sum(v, v, dv);
+    m *= E;
+}
+} // namespace
+
 std::string leg::human_readable() const
 {
     std::ostringstream s;
@@ -94,5 +192,386 @@ std::ostream &operator<<(std::ostream &s, const leg &in)
     s << "]";
     return s;
 }
+
+/// Keplerian arcs of the impulsive model
+/**
+ * Computes the two Keplerian arcs of each segment, before and after its impulse. As in get_mismatch_con, the first
+ * half of the segments is propagated forward from the initial state and the second half backward from the final
+ * state, so that the arcs of the two halves do not join at the match point.
+ *
+ * \param[out] a the arcs, in chronological order
+ */
+void leg::get_impulsive_arcs(impulsive_arcs &a) const
+{
+    const std::size_t n_seg = throttles.size();
+    const std::size_t n_seg_fwd = (n_seg + 1u) / 2u, n_seg_back = n_seg / 2u;
+    for (soa3D *x : {&a.r0, &a.v0, &a.r1, &a.v1}) {
+        detail::soa_resize(*x, 2u * n_seg);
+    }
+    a.t0.resize(2u * n_seg);
+    a.t1.resize(2u * n_seg);
+    a.m.resize(2u * n_seg);
+    auto store = [](soa3D &r_soa, soa3D &v_soa, std::size_t k, const array3D &r, const array3D &v) {
+        for (unsigned j = 0u; j < 3u; ++j) {
+            r_soa[j][k] = r[j];
+            v_soa[j][k] = v[j];
+        }
+    };
+    double max_thrust, isp;
+    array3D dv;
+
+    // Forward propagation
+    array3D r = x_i.get_position(), v = x_i.get_velocity();
+    double m = x_i.get_mass();
+    double current_time = t_i.mjd2000() * ASTRO_DAY2SEC;
+    for (std::size_t i = 0u; i < n_seg_fwd; ++i) {
+        const double start = throttles[i].get_start().mjd2000() * ASTRO_DAY2SEC;
+        const double end = throttles[i].get_end().mjd2000() * ASTRO_DAY2SEC;
+        const double manouver_time = (start + end) / 2.;
+        a.t0[2u * i] = current_time;
+        a.t1[2u * i] = manouver_time;
+        a.m[2u * i] = m;
+        store(a.r0, a.v0, 2u * i, r, v);
+        propagate_lagrangian(r, v, manouver_time - current_time, m_mu);
+        store(a.r1, a.v1, 2u * i, r, v);
+        m_sc.get_thrust_isp(r, max_thrust, isp);
+        for (unsigned j = 0u; j < 3u; ++j) {
+            dv[j] = max_thrust / m * (end - start) * throttles[i].get_value()[j];
+        }
+        sum(v, v, dv);
+        m *= std::exp(-norm(dv) / isp / ASTRO_G0);
+        if (m < 1) m = 1;
+        a.t0[2u * i + 1u] = manouver_time;
+        a.t1[2u * i + 1u] = end;
+        a.m[2u * i + 1u] = m;
+        store(a.r0, a.v0, 2u * i + 1u, r, v);
+        propagate_lagrangian(r, v, end - manouver_time, m_mu);
+        store(a.r1, a.v1, 2u * i + 1u, r, v);
+        current_time = end;
+    }
+
+    // Backward propagation
+    r = x_f.get_position();
+    v = x_f.get_velocity();
+    m = x_f.get_mass();
+    current_time = t_f.mjd2000() * ASTRO_DAY2SEC;
+    for (std::size_t k = 0u; k < n_seg_back; ++k) {
+        const std::size_t i = n_seg - 1u - k;
+        const double start = throttles[i].get_start().mjd2000() * ASTRO_DAY2SEC;
+        const double end = throttles[i].get_end().mjd2000() * ASTRO_DAY2SEC;
+        const double manouver_time = (start + end) / 2.;
+        a.t0[2u * i + 1u] = manouver_time;
+        a.t1[2u * i + 1u] = current_time;
+        a.m[2u * i + 1u] = m;
+        store(a.r1, a.v1, 2u * i + 1u, r, v);
+        propagate_lagrangian(r, v, manouver_time - current_time, m_mu);
+        store(a.r0, a.v0, 2u * i + 1u, r, v);
+        m_sc.get_thrust_isp(r, max_thrust, isp);
+        for (unsigned j = 0u; j < 3u; ++j) {
+            dv[j] = -max_thrust / m * (end - start) * throttles[i].get_value()[j];
+        }
+        sum(v, v, dv);
+        m *= std::exp(norm(dv) / isp / ASTRO_G0);
+        a.t0[2u * i] = start;
+        a.t1[2u * i] = manouver_time;
+        a.m[2u * i] = m;
+        store(a.r1, a.v1, 2u * i, r, v);
+        propagate_lagrangian(r, v, start - manouver_time, m_mu);
+        store(a.r0, a.v0, 2u * i, r, v);
+        current_time = start;
+    }
+}
+
+/// Closest distances along the leg segments
+/**
+ * Computes, for each segment, the closest distance to the primary body along the Keplerian arcs before and after
+ * its impulse (see get_impulsive_arcs). All the arcs are evaluated at once by closest_distance_soa.
+ *
+ * \param[out] d_min the closest distance along each segment
+ *
+ * \throws value_error if high-fidelity propagation is on, as the thrust arcs are then not Keplerian
+ */
+void leg::get_closest_distances(std::vector<double> &d_min) const
+{
+    if (m_hf) {
+        throw_value_error("The closest distances are only available when high-fidelity propagation is off");
+    }
+    const std::size_t n_seg = throttles.size();
+    impulsive_arcs a;
+    get_impulsive_arcs(a);
+    std::vector<double> d, ra;
+    closest_distance_soa(d, ra, a.r0, a.v0, a.r1, a.v1, std::vector<double>(2u * n_seg, m_mu));
+    d_min.resize(n_seg);
+    for (std::size_t i = 0u; i < n_seg; ++i) {
+        d_min[i] = std::min(d[2u * i], d[2u * i + 1u]);
+    }
+}
+
+/// Samples the leg trajectory
+/**
+ * Samples the trajectory with N points along each half of each segment: the Keplerian arcs before and after the
+ * impulses (see get_impulsive_arcs) or, when high-fidelity propagation is on, the two halves of the thrust arcs. As in
+ * get_mismatch_con, the first half of the segments is propagated forward from the initial state and the second half
+ * backward from the final state. The samples are stored in chronological order, arcs \f$ 2i\f$ and \f$ 2i + 1\f$
+ * being the two halves of segment \f$ i\f$, so the last sample of an arc and the first of the next one differ by the
+ * impulse (or, at the match point, by the state mismatch).
+ *
+ * \param[in] N the number of samples along each arc
+ * \param[out] r the positions, \f$ 2 N n_{seg}\f$ samples
+ * \param[out] v the velocities
+ * \param[out] m the masses
+ *
+ * \throws value_error if N is smaller than two
+ */
+void leg::sample_trajectory(unsigned N, std::vector<array3D> &r, std::vector<array3D> &v, std::vector<double> &m) const
+{
+    const std::size_t n_seg = throttles.size();
+    const std::size_t n_seg_fwd = (n_seg + 1u) / 2u, n_seg_back = n_seg / 2u;
+    r.resize(2u * n_seg * N);
+    v.resize(2u * n_seg * N);
+    m.resize(2u * n_seg * N);
+    std::vector<array3D> r_arc, v_arc;
+    std::vector<double> m_arc;
+    // Stores the samples of an arc (in reverse order for the backward arcs)
+    auto store = [&](std::size_t arc, bool fwd) {
+        for (std::size_t j = 0u; j < N; ++j) {
+            const std::size_t k = arc * N + (fwd ? j : N - 1u - j);
+            r[k] = r_arc[j];
+            v[k] = v_arc[j];
+            m[k] = m_arc[j];
+        }
+    };
+
+    if (!m_hf) {
+        impulsive_arcs a;
+        get_impulsive_arcs(a);
+        // Each arc is sampled from the state it was propagated from
+        for (std::size_t arc = 0u; arc < 2u * n_seg; ++arc) {
+            const bool fwd = arc < 2u * n_seg_fwd;
+            const soa3D &r_s = fwd ? a.r0 : a.r1, &v_s = fwd ? a.v0 : a.v1;
+            const array3D r0{{r_s[0][arc], r_s[1][arc], r_s[2][arc]}}, v0{{v_s[0][arc], v_s[1][arc], v_s[2][arc]}};
+            util::sample_kepler(r0, v0, fwd ? a.t1[arc] - a.t0[arc] : a.t0[arc] - a.t1[arc], m_mu, N, r_arc, v_arc);
+            m_arc.assign(N, a.m[arc]);
+            store(arc, fwd);
+        }
+        return;
+    }
+
+    // Samples the two halves of the thrust arc of segment i starting from r_s, v_s, m_s (at the end of the segment if
+    // fwd is false)
+    auto sample_segment = [&](std::size_t i, bool fwd, array3D &r_s, array3D &v_s, double &m_s) {
+        const double sign = fwd ? 1. : -1.;
+        const double start = throttles[i].get_start().mjd2000() * ASTRO_DAY2SEC;
+        const double end = throttles[i].get_end().mjd2000() * ASTRO_DAY2SEC;
+        double max_thrust, isp;
+        array3D thrust;
+        m_sc.get_thrust_isp(r_s, max_thrust, isp);
+        for (unsigned j = 0u; j < 3u; ++j) {
+            thrust[j] = max_thrust * throttles[i].get_value()[j];
+        }
+        for (std::size_t arc : {fwd ? 2u * i : 2u * i + 1u, fwd ? 2u * i + 1u : 2u * i}) {
+            util::sample_taylor(r_s, v_s, m_s, thrust, sign * (end - start) / 2., m_mu, isp * ASTRO_G0, N, r_arc,
+                                v_arc, m_arc, m_tol, m_tol);
+            store(arc, fwd);
+            r_s = r_arc.back();
+            v_s = v_arc.back();
+            m_s = m_arc.back();
+        }
+    };
+    array3D r_s = x_i.get_position(), v_s = x_i.get_velocity();
+    double m_s = x_i.get_mass();
+    for (std::size_t i = 0u; i < n_seg_fwd; ++i) {
+        sample_segment(i, true, r_s, v_s, m_s);
+    }
+    r_s = x_f.get_position();
+    v_s = x_f.get_velocity();
+    m_s = x_f.get_mass();
+    for (std::size_t k = 0u; k < n_seg_back; ++k) {
+        sample_segment(n_seg - 1u - k, false, r_s, v_s, m_s);
+    }
+}
+
+/// Jacobian of the leg constraints
+/**
+ * Computes the Jacobian of the constraints returned by get_mismatch_con (7 rows) and get_throttles_con (one row
+ * per segment) with respect to the leg decision vector \f$ (t_i, \mathbf x_i, x_1, y_1, z_1, ..., x_N, y_N, z_N,
+ * t_f, \mathbf x_f) \f$, where the epochs are in days and the sc_states are \f$ \mathbf r, \mathbf v, m\f$.
+ *
+ * The derivatives are analytical. When high-fidelity propagation is off, the state transition matrices of the
+ * Keplerian arcs are chained with the partials of the impulses. When it is on, the variational equations are
+ * integrated along each thrust arc together with the Taylor propagation (see propagate_taylor_variational).
+ *
+ * The throttle epochs are assumed to move with \f$ t_i \f$ and \f$ t_f\f$ keeping their relative position
+ * in the leg, as is the case for the equally spaced segments created by set_leg.
+ *
+ * \param[out] jac the dense Jacobian, \f$ (7 + N) \times (3N + 16)\f$, stored by rows
+ *
+ * \throws value_error if the final epoch is not after the initial one, or if the propulsion model of the
+ * spacecraft is not constant
+ */
+void leg::get_constraints_jacobian(std::vector<double> &jac) const
+{
+    const double T = t_f.mjd2000() - t_i.mjd2000();
+    if (!(T > 0.)) {
+        throw_value_error("Final epoch is before initial epoch");
+    }
+    if (m_sc.get_propulsion_model().get_type() != propulsion_model::CONSTANT) {
+        throw_value_error("The constraints Jacobian is only available for a constant propulsion model");
+    }
+    const std::size_t n_seg = throttles.size();
+    const std::size_t n_seg_fwd = (n_seg + 1u) / 2u, n_seg_back = n_seg / 2u;
+    const std::size_t n_cols = 3u * n_seg + 16u;
+    const double max_thrust = m_sc.get_thrust();
+    const double veff = m_sc.get_isp() * ASTRO_G0;
+    // Relative position of an epoch in the leg
+    auto beta = [this, T](const epoch &e) { return (e.mjd2000() - t_i.mjd2000()) / T; };
+
+    std::vector<double> jfwd(7u * n_cols, 0.), jback(7u * n_cols, 0.), tmp;
+    for (std::size_t i = 0u; i < 7u; ++i) {
+        jfwd[i * n_cols + 1u + i] = 1.;
+        jback[i * n_cols + n_cols - 7u + i] = 1.;
+    }
+    array3D rfwd = x_i.get_position(), vfwd = x_i.get_velocity();
+    double mfwd = x_i.get_mass();
+    array3D rback = x_f.get_position(), vback = x_f.get_velocity();
+    double mback = x_f.get_mass();
+
+    if (m_hf) {
+        std::array<double, 77> local;
+        std::array<double, 49> A;
+        std::array<double, 21> B;
+        std::array<double, 7> c;
+        for (std::size_t k = 0u; k < n_seg_fwd + n_seg_back; ++k) {
+            const bool fwd = k < n_seg_fwd;
+            const std::size_t seg = fwd ? k : n_seg - 1u - (k - n_seg_fwd);
+            const throttle &th = throttles[seg];
+            const double dur = (th.get_end().mjd2000() - th.get_start().mjd2000()) * ASTRO_DAY2SEC;
+            const double dbeta = beta(th.get_end()) - beta(th.get_start());
+            array3D thrust;
+            for (unsigned l = 0u; l < 3u; ++l) {
+                thrust[l] = max_thrust * th.get_value()[l];
+            }
+            if (fwd) {
+                propagate_taylor_variational(rfwd, vfwd, mfwd, thrust, dur, m_mu, veff, local, m_tol, m_tol);
+            } else {
+                propagate_taylor_variational(rback, vback, mback, thrust, -dur, m_mu, veff, local, m_tol, m_tol);
+            }
+            for (std::size_t i = 0u; i < 7u; ++i) {
+                for (std::size_t l = 0u; l < 7u; ++l) {
+                    A[i * 7u + l] = local[i * 11u + l];
+                }
+                for (std::size_t l = 0u; l < 3u; ++l) {
+                    B[i * 3u + l] = max_thrust * local[i * 11u + 7u + l];
+                }
+                c[i] = fwd ? local[i * 11u + 10u] : -local[i * 11u + 10u];
+            }
+            chain_step(fwd ? jfwd : jback, n_cols, A, B, 8u + 3u * seg, c, -ASTRO_DAY2SEC * dbeta,
+                       ASTRO_DAY2SEC * dbeta, tmp);
+        }
+    } else {
+        // Forward propagation
+        double current_fwd = t_i.mjd2000(), beta_fwd = 0.;
+        for (std::size_t i = 0u; i < n_seg_fwd; ++i) {
+            const throttle &th = throttles[i];
+            const double manouver = (th.get_start().mjd2000() + th.get_end().mjd2000()) / 2.;
+            const double beta_m = (beta(th.get_start()) + beta(th.get_end())) / 2.;
+            chain_kepler(rfwd, vfwd, (manouver - current_fwd) * ASTRO_DAY2SEC, m_mu, jfwd, n_cols,
+                         ASTRO_DAY2SEC * (beta_fwd - beta_m), ASTRO_DAY2SEC * (beta_m - beta_fwd), tmp);
+            current_fwd = manouver;
+            beta_fwd = beta_m;
+            const double dur = (th.get_end().mjd2000() - th.get_start().mjd2000()) * ASTRO_DAY2SEC;
+            const double dbeta = beta(th.get_end()) - beta(th.get_start());
+            chain_impulse(vfwd, mfwd, th.get_value(), dur, 1., max_thrust, veff, jfwd, n_cols, 8u + 3u * i,
+                          -ASTRO_DAY2SEC * dbeta, ASTRO_DAY2SEC * dbeta, tmp);
+            // As in get_mismatch_con, the mass cannot go below 1
+            if (mfwd < 1) {
+                mfwd = 1;
+                std::fill(jfwd.begin() + 6u * n_cols, jfwd.end(), 0.);
+            }
+        }
+        // Backward propagation
+        double current_back = t_f.mjd2000(), beta_back = 1.;
+        for (std::size_t i = 0u; i < n_seg_back; ++i) {
+            const std::size_t seg = n_seg - i - 1u;
+            const throttle &th = throttles[seg];
+            const double manouver = (th.get_start().mjd2000() + th.get_end().mjd2000()) / 2.;
+            const double beta_m = (beta(th.get_start()) + beta(th.get_end())) / 2.;
+            chain_kepler(rback, vback, (manouver - current_back) * ASTRO_DAY2SEC, m_mu, jback, n_cols,
+                         ASTRO_DAY2SEC * (beta_back - beta_m), ASTRO_DAY2SEC * (beta_m - beta_back), tmp);
+            current_back = manouver;
+            beta_back = beta_m;
+            const double dur = (th.get_end().mjd2000() - th.get_start().mjd2000()) * ASTRO_DAY2SEC;
+            const double dbeta = beta(th.get_end()) - beta(th.get_start());
+            chain_impulse(vback, mback, th.get_value(), dur, -1., max_thrust, veff, jback, n_cols, 8u + 3u * seg,
+                          -ASTRO_DAY2SEC * dbeta, ASTRO_DAY2SEC * dbeta, tmp);
+        }
+        // Keplerian arc to the match point
+        chain_kepler(rfwd, vfwd, (current_back - current_fwd) * ASTRO_DAY2SEC, m_mu, jfwd, n_cols,
+                     ASTRO_DAY2SEC * (beta_fwd - beta_back), ASTRO_DAY2SEC * (beta_back - beta_fwd), tmp);
+    }
+
+    jac.assign((7u + n_seg) * n_cols, 0.);
+    for (std::size_t i = 0u; i < 7u * n_cols; ++i) {
+        jac[i] = jfwd[i] - jback[i];
+    }
+    for (std::size_t i = 0u; i < n_seg; ++i) {
+        for (std::size_t l = 0u; l < 3u; ++l) {
+            jac[(7u + i) * n_cols + 8u + 3u * i + l] = 2. * throttles[i].get_value()[l];
+        }
+    }
+}
+
+/// Sparsity pattern of the leg constraints Jacobian
+/**
+ * Returns the (row, column) indices of the structurally non-zero entries of the Jacobian computed by
+ * get_constraints_jacobian: the position and velocity mismatches depend on the whole decision vector,
+ * the mass mismatch does not depend on positions and velocities (unless the propulsion model of the spacecraft
+ * depends on the position), and each throttle constraint depends only on its own throttle.
+ *
+ * @return the indices of the non-zero entries, sorted by row and column
+ */
+std::vector<std::pair<std::size_t, std::size_t>> leg::get_constraints_jacobian_sparsity() const
+{
+    const std::size_t n_seg = throttles.size();
+    const std::size_t n_cols = 3u * n_seg + 16u;
+    std::vector<std::pair<std::size_t, std::size_t>> retval;
+    for (std::size_t i = 0u; i < 6u; ++i) {
+        for (std::size_t j = 0u; j < n_cols; ++j) {
+            retval.emplace_back(i, j);
+        }
+    }
+    const bool constant_propulsion = m_sc.get_propulsion_model().get_type() == propulsion_model::CONSTANT;
+    for (std::size_t j = 0u; j < n_cols; ++j) {
+        const bool state_column = (j >= 1u && j < 7u) || (j >= n_cols - 7u && j < n_cols - 1u);
+        if (!state_column || !constant_propulsion) {
+            retval.emplace_back(6u, j);
+        }
+    }
+    for (std::size_t i = 0u; i < n_seg; ++i) {
+        for (std::size_t l = 0u; l < 3u; ++l) {
+            retval.emplace_back(7u + i, 8u + 3u * i + l);
+        }
+    }
+    return retval;
+}
+
+/// Sparse Jacobian of the leg constraints
+/**
+ * As get_constraints_jacobian, but only the entries in the pattern returned by get_constraints_jacobian_sparsity
+ * are stored, in the same order.
+ *
+ * \param[out] values the non-zero entries of the Jacobian
+ */
+void leg::get_constraints_jacobian_sparse(std::vector<double> &values) const
+{
+    std::vector<double> jac;
+    get_constraints_jacobian(jac);
+    const std::size_t n_cols = 3u * throttles.size() + 16u;
+    const std::vector<std::pair<std::size_t, std::size_t>> pattern = get_constraints_jacobian_sparsity();
+    values.resize(pattern.size());
+    for (std::size_t k = 0u; k < pattern.size(); ++k) {
+        values[k] = jac[pattern[k].first * n_cols + pattern[k].second];
+    }
+}
 }
 } // namespaces
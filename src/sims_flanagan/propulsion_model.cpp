@@ -0,0 +1,228 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cstddef>
+#include <sstream>
+
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/sims_flanagan/propulsion_model.hpp>
+
+namespace kep_toolbox
+{
+namespace sims_flanagan
+{
+
+namespace
+{
+// Horner evaluation of a polynomial given by its coefficients in increasing degree order
+double polyval(const std::vector<double> &c, double x)
+{
+    double retval = 0.;
+    for (auto it = c.rbegin(); it != c.rend(); ++it) {
+        retval = retval * x + *it;
+    }
+    return retval;
+}
+} // namespace
+
+/// Constructor
+/**
+ * Constructs the constant model: the nominal thrust and specific impulse of the spacecraft are used.
+ */
+propulsion_model::propulsion_model()
+    : m_type(CONSTANT), m_bus_demand(0.), m_efficiency(1.), m_max_power(0.)
+{
+}
+
+/// Solar electric propulsion model
+/**
+ * \param[in] power coefficients of the power generated as a function of the distance from the Sun (AU)
+ * \param[in] bus_power coefficients of the power available to the bus as a function of the distance (may be empty)
+ * \param[in] bus_demand power demand of the bus, the deficit is taken from the power generated
+ * \param[in] efficiency power conversion efficiency
+ * \param[in] max_power maximum power that can be fed to the engine (thermal cap)
+ * \param[in] thrust coefficients of the thrust (N) as a function of the input power
+ * \param[in] isp coefficients of the specific impulse (s) as a function of the input power
+ *
+ * @return the propulsion model
+ *
+ * \throws value_error if the power, thrust or isp polynomials are empty, or the efficiency is not positive
+ */
+propulsion_model propulsion_model::solar_polynomial(const std::vector<double> &power,
+                                                    const std::vector<double> &bus_power, double bus_demand,
+                                                    double efficiency, double max_power,
+                                                    const std::vector<double> &thrust, const std::vector<double> &isp)
+{
+    if (power.empty() || thrust.empty() || isp.empty()) {
+        throw_value_error("The power, thrust and isp polynomials must have at least one coefficient");
+    }
+    if (!(efficiency > 0.)) {
+        throw_value_error("The power conversion efficiency must be positive");
+    }
+    propulsion_model retval;
+    retval.m_type = SOLAR_POLYNOMIAL;
+    retval.m_power = power;
+    retval.m_bus_power = bus_power;
+    retval.m_bus_demand = bus_demand;
+    retval.m_efficiency = efficiency;
+    retval.m_max_power = max_power;
+    retval.m_thrust = thrust;
+    retval.m_isp = isp;
+    return retval;
+}
+
+/// Tabulated model
+/**
+ * \param[in] r distances from the Sun (AU), strictly increasing
+ * \param[in] thrust thrust (N) at each distance
+ * \param[in] isp specific impulse (s) at each distance
+ *
+ * @return the propulsion model
+ *
+ * \throws value_error if the table is empty, if its columns have different sizes or if r is not strictly increasing
+ */
+propulsion_model propulsion_model::tabulated(const std::vector<double> &r, const std::vector<double> &thrust,
+                                             const std::vector<double> &isp)
+{
+    if (r.empty() || r.size() != thrust.size() || r.size() != isp.size()) {
+        throw_value_error("The distance, thrust and isp tables must be non empty and of the same size");
+    }
+    if (std::adjacent_find(r.begin(), r.end(), [](double a, double b) { return !(a < b); }) != r.end()) {
+        throw_value_error("The distances of the table must be strictly increasing");
+    }
+    propulsion_model retval;
+    retval.m_type = TABULATED;
+    retval.m_r = r;
+    retval.m_thrust = thrust;
+    retval.m_isp = isp;
+    return retval;
+}
+
+/// Evaluates the model
+/**
+ * \param[in] r distance from the Sun (AU)
+ * \param[in] nominal_thrust thrust returned by the constant model
+ * \param[in] nominal_isp specific impulse returned by the constant model
+ * \param[out] thrust maximum thrust at r
+ * \param[out] isp specific impulse at r
+ */
+void propulsion_model::eval(double r, double nominal_thrust, double nominal_isp, double &thrust, double &isp) const
+{
+    switch (m_type) {
+        case SOLAR_POLYNOMIAL: {
+            double power = polyval(m_power, r);
+            if (!m_bus_power.empty()) {
+                const double bus = polyval(m_bus_power, r);
+                if (bus < m_bus_demand) {
+                    power -= m_bus_demand - bus;
+                }
+            }
+            const double p_in = std::min(m_efficiency * power, m_max_power);
+            thrust = std::max(polyval(m_thrust, p_in), 0.);
+            isp = polyval(m_isp, p_in);
+            break;
+        }
+        case TABULATED: {
+            if (r <= m_r.front()) {
+                thrust = m_thrust.front();
+                isp = m_isp.front();
+            } else if (r >= m_r.back()) {
+                thrust = m_thrust.back();
+                isp = m_isp.back();
+            } else {
+                const auto i = static_cast<std::size_t>(std::upper_bound(m_r.begin(), m_r.end(), r) - m_r.begin());
+                const double w = (r - m_r[i - 1u]) / (m_r[i] - m_r[i - 1u]);
+                thrust = m_thrust[i - 1u] + w * (m_thrust[i] - m_thrust[i - 1u]);
+                isp = m_isp[i - 1u] + w * (m_isp[i] - m_isp[i - 1u]);
+            }
+            break;
+        }
+        default:
+            thrust = nominal_thrust;
+            isp = nominal_isp;
+    }
+}
+
+/// Equality operator
+bool propulsion_model::operator==(const propulsion_model &other) const
+{
+    return m_type == other.m_type && m_power == other.m_power && m_bus_power == other.m_bus_power
+           && m_bus_demand == other.m_bus_demand && m_efficiency == other.m_efficiency
+           && m_max_power == other.m_max_power && m_r == other.m_r && m_thrust == other.m_thrust
+           && m_isp == other.m_isp;
+}
+
+/// Inequality operator
+bool propulsion_model::operator!=(const propulsion_model &other) const
+{
+    return !(*this == other);
+}
+
+std::string propulsion_model::human_readable() const
+{
+    std::ostringstream s;
+    s << *this;
+    return s.str();
+}
+
+namespace
+{
+std::ostream &print_vector(std::ostream &s, const std::vector<double> &v)
+{
+    s << "[";
+    for (decltype(v.size()) i = 0u; i < v.size(); ++i) {
+        s << (i ? ", " : "") << v[i];
+    }
+    return s << "]";
+}
+} // namespace
+
+std::ostream &operator<<(std::ostream &s, const propulsion_model &in)
+{
+    switch (in.m_type) {
+        case propulsion_model::SOLAR_POLYNOMIAL:
+            s << "Solar polynomial propulsion model" << std::endl;
+            print_vector(s << "power: ", in.m_power) << std::endl;
+            print_vector(s << "bus power: ", in.m_bus_power) << std::endl;
+            s << "bus demand: " << in.m_bus_demand << std::endl;
+            s << "efficiency: " << in.m_efficiency << std::endl;
+            s << "max power: " << in.m_max_power << std::endl;
+            print_vector(s << "thrust: ", in.m_thrust) << std::endl;
+            print_vector(s << "isp: ", in.m_isp);
+            break;
+        case propulsion_model::TABULATED:
+            s << "Tabulated propulsion model" << std::endl;
+            print_vector(s << "r: ", in.m_r) << std::endl;
+            print_vector(s << "thrust: ", in.m_thrust) << std::endl;
+            print_vector(s << "isp: ", in.m_isp);
+            break;
+        default:
+            s << "Constant propulsion model";
+    }
+    return s;
+}
+} // namespace sims_flanagan
+} // namespace kep_toolbox
@@ -39,6 +39,9 @@ std::string spacecraft::human_readable() const
     s << "mass: " << get_mass() << std::endl;
     s << "thrust: " << get_thrust() << std::endl;
     s << "isp: " << get_isp() << std::endl;
+    if (m_propulsion.get_type() != propulsion_model::CONSTANT) {
+        s << m_propulsion << std::endl;
+    }
     return s.str();
 }
 
@@ -47,6 +50,9 @@ std::ostream &operator<<(std::ostream &s, const spacecraft &in)
     s << "Spacecraft mass: " << in.get_mass() << std::endl;
     s << "Spacecraft thrust: " << in.get_thrust() << std::endl;
     s << "Spacecraft isp: " << in.get_isp();
+    if (in.m_propulsion.get_type() != propulsion_model::CONSTANT) {
+        s << std::endl << in.m_propulsion;
+    }
     return s;
 }
 }
@@ -0,0 +1,291 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <cmath>
+#include <vector>
+
+#include <boost/math/constants/constants.hpp>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/array3D_operations.hpp>
+#include <keplerian_toolbox/core_functions/fb_prop.hpp>
+#include <keplerian_toolbox/core_functions/propagate_lagrangian_u.hpp>
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/lambert_problem.hpp>
+#include <keplerian_toolbox/trajopt/mga_1dsm_evaluator.hpp>
+
+namespace kep_toolbox
+{
+namespace trajopt
+{
+
+/// Constructor
+/**
+ * \param[in] seq the encounter sequence (including the departure planet), the planets are cloned
+ * \param[in] encoding encoding of the times of flight (see the class documentation)
+ * \param[in] tof_max upper bound on the total time of flight (days), used by the ETA encoding only
+ * \param[in] add_vinf_dep when true the launch hyperbolic velocity is added to the DV
+ * \param[in] add_vinf_arr when true the arrival relative velocity is added to the DV
+ * \param[in] multi_objective when true the total time of flight is a second objective
+ * \param[in] orbit_insertion when true the arrival DV is the pericenter burn acquiring the target orbit
+ * \param[in] e_target eccentricity of the target orbit around the last planet
+ * \param[in] rp_target pericenter radius of the target orbit around the last planet (m)
+ *
+ * \throws value_error if the sequence has less than two planets, if the planets do not share the same central
+ * body, if tof_max is not positive with the ETA encoding, or if orbit insertion is selected with a non positive
+ * rp_target or without add_vinf_arr
+ */
+mga_1dsm_evaluator::mga_1dsm_evaluator(const std::vector<planet::planet_ptr> &seq, tof_encoding encoding,
+                                       double tof_max, bool add_vinf_dep, bool add_vinf_arr, bool multi_objective,
+                                       bool orbit_insertion, double e_target, double rp_target)
+    : m_encoding(encoding), m_tof_max(tof_max), m_add_vinf_dep(add_vinf_dep), m_add_vinf_arr(add_vinf_arr),
+      m_multi_objective(multi_objective), m_orbit_insertion(orbit_insertion), m_e_target(e_target),
+      m_rp_target(rp_target)
+{
+    if (seq.size() < 2u) {
+        throw_value_error("The planetary sequence must contain at least two planets");
+    }
+    for (const auto &p : seq) {
+        if (p->get_mu_central_body() != seq[0]->get_mu_central_body()) {
+            throw_value_error("All planets in the sequence need to have identical mu_central_body");
+        }
+        m_seq.push_back(p->clone());
+    }
+    if (encoding == ETA && !(tof_max > 0.)) {
+        throw_value_error("The eta encoding needs a positive upper bound on the time of flight");
+    }
+    if (orbit_insertion && !(rp_target > 0.)) {
+        throw_value_error("The rp_target needs to be positive when orbit insertion is selected");
+    }
+    if (orbit_insertion && !add_vinf_arr) {
+        throw_value_error("When orbit insertion is selected, the add_vinf_arr must be True");
+    }
+    m_mu = seq[0]->get_mu_central_body();
+}
+
+/// Copy constructor
+/**
+ * The planets are cloned, as the ephemerides of some planets (e.g. planet::tle) are not reentrant and the copy may
+ * be used by another thread.
+ *
+ * \param[in] other the evaluator to copy
+ */
+mga_1dsm_evaluator::mga_1dsm_evaluator(const mga_1dsm_evaluator &other)
+    : m_encoding(other.m_encoding), m_tof_max(other.m_tof_max), m_add_vinf_dep(other.m_add_vinf_dep),
+      m_add_vinf_arr(other.m_add_vinf_arr), m_multi_objective(other.m_multi_objective),
+      m_orbit_insertion(other.m_orbit_insertion), m_e_target(other.m_e_target), m_rp_target(other.m_rp_target),
+      m_mu(other.m_mu)
+{
+    for (const auto &p : other.m_seq) {
+        m_seq.push_back(p->clone());
+    }
+}
+
+/// Copy assignment operator (clones the planets, see the copy constructor)
+mga_1dsm_evaluator &mga_1dsm_evaluator::operator=(const mga_1dsm_evaluator &other)
+{
+    if (this != &other) {
+        *this = mga_1dsm_evaluator(other);
+    }
+    return *this;
+}
+
+// Time of flight of the i-th leg (days). With the ALPHA encoding acc is the sum of minus the logarithms of the
+// alphas, with the ETA encoding it is the sum of the previous times of flight and it is updated
+double mga_1dsm_evaluator::tof(const std::vector<double> &x, std::size_t i, double &acc) const
+{
+    switch (m_encoding) {
+        case ALPHA: {
+            const double a = -std::log(x[5u + 4u * i]);
+            return x.back() * a / acc;
+        }
+        case ETA: {
+            const double T = (m_tof_max - acc) * x[5u + 4u * i];
+            acc += T;
+            return T;
+        }
+        default:
+            return x[5u + 4u * i];
+    }
+}
+
+/// Decodes the times of flight
+/**
+ * \param[in] x the decision vector
+ * \param[out] T the times of flight of the legs (days)
+ *
+ * \throws value_error if x does not have the size get_nx()
+ */
+void mga_1dsm_evaluator::decode_tofs(const std::vector<double> &x, std::vector<double> &T) const
+{
+    if (x.size() != get_nx()) {
+        throw_value_error("The decision vector has the wrong size");
+    }
+    const std::size_t n_legs = m_seq.size() - 1u;
+    double acc = 0.;
+    if (m_encoding == ALPHA) {
+        for (std::size_t i = 0u; i < n_legs; ++i) {
+            acc += -std::log(x[5u + 4u * i]);
+        }
+    }
+    T.resize(n_legs);
+    for (std::size_t i = 0u; i < n_legs; ++i) {
+        T[i] = tof(x, i, acc);
+    }
+}
+
+/// Decodes the launch hyperbolic velocity
+/**
+ * \param[in] x the decision vector
+ * \param[out] vinf the cartesian components of the launch hyperbolic velocity (m/s)
+ */
+void mga_1dsm_evaluator::decode_vinf(const std::vector<double> &x, array3D &vinf) const
+{
+    const double theta = 2 * boost::math::constants::pi<double>() * x[1];
+    const double phi = std::acos(2 * x[2] - 1) - boost::math::constants::pi<double>() / 2;
+    vinf[0] = x[3] * std::cos(phi) * std::cos(theta);
+    vinf[1] = x[3] * std::cos(phi) * std::sin(theta);
+    vinf[2] = x[3] * std::sin(phi);
+}
+
+/// Fitness
+/**
+ * Evaluates the trajectory encoded in a decision vector (see the class documentation). No memory is allocated if
+ * f already has the size get_nf().
+ *
+ * \param[in] x the decision vector
+ * \param[out] f the objectives (total DV in m/s and, if multi-objective, total time of flight in days)
+ *
+ * \throws value_error if x does not have the size get_nx()
+ */
+void mga_1dsm_evaluator::fitness(const std::vector<double> &x, std::vector<double> &f) const
+{
+    if (x.size() != get_nx()) {
+        throw_value_error("The decision vector has the wrong size");
+    }
+    const std::size_t n_legs = m_seq.size() - 1u;
+    double acc = 0.;
+    if (m_encoding == ALPHA) {
+        for (std::size_t i = 0u; i < n_legs; ++i) {
+            acc += -std::log(x[5u + 4u * i]);
+        }
+    }
+
+    // Leg by leg: Keplerian arc from the planet (after the launch or the fly-by), DSM and Lambert arc to the next
+    // planet
+    array3D r_P, v_P, r_next, v_next, r, v, v_beg, v_end, dv;
+    double T_sum = 0., dv_tot = 0.;
+    m_seq[0]->eph(x[0], r_P, v_P);
+    for (std::size_t i = 0u; i < n_legs; ++i) {
+        const double T = tof(x, i, acc), eta = x[4u + 4u * i];
+        T_sum += T;
+        m_seq[i + 1u]->eph(x[0] + T_sum, r_next, v_next);
+        r = r_P;
+        if (i == 0u) {
+            decode_vinf(x, v);
+            sum(v, v_P, v);
+        } else {
+            const planet::base &pl = *m_seq[i];
+            fb_prop(v, v_end, v_P, x[3u + 4u * i] * pl.get_radius(), x[2u + 4u * i], pl.get_mu_self());
+        }
+        propagate_lagrangian_u(r, v, eta * T * ASTRO_DAY2SEC, m_mu);
+        lambert_problem::solve_0rev(v_beg, v_end, r, r_next, (1 - eta) * T * ASTRO_DAY2SEC, m_mu);
+        diff(dv, v_beg, v);
+        double dv_dsm = norm(dv);
+        if (i == 0u && m_add_vinf_dep) {
+            dv_dsm += x[3];
+        }
+        dv_tot += dv_dsm;
+        r_P = r_next;
+        v_P = v_next;
+    }
+
+    // Arrival
+    if (m_add_vinf_arr) {
+        diff(dv, v_end, v_P);
+        double dv_arr = norm(dv);
+        if (m_orbit_insertion) {
+            // Single pericenter burn from the incoming hyperbola to the target orbit
+            const double mu = m_seq.back()->get_mu_self();
+            const double dv_per = std::sqrt(dv_arr * dv_arr + 2 * mu / m_rp_target);
+            const double dv_per2 = std::sqrt(2 * mu / m_rp_target - mu / m_rp_target * (1. - m_e_target));
+            dv_arr = std::abs(dv_per - dv_per2);
+        }
+        dv_tot += dv_arr;
+    }
+
+    f.resize(get_nobj());
+    f[0] = dv_tot;
+    if (m_multi_objective) {
+        f[1] = T_sum;
+    }
+}
+
+/// Fitness
+/**
+ * As the other overload, but returns the fitness vector.
+ *
+ * \param[in] x the decision vector
+ *
+ * @return the fitness vector
+ */
+std::vector<double> mga_1dsm_evaluator::fitness(const std::vector<double> &x) const
+{
+    std::vector<double> retval(get_nobj());
+    fitness(x, retval);
+    return retval;
+}
+
+/// Size of the decision vector
+std::size_t mga_1dsm_evaluator::get_nx() const
+{
+    return 4u * m_seq.size() - 2u + (m_encoding == ALPHA ? 1u : 0u);
+}
+
+/// Number of objectives
+std::size_t mga_1dsm_evaluator::get_nobj() const
+{
+    return m_multi_objective ? 2u : 1u;
+}
+
+/// Size of the fitness vector
+std::size_t mga_1dsm_evaluator::get_nf() const
+{
+    return get_nobj();
+}
+
+/// Gets the planetary sequence
+const std::vector<planet::planet_ptr> &mga_1dsm_evaluator::get_seq() const
+{
+    return m_seq;
+}
+
+/// Gets the encoding of the times of flight
+mga_1dsm_evaluator::tof_encoding mga_1dsm_evaluator::get_tof_encoding() const
+{
+    return m_encoding;
+}
+} // namespace trajopt
+} // namespace kep_toolbox
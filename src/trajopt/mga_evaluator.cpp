@@ -0,0 +1,260 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/array3D_operations.hpp>
+#include <keplerian_toolbox/core_functions/fb_vel.hpp>
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/lambert_problem.hpp>
+#include <keplerian_toolbox/trajopt/mga_evaluator.hpp>
+
+namespace kep_toolbox
+{
+namespace trajopt
+{
+
+/// Constructor
+/**
+ * \param[in] seq the encounter sequence (including the departure planet), the planets are cloned
+ * \param[in] encoding encoding of the times of flight (see the class documentation)
+ * \param[in] tof_max upper bound on the total time of flight (days), used by the ETA encoding only
+ * \param[in] vinf launch hyperbolic velocity given for free (m/s)
+ * \param[in] multi_objective when true the total time of flight is a second objective
+ * \param[in] orbit_insertion when true the arrival DV is the pericenter burn acquiring the target orbit
+ * \param[in] e_target eccentricity of the target orbit around the last planet
+ * \param[in] rp_target pericenter radius of the target orbit around the last planet (m)
+ *
+ * \throws value_error if the sequence has less than two planets, if the planets do not share the same central
+ * body, if tof_max is not positive with the ETA encoding or if rp_target is not positive with orbit insertion
+ */
+mga_evaluator::mga_evaluator(const std::vector<planet::planet_ptr> &seq, tof_encoding encoding, double tof_max,
+                             double vinf, bool multi_objective, bool orbit_insertion, double e_target,
+                             double rp_target)
+    : m_encoding(encoding), m_tof_max(tof_max), m_vinf(vinf), m_multi_objective(multi_objective),
+      m_orbit_insertion(orbit_insertion), m_e_target(e_target), m_rp_target(rp_target)
+{
+    if (seq.size() < 2u) {
+        throw_value_error("The planetary sequence must contain at least two planets");
+    }
+    for (const auto &p : seq) {
+        if (p->get_mu_central_body() != seq[0]->get_mu_central_body()) {
+            throw_value_error("All planets in the sequence need to have exactly the same mu_central_body");
+        }
+        m_seq.push_back(p->clone());
+    }
+    if (encoding == ETA && !(tof_max > 0.)) {
+        throw_value_error("The eta encoding needs a positive upper bound on the time of flight");
+    }
+    if (orbit_insertion && !(rp_target > 0.)) {
+        throw_value_error("The rp_target needs to be positive when orbit insertion is selected");
+    }
+    m_mu = seq[0]->get_mu_central_body();
+}
+
+/// Copy constructor
+/**
+ * The planets are cloned, as the ephemerides of some planets (e.g. planet::tle) are not reentrant and the copy may
+ * be used by another thread.
+ *
+ * \param[in] other the evaluator to copy
+ */
+mga_evaluator::mga_evaluator(const mga_evaluator &other)
+    : m_encoding(other.m_encoding), m_tof_max(other.m_tof_max), m_vinf(other.m_vinf),
+      m_multi_objective(other.m_multi_objective), m_orbit_insertion(other.m_orbit_insertion),
+      m_e_target(other.m_e_target), m_rp_target(other.m_rp_target), m_mu(other.m_mu)
+{
+    for (const auto &p : other.m_seq) {
+        m_seq.push_back(p->clone());
+    }
+}
+
+/// Copy assignment operator (clones the planets, see the copy constructor)
+mga_evaluator &mga_evaluator::operator=(const mga_evaluator &other)
+{
+    if (this != &other) {
+        *this = mga_evaluator(other);
+    }
+    return *this;
+}
+
+// Time of flight of the i-th leg (days). With the ALPHA encoding acc is the sum of the logarithms of the alphas,
+// with the ETA encoding it is the sum of the previous times of flight and it is updated
+double mga_evaluator::tof(const std::vector<double> &x, std::size_t i, double &acc) const
+{
+    switch (m_encoding) {
+        case ALPHA:
+            return std::log(x[2u + i]) / acc * x[1];
+        case ETA: {
+            const double T = (m_tof_max - acc) * x[1u + i];
+            acc += T;
+            return T;
+        }
+        default:
+            return x[1u + i];
+    }
+}
+
+/// Decodes the times of flight
+/**
+ * \param[in] x the decision vector
+ * \param[out] T the times of flight of the legs (days)
+ *
+ * \throws value_error if x does not have the size get_nx()
+ */
+void mga_evaluator::decode_tofs(const std::vector<double> &x, std::vector<double> &T) const
+{
+    if (x.size() != get_nx()) {
+        throw_value_error("The decision vector has the wrong size");
+    }
+    const std::size_t n_legs = m_seq.size() - 1u;
+    double acc = 0.;
+    if (m_encoding == ALPHA) {
+        for (std::size_t i = 0u; i < n_legs; ++i) {
+            acc += std::log(x[2u + i]);
+        }
+    }
+    T.resize(n_legs);
+    for (std::size_t i = 0u; i < n_legs; ++i) {
+        T[i] = tof(x, i, acc);
+    }
+}
+
+/// Fitness
+/**
+ * Evaluates the trajectory encoded in a decision vector (see the class documentation). No memory is allocated if
+ * f already has the size get_nf().
+ *
+ * \param[in] x the decision vector
+ * \param[out] f the objectives (total DV in m/s and, if multi-objective, total time of flight in days)
+ *
+ * \throws value_error if x does not have the size get_nx()
+ */
+void mga_evaluator::fitness(const std::vector<double> &x, std::vector<double> &f) const
+{
+    if (x.size() != get_nx()) {
+        throw_value_error("The decision vector has the wrong size");
+    }
+    const std::size_t n_legs = m_seq.size() - 1u;
+    double acc = 0.;
+    if (m_encoding == ALPHA) {
+        for (std::size_t i = 0u; i < n_legs; ++i) {
+            acc += std::log(x[2u + i]);
+        }
+    }
+
+    // Leg by leg: ephemerides at the arrival, Lambert arc and DV at the departure (launch or fly-by)
+    array3D r0, v0, r1, v1, v_dep, v_arr, v_rel_in, v_rel_out;
+    array3D v_arr_prev{};
+    double t = x[0], T_tot = 0., dv_launch = 0., dv_fb = 0.;
+    m_seq[0]->eph(t, r0, v0);
+    for (std::size_t i = 0u; i < n_legs; ++i) {
+        const double T = tof(x, i, acc);
+        T_tot += T;
+        t += T;
+        m_seq[i + 1u]->eph(t, r1, v1);
+        lambert_problem::solve_0rev(v_dep, v_arr, r0, r1, T * ASTRO_DAY2SEC, m_mu);
+        if (i == 0u) {
+            diff(v_rel_out, v0, v_dep);
+            dv_launch = std::max(0., norm(v_rel_out) - m_vinf);
+        } else {
+            diff(v_rel_in, v_arr_prev, v0);
+            diff(v_rel_out, v_dep, v0);
+            double dv;
+            fb_vel(dv, v_rel_in, v_rel_out, *m_seq[i]);
+            dv_fb += dv;
+        }
+        v_arr_prev = v_arr;
+        r0 = r1;
+        v0 = v1;
+    }
+
+    // Arrival
+    diff(v_rel_in, v0, v_arr_prev);
+    double dv_arr = norm(v_rel_in);
+    if (m_orbit_insertion) {
+        // Single pericenter burn from the incoming hyperbola to the target orbit
+        const double mu = m_seq.back()->get_mu_self();
+        const double dv_per = std::sqrt(dv_arr * dv_arr + 2 * mu / m_rp_target);
+        const double dv_per2 = std::sqrt(2 * mu / m_rp_target - mu / m_rp_target * (1. - m_e_target));
+        dv_arr = std::abs(dv_per - dv_per2);
+    }
+
+    f.resize(get_nobj());
+    f[0] = dv_launch + dv_fb + dv_arr;
+    if (m_multi_objective) {
+        f[1] = (m_encoding == ALPHA) ? x[1] : T_tot;
+    }
+}
+
+/// Fitness
+/**
+ * As the other overload, but returns the fitness vector.
+ *
+ * \param[in] x the decision vector
+ *
+ * @return the fitness vector
+ */
+std::vector<double> mga_evaluator::fitness(const std::vector<double> &x) const
+{
+    std::vector<double> retval(get_nobj());
+    fitness(x, retval);
+    return retval;
+}
+
+/// Size of the decision vector
+std::size_t mga_evaluator::get_nx() const
+{
+    return m_seq.size() + (m_encoding == ALPHA ? 1u : 0u);
+}
+
+/// Number of objectives
+std::size_t mga_evaluator::get_nobj() const
+{
+    return m_multi_objective ? 2u : 1u;
+}
+
+/// Size of the fitness vector
+std::size_t mga_evaluator::get_nf() const
+{
+    return get_nobj();
+}
+
+/// Gets the planetary sequence
+const std::vector<planet::planet_ptr> &mga_evaluator::get_seq() const
+{
+    return m_seq;
+}
+
+/// Gets the encoding of the times of flight
+mga_evaluator::tof_encoding mga_evaluator::get_tof_encoding() const
+{
+    return m_encoding;
+}
+} // namespace trajopt
+} // namespace kep_toolbox
@@ -0,0 +1,384 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <numeric>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/fb_con.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/sims_flanagan/sc_state.hpp>
+#include <keplerian_toolbox/trajopt/mga_lt_nep_evaluator.hpp>
+#include <keplerian_toolbox/util/finite_differences.hpp>
+#include <keplerian_toolbox/util/parallel_for.hpp>
+
+namespace kep_toolbox
+{
+namespace trajopt
+{
+
+/// Constructor
+/**
+ * \param[in] seq the encounter sequence (including the departure planet), the planets are cloned
+ * \param[in] n_seg number of segments of each leg
+ * \param[in] vinf_dep maximum launch hyperbolic velocity (m/s)
+ * \param[in] vinf_arr maximum arrival hyperbolic velocity (m/s)
+ * \param[in] mass spacecraft launch mass (kg)
+ * \param[in] thrust maximum thrust (N)
+ * \param[in] isp specific impulse (s)
+ * \param[in] multi_objective when true the total time of flight is a second objective
+ * \param[in] high_fidelity when true the legs are propagated with continuous thrust
+ * \param[in] mu gravitational parameter of the central body
+ *
+ * \throws value_error if the sequence has less than two planets or n_seg is not of size seq.size() - 1
+ */
+mga_lt_nep_evaluator::mga_lt_nep_evaluator(const std::vector<planet::planet_ptr> &seq,
+                                           const std::vector<unsigned> &n_seg, double vinf_dep, double vinf_arr,
+                                           double mass, double thrust, double isp, bool multi_objective,
+                                           bool high_fidelity, double mu)
+    : m_n_seg(n_seg), m_vinf_dep(vinf_dep), m_vinf_arr(vinf_arr), m_mass(mass), m_multi_objective(multi_objective),
+      m_high_fidelity(high_fidelity)
+{
+    if (seq.size() < 2u) {
+        throw_value_error("The planetary sequence must contain at least two planets");
+    }
+    if (n_seg.size() != seq.size() - 1u) {
+        throw_value_error("The number of segments must be given for each leg");
+    }
+    if (std::find(n_seg.begin(), n_seg.end(), 0u) != n_seg.end()) {
+        throw_value_error("Each leg must have at least one segment");
+    }
+    for (const auto &p : seq) {
+        m_seq.push_back(p->clone());
+    }
+    m_legs.resize(n_seg.size());
+    for (std::size_t i = 0u; i < m_legs.size(); ++i) {
+        m_legs[i].set_spacecraft(sims_flanagan::spacecraft(mass, thrust, isp));
+        m_legs[i].set_mu(mu);
+        m_legs[i].set_high_fidelity(high_fidelity);
+        m_legs[i].set_throttles_size(static_cast<int>(n_seg[i]));
+    }
+    set_gradient_sparsity();
+}
+
+/// Copy constructor
+/**
+ * The planets are cloned, as the ephemerides of some planets (e.g. planet::tle) are not reentrant and the copy may
+ * be used by another thread.
+ *
+ * \param[in] other the evaluator to copy
+ */
+mga_lt_nep_evaluator::mga_lt_nep_evaluator(const mga_lt_nep_evaluator &other)
+    : m_n_seg(other.m_n_seg), m_vinf_dep(other.m_vinf_dep), m_vinf_arr(other.m_vinf_arr), m_mass(other.m_mass),
+      m_multi_objective(other.m_multi_objective), m_high_fidelity(other.m_high_fidelity), m_legs(other.m_legs),
+      m_sparsity(other.m_sparsity), m_colours(other.m_colours)
+{
+    for (const auto &p : other.m_seq) {
+        m_seq.push_back(p->clone());
+    }
+}
+
+/// Copy assignment operator (clones the planets, see the copy constructor)
+mga_lt_nep_evaluator &mga_lt_nep_evaluator::operator=(const mga_lt_nep_evaluator &other)
+{
+    if (this != &other) {
+        *this = mga_lt_nep_evaluator(other);
+    }
+    return *this;
+}
+
+// Assembles the sparsity pattern of the fitness from the ones of the legs, and colours its columns
+void mga_lt_nep_evaluator::set_gradient_sparsity()
+{
+    const std::size_t n_legs = m_legs.size(), nobj = get_nobj(), nec = get_nec();
+    std::set<std::pair<std::size_t, std::size_t>> sp;
+    // Objectives
+    sp.emplace(0u, 2 + 8 * (n_legs - 1u));
+    if (m_multi_objective) {
+        for (std::size_t i = 0u; i < n_legs; ++i) {
+            sp.emplace(1u, 1 + 8 * i);
+        }
+    }
+    // Legs: each column of the leg Jacobian (t_i, x_i, throttles, t_f, x_f) is mapped to the decision vector
+    std::size_t first_throttle = 0u;
+    for (std::size_t i = 0u; i < n_legs; ++i) {
+        const std::size_t n = m_n_seg[i], th = 1u + 8u * n_legs + 3u * first_throttle;
+        std::vector<std::size_t> epoch_i{0u}, epoch_f{0u};
+        for (std::size_t j = 0u; j < i; ++j) {
+            epoch_i.push_back(1 + 8 * j);
+        }
+        epoch_f = epoch_i;
+        epoch_f.push_back(1 + 8 * i);
+        std::vector<std::vector<std::size_t>> columns(3u * n + 16u);
+        for (std::size_t k = 0u; k < 7u; ++k) {
+            columns[k] = epoch_i;
+            columns[8u + 3u * n + k] = epoch_f;
+        }
+        for (std::size_t k = 0u; k < 3u; ++k) {
+            columns[4u + k].push_back(3 + 8 * i + k);
+            columns[12u + 3u * n + k].push_back(6 + 8 * i + k);
+        }
+        if (i > 0u) {
+            columns[7u].push_back(2 + 8 * (i - 1u));
+        }
+        for (std::size_t k = 0u; k < 3u * n; ++k) {
+            columns[8u + k].push_back(th + k);
+        }
+        columns[15u + 3u * n].push_back(2 + 8 * i);
+        for (const auto &p : m_legs[i].get_constraints_jacobian_sparsity()) {
+            const std::size_t row
+                = (p.first < 7u) ? nobj + 7u * i + p.first : nobj + nec + first_throttle + (p.first - 7u);
+            for (auto c : columns[p.second]) {
+                sp.emplace(row, c);
+            }
+        }
+        first_throttle += n;
+    }
+    // Fly-bys
+    for (std::size_t i = 0u; i + 1u < n_legs; ++i) {
+        for (std::size_t k = 0u; k < 3u; ++k) {
+            for (std::size_t row : {nobj + 7u * n_legs + i, nobj + nec + first_throttle + i}) {
+                sp.emplace(row, 6 + 8 * i + k);
+                sp.emplace(row, 11 + 8 * i + k);
+            }
+        }
+    }
+    // Launch and arrival hyperbolic velocities
+    const std::size_t n_rows = nobj + nec + get_nic();
+    for (std::size_t k = 0u; k < 3u; ++k) {
+        sp.emplace(n_rows - 2u, 3 + k);
+        sp.emplace(n_rows - 1u, 6 + 8 * (n_legs - 1u) + k);
+    }
+    m_sparsity.assign(sp.begin(), sp.end());
+    m_colours = util::colour_columns(m_sparsity, get_nx());
+}
+
+/// Fitness
+/**
+ * Evaluates the trajectory encoded in a decision vector (see the class documentation).
+ *
+ * \param[in] x the decision vector
+ * \param[out] obj the objectives
+ * \param[out] ec the equality constraints
+ * \param[out] ic the inequality constraints
+ * \param[in] n_threads number of threads used to evaluate the legs (0 means all the available cores)
+ *
+ * \throws value_error if x does not have the size get_nx()
+ */
+void mga_lt_nep_evaluator::fitness(const std::vector<double> &x, std::vector<double> &obj, std::vector<double> &ec,
+                                   std::vector<double> &ic, unsigned n_threads) const
+{
+    if (x.size() != get_nx()) {
+        throw_value_error("The decision vector has the wrong size");
+    }
+    const std::size_t n_legs = m_legs.size();
+    obj.assign(get_nobj(), 0.);
+    ec.assign(get_nec(), 0.);
+    ic.assign(get_nic(), 0.);
+
+    obj[0] = -x[2 + 8 * (n_legs - 1u)];
+    if (m_multi_objective) {
+        for (std::size_t i = 0u; i < n_legs; ++i) {
+            obj[1] += x[1 + 8 * i];
+        }
+    }
+
+    // Epochs and ephemerides of the planetary encounters
+    std::vector<double> t_P(n_legs + 1u);
+    std::vector<array3D> r_P(n_legs + 1u), v_P(n_legs + 1u);
+    t_P[0] = x[0];
+    for (std::size_t i = 1u; i <= n_legs; ++i) {
+        t_P[i] = t_P[i - 1u] + x[1 + 8 * (i - 1u)];
+    }
+    for (std::size_t i = 0u; i <= n_legs; ++i) {
+        m_seq[i]->eph(t_P[i], r_P[i], v_P[i]);
+    }
+
+    // 1 - Mismatch and throttles constraints, leg by leg
+    std::vector<std::size_t> first_throttle(n_legs + 1u, 0u);
+    for (std::size_t i = 0u; i < n_legs; ++i) {
+        first_throttle[i + 1u] = first_throttle[i] + m_n_seg[i];
+    }
+    util::parallel_for(0u, n_legs,
+                       [&](std::size_t b, std::size_t e) {
+                           for (std::size_t i = b; i < e; ++i) {
+                               array3D v0, vf;
+                               for (unsigned j = 0u; j < 3u; ++j) {
+                                   v0[j] = v_P[i][j] + x[3 + 8 * i + j];
+                                   vf[j] = v_P[i + 1u][j] + x[6 + 8 * i + j];
+                               }
+                               const double m0 = (i == 0u) ? m_mass : x[2 + 8 * (i - 1u)];
+                               sims_flanagan::sc_state x0(r_P[i], v0, m0), xf(r_P[i + 1u], vf, x[2 + 8 * i]);
+                               auto thr = x.begin() + 1 + 8 * n_legs + 3 * first_throttle[i];
+                               sims_flanagan::leg &l = m_legs[i];
+                               l.set_leg(epoch(t_P[i]), x0, thr, thr + 3 * m_n_seg[i], epoch(t_P[i + 1u]), xf,
+                                         l.get_mu());
+                               auto mismatch = ec.begin() + 7 * i;
+                               l.get_mismatch_con(mismatch, mismatch + 7);
+                               // Non dimensional mismatch (assumes an heliocentric interplanetary trajectory)
+                               for (unsigned j = 0u; j < 3u; ++j) {
+                                   mismatch[j] /= ASTRO_AU;
+                                   mismatch[3 + j] /= ASTRO_EARTH_VELOCITY;
+                               }
+                               mismatch[6] /= m_mass;
+                               l.get_throttles_con(ic.begin() + first_throttle[i],
+                                                   ic.begin() + first_throttle[i + 1u]);
+                           }
+                       },
+                       n_threads, 1u);
+
+    // 2 - Fly-by constraints
+    const double v2_scale = ASTRO_EARTH_VELOCITY * ASTRO_EARTH_VELOCITY;
+    for (std::size_t i = 0u; i + 1u < n_legs; ++i) {
+        array3D v_rel_in, v_rel_out;
+        std::copy(x.begin() + 6 + 8 * i, x.begin() + 9 + 8 * i, v_rel_in.begin());
+        std::copy(x.begin() + 11 + 8 * i, x.begin() + 14 + 8 * i, v_rel_out.begin());
+        double dv_eq, alpha_ineq;
+        fb_con(dv_eq, alpha_ineq, v_rel_in, v_rel_out, *m_seq[i + 1u]);
+        ec[7 * n_legs + i] = dv_eq / v2_scale;
+        ic[first_throttle[n_legs] + i] = alpha_ineq;
+    }
+
+    // 3 - Departure and arrival hyperbolic velocities
+    const std::size_t arr = 6 + 8 * (n_legs - 1u);
+    ic[ic.size() - 2u] = (x[3] * x[3] + x[4] * x[4] + x[5] * x[5] - m_vinf_dep * m_vinf_dep) / v2_scale;
+    ic[ic.size() - 1u]
+        = (x[arr] * x[arr] + x[arr + 1] * x[arr + 1] + x[arr + 2] * x[arr + 2] - m_vinf_arr * m_vinf_arr) / v2_scale;
+}
+
+/// Fitness
+/**
+ * As the other overload, but returns the objectives, the equality and the inequality constraints concatenated
+ * (as in the pygmo problem fitness).
+ *
+ * \param[in] x the decision vector
+ * \param[in] n_threads number of threads used to evaluate the legs (0 means all the available cores)
+ *
+ * @return the fitness vector
+ */
+std::vector<double> mga_lt_nep_evaluator::fitness(const std::vector<double> &x, unsigned n_threads) const
+{
+    std::vector<double> obj, ec, ic;
+    fitness(x, obj, ec, ic, n_threads);
+    obj.insert(obj.end(), ec.begin(), ec.end());
+    obj.insert(obj.end(), ic.begin(), ic.end());
+    return obj;
+}
+
+/// Gradient sparsity
+/**
+ * Returns the structurally non-zero entries of the Jacobian of the fitness (objectives, equality and inequality
+ * constraints concatenated) with respect to the decision vector, as (row, column) pairs sorted lexicographically.
+ *
+ * @return the sparsity pattern
+ */
+const std::vector<std::pair<std::size_t, std::size_t>> &mga_lt_nep_evaluator::get_gradient_sparsity() const
+{
+    return m_sparsity;
+}
+
+/// Gradient
+/**
+ * Estimates the entries of the Jacobian of the fitness in the pattern returned by get_gradient_sparsity with
+ * coloured forward finite differences (see util::coloured_finite_differences).
+ *
+ * \param[in] x the decision vector
+ * \param[in] n_threads number of threads used to evaluate the legs (0 means all the available cores)
+ * \param[in] dx relative perturbation of the decision vector components
+ *
+ * @return the Jacobian entries, in the order of the sparsity pattern
+ *
+ * \throws value_error if x does not have the size get_nx()
+ */
+std::vector<double> mga_lt_nep_evaluator::gradient(const std::vector<double> &x, unsigned n_threads, double dx) const
+{
+    if (x.size() != get_nx()) {
+        throw_value_error("The decision vector has the wrong size");
+    }
+    std::vector<double> retval;
+    util::coloured_finite_differences([this, n_threads](const std::vector<double> &y) { return fitness(y, n_threads); },
+                                      x, m_sparsity, m_colours, retval, dx);
+    return retval;
+}
+
+/// Size of the decision vector
+std::size_t mga_lt_nep_evaluator::get_nx() const
+{
+    return 1u + 8u * m_legs.size() + 3u * std::accumulate(m_n_seg.begin(), m_n_seg.end(), std::size_t(0u));
+}
+
+/// Number of objectives
+std::size_t mga_lt_nep_evaluator::get_nobj() const
+{
+    return m_multi_objective ? 2u : 1u;
+}
+
+/// Number of equality constraints
+std::size_t mga_lt_nep_evaluator::get_nec() const
+{
+    return 7u * m_legs.size() + (m_legs.size() - 1u);
+}
+
+/// Number of inequality constraints
+std::size_t mga_lt_nep_evaluator::get_nic() const
+{
+    return std::accumulate(m_n_seg.begin(), m_n_seg.end(), std::size_t(0u)) + (m_legs.size() - 1u) + 2u;
+}
+
+/// Size of the fitness vector
+std::size_t mga_lt_nep_evaluator::get_nf() const
+{
+    return get_nobj() + get_nec() + get_nic();
+}
+
+/// Gets the planetary sequence
+const std::vector<planet::planet_ptr> &mga_lt_nep_evaluator::get_seq() const
+{
+    return m_seq;
+}
+
+/// Gets the propagation fidelity
+bool mga_lt_nep_evaluator::get_high_fidelity() const
+{
+    return m_high_fidelity;
+}
+
+/// Sets the propagation fidelity
+/**
+ * \param[in] status when true the legs are propagated with continuous thrust
+ */
+void mga_lt_nep_evaluator::set_high_fidelity(bool status)
+{
+    m_high_fidelity = status;
+    for (auto &l : m_legs) {
+        l.set_high_fidelity(status);
+    }
+}
+} // namespace trajopt
+} // namespace kep_toolbox
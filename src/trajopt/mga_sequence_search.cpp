@@ -0,0 +1,284 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/array3D_operations.hpp>
+#include <keplerian_toolbox/core_functions/fb_vel.hpp>
+#include <keplerian_toolbox/core_functions/three_impulses_approximation.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/lambert_problem.hpp>
+#include <keplerian_toolbox/trajopt/mga_sequence_search.hpp>
+#include <keplerian_toolbox/util/grid.hpp>
+#include <keplerian_toolbox/util/parallel_for.hpp>
+
+namespace kep_toolbox
+{
+namespace trajopt
+{
+
+// A partial sequence
+struct mga_sequence_search::node {
+    std::vector<std::size_t> seq;
+    // Decision vector, direct encoding
+    std::vector<double> x;
+    // Epoch of the last encounter (mjd2000)
+    double t;
+    // Velocity of the spacecraft at the last encounter
+    array3D v;
+    double dv_launch;
+    double dv_fb;
+    // Ranking in the beam
+    double key;
+};
+
+/// Constructor
+/**
+ * \param[in] planets the planet set (departure, arrival and fly-by candidates), the planets are cloned
+ * \param[in] departure index of the departure planet in the set
+ * \param[in] arrival index of the arrival planet in the set
+ * \param[in] t0 bounds of the launch epoch (mjd2000)
+ * \param[in] n_t0 number of launch epochs in the grid
+ * \param[in] tof bounds of the time of flight of each leg (days)
+ * \param[in] n_tof number of times of flight in the grid of each leg
+ * \param[in] vinf launch hyperbolic velocity given for free (m/s)
+ * \param[in] max_flybys maximum number of fly-bys
+ * \param[in] beam_width number of partial sequences kept at each depth
+ * \param[in] bound_factor weight of the three impulses estimate in the pruning (0 for an exact pruning, as the
+ * estimate is not a lower bound on the remaining DV)
+ * \param[in] max_fb_dv maximum DV of a fly-by (m/s), infinite (no pruning on the fly-by DV) by default
+ *
+ * \throws value_error if the planet set is empty, if the indices are out of range, if the planets do not share the
+ * same central body or if the grids are ill defined
+ */
+mga_sequence_search::mga_sequence_search(const std::vector<planet::planet_ptr> &planets, std::size_t departure,
+                                         std::size_t arrival, const std::array<double, 2> &t0, unsigned n_t0,
+                                         const std::array<double, 2> &tof, unsigned n_tof, double vinf,
+                                         unsigned max_flybys, unsigned beam_width, double bound_factor,
+                                         double max_fb_dv)
+    : m_departure(departure), m_arrival(arrival), m_t0(t0), m_n_t0(n_t0), m_tof(tof), m_n_tof(n_tof), m_vinf(vinf),
+      m_max_flybys(max_flybys), m_beam_width(beam_width), m_bound_factor(bound_factor), m_max_fb_dv(max_fb_dv)
+{
+    if (planets.empty()) {
+        throw_value_error("The planet set is empty");
+    }
+    if (departure >= planets.size() || arrival >= planets.size()) {
+        throw_value_error("The departure and arrival planets must be indices in the planet set");
+    }
+    if (t0[1] < t0[0] || n_t0 == 0u) {
+        throw_value_error("The launch epochs grid is ill defined");
+    }
+    if (!(tof[0] > 0.) || tof[1] < tof[0] || n_tof == 0u) {
+        throw_value_error("The times of flight grid is ill defined");
+    }
+    if (beam_width == 0u) {
+        throw_value_error("The beam width must be at least one");
+    }
+    for (const auto &p : planets) {
+        if (p->get_mu_central_body() != planets[0]->get_mu_central_body()) {
+            throw_value_error("All planets in the set need to have exactly the same mu_central_body");
+        }
+        m_planets.push_back(p->clone());
+    }
+    // A heuristic of the remaining DV, evaluated at the start of the launch window only
+    const epoch ep(t0[0]);
+    for (std::size_t i = 0u; i < m_planets.size(); ++i) {
+        m_estimate.push_back((i == arrival) ? 0.
+                                            : three_impulses_approx(*m_planets[i], *m_planets[arrival], ep, ep));
+    }
+}
+
+// Extends a partial sequence with each planet of the set, appending the partial sequences worth expanding further
+// to children and the complete ones (better than threshold) to solutions. The ephemerides are computed with planets,
+// a copy of the planet set that no other thread uses.
+void mga_sequence_search::expand(const std::vector<planet::planet_ptr> &planets, const node &n,
+                                 std::vector<node> &children, std::vector<solution> &solutions, double threshold) const
+{
+    const double mu = planets[0]->get_mu_central_body();
+    const std::size_t cur = n.seq.back();
+    const bool launch = (n.seq.size() == 1u), intermediate = (n.seq.size() <= m_max_flybys);
+    array3D r0, v0, r1, v1, v_dep, v_arr, dv, v_rel_in, v_rel_out;
+    planets[cur]->eph(n.t, r0, v0);
+    diff(v_rel_in, n.v, v0);
+    for (std::size_t j = 0u; j < planets.size(); ++j) {
+        // Best time of flight to continue the sequence through j, and to end it at j
+        double best = std::numeric_limits<double>::infinity(), best_end = best, T_best = 0., T_end = 0.;
+        double launch_best = 0., fb_best = 0.;
+        array3D v_best{};
+        for (unsigned k = 0u; k < m_n_tof; ++k) {
+            const double T = util::grid_point(m_tof, k, m_n_tof);
+            planets[j]->eph(n.t + T, r1, v1);
+            lambert_problem::solve_0rev(v_dep, v_arr, r0, r1, T * ASTRO_DAY2SEC, mu);
+            double dv_launch = n.dv_launch, dv_fb = n.dv_fb;
+            if (launch) {
+                diff(dv, v0, v_dep);
+                dv_launch = std::max(0., norm(dv) - m_vinf);
+            } else {
+                double dv_leg;
+                diff(v_rel_out, v_dep, v0);
+                fb_vel(dv_leg, v_rel_in, v_rel_out, *planets[cur]);
+                if (dv_leg > m_max_fb_dv) {
+                    continue;
+                }
+                dv_fb += dv_leg;
+            }
+            const double acc = dv_launch + dv_fb;
+            if (intermediate && acc < best) {
+                best = acc;
+                launch_best = dv_launch;
+                fb_best = dv_fb;
+                T_best = T;
+                v_best = v_arr;
+            }
+            if (j == m_arrival) {
+                diff(dv, v1, v_arr);
+                const double total = acc + norm(dv);
+                if (total < best_end) {
+                    best_end = total;
+                    T_end = T;
+                }
+            }
+        }
+        if (best + m_bound_factor * m_estimate[j] < threshold) {
+            node c(n);
+            c.seq.push_back(j);
+            c.x.push_back(T_best);
+            c.t = n.t + T_best;
+            c.v = v_best;
+            c.dv_launch = launch_best;
+            c.dv_fb = fb_best;
+            c.key = best + m_estimate[j];
+            children.push_back(std::move(c));
+        }
+        if (best_end < threshold) {
+            solution s{n.seq, n.x, best_end};
+            s.seq.push_back(j);
+            s.x.push_back(T_end);
+            solutions.push_back(std::move(s));
+        }
+    }
+}
+
+/// Runs the search
+/**
+ * \param[in] top_k number of sequences to return
+ * \param[in] n_threads number of threads (0 means all the available cores)
+ *
+ * @return the best top_k sequences found (at most), each with its best decision vector, sorted by DV
+ */
+std::vector<mga_sequence_search::solution> mga_sequence_search::run(unsigned top_k, unsigned n_threads) const
+{
+    std::vector<node> frontier;
+    for (unsigned k = 0u; k < m_n_t0; ++k) {
+        const double t0 = util::grid_point(m_t0, k, m_n_t0);
+        frontier.push_back(node{{m_departure}, {t0}, t0, array3D{}, 0., 0., 0.});
+    }
+    // Best solution of each sequence
+    std::map<std::vector<std::size_t>, solution> best;
+    std::vector<solution> retval;
+    double threshold = std::numeric_limits<double>::infinity();
+    // Clones of the planet set not in use by any thread, as the ephemerides of some planets (e.g. planet::tle) are
+    // not reentrant. Each block of nodes borrows one, so that at most one set per thread is ever cloned.
+    std::vector<std::vector<planet::planet_ptr>> free_sets;
+    std::mutex free_sets_mutex;
+    while (!frontier.empty()) {
+        std::vector<std::vector<node>> children(frontier.size());
+        std::vector<std::vector<solution>> solutions(frontier.size());
+        util::parallel_for(0u, frontier.size(),
+                           [&](std::size_t b, std::size_t e) {
+                               std::vector<planet::planet_ptr> planets;
+                               {
+                                   std::lock_guard<std::mutex> lock(free_sets_mutex);
+                                   if (!free_sets.empty()) {
+                                       planets = std::move(free_sets.back());
+                                       free_sets.pop_back();
+                                   }
+                               }
+                               if (planets.empty()) {
+                                   for (const auto &p : m_planets) {
+                                       planets.push_back(p->clone());
+                                   }
+                               }
+                               for (std::size_t i = b; i < e; ++i) {
+                                   expand(planets, frontier[i], children[i], solutions[i], threshold);
+                               }
+                               std::lock_guard<std::mutex> lock(free_sets_mutex);
+                               free_sets.push_back(std::move(planets));
+                           },
+                           n_threads, 1u);
+        // Complete trajectories
+        for (auto &sols : solutions) {
+            for (auto &s : sols) {
+                auto it = best.find(s.seq);
+                if (it == best.end()) {
+                    best.emplace(s.seq, std::move(s));
+                } else if (s.dv < it->second.dv) {
+                    it->second = std::move(s);
+                }
+            }
+        }
+        retval.clear();
+        for (const auto &p : best) {
+            retval.push_back(p.second);
+        }
+        std::stable_sort(retval.begin(), retval.end(),
+                         [](const solution &a, const solution &b) { return a.dv < b.dv; });
+        if (retval.size() > top_k) {
+            retval.resize(top_k);
+        }
+        if (top_k > 0u && retval.size() == top_k) {
+            threshold = retval.back().dv;
+        }
+        // Next beam
+        frontier.clear();
+        for (auto &c : children) {
+            for (auto &n : c) {
+                if (n.dv_launch + n.dv_fb + m_bound_factor * m_estimate[n.seq.back()] < threshold) {
+                    frontier.push_back(std::move(n));
+                }
+            }
+        }
+        std::stable_sort(frontier.begin(), frontier.end(), [](const node &a, const node &b) { return a.key < b.key; });
+        if (frontier.size() > m_beam_width) {
+            frontier.resize(m_beam_width);
+        }
+    }
+    return retval;
+}
+
+/// Gets the planet set
+const std::vector<planet::planet_ptr> &mga_sequence_search::get_planets() const
+{
+    return m_planets;
+}
+} // namespace trajopt
+} // namespace kep_toolbox
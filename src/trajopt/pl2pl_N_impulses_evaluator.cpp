@@ -0,0 +1,266 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <boost/math/constants/constants.hpp>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/array3D_operations.hpp>
+#include <keplerian_toolbox/core_functions/ic2par.hpp>
+#include <keplerian_toolbox/core_functions/propagate_lagrangian_u.hpp>
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/lambert_problem.hpp>
+#include <keplerian_toolbox/trajopt/pl2pl_N_impulses_evaluator.hpp>
+
+namespace kep_toolbox
+{
+namespace trajopt
+{
+
+/// Constructor
+/**
+ * \param[in] start the starting planet (cloned)
+ * \param[in] target the target planet (cloned)
+ * \param[in] N_max maximum number of impulses
+ * \param[in] tof bounds on the time of flight (days)
+ * \param[in] vinf bounds on the magnitude of each of the N - 2 impulses (m/s)
+ * \param[in] phase_free when true the start and arrival anomalies are free (no rendezvous condition)
+ * \param[in] multi_objective when true the time of flight is a second objective
+ * \param[in] t0 bounds on the launch epoch (mjd2000), not used when the phase is free
+ * \param[in] orbit_insertion when true the arrival DV is the pericenter burn acquiring the target orbit
+ * \param[in] e_target eccentricity of the target orbit around the target planet
+ * \param[in] rp_target pericenter radius of the target orbit around the target planet (m)
+ *
+ * The bounds on the launch and arrival epochs of the free phase problem span two periods of the osculating orbits
+ * of the start and target planets at epoch 0.
+ *
+ * \throws value_error if the planets do not share the same central body, if N_max is less than 2, or if orbit
+ * insertion is selected with a non positive rp_target
+ */
+pl2pl_N_impulses_evaluator::pl2pl_N_impulses_evaluator(const planet::base &start, const planet::base &target,
+                                                       unsigned N_max, const std::array<double, 2> &tof,
+                                                       const std::array<double, 2> &vinf, bool phase_free,
+                                                       bool multi_objective, const std::array<double, 2> &t0,
+                                                       bool orbit_insertion, double e_target, double rp_target)
+    : m_seq{start.clone(), target.clone()}, m_N_max(N_max), m_phase_free(phase_free),
+      m_multi_objective(multi_objective), m_orbit_insertion(orbit_insertion), m_e_target(e_target),
+      m_rp_target(rp_target), m_mu(start.get_mu_central_body())
+{
+    if (start.get_mu_central_body() != target.get_mu_central_body()) {
+        throw_value_error("Starting and ending planets must have the same mu_central_body");
+    }
+    if (N_max < 2u) {
+        throw_value_error("Number of impulses N is less than 2");
+    }
+    if (orbit_insertion && !(rp_target > 0.)) {
+        throw_value_error("The rp_target needs to be positive when orbit insertion is selected");
+    }
+    if (phase_free) {
+        m_lb = {0., tof[0]};
+        m_ub = {2 * start.compute_period() * ASTRO_SEC2DAY, tof[1]};
+    } else {
+        m_lb = {t0[0], tof[0]};
+        m_ub = {t0[1], tof[1]};
+    }
+    for (unsigned i = 0u; i < N_max - 2u; ++i) {
+        m_lb.insert(m_lb.end(), {1e-3, 0., 0., vinf[0]});
+        m_ub.insert(m_ub.end(), {1. - 1e-3, 1., 1., vinf[1]});
+    }
+    m_lb.push_back(1e-3);
+    m_ub.push_back(1. - 1e-3);
+    if (phase_free) {
+        m_lb.push_back(0.);
+        m_ub.push_back(2 * target.compute_period() * ASTRO_SEC2DAY);
+    }
+}
+
+/// Copy constructor
+/**
+ * The planets are cloned, as the ephemerides of some planets (e.g. planet::tle) are not reentrant and the copy may
+ * be used by another thread.
+ *
+ * \param[in] other the evaluator to copy
+ */
+pl2pl_N_impulses_evaluator::pl2pl_N_impulses_evaluator(const pl2pl_N_impulses_evaluator &other)
+    : m_N_max(other.m_N_max), m_phase_free(other.m_phase_free), m_multi_objective(other.m_multi_objective),
+      m_orbit_insertion(other.m_orbit_insertion), m_e_target(other.m_e_target), m_rp_target(other.m_rp_target),
+      m_mu(other.m_mu), m_lb(other.m_lb), m_ub(other.m_ub)
+{
+    for (const auto &p : other.m_seq) {
+        m_seq.push_back(p->clone());
+    }
+}
+
+/// Copy assignment operator (clones the planets, see the copy constructor)
+pl2pl_N_impulses_evaluator &pl2pl_N_impulses_evaluator::operator=(const pl2pl_N_impulses_evaluator &other)
+{
+    if (this != &other) {
+        *this = pl2pl_N_impulses_evaluator(other);
+    }
+    return *this;
+}
+
+/// Decodes the times of flight
+/**
+ * \param[in] x the decision vector
+ * \param[out] T the times of flight of the N - 1 arcs (days)
+ *
+ * \throws value_error if x does not have the size get_nx()
+ */
+void pl2pl_N_impulses_evaluator::decode_tofs(const std::vector<double> &x, std::vector<double> &T) const
+{
+    if (x.size() != get_nx()) {
+        throw_value_error("The decision vector has the wrong size");
+    }
+    T.resize(m_N_max - 1u);
+    double total = 0.;
+    for (std::size_t i = 0u; i < T.size(); ++i) {
+        T[i] = std::log(x[2u + 4u * i]);
+        total += T[i];
+    }
+    for (auto &t : T) {
+        t = x[1] * t / total;
+    }
+}
+
+/// Fitness
+/**
+ * Evaluates the trajectory encoded in a decision vector (see the class documentation). No memory is allocated if
+ * f already has the size get_nf().
+ *
+ * \param[in] x the decision vector
+ * \param[out] f the objectives (total DV in m/s and, if multi-objective, time of flight in days)
+ *
+ * \throws value_error if x does not have the size get_nx()
+ */
+void pl2pl_N_impulses_evaluator::fitness(const std::vector<double> &x, std::vector<double> &f) const
+{
+    if (x.size() != get_nx()) {
+        throw_value_error("The decision vector has the wrong size");
+    }
+    const double pi = boost::math::constants::pi<double>();
+    const std::size_t n_arcs = m_N_max - 1u;
+    double total = 0.;
+    for (std::size_t i = 0u; i < n_arcs; ++i) {
+        total += std::log(x[2u + 4u * i]);
+    }
+
+    // Starting and target positions
+    array3D r, v, r_target, v_target, v_beg, v_end, dv;
+    m_seq[0]->eph(x[0], r, v);
+    m_seq[1]->eph(m_phase_free ? x.back() : x[0] + x[1], r_target, v_target);
+
+    // Inner impulses, each followed by a Keplerian arc
+    double dv_others = 0.;
+    for (std::size_t i = 0u; i + 1u < n_arcs; ++i) {
+        const double theta = 2 * pi * x[3u + 4u * i];
+        const double phi = std::acos(2 * x[4u + 4u * i] - 1) - pi / 2;
+        const double DV = x[5u + 4u * i];
+        v[0] += DV * std::cos(phi) * std::cos(theta);
+        v[1] += DV * std::cos(phi) * std::sin(theta);
+        v[2] += DV * std::sin(phi);
+        propagate_lagrangian_u(r, v, x[1] * std::log(x[2u + 4u * i]) / total * ASTRO_DAY2SEC, m_mu);
+        dv_others += DV;
+    }
+
+    // Lambert arc to the target, retrograde if the orbit after the last impulse is
+    std::array<double, 6> E;
+    ic2par(r, v, m_mu, E);
+    const double T_last = x[1] * std::log(x[2u + 4u * (n_arcs - 1u)]) / total;
+    lambert_problem::solve_0rev(v_beg, v_end, r, r_target, T_last * ASTRO_DAY2SEC, m_mu, E[2] > pi / 2);
+    diff(dv, v_beg, v);
+    const double DV1 = norm(dv);
+    diff(dv, v_end, v_target);
+    double DV2 = norm(dv);
+    if (m_orbit_insertion) {
+        // Single pericenter burn from the incoming hyperbola to the target orbit
+        const double mu = m_seq[1]->get_mu_self();
+        const double dv_per = std::sqrt(DV2 * DV2 + 2 * mu / m_rp_target);
+        const double dv_per2 = std::sqrt(2 * mu / m_rp_target - mu / m_rp_target * (1. - m_e_target));
+        DV2 = std::abs(dv_per - dv_per2);
+    }
+
+    f.resize(get_nobj());
+    f[0] = DV1 + DV2 + dv_others;
+    if (m_multi_objective) {
+        f[1] = x[1];
+    }
+}
+
+/// Fitness
+/**
+ * As the other overload, but returns the fitness vector.
+ *
+ * \param[in] x the decision vector
+ *
+ * @return the fitness vector
+ */
+std::vector<double> pl2pl_N_impulses_evaluator::fitness(const std::vector<double> &x) const
+{
+    std::vector<double> retval(get_nobj());
+    fitness(x, retval);
+    return retval;
+}
+
+/// Size of the decision vector
+std::size_t pl2pl_N_impulses_evaluator::get_nx() const
+{
+    return 4u * m_N_max - 5u + (m_phase_free ? 1u : 0u);
+}
+
+/// Number of objectives
+std::size_t pl2pl_N_impulses_evaluator::get_nobj() const
+{
+    return m_multi_objective ? 2u : 1u;
+}
+
+/// Size of the fitness vector
+std::size_t pl2pl_N_impulses_evaluator::get_nf() const
+{
+    return get_nobj();
+}
+
+/// Lower bounds of the decision vector
+const std::vector<double> &pl2pl_N_impulses_evaluator::get_lb() const
+{
+    return m_lb;
+}
+
+/// Upper bounds of the decision vector
+const std::vector<double> &pl2pl_N_impulses_evaluator::get_ub() const
+{
+    return m_ub;
+}
+
+/// Gets the start and target planets
+const std::vector<planet::planet_ptr> &pl2pl_N_impulses_evaluator::get_seq() const
+{
+    return m_seq;
+}
+} // namespace trajopt
+} // namespace kep_toolbox
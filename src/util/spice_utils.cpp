@@ -23,6 +23,8 @@
  *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
  *****************************************************************************/
 
+#include <atomic>
+#include <mutex>
 #include <sstream>
 #include <string>
 
@@ -33,6 +35,36 @@ namespace kep_toolbox
 namespace util
 {
 
+namespace detail
+{
+// Bumped every time a kernel is loaded, so that cached ephemerides computed
+// with a previous kernel pool can be recognised as stale.
+std::atomic<unsigned long long> kernel_generation(0u);
+} // namespace detail
+
+/// Mutex serializing all calls into the SPICE toolbox
+/**
+ * CSPICE is not re-entrant: its error status and kernel pool are global. Every call into the
+ * toolbox made by kep_toolbox holds this mutex. Code that calls CSPICE routines directly while
+ * kep_toolbox::planet::spice objects may be used from other threads must hold it too.
+ *
+ * \returns a reference to the global SPICE mutex
+ */
+std::mutex &spice_mutex()
+{
+    static std::mutex m;
+    return m;
+}
+
+/// Kernel pool generation
+/**
+ * \returns a counter incremented at each successful call to load_spice_kernel
+ */
+unsigned long long spice_kernel_generation()
+{
+    return detail::kernel_generation.load();
+}
+
 /// Load SPICE kernel
 /**
  * This function wraps the SPICE toolbox furnsh_c routine. You can find the original documentation
@@ -50,6 +82,7 @@ namespace util
 
 void load_spice_kernel(std::string file_name)
 {
+    std::lock_guard<std::mutex> lock(spice_mutex());
     /// Transferring error handling from spice to kep_toolbox
     erract_c("SET", 0, const_cast<char *>("RETURN"));
     /// Loading the kernel
@@ -61,6 +94,7 @@ void load_spice_kernel(std::string file_name)
         reset_c();
         throw_value_error(msg.str());
     }
+    ++detail::kernel_generation;
 }
 
 /// Transforms kep_toolbox epoch to SPICE epoch
@@ -0,0 +1,220 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <keplerian_toolbox/core_functions/propagate_lagrangian.hpp>
+#include <keplerian_toolbox/core_functions/propagate_taylor.hpp>
+#include <keplerian_toolbox/exceptions.hpp>
+#include <keplerian_toolbox/util/trajectory_sampling.hpp>
+
+namespace kep_toolbox
+{
+namespace util
+{
+
+namespace
+{
+void check_n_samples(unsigned N)
+{
+    if (N < 2u) {
+        throw_value_error("At least two samples are needed");
+    }
+}
+
+// The k-th of N equally spaced times in [0, T], the last one being exactly T
+double sample_time(double T, unsigned k, unsigned N)
+{
+    return (k + 1u == N) ? T : T * k / (N - 1u);
+}
+} // namespace
+
+/// Samples a planet orbit
+/**
+ * Computes the planet ephemerides at N equally spaced epochs in [t0, tf], with one call to the batch ephemerides.
+ *
+ * \param[in] pl the planet
+ * \param[in] t0 the first epoch (mjd2000)
+ * \param[in] tf the last epoch (mjd2000)
+ * \param[in] N the number of samples
+ * \param[out] r the planet positions
+ * \param[out] v the planet velocities
+ *
+ * \throws value_error if N is smaller than two
+ */
+void sample_planet(const planet::base &pl, double t0, double tf, unsigned N, std::vector<array3D> &r,
+                   std::vector<array3D> &v)
+{
+    check_n_samples(N);
+    std::vector<double> when(N);
+    for (unsigned k = 0u; k < N; ++k) {
+        when[k] = t0 + sample_time(tf - t0, k, N);
+    }
+    pl.eph(when, r, v);
+}
+
+/// Samples a Keplerian arc
+/**
+ * Computes the states at N equally spaced times along the Keplerian arc starting from r0, v0. Each sample is
+ * obtained with one Kepler solve from the initial state, so that the errors do not accumulate along the arc.
+ *
+ * \param[in] r0 the initial position
+ * \param[in] v0 the initial velocity
+ * \param[in] tof the duration of the arc (can be negative)
+ * \param[in] mu the gravitational parameter of the central body
+ * \param[in] N the number of samples
+ * \param[out] r the positions
+ * \param[out] v the velocities
+ *
+ * \throws value_error if N is smaller than two
+ */
+void sample_kepler(const array3D &r0, const array3D &v0, double tof, double mu, unsigned N, std::vector<array3D> &r,
+                   std::vector<array3D> &v)
+{
+    check_n_samples(N);
+    r.resize(N);
+    v.resize(N);
+    r[0] = r0;
+    v[0] = v0;
+    for (unsigned k = 1u; k < N; ++k) {
+        r[k] = r0;
+        v[k] = v0;
+        propagate_lagrangian(r[k], v[k], sample_time(tof, k, N), mu);
+    }
+}
+
+/// Samples a Lambert solution
+/**
+ * As sample_kepler, along one of the solutions of a Lambert problem.
+ *
+ * \param[in] l the Lambert problem
+ * \param[in] sol the solution index (in 0 .. 2 Nmax)
+ * \param[in] N the number of samples
+ * \param[out] r the positions
+ * \param[out] v the velocities
+ *
+ * \throws value_error if the solution does not exist or if N is smaller than two
+ */
+void sample_lambert(const lambert_problem &l, unsigned sol, unsigned N, std::vector<array3D> &r,
+                    std::vector<array3D> &v)
+{
+    if (sol >= l.get_v1().size()) {
+        throw_value_error("The solution index must be in 0 .. 2 Nmax");
+    }
+    sample_kepler(l.get_r1(), l.get_v1()[sol], l.get_tof(), l.get_mu(), N, r, v);
+}
+
+/// Samples a constant thrust arc
+/**
+ * Computes the states at N equally spaced times along the arc propagated by propagate_taylor. The propagation is
+ * done only once: the samples falling in each integration step are evaluated from the Taylor polynomials of that
+ * step (dense output).
+ *
+ * \param[in] r0 the initial position
+ * \param[in] v0 the initial velocity
+ * \param[in] m0 the initial mass
+ * \param[in] thrust the thrust vector
+ * \param[in] tof the duration of the arc (can be negative)
+ * \param[in] mu the gravitational parameter of the central body
+ * \param[in] veff the effective exhaust velocity (Isp g0)
+ * \param[in] N the number of samples
+ * \param[out] r the positions
+ * \param[out] v the velocities
+ * \param[out] m the masses
+ * \param[in] log10tolerance the logarithm of the absolute tolerance
+ * \param[in] log10rtolerance the logarithm of the relative tolerance
+ *
+ * \throws value_error if N is smaller than two, or if the propagation fails as in propagate_taylor
+ */
+void sample_taylor(const array3D &r0, const array3D &v0, double m0, const array3D &thrust, double tof, double mu,
+                   double veff, unsigned N, std::vector<array3D> &r, std::vector<array3D> &v, std::vector<double> &m,
+                   int log10tolerance, int log10rtolerance)
+{
+    check_n_samples(N);
+    r.resize(N);
+    v.resize(N);
+    m.resize(N);
+    r[0] = r0;
+    v[0] = v0;
+    m[0] = m0;
+
+    const int max_iter = 10000, max_order = 3000;
+    const double eps_a = std::pow(10., log10tolerance);
+    const double eps_r = std::pow(10., log10rtolerance);
+    std::vector<std::array<double, 7>> x;
+    std::vector<std::array<double, 21>> u;
+    array3D rc = r0, vc = v0;
+    double mc = m0;
+    // Time reached by the propagation and next sample
+    double t = 0.;
+    unsigned k = 1u;
+    for (int iter = 0; k < N; ++iter) {
+        if (iter == max_iter) {
+            throw_value_error("Maximum number of iteration reached");
+        }
+        // Polynomial order, as in propagate_taylor
+        double xm = std::max(std::abs(rc[0]), std::abs(rc[1]));
+        xm = std::max(xm, std::abs(rc[2]));
+        xm = std::max(xm, std::abs(vc[0]));
+        xm = std::max(xm, std::abs(vc[1]));
+        xm = std::max(xm, std::abs(vc[2]));
+        xm = std::max(xm, std::abs(mc));
+        const double eps_m = (eps_r * xm < eps_a) ? eps_a : eps_r;
+        const int order = static_cast<int>(std::ceil(-0.5 * std::log(eps_m) + 1));
+        if (order > max_order) {
+            throw_value_error("Polynomial order is too high.....");
+        }
+        x.assign(static_cast<std::size_t>(order) + 1u, std::array<double, 7>());
+        u.assign(static_cast<std::size_t>(order), std::array<double, 21>());
+
+        const double h = propagate_taylor_step(rc, vc, mc, tof - t, order, thrust, mu, veff, xm, eps_a, eps_r, x, u);
+        const double t_next = (std::abs(h) >= std::abs(tof - t)) ? tof : t + h;
+        // Samples in the step, evaluated with Horner's method from the Taylor coefficients (x[0] is the state at t)
+        for (; k < N; ++k) {
+            const double tk = sample_time(tof, k, N);
+            if ((tk - t_next) * tof > 0.) {
+                break;
+            }
+            const double tau = tk - t;
+            const std::array<double, 7> &x_n = x[static_cast<std::size_t>(order)];
+            std::array<double, 6> s = {{x_n[0], x_n[1], x_n[2], x_n[3], x_n[4], x_n[5]}};
+            for (int j = order - 1; j >= 0; --j) {
+                for (std::size_t c = 0u; c < 6u; ++c) {
+                    s[c] = s[c] * tau + x[static_cast<std::size_t>(j)][c];
+                }
+            }
+            r[k] = {{s[0], s[1], s[2]}};
+            v[k] = {{s[3], s[4], s[5]}};
+            m[k] = x[0][6] + x[1][6] * tau;
+        }
+        t = t_next;
+    }
+}
+} // namespace util
+} // namespace kep_toolbox
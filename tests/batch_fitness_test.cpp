@@ -0,0 +1,97 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <exception>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <keplerian_toolbox/planet/jpl_low_precision.hpp>
+#include <keplerian_toolbox/trajopt/batch_fitness.hpp>
+#include <keplerian_toolbox/trajopt/mga_lt_nep_evaluator.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we evaluate a random population with trajopt::batch_fitness, with different numbers of threads,
+// and check that the fitness vectors are exactly those of the serial evaluations. We also check that the copies
+// used by the workers do not share the planets.
+
+int main()
+{
+    std::vector<planet::planet_ptr> seq{planet::jpl_lp("earth").clone(), planet::jpl_lp("venus").clone(),
+                                        planet::jpl_lp("mercury").clone()};
+    trajopt::mga_lt_nep_evaluator udp(seq, {5u, 10u}, 3000., 2000., 2000., 0.5, 3500., false, true);
+    const std::size_t nx = udp.get_nx(), nf = udp.get_nf(), n = 100u;
+
+    std::mt19937 gen(7u);
+    std::uniform_real_distribution<double> u(-1., 1.);
+    std::vector<double> dvs(n * nx);
+    for (std::size_t i = 0u; i < n; ++i) {
+        double *x = dvs.data() + i * nx;
+        x[0] = 3000. + 500. * u(gen);
+        for (std::size_t l = 0u; l < 2u; ++l) {
+            x[1 + 8 * l] = 300. + 100. * u(gen);
+            x[2 + 8 * l] = 1800. - 100. * static_cast<double>(l) + 50. * u(gen);
+            for (std::size_t j = 3u; j < 9u; ++j) {
+                x[8 * l + j] = 2000. * u(gen);
+            }
+        }
+        for (std::size_t j = 17u; j < nx; ++j) {
+            x[j] = 0.5 * u(gen);
+        }
+    }
+    std::vector<double> expected;
+    for (std::size_t i = 0u; i < n; ++i) {
+        const auto f = udp.fitness(std::vector<double>(dvs.begin() + i * nx, dvs.begin() + (i + 1u) * nx));
+        expected.insert(expected.end(), f.begin(), f.end());
+    }
+    if (expected.size() != n * nf) {
+        std::cout << "Wrong fitness dimension" << std::endl << "FAIL" << std::endl;
+        return 1;
+    }
+    for (unsigned n_threads : {1u, 3u, 0u}) {
+        if (trajopt::batch_fitness(udp, dvs, n_threads) != expected) {
+            std::cout << "Batch fitness with " << n_threads << " threads differs from the serial one" << std::endl;
+            std::cout << "FAIL" << std::endl;
+            return 1;
+        }
+    }
+    const trajopt::mga_lt_nep_evaluator copy(udp);
+    for (std::size_t i = 0u; i < seq.size(); ++i) {
+        if (copy.get_seq()[i] == udp.get_seq()[i]) {
+            std::cout << "The copy of the evaluator shares the planets" << std::endl << "FAIL" << std::endl;
+            return 1;
+        }
+    }
+    dvs.pop_back();
+    try {
+        trajopt::batch_fitness(udp, dvs);
+        std::cout << "Wrong batch size not detected" << std::endl << "FAIL" << std::endl;
+        return 1;
+    } catch (const std::exception &) {
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
@@ -0,0 +1,171 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/closest_distance.hpp>
+#include <keplerian_toolbox/core_functions/closest_distance_soa.hpp>
+#include <keplerian_toolbox/core_functions/par2ic.hpp>
+#include <keplerian_toolbox/core_functions/propagate_lagrangian.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/sims_flanagan/leg.hpp>
+#include <keplerian_toolbox/sims_flanagan/spacecraft.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we compare the structure-of-arrays closest distance with the scalar one on random elliptic and
+// hyperbolic arcs, then check the closest distances along the segments of a coasting leg against a dense sampling
+// of its orbit.
+
+int check_arcs()
+{
+    std::mt19937 gen(5u);
+    std::uniform_real_distribution<double> u(0., 1.);
+    const std::size_t n = 2000u;
+    soa3D r0, v0, r1, v1;
+    std::vector<double> mu(n);
+    for (soa3D *x : {&r0, &v0, &r1, &v1}) {
+        detail::soa_resize(*x, n);
+    }
+    for (std::size_t j = 0; j < n; ++j) {
+        const bool hyperbolic = j % 2u;
+        mu[j] = 0.5 + u(gen);
+        const double a = 0.5 + 2. * u(gen);
+        const double e = hyperbolic ? 1.1 + 2. * u(gen) : 0.9 * u(gen);
+        const double EA = hyperbolic ? 2. * u(gen) - 1. : 6. * u(gen) - 3.;
+        array6D el{{a, e, 3. * u(gen), 6. * u(gen), 6. * u(gen), EA}};
+        array3D r, v;
+        par2ic(el, mu[j], r, v);
+        for (unsigned c = 0; c < 3; ++c) {
+            r0[c][j] = r[c];
+            v0[c][j] = v[c];
+        }
+        // The final state is on the same orbit, with a larger anomaly
+        el[5] += hyperbolic ? u(gen) : 6. * u(gen);
+        par2ic(el, mu[j], r, v);
+        for (unsigned c = 0; c < 3; ++c) {
+            r1[c][j] = r[c];
+            v1[c][j] = v[c];
+        }
+    }
+    std::vector<double> d_min, ra;
+    closest_distance_soa(d_min, ra, r0, v0, r1, v1, mu);
+    for (std::size_t j = 0; j < n; ++j) {
+        const array3D r{{r0[0][j], r0[1][j], r0[2][j]}}, v{{v0[0][j], v0[1][j], v0[2][j]}};
+        const array3D rf{{r1[0][j], r1[1][j], r1[2][j]}}, vf{{v1[0][j], v1[1][j], v1[2][j]}};
+        double d_ref, ra_ref;
+        closest_distance(d_ref, ra_ref, r, v, rf, vf, mu[j]);
+        if (!(std::abs(d_min[j] - d_ref) <= 1e-12 * d_ref && std::abs(ra[j] - ra_ref) <= 1e-12 * std::abs(ra_ref))) {
+            std::cout << "closest_distance_soa differs from the scalar version, arc " << j << ": " << d_min[j] << " "
+                      << d_ref << " " << ra[j] << " " << ra_ref << std::endl;
+            return 1;
+        }
+    }
+    mu.pop_back();
+    try {
+        closest_distance_soa(d_min, ra, r0, v0, r1, v1, mu);
+        std::cout << "Gravitational parameters of different size not detected" << std::endl;
+        return 1;
+    } catch (const std::exception &) {
+    }
+    mu.push_back(1.);
+    v1[2].pop_back();
+    try {
+        closest_distance_soa(d_min, ra, r0, v0, r1, v1, mu);
+        std::cout << "Components of different sizes not detected" << std::endl;
+        return 1;
+    } catch (const std::exception &) {
+    }
+    return 0;
+}
+
+int check_leg()
+{
+    // An eccentric orbit crossing its periapsis during the leg
+    const unsigned n_seg = 10u;
+    const double ti = 1000., tf = 1200.;
+    array3D r, v;
+    const array6D el{{1.5 * ASTRO_AU, 0.5, 0.1, 0.2, 0.3, -0.6}};
+    par2ic(el, ASTRO_MU_SUN, r, v);
+    sims_flanagan::sc_state xi(r, v, 1000.);
+    propagate_lagrangian(r, v, (tf - ti) * ASTRO_DAY2SEC, ASTRO_MU_SUN);
+    sims_flanagan::sc_state xf(r, v, 1000.);
+    sims_flanagan::leg l(epoch(ti), xi, std::vector<double>(3 * n_seg, 0.), epoch(tf), xf,
+                         sims_flanagan::spacecraft(1000., 0.3, 2500.), ASTRO_MU_SUN);
+    std::vector<double> d_min, con(n_seg);
+    l.get_closest_distances(d_min);
+    l.get_min_radius_con(con.begin(), con.end(), ASTRO_AU);
+
+    const unsigned n_samples = 2000u;
+    const double dt = (tf - ti) / n_seg / n_samples * ASTRO_DAY2SEC;
+    r = xi.get_position();
+    v = xi.get_velocity();
+    bool periapsis = false;
+    for (unsigned i = 0; i < n_seg; ++i) {
+        double sampled = std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+        for (unsigned k = 0; k < n_samples; ++k) {
+            propagate_lagrangian(r, v, dt, ASTRO_MU_SUN);
+            sampled = std::min(sampled, std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]));
+        }
+        periapsis = periapsis || std::abs(d_min[i] - 0.75 * ASTRO_AU) < 1e-9 * ASTRO_AU;
+        if (!(d_min[i] <= sampled * (1. + 1e-12) && sampled - d_min[i] <= 1e-6 * d_min[i])) {
+            std::cout << "Wrong closest distance along segment " << i << ": " << d_min[i] << " " << sampled
+                      << std::endl;
+            return 1;
+        }
+        if (con[i] != ASTRO_AU - d_min[i]) {
+            std::cout << "Wrong minimum radius constraint for segment " << i << std::endl;
+            return 1;
+        }
+    }
+    if (!periapsis) {
+        std::cout << "The periapsis should be crossed during the leg" << std::endl;
+        return 1;
+    }
+    l.set_high_fidelity(true);
+    try {
+        l.get_closest_distances(d_min);
+        std::cout << "High-fidelity legs should not be accepted" << std::endl;
+        return 1;
+    } catch (const std::exception &) {
+    }
+    return 0;
+}
+
+int main()
+{
+    if (check_arcs() || check_leg()) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
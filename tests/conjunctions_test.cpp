@@ -0,0 +1,168 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <keplerian_toolbox/catalog/conjunctions.hpp>
+#include <keplerian_toolbox/catalog/sgp4_soa.hpp>
+#include <keplerian_toolbox/catalog/tle_catalog.hpp>
+#include <keplerian_toolbox/planet/tle.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we build a synthetic catalog of objects in a narrow LEO shell and screen it for conjunctions.
+// The result is checked against a brute force sampling of all the pairs every second: each pair sampled
+// closer than the threshold must be reported, with a miss distance not larger than the sampled one.
+// We also check that the reported TCAs are minima of the distance and that the result does not depend on
+// the number of threads.
+
+// Appends the modulo 10 checksum to a TLE line
+std::string with_checksum(const std::string &line)
+{
+    int sum = 0;
+    for (char c : line) {
+        if (c >= '0' && c <= '9') {
+            sum += c - '0';
+        } else if (c == '-') {
+            sum += 1;
+        }
+    }
+    return line + std::to_string(sum % 10);
+}
+
+double distance(const array3D &r1, const array3D &r2)
+{
+    return std::sqrt((r1[0] - r2[0]) * (r1[0] - r2[0]) + (r1[1] - r2[1]) * (r1[1] - r2[1])
+                     + (r1[2] - r2[2]) * (r1[2] - r2[2]));
+}
+
+int main()
+{
+    const std::size_t n = 60u;
+    std::mt19937 gen(12345u);
+    std::uniform_real_distribution<double> angle(0., 360.), incl(0., 180.), ecc(0., 0.002), mm(14.95, 15.05);
+    std::vector<std::string> lines;
+    char buffer[80];
+    for (std::size_t i = 0u; i < n; ++i) {
+        int sat = 10000 + static_cast<int>(i);
+        std::snprintf(buffer, sizeof(buffer), "1 %05dU 20001A   20001.00000000  .00000000  00000-0  00000-0 0  999",
+                      sat);
+        lines.push_back(with_checksum(buffer));
+        std::snprintf(buffer, sizeof(buffer), "2 %05d %8.4f %8.4f %07d %8.4f %8.4f %11.8f%5d", sat, incl(gen),
+                      angle(gen), static_cast<int>(ecc(gen) * 1e7), angle(gen), angle(gen), mm(gen), 1);
+        lines.push_back(with_checksum(buffer));
+    }
+    catalog::tle_catalog cat(lines);
+    if (cat.size() != n) {
+        std::cout << "Synthetic catalog not loaded" << std::endl;
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+
+    const double start = cat.get_ref_mjd2000()[0];
+    const double end = start + 0.25;
+    const double threshold = 50000.;
+    const double step = 10.;
+    std::vector<catalog::conjunction> conj = catalog::screen_conjunctions(cat, start, end, threshold, step, 1u);
+    std::vector<catalog::conjunction> conj4 = catalog::screen_conjunctions(cat, start, end, threshold, step, 4u);
+    std::cout << "Conjunctions found: " << conj.size() << std::endl;
+    if (conj.empty() || conj.size() != conj4.size()) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    for (std::size_t k = 0u; k < conj.size(); ++k) {
+        if (conj[k].i != conj4[k].i || conj[k].j != conj4[k].j || conj[k].tca != conj4[k].tca
+            || conj[k].miss_distance != conj4[k].miss_distance) {
+            std::cout << "Results depend on the number of threads" << std::endl;
+            std::cout << "FAIL" << std::endl;
+            return 1;
+        }
+    }
+
+    // The TCAs are minima of the distance, and below the threshold
+    for (const auto &c : conj) {
+        planet::tle p1 = cat.get_planet(c.i), p2 = cat.get_planet(c.j);
+        array3D r1, v1, r2, v2;
+        double d[3];
+        for (int s = -1; s <= 1; ++s) {
+            double t = std::min(std::max(c.tca + s * 1e-2 * ASTRO_SEC2DAY, start), end);
+            p1.eph(t, r1, v1);
+            p2.eph(t, r2, v2);
+            d[s + 1] = distance(r1, r2);
+        }
+        if (c.j <= c.i || c.miss_distance > threshold || c.tca < start || c.tca > end
+            || std::abs(d[1] - c.miss_distance) > 1e-6 * threshold || d[0] < d[1] - 1e-3 || d[2] < d[1] - 1e-3) {
+            std::cout << "Wrong conjunction between " << c.i << " and " << c.j << std::endl;
+            std::cout << "FAIL" << std::endl;
+            return 1;
+        }
+    }
+
+    // Brute force
+    catalog::sgp4_soa soa(cat);
+    catalog::soa_states states;
+    std::vector<int> status;
+    std::vector<double> sampled_min(n * n, 1e300);
+    const int n_samples = static_cast<int>((end - start) * ASTRO_DAY2SEC);
+    for (int k = 0; k <= n_samples; ++k) {
+        soa.propagate(start + k * ASTRO_SEC2DAY, states, status);
+        for (std::size_t i = 0u; i < n; ++i) {
+            for (std::size_t j = i + 1u; j < n; ++j) {
+                double dx = states.x[i] - states.x[j], dy = states.y[i] - states.y[j], dz = states.z[i] - states.z[j];
+                sampled_min[i * n + j] = std::min(sampled_min[i * n + j], std::sqrt(dx * dx + dy * dy + dz * dz));
+            }
+        }
+    }
+    std::size_t n_close = 0u;
+    for (std::size_t i = 0u; i < n; ++i) {
+        for (std::size_t j = i + 1u; j < n; ++j) {
+            if (sampled_min[i * n + j] > threshold) {
+                continue;
+            }
+            ++n_close;
+            double found = 1e300;
+            for (const auto &c : conj) {
+                if (c.i == i && c.j == j) {
+                    found = std::min(found, c.miss_distance);
+                }
+            }
+            if (found > sampled_min[i * n + j] + 1e-3) {
+                std::cout << "Missed conjunction between " << i << " and " << j << ": sampled "
+                          << sampled_min[i * n + j] << ", found " << found << std::endl;
+                std::cout << "FAIL" << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << "Pairs closer than the threshold (brute force): " << n_close << std::endl;
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
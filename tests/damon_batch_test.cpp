@@ -0,0 +1,176 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <array>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/array3D_operations.hpp>
+#include <keplerian_toolbox/core_functions/damon.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/lambert_problem.hpp>
+#include <keplerian_toolbox/phasing/damon_batch.hpp>
+#include <keplerian_toolbox/phasing/lambert_matrix.hpp>
+#include <keplerian_toolbox/planet/keplerian.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we compare the batched Damon approximation with the scalar one, and the low-thrust reachability
+// matrix with a brute force implementation solving one lambert_problem at a time.
+
+int main()
+{
+    std::mt19937 gen(5u);
+    std::uniform_real_distribution<double> u(-1., 1.);
+    const double T_max = 0.3, Isp = 3000., m0 = 1500.;
+    int res = 0;
+
+    // Batch against scalar
+    phasing::lambert_arcs arcs;
+    arcs.resize(10000u);
+    for (std::size_t i = 0; i < arcs.size(); ++i) {
+        arcs.v1x[i] = 3000. * u(gen);
+        arcs.v1y[i] = 3000. * u(gen);
+        arcs.v1z[i] = 3000. * u(gen);
+        arcs.v2x[i] = 3000. * u(gen);
+        arcs.v2y[i] = 3000. * u(gen);
+        arcs.v2z[i] = 3000. * u(gen);
+        arcs.tof[i] = (200. + 150. * u(gen)) * ASTRO_DAY2SEC;
+    }
+    std::size_t n_feasible = 0u;
+    for (unsigned n_threads : {1u, 3u, 0u}) {
+        std::vector<double> acc, dv;
+        std::vector<char> feasible;
+        phasing::damon_batch(arcs, T_max, Isp, m0, acc, dv, feasible, n_threads);
+        n_feasible = 0u;
+        for (std::size_t i = 0; i < arcs.size(); ++i) {
+            const array3D v1{{arcs.v1x[i], arcs.v1y[i], arcs.v1z[i]}}, v2{{arcs.v2x[i], arcs.v2y[i], arcs.v2z[i]}};
+            array3D a1, a2;
+            double tau, ref_dv;
+            damon_approx(v1, v2, arcs.tof[i], a1, a2, tau, ref_dv);
+            const bool ref_feasible = max_start_mass(norm(a1), ref_dv, T_max, Isp) >= m0;
+            if (acc[i] != norm(a1) || dv[i] != ref_dv || feasible[i] != ref_feasible
+                || std::abs(norm(a2) - norm(a1)) > 1e-9 * norm(a1)) {
+                std::cout << "Arc " << i << " differs from the scalar implementation" << std::endl;
+                res = 1;
+            }
+            n_feasible += ref_feasible;
+        }
+    }
+    if (n_feasible == 0u || n_feasible == arcs.size()) {
+        std::cout << "The test arcs are all feasible or all unfeasible" << std::endl;
+        res = 1;
+    }
+    arcs.v2z.pop_back();
+    try {
+        std::vector<double> acc, dv;
+        std::vector<char> feasible;
+        phasing::damon_batch(arcs, T_max, Isp, m0, acc, dv, feasible);
+        std::cout << "Arrays of different sizes not detected" << std::endl;
+        res = 1;
+    } catch (const std::exception &) {
+    }
+
+    // Reachability matrix against brute force
+    std::uniform_real_distribution<double> v(0., 1.);
+    std::vector<planet::planet_ptr> ast;
+    for (unsigned i = 0; i < 25; ++i) {
+        const array6D elem{{(2.5 + 0.2 * v(gen)) * ASTRO_AU, 0.05 * v(gen), 0.05 * v(gen), 6.28 * v(gen),
+                            6.28 * v(gen), 6.28 * v(gen)}};
+        ast.push_back(planet::keplerian(epoch(6000.), elem, ASTRO_MU_SUN, 1., 1., 1.).clone());
+    }
+    const std::array<double, 2> t0{{7000., 7200.}}, tof{{150., 450.}};
+    const unsigned n_t0 = 5u, n_tof = 7u;
+    const std::vector<std::size_t> departures{3u, 0u, 17u};
+    const std::size_t n = ast.size();
+    std::vector<double> ref(departures.size() * n, std::numeric_limits<double>::infinity());
+    std::vector<double> ref_t0(ref.size()), ref_tof(ref.size());
+    std::size_t ref_reachable = 0u;
+    for (std::size_t i = 0; i < departures.size(); ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            if (departures[i] == j) {
+                continue;
+            }
+            for (unsigned k = 0; k < n_t0; ++k) {
+                for (unsigned l = 0; l < n_tof; ++l) {
+                    const double t = t0[0] + (t0[1] - t0[0]) * k / (n_t0 - 1);
+                    const double T = tof[0] + (tof[1] - tof[0]) * l / (n_tof - 1);
+                    array3D r1, v1, r2, v2, dv1, dv2, a1, a2;
+                    double tau, damon_dv;
+                    ast[departures[i]]->eph(epoch(t), r1, v1);
+                    ast[j]->eph(epoch(t + T), r2, v2);
+                    const lambert_problem lp(r1, r2, T * ASTRO_DAY2SEC, ASTRO_MU_SUN);
+                    diff(dv1, lp.get_v1()[0], v1);
+                    diff(dv2, lp.get_v2()[0], v2);
+                    damon_approx(dv1, dv2, T * ASTRO_DAY2SEC, a1, a2, tau, damon_dv);
+                    if (max_start_mass(norm(a1), damon_dv, T_max, Isp) >= m0 && damon_dv < ref[i * n + j]) {
+                        ref[i * n + j] = damon_dv;
+                        ref_t0[i * n + j] = t;
+                        ref_tof[i * n + j] = T;
+                    }
+                }
+            }
+            ref_reachable += !std::isinf(ref[i * n + j]);
+        }
+    }
+    if (ref_reachable == 0u || ref_reachable == departures.size() * (n - 1)) {
+        std::cout << "The test asteroids are all reachable or all unreachable" << std::endl;
+        res = 1;
+    }
+    for (unsigned n_threads : {1u, 4u, 0u}) {
+        std::vector<float> dv, best_t0, best_tof;
+        const std::size_t reachable = phasing::lambert_damon_matrix(ast, departures, t0, n_t0, tof, n_tof, T_max,
+                                                                    Isp, m0, dv, best_t0, best_tof, n_threads);
+        if (reachable != ref_reachable || dv.size() != ref.size()) {
+            std::cout << "Wrong number of reachable pairs: " << reachable << " " << ref_reachable << std::endl;
+            res = 1;
+            continue;
+        }
+        for (std::size_t ij = 0; ij < ref.size(); ++ij) {
+            if (std::isinf(ref[ij])) {
+                if (!std::isinf(dv[ij]) || !std::isnan(best_t0[ij]) || !std::isnan(best_tof[ij])) {
+                    std::cout << "Transfer " << ij << " should be unreachable" << std::endl;
+                    res = 1;
+                }
+            } else if (std::abs(dv[ij] - ref[ij]) > 1e-5 * ref[ij] || std::abs(best_t0[ij] - ref_t0[ij]) > 1e-3
+                       || best_tof[ij] != ref_tof[ij]) {
+                std::cout << "Transfer " << ij << " differs from the reference: " << dv[ij] << " " << ref[ij]
+                          << std::endl;
+                res = 1;
+            }
+        }
+    }
+    if (res) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
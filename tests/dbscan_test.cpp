@@ -0,0 +1,160 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/phasing/dbscan.hpp>
+#include <keplerian_toolbox/phasing/kdtree.hpp>
+#include <keplerian_toolbox/planet/keplerian.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we cluster an asteroid belt made of a background and of some families with DBSCAN, and compare the
+// result with a brute force implementation (all pairs region queries, same depth first search).
+
+std::size_t reference(const phasing::kdtree &tree, double eps, std::size_t min_samples, std::vector<long> &labels)
+{
+    const std::size_t n = tree.size();
+    std::vector<std::vector<std::size_t>> neighbours(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::vector<std::pair<double, std::size_t>> nb;
+        for (std::size_t j = 0; j < n; ++j) {
+            double d2 = 0.;
+            for (unsigned k = 0; k < 6; ++k) {
+                d2 += (tree.get_point(i)[k] - tree.get_point(j)[k]) * (tree.get_point(i)[k] - tree.get_point(j)[k]);
+            }
+            if (d2 <= eps * eps) {
+                nb.emplace_back(d2, j);
+            }
+        }
+        std::sort(nb.begin(), nb.end());
+        for (const auto &p : nb) {
+            neighbours[i].push_back(p.second);
+        }
+    }
+    labels.assign(n, -1);
+    long label = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (labels[i] != -1 || neighbours[i].size() < min_samples) {
+            continue;
+        }
+        std::vector<std::size_t> stack{i};
+        while (!stack.empty()) {
+            const std::size_t j = stack.back();
+            stack.pop_back();
+            if (labels[j] != -1) {
+                continue;
+            }
+            labels[j] = label;
+            if (neighbours[j].size() >= min_samples) {
+                for (auto nb : neighbours[j]) {
+                    if (labels[nb] == -1) {
+                        stack.push_back(nb);
+                    }
+                }
+            }
+        }
+        ++label;
+    }
+    return static_cast<std::size_t>(label);
+}
+
+int main()
+{
+    std::mt19937 gen(7u);
+    std::uniform_real_distribution<double> u(0., 1.);
+    std::vector<planet::planet_ptr> belt;
+    for (unsigned i = 0; i < 1500; ++i) {
+        const array6D elem{{(2. + u(gen)) * ASTRO_AU, 0.2 * u(gen), 0.3 * u(gen), 6.28 * u(gen), 6.28 * u(gen),
+                            6.28 * u(gen)}};
+        belt.push_back(planet::keplerian(epoch(6000.), elem, ASTRO_MU_SUN, 1., 1., 1.).clone());
+    }
+    // Families: asteroids with close elements, interleaved with the background
+    for (unsigned f = 0; f < 10; ++f) {
+        const array6D elem{{(2. + u(gen)) * ASTRO_AU, 0.2 * u(gen), 0.3 * u(gen), 6.28 * u(gen), 6.28 * u(gen),
+                            6.28 * u(gen)}};
+        for (unsigned i = 0; i < 30; ++i) {
+            array6D e = elem;
+            e[0] *= 1. + 2e-3 * (u(gen) - 0.5);
+            e[1] += 2e-3 * u(gen);
+            e[5] += 1e-2 * (u(gen) - 0.5);
+            belt.insert(belt.begin() + static_cast<std::ptrdiff_t>(u(gen) * static_cast<double>(belt.size())),
+                        planet::keplerian(epoch(6000.), e, ASTRO_MU_SUN, 1., 1., 1.).clone());
+        }
+    }
+
+    int res = 0;
+    for (auto m : {phasing::kdtree::ORBITAL, phasing::kdtree::EUCLIDEAN, phasing::kdtree::EUCLIDEAN_R}) {
+        const double eps = (m == phasing::kdtree::ORBITAL) ? 300. : 0.01;
+        const std::size_t min_samples = 5u;
+        std::vector<long> ref_labels;
+        const phasing::kdtree tree(belt, 7000., m);
+        const std::size_t ref_n = reference(tree, eps, min_samples, ref_labels);
+        if (ref_n < 5u) {
+            std::cout << "The test families were not found by the reference" << std::endl;
+            return 1;
+        }
+        for (unsigned n_threads : {1u, 3u, 0u}) {
+            std::vector<long> labels;
+            std::vector<std::size_t> core;
+            const std::size_t n_clusters = phasing::dbscan(tree, eps, min_samples, labels, core, n_threads);
+            if (n_clusters != ref_n || labels != ref_labels) {
+                std::cout << "DBSCAN differs from the reference" << std::endl;
+                res = 1;
+            }
+            for (std::size_t i = 0; i < core.size(); ++i) {
+                std::vector<std::size_t> ids;
+                std::vector<double> dists;
+                tree.query_ball(tree.get_point(core[i]), eps, ids, dists);
+                if (ids.size() < min_samples || labels[core[i]] == -1 || (i > 0 && core[i] <= core[i - 1])) {
+                    std::cout << "Wrong core sample" << std::endl;
+                    res = 1;
+                }
+            }
+        }
+    }
+    try {
+        std::vector<long> labels;
+        std::vector<std::size_t> core;
+        phasing::dbscan(phasing::kdtree(belt, 7000.), -1., 5u, labels, core);
+        std::cout << "Negative eps not detected" << std::endl;
+        res = 1;
+    } catch (const std::exception &) {
+    }
+    if (res) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
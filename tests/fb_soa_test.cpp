@@ -0,0 +1,120 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/fb_con.hpp>
+#include <keplerian_toolbox/core_functions/fb_prop.hpp>
+#include <keplerian_toolbox/core_functions/fb_soa.hpp>
+#include <keplerian_toolbox/core_functions/fb_vel.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/planet/keplerian.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we compare the structure-of-arrays fly-by functions with the scalar ones, on feasible and
+// unfeasible fly-bys.
+
+int compare(const std::string &name, double soa, double ref, std::size_t j)
+{
+    if (!(std::abs(soa - ref) <= 1e-12 * std::max(1., std::abs(ref)))) {
+        std::cout << name << " differs from the scalar version, fly-by " << j << ": " << soa << " " << ref
+                  << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main()
+{
+    std::mt19937 gen(7u);
+    std::uniform_real_distribution<double> u(-1., 1.);
+    const std::size_t n = 1000u;
+    soa3D v_rel_in, v_rel_out, v_pla;
+    std::vector<double> safe_radius(n), mu_self(n), beta(n);
+    detail::soa_resize(v_rel_in, n);
+    detail::soa_resize(v_rel_out, n);
+    detail::soa_resize(v_pla, n);
+    for (std::size_t j = 0; j < n; ++j) {
+        for (unsigned c = 0; c < 3; ++c) {
+            v_rel_in[c][j] = 5000. * u(gen);
+            v_rel_out[c][j] = 5000. * u(gen);
+            v_pla[c][j] = 30000. * u(gen);
+        }
+        safe_radius[j] = 1e7 * (1.5 + u(gen));
+        mu_self[j] = 1e14 * (1.5 + u(gen));
+        beta[j] = 3. * u(gen);
+    }
+
+    int res = 0;
+    std::vector<double> eq_V2, ineq_delta, dV;
+    soa3D v_out;
+    fb_con_soa(eq_V2, ineq_delta, v_rel_in, v_rel_out, safe_radius, mu_self);
+    fb_vel_soa(dV, v_rel_in, v_rel_out, safe_radius, mu_self);
+    fb_prop_soa(v_out, v_rel_in, v_pla, safe_radius, beta, mu_self);
+    const array6D elements = planet::keplerian().get_elements();
+    unsigned n_feasible = 0u;
+    for (std::size_t j = 0; j < n && !res; ++j) {
+        const planet::keplerian pl(epoch(0), elements, ASTRO_MU_SUN, mu_self[j], 1., safe_radius[j]);
+        const array3D in{{v_rel_in[0][j], v_rel_in[1][j], v_rel_in[2][j]}};
+        const array3D out{{v_rel_out[0][j], v_rel_out[1][j], v_rel_out[2][j]}};
+        const array3D vp{{v_pla[0][j], v_pla[1][j], v_pla[2][j]}};
+        double eq, ineq, dv;
+        fb_con(eq, ineq, in, out, pl);
+        fb_vel(dv, in, out, pl);
+        n_feasible += ineq <= 0.;
+        res += compare("fb_con_soa (equality)", eq_V2[j], eq, j);
+        res += compare("fb_con_soa (inequality)", ineq_delta[j], ineq, j);
+        res += compare("fb_vel_soa", dV[j], dv, j);
+        array3D vo;
+        fb_prop(vo, in, vp, safe_radius[j], beta[j], mu_self[j]);
+        for (unsigned c = 0; c < 3; ++c) {
+            res += compare("fb_prop_soa", v_out[c][j], vo[c], j);
+        }
+    }
+    if (n_feasible == 0u || n_feasible == n) {
+        std::cout << "Both feasible and unfeasible fly-bys should be tested: " << n_feasible << std::endl;
+        res = 1;
+    }
+    safe_radius.pop_back();
+    try {
+        fb_vel_soa(dV, v_rel_in, v_rel_out, safe_radius, mu_self);
+        std::cout << "Arrays of different sizes not detected" << std::endl;
+        res = 1;
+    } catch (const std::exception &) {
+    }
+    if (res) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
@@ -0,0 +1,167 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include <keplerian_toolbox/planet/jpl_low_precision.hpp>
+#include <keplerian_toolbox/trajopt/mga_lt_nep_evaluator.hpp>
+#include <keplerian_toolbox/util/finite_differences.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we check the column colouring on simple patterns, the coloured finite differences on an analytic
+// function and, for the mga_lt_nep evaluator, that the sparsity pattern contains all the non-zeros found by
+// dense finite differences and that the coloured gradient is the one computed column by column.
+
+bool valid_colouring(const util::sparsity_pattern &sp, const std::vector<std::size_t> &colours)
+{
+    std::set<std::pair<std::size_t, std::size_t>> seen; // (row, colour)
+    for (const auto &p : sp) {
+        if (!seen.emplace(p.first, colours[p.second]).second) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int check_colouring()
+{
+    // Tridiagonal: three colours
+    const std::size_t n = 50u;
+    util::sparsity_pattern tri;
+    for (std::size_t i = 0u; i < n; ++i) {
+        for (std::size_t j = (i ? i - 1u : 0u); j < std::min(n, i + 2u); ++j) {
+            tri.emplace_back(i, j);
+        }
+    }
+    auto colours = util::colour_columns(tri, n);
+    if (!valid_colouring(tri, colours) || *std::max_element(colours.begin(), colours.end()) != 2u) {
+        std::cout << "Wrong colouring of a tridiagonal pattern" << std::endl;
+        return 1;
+    }
+    // f_i = x_i^2 * x_{i+1} + sin(x_{i-1})
+    auto f = [n](const std::vector<double> &x) {
+        std::vector<double> retval(n);
+        for (std::size_t i = 0u; i < n; ++i) {
+            retval[i] = x[i] * x[i] * (i + 1u < n ? x[i + 1u] : 1.) + (i ? std::sin(x[i - 1u]) : 0.);
+        }
+        return retval;
+    };
+    std::vector<double> x(n), values;
+    for (std::size_t i = 0u; i < n; ++i) {
+        x[i] = 0.1 * static_cast<double>(i) - 2.;
+    }
+    util::coloured_finite_differences(f, x, tri, colours, values, 1e-7);
+    for (std::size_t k = 0u; k < tri.size(); ++k) {
+        const std::size_t i = tri[k].first, j = tri[k].second;
+        double exact;
+        if (j + 1u == i) {
+            exact = std::cos(x[j]);
+        } else if (j == i) {
+            exact = 2. * x[i] * (i + 1u < n ? x[i + 1u] : 1.);
+        } else {
+            exact = x[i] * x[i];
+        }
+        if (std::abs(values[k] - exact) > 1e-5 * std::max(1., std::abs(exact))) {
+            std::cout << "Wrong coloured finite difference at (" << i << ", " << j << ")" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int check_evaluator(bool hf)
+{
+    std::vector<planet::planet_ptr> seq{planet::jpl_lp("earth").clone(), planet::jpl_lp("venus").clone(),
+                                        planet::jpl_lp("mercury").clone()};
+    trajopt::mga_lt_nep_evaluator udp(seq, {5u, 20u}, 3000., 2000., 2000., 0.5, 3500., true, hf);
+    std::vector<double> x(udp.get_nx(), 0.1);
+    x[0] = 3200.;
+    x[1] = 300.;
+    x[2] = 1800.;
+    x[9] = 500.;
+    x[10] = 1600.;
+    for (std::size_t j = 3u; j < 9u; ++j) {
+        x[j] = 1000. * std::cos(static_cast<double>(j));
+        x[8u + j] = 1500. * std::sin(static_cast<double>(j));
+    }
+    const auto &sp = udp.get_gradient_sparsity();
+    const auto colours = util::colour_columns(sp, udp.get_nx());
+    const std::size_t n_colours = *std::max_element(colours.begin(), colours.end()) + 1u;
+    if (!valid_colouring(sp, colours) || n_colours >= udp.get_nx()) {
+        std::cout << "Wrong colouring of the evaluator pattern (" << n_colours << " colours)" << std::endl;
+        return 1;
+    }
+    // Dense finite differences, column by column
+    const auto f0 = udp.fitness(x);
+    const std::size_t n_rows = f0.size(), n_cols = x.size();
+    std::vector<double> dense(n_rows * n_cols);
+    for (std::size_t j = 0u; j < n_cols; ++j) {
+        auto xp = x;
+        xp[j] += 1e-8 * std::max(1., std::abs(x[j]));
+        const double h = xp[j] - x[j];
+        const auto fp = udp.fitness(xp);
+        for (std::size_t i = 0u; i < n_rows; ++i) {
+            dense[i * n_cols + j] = (fp[i] - f0[i]) / h;
+        }
+    }
+    // With the Taylor integrator the step size depends on the whole state, so that structurally zero entries are
+    // only zero up to the integration noise. In the chemical model the comparisons are exact.
+    const double tol = hf ? 1e-8 : 0.;
+    const std::set<std::pair<std::size_t, std::size_t>> pattern(sp.begin(), sp.end());
+    for (std::size_t i = 0u; i < n_rows; ++i) {
+        for (std::size_t j = 0u; j < n_cols; ++j) {
+            if (std::abs(dense[i * n_cols + j]) > tol && !pattern.count(std::make_pair(i, j))) {
+                std::cout << "Non-zero entry (" << i << ", " << j << ") missing in the sparsity pattern" << std::endl;
+                return 1;
+            }
+        }
+    }
+    const auto grad = udp.gradient(x);
+    for (std::size_t k = 0u; k < sp.size(); ++k) {
+        const double d = dense[sp[k].first * n_cols + sp[k].second];
+        if (std::abs(grad[k] - d) > tol * std::max(1., std::abs(d))) {
+            std::cout << "Coloured gradient differs from the dense one at (" << sp[k].first << ", " << sp[k].second
+                      << ")" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main()
+{
+    if (check_colouring() || check_evaluator(false) || check_evaluator(true)) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
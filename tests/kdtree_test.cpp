@@ -0,0 +1,217 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/phasing/kdtree.hpp>
+#include <keplerian_toolbox/planet/keplerian.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we index a random asteroid belt with the kd-tree, in both metrics and with different numbers of
+// threads, and compare the knn and ball queries with a brute force search. The tree is then moved across epochs
+// with update() and compared with trees built at those epochs.
+
+std::vector<std::pair<double, std::size_t>> brute_force(const phasing::kdtree &tree,
+                                                        const phasing::kdtree::point_type &x)
+{
+    std::vector<std::pair<double, std::size_t>> retval;
+    for (std::size_t i = 0; i < tree.size(); ++i) {
+        const auto &p = tree.get_point(i);
+        double d2 = 0.;
+        for (unsigned k = 0; k < 6; ++k) {
+            d2 += (x[k] - p[k]) * (x[k] - p[k]);
+        }
+        retval.emplace_back(d2, i);
+    }
+    std::sort(retval.begin(), retval.end());
+    return retval;
+}
+
+int check(const std::vector<planet::planet_ptr> &belt, phasing::kdtree::metric m, unsigned n_threads)
+{
+    const double t = 7000.;
+    phasing::kdtree tree(belt, t, m, 180., ASTRO_AU, ASTRO_EARTH_VELOCITY, n_threads);
+    if (tree.size() != belt.size()) {
+        std::cout << "Wrong tree size" << std::endl;
+        return 1;
+    }
+    // The embedding of the planets
+    array3D r, v;
+    belt[7]->eph(t, r, v);
+    const auto p7 = tree.get_point(7);
+    if (m == phasing::kdtree::ORBITAL
+        && (p7[3] != r[0] / (180. * ASTRO_DAY2SEC) || p7[0] != r[0] / (180. * ASTRO_DAY2SEC) + v[0])) {
+        std::cout << "Wrong orbital embedding" << std::endl;
+        return 1;
+    }
+    if (m == phasing::kdtree::EUCLIDEAN && (p7[0] != r[0] / ASTRO_AU || p7[3] != v[0] / ASTRO_EARTH_VELOCITY)) {
+        std::cout << "Wrong euclidean embedding" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::size_t> ids;
+    std::vector<double> dists;
+    for (std::size_t q = 0; q < belt.size(); q += 97) {
+        const auto &x = tree.get_point(q);
+        const auto bf = brute_force(tree, x);
+        for (std::size_t k : {1u, 10u, 100u}) {
+            tree.query_knn(x, k, ids, dists);
+            if (ids.size() != k) {
+                std::cout << "Wrong number of neighbours" << std::endl;
+                return 1;
+            }
+            for (std::size_t j = 0; j < k; ++j) {
+                if (ids[j] != bf[j].second || dists[j] != std::sqrt(bf[j].first)) {
+                    std::cout << "knn query differs from the brute force search" << std::endl;
+                    return 1;
+                }
+            }
+        }
+        // A ball containing the 50 nearest neighbours
+        const double radius = std::sqrt(bf[49].first);
+        tree.query_ball(x, radius, ids, dists);
+        std::size_t n_in = 0;
+        while (n_in < bf.size() && bf[n_in].first <= radius * radius) {
+            ++n_in;
+        }
+        if (ids.size() != n_in) {
+            std::cout << "Wrong number of points in the ball" << std::endl;
+            return 1;
+        }
+        for (std::size_t j = 0; j < n_in; ++j) {
+            if (ids[j] != bf[j].second) {
+                std::cout << "Ball query differs from the brute force search" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    // Batch queries and a planet not in the tree
+    std::vector<std::size_t> idxs{0u, 3u, 1000u, belt.size() - 1u}, bids;
+    std::vector<double> bdists;
+    tree.query_knn(idxs, 5u, bids, bdists, n_threads);
+    for (std::size_t q = 0; q < idxs.size(); ++q) {
+        tree.query_knn(tree.get_point(idxs[q]), 5u, ids, dists);
+        if (!std::equal(ids.begin(), ids.end(), bids.begin() + 5 * q) || bids[5 * q] != idxs[q]) {
+            std::cout << "Batch knn query differs from the single queries" << std::endl;
+            return 1;
+        }
+    }
+    tree.query_knn(tree.embed(*belt[3]), 1u, ids, dists);
+    if (ids[0] != 3u || dists[0] != 0.) {
+        std::cout << "A planet is not its own nearest neighbour" << std::endl;
+        return 1;
+    }
+    tree.query_knn(tree.get_point(0), 2 * belt.size(), ids, dists);
+    if (ids.size() != belt.size()) {
+        std::cout << "A knn query with k larger than the tree size must return the whole tree" << std::endl;
+        return 1;
+    }
+
+    // Moving the tree: the refitted tree answers as a tree built at the new epoch
+    for (unsigned step = 1; step <= 5; ++step) {
+        const double t_new = t + 30. * step;
+        if (tree.update(t_new, 1e300, n_threads)) {
+            std::cout << "The tree was rebuilt with an infinite rebuild factor" << std::endl;
+            return 1;
+        }
+        phasing::kdtree fresh(belt, t_new, m, 180., ASTRO_AU, ASTRO_EARTH_VELOCITY, n_threads);
+        std::vector<std::size_t> fids;
+        std::vector<double> fdists;
+        for (std::size_t q = 0; q < belt.size(); q += 331) {
+            if (tree.get_point(q) != fresh.get_point(q)) {
+                std::cout << "Updated points differ from the points of a new tree" << std::endl;
+                return 1;
+            }
+            tree.query_knn(tree.get_point(q), 20u, ids, dists);
+            fresh.query_knn(fresh.get_point(q), 20u, fids, fdists);
+            if (ids != fids || dists != fdists) {
+                std::cout << "Updated tree knn query differs from a new tree" << std::endl;
+                return 1;
+            }
+            tree.query_ball(tree.get_point(q), dists.back(), ids, dists);
+            fresh.query_ball(fresh.get_point(q), fdists.back(), fids, fdists);
+            if (ids != fids || dists != fdists) {
+                std::cout << "Updated tree ball query differs from a new tree" << std::endl;
+                return 1;
+            }
+        }
+    }
+    if (!(tree.get_degradation() > 1.)) {
+        std::cout << "The refitted tree is not degraded" << std::endl;
+        return 1;
+    }
+    if (!tree.update(t + 200., 1., n_threads) || tree.get_degradation() != 1.) {
+        std::cout << "The degraded tree was not rebuilt" << std::endl;
+        return 1;
+    }
+
+    try {
+        tree.get_point(belt.size());
+        std::cout << "Out of range index not detected" << std::endl;
+        return 1;
+    } catch (const std::exception &) {
+    }
+    return 0;
+}
+
+int main()
+{
+    std::mt19937 gen(42u);
+    std::uniform_real_distribution<double> u(0., 1.);
+    std::vector<planet::planet_ptr> belt;
+    for (unsigned i = 0; i < 3000; ++i) {
+        const array6D elem{{(2. + u(gen)) * ASTRO_AU, 0.2 * u(gen), 0.3 * u(gen), 6.28 * u(gen), 6.28 * u(gen),
+                            6.28 * u(gen)}};
+        belt.push_back(planet::keplerian(epoch(6000.), elem, ASTRO_MU_SUN, 1., 1., 1.).clone());
+    }
+    int res = 0;
+    for (auto m : {phasing::kdtree::ORBITAL, phasing::kdtree::EUCLIDEAN}) {
+        for (unsigned n_threads : {1u, 3u, 0u}) {
+            res += check(belt, m, n_threads);
+        }
+    }
+    try {
+        phasing::kdtree(belt, 7000., phasing::kdtree::ORBITAL, 0.);
+        std::cout << "Non positive transfer time not detected" << std::endl;
+        ++res;
+    } catch (const std::exception &) {
+    }
+    if (res) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
@@ -0,0 +1,130 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <array>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/array3D_operations.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/lambert_problem.hpp>
+#include <keplerian_toolbox/phasing/lambert_matrix.hpp>
+#include <keplerian_toolbox/planet/keplerian.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we compute the Lambert transfer cost matrix of a few asteroids and compare it with a brute force
+// implementation solving one lambert_problem at a time.
+
+int main()
+{
+    std::mt19937 gen(11u);
+    std::uniform_real_distribution<double> u(0., 1.);
+    std::vector<planet::planet_ptr> ast;
+    for (unsigned i = 0; i < 30; ++i) {
+        const array6D elem{{(2.2 + 0.6 * u(gen)) * ASTRO_AU, 0.15 * u(gen), 0.5 * u(gen), 6.28 * u(gen),
+                            6.28 * u(gen), 6.28 * u(gen)}};
+        ast.push_back(planet::keplerian(epoch(6000.), elem, ASTRO_MU_SUN, 1., 1., 1.).clone());
+    }
+    const std::array<double, 2> t0{{7000., 7300.}}, tof{{100., 400.}};
+    const unsigned n_t0 = 7u, n_tof = 5u;
+    const std::size_t n = ast.size();
+
+    // Reference
+    std::vector<double> ref(n * n, std::numeric_limits<double>::infinity()), ref_t0(n * n), ref_tof(n * n);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            if (i == j) {
+                continue;
+            }
+            for (unsigned k = 0; k < n_t0; ++k) {
+                for (unsigned l = 0; l < n_tof; ++l) {
+                    const double t = t0[0] + (t0[1] - t0[0]) * k / (n_t0 - 1);
+                    const double T = tof[0] + (tof[1] - tof[0]) * l / (n_tof - 1);
+                    array3D r1, v1, r2, v2, dv1, dv2;
+                    ast[i]->eph(epoch(t), r1, v1);
+                    ast[j]->eph(epoch(t + T), r2, v2);
+                    const lambert_problem lp(r1, r2, T * ASTRO_DAY2SEC, ASTRO_MU_SUN);
+                    diff(dv1, lp.get_v1()[0], v1);
+                    diff(dv2, v2, lp.get_v2()[0]);
+                    const double cost = norm(dv1) + norm(dv2);
+                    if (cost < ref[i * n + j]) {
+                        ref[i * n + j] = cost;
+                        ref_t0[i * n + j] = t;
+                        ref_tof[i * n + j] = T;
+                    }
+                }
+            }
+        }
+    }
+
+    int res = 0;
+    for (double dv_max : {std::numeric_limits<double>::infinity(), 8000.}) {
+        for (unsigned n_threads : {1u, 4u, 0u}) {
+            std::vector<float> dv, best_t0, best_tof;
+            const std::size_t solved
+                = phasing::lambert_matrix(ast, t0, n_t0, tof, n_tof, dv, best_t0, best_tof, dv_max, n_threads);
+            if (dv.size() != n * n || best_t0.size() != n * n || best_tof.size() != n * n) {
+                std::cout << "Wrong size of the outputs" << std::endl;
+                return 1;
+            }
+            if ((std::isinf(dv_max) && solved != n * (n - 1)) || (!std::isinf(dv_max) && solved == n * (n - 1))) {
+                std::cout << "Wrong number of solved pairs: " << solved << std::endl;
+                res = 1;
+            }
+            for (std::size_t ij = 0; ij < n * n; ++ij) {
+                if (std::isinf(ref[ij]) || ref[ij] > dv_max) {
+                    if (!std::isinf(dv[ij]) || !std::isnan(best_t0[ij]) || !std::isnan(best_tof[ij])) {
+                        std::cout << "Transfer " << ij << " should not be reported" << std::endl;
+                        res = 1;
+                    }
+                } else if (std::abs(dv[ij] - ref[ij]) > 1e-5 * ref[ij]
+                           || std::abs(best_t0[ij] - ref_t0[ij]) > 1e-3 || best_tof[ij] != ref_tof[ij]) {
+                    std::cout << "Transfer " << ij << " differs from the reference: " << dv[ij] << " " << ref[ij]
+                              << std::endl;
+                    res = 1;
+                }
+            }
+        }
+    }
+    try {
+        std::vector<float> dv, best_t0, best_tof;
+        phasing::lambert_matrix(ast, t0, n_t0, {{0., 100.}}, n_tof, dv, best_t0, best_tof);
+        std::cout << "Zero time of flight not detected" << std::endl;
+        res = 1;
+    } catch (const std::exception &) {
+    }
+    if (res) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
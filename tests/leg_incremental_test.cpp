@@ -0,0 +1,126 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/planet/jpl_low_precision.hpp>
+#include <keplerian_toolbox/sims_flanagan/leg.hpp>
+#include <keplerian_toolbox/sims_flanagan/spacecraft.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we modify randomly the throttles, the epochs and the boundary states of a leg many times and
+// check that the mismatch computed restarting from the cached segment states is exactly the one computed by a
+// freshly constructed leg, in both the chemical and the high-fidelity modes. We also evaluate a shared leg from
+// several threads and check that all of them get the serial result.
+
+int check(bool hf)
+{
+    const unsigned n_seg = 10u;
+    sims_flanagan::spacecraft sc(1000., 0.3, 2500.);
+    planet::jpl_lp earth("earth"), mars("mars");
+    array3D r, v;
+    earth.eph(epoch(1000.), r, v);
+    sims_flanagan::sc_state xi(r, v, 1000.);
+    mars.eph(epoch(1250.), r, v);
+    sims_flanagan::sc_state xf(r, v, 800.);
+    std::vector<double> thr(3 * n_seg, 0.1);
+    double ti = 1000., tf = 1250.;
+
+    sims_flanagan::leg cached;
+    cached.set_spacecraft(sc);
+    cached.set_mu(ASTRO_MU_SUN);
+    cached.set_high_fidelity(hf);
+
+    std::mt19937 gen(42u);
+    std::uniform_real_distribution<double> u(-0.5, 0.5);
+    std::uniform_int_distribution<unsigned> pick(0u, 3u * n_seg + 3u);
+    for (int trial = 0; trial < 200; ++trial) {
+        unsigned what = pick(gen);
+        if (what < 3u * n_seg) {
+            thr[what] = u(gen);
+        } else if (what == 3u * n_seg) {
+            ti += u(gen);
+        } else if (what == 3u * n_seg + 1u) {
+            tf += u(gen);
+        } else if (what == 3u * n_seg + 2u) {
+            xi.set_mass(xi.get_mass() + u(gen));
+        } else {
+            xf.set_mass(xf.get_mass() + u(gen));
+        }
+        cached.set_leg(epoch(ti), xi, thr, epoch(tf), xf);
+        sims_flanagan::leg fresh(epoch(ti), xi, thr, epoch(tf), xf, sc, ASTRO_MU_SUN);
+        fresh.set_high_fidelity(hf);
+        array7D m1, m2;
+        cached.get_mismatch_con(m1.begin(), m1.end());
+        fresh.get_mismatch_con(m2.begin(), m2.end());
+        if (m1 != m2) {
+            std::cout << "Mismatch differs from a fresh evaluation at trial " << trial << std::endl;
+            return 1;
+        }
+    }
+
+    // Concurrent evaluations on the same leg
+    const sims_flanagan::leg &shared = cached;
+    sims_flanagan::leg serial(epoch(ti), xi, thr, epoch(tf), xf, sc, ASTRO_MU_SUN);
+    serial.set_high_fidelity(hf);
+    array7D ref;
+    serial.get_mismatch_con(ref.begin(), ref.end());
+    std::vector<int> failures(4u, 0);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0u; t < failures.size(); ++t) {
+        threads.emplace_back([&shared, &ref, &failures, t]() {
+            array7D m;
+            for (int trial = 0; trial < 100; ++trial) {
+                shared.get_mismatch_con(m.begin(), m.end());
+                failures[t] += (m != ref);
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+    for (int f : failures) {
+        if (f) {
+            std::cout << "Concurrent evaluations differ from the serial one" << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main()
+{
+    if (check(false) || check(true)) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
@@ -0,0 +1,170 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <keplerian_toolbox/core_functions/propagate_lagrangian.hpp>
+#include <keplerian_toolbox/core_functions/propagate_lagrangian_stm.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/planet/jpl_low_precision.hpp>
+#include <keplerian_toolbox/sims_flanagan/leg.hpp>
+#include <keplerian_toolbox/sims_flanagan/spacecraft.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we check the analytical Jacobian of the sims_flanagan::leg constraints against central finite
+// differences, in both the chemical and the high-fidelity modes. Rows and columns are made non-dimensional
+// before the comparison. We also check that propagate_lagrangian_stm propagates as propagate_lagrangian.
+
+// The leg decision vector (t_i, x_i, throttles, t_f, x_f)
+std::vector<double> constraints(sims_flanagan::leg &l, const std::vector<double> &x, std::size_t n_seg)
+{
+    std::vector<double> thr(x.begin() + 8, x.begin() + 8 + 3 * n_seg);
+    const double *xf = &x[9 + 3 * n_seg];
+    sims_flanagan::sc_state xi_s({{x[1], x[2], x[3]}}, {{x[4], x[5], x[6]}}, x[7]);
+    sims_flanagan::sc_state xf_s({{xf[0], xf[1], xf[2]}}, {{xf[3], xf[4], xf[5]}}, xf[6]);
+    l.set_leg(epoch(x[0]), xi_s, thr, epoch(x[8 + 3 * n_seg]), xf_s);
+    std::vector<double> retval(7 + n_seg);
+    l.get_mismatch_con(retval.begin(), retval.begin() + 7);
+    l.get_throttles_con(retval.begin() + 7, retval.end());
+    return retval;
+}
+
+int check_leg(bool hf)
+{
+    const std::size_t n_seg = 5u;
+    sims_flanagan::spacecraft sc(1000., 0.3, 2500.);
+    sims_flanagan::leg l;
+    l.set_spacecraft(sc);
+    l.set_mu(ASTRO_MU_SUN);
+    l.set_high_fidelity(hf);
+    planet::jpl_lp earth("earth"), mars("mars");
+    array3D r, v;
+    std::vector<double> x;
+    x.push_back(1000.);
+    earth.eph(epoch(1000.), r, v);
+    x.insert(x.end(), r.begin(), r.end());
+    x.insert(x.end(), v.begin(), v.end());
+    x.push_back(1000.);
+    const double thr[15] = {0.3, -0.2, 0.5, 0.8, 0.1, -0.1, 0.0, 0.0, 0.0, -0.4, 0.6, 0.2, 0.1, 0.7, -0.3};
+    x.insert(x.end(), thr, thr + 15);
+    x.push_back(1250.);
+    mars.eph(epoch(1250.), r, v);
+    x.insert(x.end(), r.begin(), r.end());
+    x.insert(x.end(), v.begin(), v.end());
+    x.push_back(800.);
+
+    // Non-dimensional units
+    std::vector<double> row_scale = {ASTRO_AU, ASTRO_AU, ASTRO_AU, ASTRO_EARTH_VELOCITY, ASTRO_EARTH_VELOCITY,
+                                     ASTRO_EARTH_VELOCITY, 1000.};
+    row_scale.resize(7 + n_seg, 1.);
+    std::vector<double> col_scale(x.size(), 1.);
+    for (std::size_t k : {std::size_t(0u), 8 + 3 * n_seg}) {
+        col_scale[k] = 100.;
+        for (std::size_t i = 0u; i < 3u; ++i) {
+            col_scale[k + 1 + i] = ASTRO_AU;
+            col_scale[k + 4 + i] = ASTRO_EARTH_VELOCITY;
+        }
+        col_scale[k + 7] = 1000.;
+    }
+
+    constraints(l, x, n_seg);
+    std::vector<double> jac;
+    l.get_constraints_jacobian(jac);
+    const std::size_t n_cols = x.size();
+    if (jac.size() != (7 + n_seg) * n_cols) {
+        std::cout << "Wrong Jacobian size" << std::endl;
+        return 1;
+    }
+    double max_err = 0.;
+    for (std::size_t j = 0u; j < n_cols; ++j) {
+        const double h = 1e-6 * col_scale[j];
+        std::vector<double> xp(x), xm(x);
+        xp[j] += h;
+        xm[j] -= h;
+        std::vector<double> cp = constraints(l, xp, n_seg), cm = constraints(l, xm, n_seg);
+        for (std::size_t i = 0u; i < 7 + n_seg; ++i) {
+            const double fd = (cp[i] - cm[i]) / (2 * h) * col_scale[j] / row_scale[i];
+            const double an = jac[i * n_cols + j] * col_scale[j] / row_scale[i];
+            max_err = std::max(max_err, std::abs(fd - an));
+        }
+    }
+    std::cout << (hf ? "High-fidelity" : "Chemical") << " leg, maximum non-dimensional error: " << max_err
+              << std::endl;
+    if (!(max_err < 1e-6)) {
+        return 1;
+    }
+
+    // The sparse Jacobian holds the non-zero entries
+    constraints(l, x, n_seg);
+    std::vector<double> values;
+    l.get_constraints_jacobian_sparse(values);
+    std::vector<std::pair<std::size_t, std::size_t>> pattern = l.get_constraints_jacobian_sparsity();
+    double n_dense = 0., n_sparse = 0.;
+    for (std::size_t k = 0u; k < pattern.size(); ++k) {
+        n_sparse += std::abs(values[k]);
+    }
+    for (double d : jac) {
+        n_dense += std::abs(d);
+    }
+    if (values.size() != pattern.size() || n_dense != n_sparse) {
+        std::cout << "Wrong sparse Jacobian" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main()
+{
+    // Elliptic and hyperbolic, forward and backward propagations
+    const double vs[2] = {30000., 45000.};
+    const double ts[2] = {86400. * 200., -86400. * 130.};
+    for (double v0 : vs) {
+        for (double t : ts) {
+            array3D r1 = {{ASTRO_AU, 0.1 * ASTRO_AU, 0.}}, v1 = {{-1000., v0, 2000.}};
+            array3D r2(r1), v2(v1);
+            std::array<double, 36> stm;
+            propagate_lagrangian(r1, v1, t, ASTRO_MU_SUN);
+            propagate_lagrangian_stm(r2, v2, t, ASTRO_MU_SUN, stm);
+            for (unsigned i = 0u; i < 3u; ++i) {
+                if (std::abs(r1[i] - r2[i]) > 1e-8 * ASTRO_AU || std::abs(v1[i] - v2[i]) > 1e-8 * v0) {
+                    std::cout << "propagate_lagrangian_stm does not match propagate_lagrangian" << std::endl;
+                    std::cout << "FAIL" << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+    if (check_leg(false) || check_leg(true)) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
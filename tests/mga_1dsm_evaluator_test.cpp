@@ -0,0 +1,193 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <boost/math/constants/constants.hpp>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/fb_prop.hpp>
+#include <keplerian_toolbox/core_functions/propagate_lagrangian_u.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/lambert_problem.hpp>
+#include <keplerian_toolbox/planet/jpl_low_precision.hpp>
+#include <keplerian_toolbox/trajopt/batch_fitness.hpp>
+#include <keplerian_toolbox/trajopt/mga_1dsm_evaluator.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we evaluate random decision vectors of the Cassini MGA-1DSM trajectory, in the three encodings of
+// the times of flight, with the native evaluator and compare the result with an evaluation written as in
+// pykep.trajopt.mga_1dsm (lambert_problem objects, propagate_lagrangian and fb_prop).
+
+double norm3(const array3D &a, const array3D &b)
+{
+    return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) + (a[2] - b[2]) * (a[2] - b[2]));
+}
+
+std::vector<double> reference(const std::vector<planet::planet_ptr> &seq, const std::vector<double> &x,
+                              const std::vector<double> &T, bool add_vinf_dep, double e_target, double rp_target)
+{
+    const double pi = boost::math::constants::pi<double>(), mu = seq[0]->get_mu_central_body();
+    const std::size_t n_legs = T.size();
+    std::vector<array3D> r_P(n_legs + 1), v_P(n_legs + 1);
+    std::vector<double> DV(n_legs + 1, 0.);
+    for (std::size_t i = 0; i <= n_legs; ++i) {
+        double s = 0.;
+        for (std::size_t j = 0; j < i; ++j) {
+            s += T[j];
+        }
+        seq[i]->eph(epoch(x[0] + s), r_P[i], v_P[i]);
+    }
+    const double theta = 2 * pi * x[1], phi = std::acos(2 * x[2] - 1) - pi / 2;
+    array3D vinf{{x[3] * std::cos(phi) * std::cos(theta), x[3] * std::cos(phi) * std::sin(theta),
+                  x[3] * std::sin(phi)}};
+    array3D r = r_P[0], v;
+    for (unsigned j = 0; j < 3; ++j) {
+        v[j] = v_P[0][j] + vinf[j];
+    }
+    propagate_lagrangian_u(r, v, x[4] * T[0] * ASTRO_DAY2SEC, mu);
+    lambert_problem l(r, r_P[1], (1 - x[4]) * T[0] * ASTRO_DAY2SEC, mu, 0, 0);
+    array3D v_end_l = l.get_v2()[0];
+    DV[0] = norm3(l.get_v1()[0], v);
+    for (std::size_t i = 1; i < n_legs; ++i) {
+        array3D v_out;
+        fb_prop(v_out, v_end_l, v_P[i], x[7 + (i - 1) * 4] * seq[i]->get_radius(), x[6 + (i - 1) * 4],
+                seq[i]->get_mu_self());
+        r = r_P[i];
+        v = v_out;
+        propagate_lagrangian_u(r, v, x[8 + (i - 1) * 4] * T[i] * ASTRO_DAY2SEC, mu);
+        lambert_problem li(r, r_P[i + 1], (1 - x[8 + (i - 1) * 4]) * T[i] * ASTRO_DAY2SEC, mu, 0, 0);
+        v_end_l = li.get_v2()[0];
+        DV[i] = norm3(li.get_v1()[0], v);
+    }
+    DV[n_legs] = norm3(v_end_l, v_P[n_legs]);
+    const double mu_p = seq.back()->get_mu_self();
+    const double dv_per = std::sqrt(DV[n_legs] * DV[n_legs] + 2 * mu_p / rp_target);
+    const double dv_per2 = std::sqrt(2 * mu_p / rp_target - mu_p / rp_target * (1. - e_target));
+    DV[n_legs] = std::abs(dv_per - dv_per2);
+    if (add_vinf_dep) {
+        DV[0] += x[3];
+    }
+    double dv = 0., t = 0.;
+    for (auto d : DV) {
+        dv += d;
+    }
+    for (auto d : T) {
+        t += d;
+    }
+    return {dv, t};
+}
+
+int check(trajopt::mga_1dsm_evaluator::tof_encoding enc, bool add_vinf_dep)
+{
+    std::vector<planet::planet_ptr> seq{planet::jpl_lp("earth").clone(),   planet::jpl_lp("venus").clone(),
+                                        planet::jpl_lp("venus").clone(),   planet::jpl_lp("earth").clone(),
+                                        planet::jpl_lp("jupiter").clone(), planet::jpl_lp("saturn").clone()};
+    const double e_target = 0.98, rp_target = 108950000., tof_max = 7000.;
+    trajopt::mga_1dsm_evaluator udp(seq, enc, tof_max, add_vinf_dep, true, true, true, e_target, rp_target);
+    const std::size_t n_legs = seq.size() - 1;
+
+    std::mt19937 gen(123u);
+    std::uniform_real_distribution<double> u(0., 1.);
+    std::vector<double> x(udp.get_nx()), T(n_legs), f, dvs;
+    for (int trial = 0; trial < 100; ++trial) {
+        x[0] = -1000. + 1000. * u(gen);
+        x[1] = u(gen);
+        x[2] = u(gen);
+        x[3] = 3000. + 2000. * u(gen);
+        for (std::size_t i = 0; i < n_legs; ++i) {
+            x[4 + 4 * i] = 0.1 + 0.8 * u(gen);
+            if (i > 0) {
+                x[2 + 4 * i] = 4 * boost::math::constants::pi<double>() * (u(gen) - 0.5);
+                x[3 + 4 * i] = 1.1 + 5. * u(gen);
+            }
+        }
+        if (enc == trajopt::mga_1dsm_evaluator::DIRECT) {
+            for (std::size_t i = 0; i < n_legs; ++i) {
+                x[5 + 4 * i] = T[i] = 30. + 1000. * u(gen);
+            }
+        } else if (enc == trajopt::mga_1dsm_evaluator::ALPHA) {
+            x.back() = 4000. + 3000. * u(gen);
+            double s = 0.;
+            for (std::size_t i = 0; i < n_legs; ++i) {
+                x[5 + 4 * i] = 1e-3 + 0.998 * u(gen);
+                s += -std::log(x[5 + 4 * i]);
+            }
+            for (std::size_t i = 0; i < n_legs; ++i) {
+                T[i] = x.back() * -std::log(x[5 + 4 * i]) / s;
+            }
+        } else {
+            double s = 0.;
+            for (std::size_t i = 0; i < n_legs; ++i) {
+                x[5 + 4 * i] = 1e-3 + 0.998 * u(gen);
+                T[i] = (tof_max - s) * x[5 + 4 * i];
+                s += T[i];
+            }
+        }
+        udp.fitness(x, f);
+        if (f != reference(seq, x, T, add_vinf_dep, e_target, rp_target)) {
+            std::cout << "Fitness differs from the reference at trial " << trial << std::endl;
+            return 1;
+        }
+        dvs.insert(dvs.end(), x.begin(), x.end());
+    }
+    // Batch evaluation
+    const auto bf = trajopt::batch_fitness(udp, dvs, 2u);
+    for (std::size_t i = 0; i < 100u; ++i) {
+        std::vector<double> xi(dvs.begin() + i * x.size(), dvs.begin() + (i + 1) * x.size());
+        if (udp.fitness(xi) != std::vector<double>(bf.begin() + 2 * i, bf.begin() + 2 * (i + 1))) {
+            std::cout << "Batch fitness differs from the fitness" << std::endl;
+            return 1;
+        }
+    }
+    x.pop_back();
+    try {
+        udp.fitness(x);
+        std::cout << "Wrong decision vector size not detected" << std::endl;
+        return 1;
+    } catch (const std::exception &) {
+    }
+    return 0;
+}
+
+int main()
+{
+    int res = 0;
+    for (auto enc : {trajopt::mga_1dsm_evaluator::DIRECT, trajopt::mga_1dsm_evaluator::ALPHA,
+                     trajopt::mga_1dsm_evaluator::ETA}) {
+        res += check(enc, false) + check(enc, true);
+    }
+    if (res) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
@@ -0,0 +1,191 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/fb_vel.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/lambert_problem.hpp>
+#include <keplerian_toolbox/planet/jpl_low_precision.hpp>
+#include <keplerian_toolbox/trajopt/batch_fitness.hpp>
+#include <keplerian_toolbox/trajopt/mga_evaluator.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we evaluate random decision vectors of the Cassini MGA trajectory, in the three encodings of the
+// times of flight, with the native evaluator and compare the result with an evaluation written as in
+// pykep.trajopt.mga (lambert_problem objects and fb_vel).
+
+std::vector<double> reference(const std::vector<planet::planet_ptr> &seq, const std::vector<double> &T, double t0,
+                              double vinf, bool orbit_insertion, double e_target, double rp_target)
+{
+    const std::size_t n_legs = T.size();
+    std::vector<double> ep{t0};
+    for (std::size_t i = 0; i < n_legs; ++i) {
+        ep.push_back(ep.back() + T[i]);
+    }
+    std::vector<array3D> r(n_legs + 1), v(n_legs + 1);
+    for (std::size_t i = 0; i <= n_legs; ++i) {
+        seq[i]->eph(epoch(ep[i]), r[i], v[i]);
+    }
+    std::vector<lambert_problem> l;
+    for (std::size_t i = 0; i < n_legs; ++i) {
+        l.emplace_back(r[i], r[i + 1], T[i] * ASTRO_DAY2SEC, seq[0]->get_mu_central_body(), 0, 0);
+    }
+    double dv_fb = 0.;
+    for (std::size_t i = 0; i + 1 < n_legs; ++i) {
+        array3D vin, vout;
+        for (unsigned j = 0; j < 3; ++j) {
+            vin[j] = l[i].get_v2()[0][j] - v[i + 1][j];
+            vout[j] = l[i + 1].get_v1()[0][j] - v[i + 1][j];
+        }
+        double dv;
+        fb_vel(dv, vin, vout, *seq[i + 1]);
+        dv_fb += dv;
+    }
+    array3D dep, arr;
+    for (unsigned j = 0; j < 3; ++j) {
+        dep[j] = v[0][j] - l[0].get_v1()[0][j];
+        arr[j] = v[n_legs][j] - l.back().get_v2()[0][j];
+    }
+    const double dv_launch = std::max(0., std::sqrt(dep[0] * dep[0] + dep[1] * dep[1] + dep[2] * dep[2]) - vinf);
+    double dv_arr = std::sqrt(arr[0] * arr[0] + arr[1] * arr[1] + arr[2] * arr[2]);
+    if (orbit_insertion) {
+        const double mu = seq.back()->get_mu_self();
+        const double dv_per = std::sqrt(dv_arr * dv_arr + 2 * mu / rp_target);
+        const double dv_per2 = std::sqrt(2 * mu / rp_target - mu / rp_target * (1. - e_target));
+        dv_arr = std::abs(dv_per - dv_per2);
+    }
+    return {dv_launch + dv_fb + dv_arr};
+}
+
+bool close(double a, double b)
+{
+    return std::abs(a - b) <= 1e-12 * std::max(1., std::abs(b));
+}
+
+int check(trajopt::mga_evaluator::tof_encoding enc, bool orbit_insertion)
+{
+    std::vector<planet::planet_ptr> seq{planet::jpl_lp("earth").clone(),   planet::jpl_lp("venus").clone(),
+                                        planet::jpl_lp("venus").clone(),   planet::jpl_lp("earth").clone(),
+                                        planet::jpl_lp("jupiter").clone(), planet::jpl_lp("saturn").clone()};
+    const double vinf = 3000., e_target = 0.98, rp_target = 108950000., tof_max = 7000.;
+    trajopt::mga_evaluator udp(seq, enc, tof_max, vinf, true, orbit_insertion, e_target, rp_target);
+    const std::size_t n_legs = seq.size() - 1;
+
+    std::mt19937 gen(123u);
+    std::uniform_real_distribution<double> u(0., 1.);
+    std::vector<double> x(udp.get_nx()), T(n_legs), f, dvs;
+    for (int trial = 0; trial < 100; ++trial) {
+        x[0] = -1000. + 1000. * u(gen);
+        double T_tot = 0.;
+        if (enc == trajopt::mga_evaluator::DIRECT) {
+            for (std::size_t i = 0; i < n_legs; ++i) {
+                x[1 + i] = T[i] = 30. + 1000. * u(gen);
+                T_tot += T[i];
+            }
+        } else if (enc == trajopt::mga_evaluator::ALPHA) {
+            x[1] = T_tot = 4000. + 3000. * u(gen);
+            double s = 0.;
+            for (std::size_t i = 0; i < n_legs; ++i) {
+                x[2 + i] = 1e-3 + 0.998 * u(gen);
+                s += std::log(x[2 + i]);
+            }
+            for (std::size_t i = 0; i < n_legs; ++i) {
+                T[i] = std::log(x[2 + i]) / s * x[1];
+            }
+        } else {
+            for (std::size_t i = 0; i < n_legs; ++i) {
+                x[1 + i] = 1e-3 + 0.998 * u(gen);
+                T[i] = (tof_max - T_tot) * x[1 + i];
+                T_tot += T[i];
+            }
+        }
+        const auto ref = reference(seq, T, x[0], vinf, orbit_insertion, e_target, rp_target);
+        udp.fitness(x, f);
+        if (f.size() != 2u || !close(f[0], ref[0]) || !close(f[1], T_tot)) {
+            std::cout << "Fitness differs from the reference at trial " << trial << ": " << f[0] << " " << ref[0]
+                      << std::endl;
+            return 1;
+        }
+        dvs.insert(dvs.end(), x.begin(), x.end());
+    }
+    // Batch evaluation
+    const auto bf = trajopt::batch_fitness(udp, dvs, 2u);
+    for (std::size_t i = 0; i < 100u; ++i) {
+        std::vector<double> xi(dvs.begin() + i * x.size(), dvs.begin() + (i + 1) * x.size());
+        if (udp.fitness(xi) != std::vector<double>(bf.begin() + 2 * i, bf.begin() + 2 * (i + 1))) {
+            std::cout << "Batch fitness differs from the fitness" << std::endl;
+            return 1;
+        }
+    }
+    x.pop_back();
+    try {
+        udp.fitness(x);
+        std::cout << "Wrong decision vector size not detected" << std::endl;
+        return 1;
+    } catch (const std::exception &) {
+    }
+    return 0;
+}
+
+// The zero revolutions solution must be the one of lambert_problem
+int check_lambert()
+{
+    std::mt19937 gen(321u);
+    std::uniform_real_distribution<double> u(-1., 1.);
+    for (int trial = 0; trial < 10000; ++trial) {
+        array3D r1{{u(gen), u(gen), u(gen)}}, r2{{u(gen), u(gen), u(gen)}}, v1, v2;
+        const double tof = 20. * (u(gen) + 1.) + 1e-3;
+        const int cw = trial % 2;
+        lambert_problem lp(r1, r2, tof, 1., cw, 0);
+        lambert_problem::solve_0rev(v1, v2, r1, r2, tof, 1., cw);
+        if (v1 != lp.get_v1()[0] || v2 != lp.get_v2()[0]) {
+            std::cout << "solve_0rev differs from lambert_problem at trial " << trial << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main()
+{
+    int res = check_lambert();
+    for (auto enc : {trajopt::mga_evaluator::DIRECT, trajopt::mga_evaluator::ALPHA, trajopt::mga_evaluator::ETA}) {
+        res += check(enc, false) + check(enc, true);
+    }
+    if (res) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
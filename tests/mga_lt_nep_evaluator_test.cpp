@@ -0,0 +1,156 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/fb_con.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/planet/jpl_low_precision.hpp>
+#include <keplerian_toolbox/sims_flanagan/leg.hpp>
+#include <keplerian_toolbox/sims_flanagan/spacecraft.hpp>
+#include <keplerian_toolbox/trajopt/mga_lt_nep_evaluator.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we evaluate random decision vectors of an Earth-Venus-Mercury trajectory with the native
+// evaluator (serially and in parallel) and compare the result with a leg by leg evaluation written as in
+// pykep.trajopt.mga_lt_nep.
+
+std::vector<double> reference(const std::vector<planet::planet_ptr> &seq, const std::vector<unsigned> &n_seg,
+                              const std::vector<double> &x, double vinf_dep, double vinf_arr, double mass,
+                              const sims_flanagan::spacecraft &sc, bool hf)
+{
+    const std::size_t n_legs = n_seg.size();
+    std::vector<double> obj{-x[2 + 8 * (n_legs - 1)]}, ec, ic;
+    std::vector<double> t_P(n_legs + 1);
+    std::vector<array3D> r_P(n_legs + 1), v_P(n_legs + 1);
+    for (std::size_t i = 0; i <= n_legs; ++i) {
+        t_P[i] = x[0];
+        for (std::size_t j = 0; j < i; ++j) {
+            t_P[i] += x[1 + 8 * j];
+        }
+        seq[i]->eph(epoch(t_P[i]), r_P[i], v_P[i]);
+    }
+    std::size_t idx = 1 + 8 * n_legs;
+    for (std::size_t i = 0; i < n_legs; ++i) {
+        array3D v0, vf;
+        for (unsigned j = 0; j < 3; ++j) {
+            v0[j] = v_P[i][j] + x[3 + 8 * i + j];
+            vf[j] = v_P[i + 1][j] + x[6 + 8 * i + j];
+        }
+        sims_flanagan::sc_state x0(r_P[i], v0, i == 0 ? mass : x[2 + 8 * (i - 1)]);
+        sims_flanagan::sc_state xf(r_P[i + 1], vf, x[2 + 8 * i]);
+        std::vector<double> thr(x.begin() + idx, x.begin() + idx + 3 * n_seg[i]);
+        idx += 3 * n_seg[i];
+        sims_flanagan::leg l(epoch(t_P[i]), x0, thr, epoch(t_P[i + 1]), xf, sc, ASTRO_MU_SUN);
+        l.set_high_fidelity(hf);
+        array7D m;
+        l.get_mismatch_con(m.begin(), m.end());
+        for (unsigned j = 0; j < 7; ++j) {
+            ec.push_back(m[j] / (j < 3 ? ASTRO_AU : (j < 6 ? ASTRO_EARTH_VELOCITY : mass)));
+        }
+        std::vector<double> tc(n_seg[i]);
+        l.get_throttles_con(tc.begin(), tc.end());
+        ic.insert(ic.end(), tc.begin(), tc.end());
+    }
+    const double ev2 = ASTRO_EARTH_VELOCITY * ASTRO_EARTH_VELOCITY;
+    for (std::size_t i = 0; i + 1 < n_legs; ++i) {
+        array3D vin, vout;
+        std::copy(x.begin() + 6 + 8 * i, x.begin() + 9 + 8 * i, vin.begin());
+        std::copy(x.begin() + 11 + 8 * i, x.begin() + 14 + 8 * i, vout.begin());
+        double dv, alpha;
+        fb_con(dv, alpha, vin, vout, *seq[i + 1]);
+        ec.push_back(dv / ev2);
+        ic.push_back(alpha);
+    }
+    const std::size_t a = 6 + 8 * (n_legs - 1);
+    ic.push_back((x[3] * x[3] + x[4] * x[4] + x[5] * x[5] - vinf_dep * vinf_dep) / ev2);
+    ic.push_back((x[a] * x[a] + x[a + 1] * x[a + 1] + x[a + 2] * x[a + 2] - vinf_arr * vinf_arr) / ev2);
+    obj.insert(obj.end(), ec.begin(), ec.end());
+    obj.insert(obj.end(), ic.begin(), ic.end());
+    return obj;
+}
+
+int check(bool hf)
+{
+    std::vector<planet::planet_ptr> seq{planet::jpl_lp("earth").clone(), planet::jpl_lp("venus").clone(),
+                                        planet::jpl_lp("venus").clone(), planet::jpl_lp("mercury").clone()};
+    std::vector<unsigned> n_seg{5u, 10u, 20u};
+    const double mass = 2000., vinf_dep = 3000., vinf_arr = 2000.;
+    sims_flanagan::spacecraft sc(mass, 0.5, 3500.);
+    trajopt::mga_lt_nep_evaluator udp(seq, n_seg, vinf_dep, vinf_arr, mass, 0.5, 3500., false, hf);
+
+    std::mt19937 gen(123u);
+    std::uniform_real_distribution<double> u(-1., 1.);
+    std::vector<double> x(udp.get_nx());
+    for (int trial = 0; trial < 20; ++trial) {
+        x[0] = 3000. + 500. * u(gen);
+        for (std::size_t i = 0; i < n_seg.size(); ++i) {
+            x[1 + 8 * i] = 400. + 200. * u(gen);
+            x[2 + 8 * i] = mass - 100. * static_cast<double>(i + 1) + 50. * u(gen);
+            for (unsigned j = 3; j < 9; ++j) {
+                x[8 * i + j] = 3000. * u(gen);
+            }
+        }
+        for (std::size_t i = 1 + 8 * n_seg.size(); i < x.size(); ++i) {
+            x[i] = 0.5 * u(gen);
+        }
+        const auto ref = reference(seq, n_seg, x, vinf_dep, vinf_arr, mass, sc, hf);
+        if (ref.size() != udp.get_nobj() + udp.get_nec() + udp.get_nic()) {
+            std::cout << "Wrong fitness dimension" << std::endl;
+            return 1;
+        }
+        for (unsigned n_threads : {1u, 2u, 0u}) {
+            if (udp.fitness(x, n_threads) != ref) {
+                std::cout << "Fitness differs from the reference at trial " << trial << " with " << n_threads
+                          << " threads" << std::endl;
+                return 1;
+            }
+        }
+    }
+    x.pop_back();
+    try {
+        udp.fitness(x);
+        std::cout << "Wrong decision vector size not detected" << std::endl;
+        return 1;
+    } catch (const std::exception &) {
+    }
+    return 0;
+}
+
+int main()
+{
+    if (check(false) || check(true)) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
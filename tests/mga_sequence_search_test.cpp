@@ -0,0 +1,114 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <vector>
+
+#include <keplerian_toolbox/planet/jpl_low_precision.hpp>
+#include <keplerian_toolbox/trajopt/mga_evaluator.hpp>
+#include <keplerian_toolbox/trajopt/mga_sequence_search.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we search the Earth to Jupiter sequences over the inner planets and check that the solutions are
+// sorted, do not depend on the number of threads and have the DV of their decision vector for mga_evaluator.
+
+bool same(const std::vector<trajopt::mga_sequence_search::solution> &a,
+          const std::vector<trajopt::mga_sequence_search::solution> &b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+        if (a[i].seq != b[i].seq || a[i].x != b[i].x || a[i].dv != b[i].dv) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main()
+{
+    std::vector<planet::planet_ptr> planets{planet::jpl_lp("venus").clone(), planet::jpl_lp("earth").clone(),
+                                            planet::jpl_lp("mars").clone(), planet::jpl_lp("jupiter").clone()};
+    const double vinf = 3000.;
+    trajopt::mga_sequence_search search(planets, 1u, 3u, {{3000., 4000.}}, 11u, {{100., 1000.}}, 10u, vinf, 2u, 30u);
+    const auto sols = search.run(5u, 1u);
+    if (sols.empty() || sols.size() > 5u) {
+        std::cout << "Wrong number of solutions: " << sols.size() << std::endl;
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    for (std::size_t i = 0; i < sols.size(); ++i) {
+        const auto &s = sols[i];
+        if ((i > 0 && s.dv < sols[i - 1].dv) || s.seq.front() != 1u || s.seq.back() != 3u || s.seq.size() > 4u
+            || s.x.size() != s.seq.size()) {
+            std::cout << "Ill formed solution " << i << std::endl;
+            std::cout << "FAIL" << std::endl;
+            return 1;
+        }
+        std::vector<planet::planet_ptr> seq;
+        for (auto j : s.seq) {
+            seq.push_back(planets[j]);
+        }
+        trajopt::mga_evaluator ev(seq, trajopt::mga_evaluator::DIRECT, 0., vinf);
+        if (ev.fitness(s.x)[0] != s.dv) {
+            std::cout << "The DV of solution " << i << " is not the one of its decision vector" << std::endl;
+            std::cout << "FAIL" << std::endl;
+            return 1;
+        }
+    }
+    if (!same(sols, search.run(5u, 2u)) || !same(sols, search.run(5u, 0u))) {
+        std::cout << "The solutions depend on the number of threads" << std::endl;
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    // Without fly-bys the search is a grid search of the direct transfer
+    trajopt::mga_sequence_search direct(planets, 1u, 3u, {{3000., 4000.}}, 11u, {{100., 1000.}}, 10u, vinf, 0u);
+    trajopt::mga_evaluator ev({planets[1], planets[3]}, trajopt::mga_evaluator::DIRECT, 0., vinf);
+    double best = 1e300;
+    for (unsigned i = 0; i < 11u; ++i) {
+        for (unsigned j = 0; j < 10u; ++j) {
+            best = std::min(best, ev.fitness({3000. + 1000. * i / 10., 100. + 900. * j / 9.})[0]);
+        }
+    }
+    const auto d = direct.run(3u);
+    if (d.size() != 1u || d[0].dv != best) {
+        std::cout << "Wrong direct transfer" << std::endl;
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    try {
+        trajopt::mga_sequence_search(planets, 1u, 4u, {{3000., 4000.}}, 11u, {{100., 1000.}}, 10u);
+        std::cout << "Wrong arrival index not detected" << std::endl;
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    } catch (const std::exception &) {
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
@@ -0,0 +1,98 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <keplerian_toolbox/catalog/mpcorb_catalog.hpp>
+#include <keplerian_toolbox/planet/mpcorb.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we write a small MPCORB.DAT-like file (header, section separators, windows line endings)
+// and check that the catalog, loaded serially and in parallel, matches planet::mpcorb line by line.
+
+static const std::vector<std::string> lines
+    = {"00001    3.34  0.12 K107N 113.41048   72.58976   80.39321   10.58682  0.0791382  0.21432817   2.7653485  0 "
+       "MPO110568  6063  94 1802-2006 0.61 M-v 30h MPCW       0000      (1) Ceres              20061025",
+       "00002    4.13  0.15 K107N  96.14812  310.15094  173.12949   34.84102  0.2312763  0.21353673   2.7721318  0 "
+       "MPO250000  8155 102 1802-2010 0.55 M-v 38h MPCLINUX   0000     (2) Pallas              20100409",
+       "K10A01X        0.15 K134G 357.44531  161.32770    4.71383    2.00543  0.6181047  0.50173052   1.5874005  0 "
+       "MPO250000    12   1    8 days 0.55 M-v 38h MPCLINUX   0000 2010 AX1",
+       "a0001   17.50  0.15 K14BL  12.01234  250.55555  100.00000  150.12345  0.1034567  0.01234567  42.1234567  0 "
+       "MPO250000    33   2 2012-2013 0.55 M-v 38h MPCLINUX   0000 2000 ZZ9"};
+
+int main()
+{
+    const unsigned n_rep = 2500u;
+    {
+        std::ofstream out("mpcorb_catalog_test.dat", std::ios::binary);
+        out << "MINOR PLANET CENTER ORBIT DATABASE (MPCORB)\n\n";
+        out << "Des'n     H     G   Epoch     M        Peri.      Node       Incl.       e            n           a\n";
+        out << std::string(160, '-') << "\n";
+        for (unsigned k = 0u; k < n_rep; ++k) {
+            for (const auto &l : lines) {
+                out << l << ((k % 3u) ? "\n" : "\r\n");
+            }
+            if (k % 1000u == 0u) {
+                out << "\n";
+            }
+        }
+    }
+
+    bool ok = true;
+    for (unsigned n_threads : {1u, 4u, 7u}) {
+        catalog::mpcorb_catalog cat("mpcorb_catalog_test.dat", n_threads);
+        if (cat.size() != n_rep * lines.size()) {
+            std::cout << "Wrong catalog size: " << cat.size() << std::endl;
+            return 1;
+        }
+        for (std::size_t idx = 0u; idx < cat.size(); ++idx) {
+            // planet::mpcorb expects full width lines
+            std::string line = lines[idx % lines.size()];
+            line.resize(202, ' ');
+            planet::mpcorb ref(line);
+            planet::mpcorb pl = cat.get_planet(idx);
+            array3D r1, v1, r2, v2;
+            ref.eph(7000., r1, v1);
+            pl.eph(7000., r2, v2);
+            ok = ok && ref.get_elements() == pl.get_elements() && ref.get_ref_mjd2000() == pl.get_ref_mjd2000()
+                 && ref.get_H() == pl.get_H() && ref.get_n_observations() == pl.get_n_observations()
+                 && ref.get_n_oppositions() == pl.get_n_oppositions()
+                 && ref.get_year_of_discovery() == pl.get_year_of_discovery() && ref.get_name() == pl.get_name()
+                 && ref.get_radius() == pl.get_radius() && ref.get_mu_self() == pl.get_mu_self() && r1 == r2
+                 && v1 == v2;
+            if (!ok) {
+                std::cout << "Mismatch at index " << idx << " with " << n_threads << " threads" << std::endl;
+                std::cout << ref << std::endl << pl << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
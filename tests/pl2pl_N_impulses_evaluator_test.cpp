@@ -0,0 +1,184 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <array>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <boost/math/constants/constants.hpp>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/ic2par.hpp>
+#include <keplerian_toolbox/core_functions/propagate_lagrangian_u.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/lambert_problem.hpp>
+#include <keplerian_toolbox/planet/jpl_low_precision.hpp>
+#include <keplerian_toolbox/trajopt/batch_fitness.hpp>
+#include <keplerian_toolbox/trajopt/pl2pl_N_impulses_evaluator.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we evaluate random decision vectors of Earth-Mars N impulses transfers with the native evaluator and
+// compare the result with an evaluation written as in pykep.trajopt.pl2pl_N_impulses (lambert_problem objects,
+// propagate_lagrangian and ic2par).
+
+double norm3(const array3D &a, const array3D &b)
+{
+    return std::sqrt((a[0] - b[0]) * (a[0] - b[0]) + (a[1] - b[1]) * (a[1] - b[1]) + (a[2] - b[2]) * (a[2] - b[2]));
+}
+
+std::vector<double> reference(const planet::base &start, const planet::base &target, unsigned N,
+                              const std::vector<double> &x, bool phase_free, double e_target = 0.,
+                              double rp_target = 0.)
+{
+    const double pi = boost::math::constants::pi<double>(), mu = start.get_mu_central_body();
+    std::vector<double> T(N - 1);
+    double total = 0.;
+    for (unsigned i = 0; i < N - 1; ++i) {
+        T[i] = std::log(x[2 + 4 * i]);
+        total += T[i];
+    }
+    for (auto &t : T) {
+        t = x[1] * t / total;
+    }
+    array3D r, v, r_target, v_target;
+    start.eph(epoch(x[0]), r, v);
+    target.eph(epoch(phase_free ? x.back() : x[0] + x[1]), r_target, v_target);
+    double DV_others = 0.;
+    for (unsigned i = 0; i + 1 < N - 1; ++i) {
+        const double theta = 2 * pi * x[3 + 4 * i], phi = std::acos(2 * x[4 + 4 * i] - 1) - pi / 2;
+        v[0] += x[5 + 4 * i] * std::cos(phi) * std::cos(theta);
+        v[1] += x[5 + 4 * i] * std::cos(phi) * std::sin(theta);
+        v[2] += x[5 + 4 * i] * std::sin(phi);
+        propagate_lagrangian_u(r, v, T[i] * ASTRO_DAY2SEC, mu);
+        DV_others += x[5 + 4 * i];
+    }
+    std::array<double, 6> E;
+    ic2par(r, v, mu, E);
+    lambert_problem l(r, r_target, T.back() * ASTRO_DAY2SEC, mu, E[2] > pi / 2, 0);
+    double DV2 = norm3(l.get_v2()[0], v_target);
+    if (rp_target > 0.) {
+        const double mu_p = target.get_mu_self();
+        const double dv_per = std::sqrt(DV2 * DV2 + 2 * mu_p / rp_target);
+        const double dv_per2 = std::sqrt(2 * mu_p / rp_target - mu_p / rp_target * (1. - e_target));
+        DV2 = std::abs(dv_per - dv_per2);
+    }
+    return {norm3(l.get_v1()[0], v) + DV2 + DV_others, x[1]};
+}
+
+int check(unsigned N, bool phase_free)
+{
+    planet::jpl_lp earth("earth"), mars("mars");
+    trajopt::pl2pl_N_impulses_evaluator udp(earth, mars, N, {{200., 700.}}, {{0., 4000.}}, phase_free, true,
+                                            {{10000., 11000.}});
+    const auto &lb = udp.get_lb(), &ub = udp.get_ub();
+    if (lb.size() != udp.get_nx() || ub.size() != udp.get_nx()) {
+        std::cout << "Bounds have the wrong size" << std::endl;
+        return 1;
+    }
+    if (phase_free && std::abs(ub[0] - 2 * earth.compute_period() * ASTRO_SEC2DAY) > 1e-9) {
+        std::cout << "Launch epoch bound is not two periods of the start planet" << std::endl;
+        return 1;
+    }
+
+    std::mt19937 gen(123u);
+    std::uniform_real_distribution<double> u(0., 1.);
+    std::vector<double> x(udp.get_nx()), f, dvs;
+    for (int trial = 0; trial < 100; ++trial) {
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            x[i] = lb[i] + (ub[i] - lb[i]) * u(gen);
+        }
+        udp.fitness(x, f);
+        if (f != reference(earth, mars, N, x, phase_free)) {
+            std::cout << "Fitness differs from the reference at trial " << trial << std::endl;
+            return 1;
+        }
+        dvs.insert(dvs.end(), x.begin(), x.end());
+    }
+    // Batch evaluation
+    const auto bf = trajopt::batch_fitness(udp, dvs, 2u);
+    for (std::size_t i = 0; i < 100u; ++i) {
+        std::vector<double> xi(dvs.begin() + i * x.size(), dvs.begin() + (i + 1) * x.size());
+        if (udp.fitness(xi) != std::vector<double>(bf.begin() + 2 * i, bf.begin() + 2 * (i + 1))) {
+            std::cout << "Batch fitness differs from the fitness" << std::endl;
+            return 1;
+        }
+    }
+    x.pop_back();
+    try {
+        udp.fitness(x);
+        std::cout << "Wrong decision vector size not detected" << std::endl;
+        return 1;
+    } catch (const std::exception &) {
+    }
+    return 0;
+}
+
+// With orbit insertion the arrival relative velocity is replaced by the pericenter burn
+int check_orbit_insertion()
+{
+    planet::jpl_lp earth("earth"), mars("mars");
+    const double e_target = 0.5, rp_target = 4000000.;
+    trajopt::pl2pl_N_impulses_evaluator udp(earth, mars, 3u, {{200., 700.}}, {{0., 4000.}}, false, false,
+                                            {{10000., 11000.}}, true, e_target, rp_target);
+    const std::vector<double> x{10500., 400., 0.3, 0.2, 0.7, 500., 0.6};
+    if (udp.fitness(x)[0] != reference(earth, mars, 3u, x, false, e_target, rp_target)[0]) {
+        std::cout << "Orbit insertion fitness differs from the reference" << std::endl;
+        return 1;
+    }
+    try {
+        trajopt::pl2pl_N_impulses_evaluator(earth, mars, 3u, {{200., 700.}}, {{0., 4000.}}, false, false,
+                                            {{10000., 11000.}}, true, e_target, 0.);
+        std::cout << "Non positive rp_target not detected" << std::endl;
+        return 1;
+    } catch (const std::exception &) {
+    }
+    return 0;
+}
+
+int main()
+{
+    int res = 0;
+    for (unsigned N : {2u, 3u, 5u}) {
+        res += check(N, false) + check(N, true);
+    }
+    res += check_orbit_insertion();
+    try {
+        trajopt::pl2pl_N_impulses_evaluator(planet::jpl_lp("earth"), planet::jpl_lp("mars"), 1u, {{200., 700.}},
+                                            {{0., 4000.}});
+        std::cout << "N less than 2 not detected" << std::endl;
+        res += 1;
+    } catch (const std::exception &) {
+    }
+    if (res) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
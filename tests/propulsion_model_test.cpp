@@ -0,0 +1,188 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include <keplerian_toolbox/core_functions/propagate_taylor.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/planet/jpl_low_precision.hpp>
+#include <keplerian_toolbox/serialization.hpp>
+#include <keplerian_toolbox/sims_flanagan/leg.hpp>
+#include <keplerian_toolbox/sims_flanagan/leg_s.hpp>
+#include <keplerian_toolbox/sims_flanagan/propulsion_model.hpp>
+#include <keplerian_toolbox/sims_flanagan/spacecraft.hpp>
+
+using namespace kep_toolbox;
+using sims_flanagan::propulsion_model;
+
+// In this test we check the propulsion models against their definition (the M-ARGO solar electric propulsion
+// model of pykep.trajopt.lt_margo for the solar polynomial) and that legs use them at every segment.
+
+// The M-ARGO model, as written in pykep.trajopt.lt_margo
+void margo(double r, double &thrust, double &isp)
+{
+    double Pbmp = -40.558 * r * r * r + 173.49 * r * r - 259.19 * r + 141.86;
+    double P = -146.26 * r * r * r + 658.52 * r * r - 1059.2 * r + 648.24;
+    if (Pbmp < 13.75) {
+        P -= (13.75 - Pbmp);
+    }
+    double Pin = std::min(0.92 * P, 120.);
+    thrust = std::max((26.27127 * Pin - 708.973) / 1000000, 0.);
+    isp = -0.0011 * Pin * Pin * Pin + 0.175971 * Pin * Pin + 4.193797 * Pin + 2037.213;
+}
+
+bool close(double a, double b)
+{
+    return std::abs(a - b) <= 1e-12 * std::max(1., std::abs(b));
+}
+
+int check_models()
+{
+    auto sep = propulsion_model::solar_polynomial({648.24, -1059.2, 658.52, -146.26},
+                                                  {141.86, -259.19, 173.49, -40.558}, 13.75, 0.92, 120.,
+                                                  {-708.973e-6, 26.27127e-6}, {2037.213, 4.193797, 0.175971, -0.0011});
+    for (double r = 0.7; r < 3.; r += 0.01) {
+        double T, isp, T_ref, isp_ref;
+        sep.eval(r, 0., 0., T, isp);
+        margo(r, T_ref, isp_ref);
+        if (!close(T, T_ref) || !close(isp, isp_ref)) {
+            std::cout << "Solar polynomial model differs from the M-ARGO model at r = " << r << std::endl;
+            return 1;
+        }
+    }
+    auto tab = propulsion_model::tabulated({1., 2., 4.}, {0.2, 0.1, 0.}, {3000., 2000., 1000.});
+    const std::vector<std::array<double, 3>> expected{
+        {{0.5, 0.2, 3000.}}, {{1., 0.2, 3000.}}, {{1.5, 0.15, 2500.}}, {{3., 0.05, 1500.}}, {{5., 0., 1000.}}};
+    for (const auto &e : expected) {
+        double T, isp;
+        tab.eval(e[0], 0., 0., T, isp);
+        if (!close(T, e[1]) || !close(isp, e[2])) {
+            std::cout << "Wrong interpolation of the tabulated model at r = " << e[0] << std::endl;
+            return 1;
+        }
+    }
+    // Spacecraft serialization keeps the model
+    sims_flanagan::spacecraft sc(20., 0.0017, 3000.);
+    sc.set_propulsion_model(sep);
+    std::stringstream ss;
+    {
+        boost::archive::text_oarchive oa(ss);
+        oa << sc;
+    }
+    sims_flanagan::spacecraft sc2;
+    {
+        boost::archive::text_iarchive ia(ss);
+        ia >> sc2;
+    }
+    if (sc2.get_propulsion_model() != sep || sc2.get_thrust() != sc.get_thrust()) {
+        std::cout << "The propulsion model is not serialized" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int check_legs()
+{
+    const unsigned n_seg = 10u;
+    planet::jpl_lp earth("earth"), mars("mars");
+    array3D r, v;
+    earth.eph(epoch(1000.), r, v);
+    sims_flanagan::sc_state xi(r, v, 1000.);
+    mars.eph(epoch(1300.), r, v);
+    sims_flanagan::sc_state xf(r, v, 900.);
+    std::vector<double> thr(3 * n_seg, 0.3);
+
+    // A flat table gives exactly the constant model
+    sims_flanagan::spacecraft sc(1000., 0.3, 2500.), flat(sc);
+    flat.set_propulsion_model(propulsion_model::tabulated({0.5, 3.}, {0.3, 0.3}, {2500., 2500.}));
+    for (bool hf : {false, true}) {
+        sims_flanagan::leg l1(epoch(1000.), xi, thr, epoch(1300.), xf, sc, ASTRO_MU_SUN);
+        sims_flanagan::leg l2(epoch(1000.), xi, thr, epoch(1300.), xf, flat, ASTRO_MU_SUN);
+        l1.set_high_fidelity(hf);
+        l2.set_high_fidelity(hf);
+        array7D m1, m2;
+        l1.get_mismatch_con(m1.begin(), m1.end());
+        l2.get_mismatch_con(m2.begin(), m2.end());
+        if (m1 != m2) {
+            std::cout << "A flat table does not reproduce the constant model" << std::endl;
+            return 1;
+        }
+    }
+    sims_flanagan::leg_s s1(n_seg, 1. / ASTRO_AU, 1.), s2(n_seg, 1. / ASTRO_AU, 1.);
+    s1.set_leg(epoch(1000.), xi, thr, epoch(1300.), xf, 300. * ASTRO_DAY2SEC, sc, ASTRO_MU_SUN);
+    s2.set_leg(epoch(1000.), xi, thr, epoch(1300.), xf, 300. * ASTRO_DAY2SEC, flat, ASTRO_MU_SUN);
+    if (s1.compute_mismatch_con() != s2.compute_mismatch_con()) {
+        std::cout << "A flat table does not reproduce the constant model in leg_s" << std::endl;
+        return 1;
+    }
+
+    // A distance dependent model is evaluated at the beginning of each high-fidelity segment
+    sims_flanagan::spacecraft varying(sc);
+    varying.set_propulsion_model(propulsion_model::tabulated({0.9, 1.7}, {0.5, 0.1}, {3000., 2000.}));
+    sims_flanagan::leg l(epoch(1000.), xi, thr, epoch(1300.), xf, varying, ASTRO_MU_SUN);
+    l.set_high_fidelity(true);
+    array7D m;
+    l.get_mismatch_con(m.begin(), m.end());
+    const double dt = 300. / n_seg * ASTRO_DAY2SEC;
+    array3D rf = xi.get_position(), vf = xi.get_velocity(), rb = xf.get_position(), vb = xf.get_velocity(), u;
+    double mf = xi.get_mass(), mb = xf.get_mass(), T, isp;
+    for (unsigned i = 0u; i < n_seg / 2u; ++i) {
+        varying.get_thrust_isp(rf, T, isp);
+        u = {{0.3 * T, 0.3 * T, 0.3 * T}};
+        propagate_taylor(rf, vf, mf, u, dt, ASTRO_MU_SUN, isp * ASTRO_G0, -10, -10);
+        varying.get_thrust_isp(rb, T, isp);
+        u = {{0.3 * T, 0.3 * T, 0.3 * T}};
+        propagate_taylor(rb, vb, mb, u, -dt, ASTRO_MU_SUN, isp * ASTRO_G0, -10, -10);
+    }
+    const array7D expected{{rf[0] - rb[0], rf[1] - rb[1], rf[2] - rb[2], vf[0] - vb[0], vf[1] - vb[1],
+                            vf[2] - vb[2], mf - mb}};
+    if (m != expected) {
+        std::cout << "The high-fidelity leg does not use the propulsion model at each segment" << std::endl;
+        return 1;
+    }
+    sims_flanagan::leg lc(epoch(1000.), xi, thr, epoch(1300.), xf, sc, ASTRO_MU_SUN);
+    lc.set_high_fidelity(true);
+    array7D mc;
+    lc.get_mismatch_con(mc.begin(), mc.end());
+    if (mc == m) {
+        std::cout << "The propulsion model has no effect" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main()
+{
+    if (check_models() || check_legs()) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
@@ -0,0 +1,110 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <keplerian_toolbox/catalog/sgp4_soa.hpp>
+#include <keplerian_toolbox/catalog/tle_catalog.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we propagate the two line elements of sgp4_test.txt (plus a deep space and a decaying
+// object) with the structure-of-arrays SGP4 and with libsgp4 (via tle_catalog) at several epochs.
+// The test passes if the statuses agree and positions differ by less than 1 mm (and velocities by
+// less than 1 micrometer per second).
+
+int main()
+{
+    std::ifstream txtfile("sgp4_test.txt");
+    if (!txtfile.good()) {
+        std::cout << "File sgp4_test.txt not found" << std::endl;
+        return 1; // exit if file not found
+    }
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(txtfile, line)) {
+        lines.push_back(line);
+    }
+    // Deep space
+    lines.push_back("1 23177U 94040C   06175.45752052  .00000386  00000-0  76590-3 0    95");
+    lines.push_back("2 23177   7.0496 179.8238 7258491 296.0482   8.3061  2.25906668 97438");
+    // Decaying
+    lines.push_back("1 25544U 98067A   08264.51782528 -.00002182  00000-0  50000-2 0  2927");
+    lines.push_back("2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537");
+
+    catalog::tle_catalog cat(lines);
+    catalog::sgp4_soa soa(cat);
+    std::cout << "Satellites: " << soa.size() << ", deep space: " << soa.get_n_deep_space() << std::endl;
+
+    const std::vector<double> &refs = cat.get_ref_mjd2000();
+    std::vector<double> epochs;
+    for (std::size_t i = 0u; i < refs.size(); i += refs.size() / 20u) {
+        epochs.push_back(refs[i] + 0.123);
+    }
+    epochs.push_back(refs.back() + 30.);
+
+    double max_err_r = 0., max_err_v = 0.;
+    std::size_t n_ok = 0u;
+    catalog::soa_states states;
+    std::vector<int> status;
+    std::vector<array3D> r, v;
+    std::vector<int> status_ref;
+    for (double when : epochs) {
+        soa.propagate(when, states, status, 3u);
+        cat.propagate(when, r, v, status_ref);
+        if (status != status_ref) {
+            std::cout << "Statuses differ at epoch " << when << std::endl;
+            std::cout << "FAIL" << std::endl;
+            return 1;
+        }
+        for (std::size_t i = 0u; i < cat.size(); ++i) {
+            if (status[i] != catalog::tle_catalog::ok) {
+                continue;
+            }
+            ++n_ok;
+            max_err_r = std::max(max_err_r, std::sqrt((states.x[i] - r[i][0]) * (states.x[i] - r[i][0])
+                                                      + (states.y[i] - r[i][1]) * (states.y[i] - r[i][1])
+                                                      + (states.z[i] - r[i][2]) * (states.z[i] - r[i][2])));
+            max_err_v = std::max(max_err_v, std::sqrt((states.vx[i] - v[i][0]) * (states.vx[i] - v[i][0])
+                                                      + (states.vy[i] - v[i][1]) * (states.vy[i] - v[i][1])
+                                                      + (states.vz[i] - v[i][2]) * (states.vz[i] - v[i][2])));
+        }
+    }
+    std::cout << "Successful propagations: " << n_ok << std::endl;
+    std::cout << "Max error r (m): " << max_err_r << std::endl;
+    std::cout << "Max error v (m/s): " << max_err_v << std::endl;
+    if (n_ok > 0u && max_err_r < 1e-3 && max_err_v < 1e-6 && status.back() == catalog::tle_catalog::decayed) {
+        std::cout << "PASS" << std::endl;
+        return 0;
+    } else {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,125 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/eq2ic.hpp>
+#include <keplerian_toolbox/core_functions/eq2par.hpp>
+#include <keplerian_toolbox/core_functions/ic2eq.hpp>
+#include <keplerian_toolbox/core_functions/ic2par.hpp>
+#include <keplerian_toolbox/core_functions/par2eq.hpp>
+#include <keplerian_toolbox/core_functions/par2ic.hpp>
+#include <keplerian_toolbox/core_functions/soa_conversions.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we compare the structure-of-arrays element conversions with the scalar ones, on elliptic and
+// hyperbolic, prograde and retrograde orbits.
+
+int compare(const std::string &name, const soa6D &soa, std::size_t j, const array6D &ref)
+{
+    for (unsigned c = 0; c < 6; ++c) {
+        if (!(std::abs(soa[c][j] - ref[c]) <= 1e-10 * std::max(1., std::abs(ref[c])))) {
+            std::cout << name << " differs from the scalar version, state " << j << " component " << c << ": "
+                      << soa[c][j] << " " << ref[c] << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main()
+{
+    std::mt19937 gen(13u);
+    std::uniform_real_distribution<double> u(0., 1.);
+    const double mu = 1.3;
+    const std::size_t n = 2000u;
+    soa6D E;
+    detail::soa_resize(E, n);
+    for (std::size_t j = 0; j < n; ++j) {
+        const bool hyperbolic = j % 2u;
+        E[0][j] = 0.5 + 2.5 * u(gen);
+        E[1][j] = hyperbolic ? 1.1 + 2. * u(gen) : 0.01 + 0.9 * u(gen);
+        E[2][j] = 0.05 + 3. * u(gen);
+        E[3][j] = 6.2 * u(gen);
+        E[4][j] = 6.2 * u(gen);
+        E[5][j] = hyperbolic ? 2.4 * u(gen) - 1.2 : 6.2 * u(gen) - 3.1;
+    }
+
+    int res = 0;
+    soa6D rv, E2, EQ, rv2, E3, EQ2;
+    par2ic_soa(E, mu, rv);
+    ic2par_soa(rv, mu, E2);
+    for (std::size_t j = 0; j < n && !res; ++j) {
+        const array6D el{{E[0][j], E[1][j], E[2][j], E[3][j], E[4][j], E[5][j]}};
+        array3D r, v;
+        par2ic(el, mu, r, v);
+        res += compare("par2ic_soa", rv, j, {{r[0], r[1], r[2], v[0], v[1], v[2]}});
+        const array3D r_soa{{rv[0][j], rv[1][j], rv[2][j]}}, v_soa{{rv[3][j], rv[4][j], rv[5][j]}};
+        array6D ref;
+        ic2par(r_soa, v_soa, mu, ref);
+        res += compare("ic2par_soa", E2, j, ref);
+    }
+    for (bool retrograde : {false, true}) {
+        ic2eq_soa(rv, mu, EQ, retrograde);
+        eq2ic_soa(EQ, mu, rv2, retrograde);
+        eq2par_soa(E3, EQ, retrograde);
+        par2eq_soa(EQ2, E, retrograde);
+        for (std::size_t j = 0; j < n && !res; ++j) {
+            const array3D r{{rv[0][j], rv[1][j], rv[2][j]}}, v{{rv[3][j], rv[4][j], rv[5][j]}};
+            array6D ref;
+            ic2eq(r, v, mu, ref, retrograde);
+            res += compare("ic2eq_soa", EQ, j, ref);
+            const array6D eq{{EQ[0][j], EQ[1][j], EQ[2][j], EQ[3][j], EQ[4][j], EQ[5][j]}};
+            array3D r2, v2;
+            eq2ic(eq, mu, r2, v2, retrograde);
+            res += compare("eq2ic_soa", rv2, j, {{r2[0], r2[1], r2[2], v2[0], v2[1], v2[2]}});
+            eq2par(ref, eq, retrograde);
+            res += compare("eq2par_soa", E3, j, ref);
+            const array6D el{{E[0][j], E[1][j], E[2][j], E[3][j], E[4][j], E[5][j]}};
+            par2eq(ref, el, retrograde);
+            res += compare("par2eq_soa", EQ2, j, ref);
+        }
+    }
+    E[5].pop_back();
+    try {
+        par2ic_soa(E, mu, rv);
+        std::cout << "Components of different sizes not detected" << std::endl;
+        res = 1;
+    } catch (const std::exception &) {
+    }
+    if (res) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
@@ -0,0 +1,96 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <atomic>
+#include <exception>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <keplerian_toolbox/planet/spice.hpp>
+
+// In this test we compute the ephemerides of the same SPICE planet from many threads at once,
+// mixing single and batch calls, failing queries and kernel reloads, and check that every thread
+// gets exactly what a serial evaluation returns.
+using namespace kep_toolbox;
+
+int main()
+{
+    util::load_spice_kernel("C_G_1000012_2012_2017.bsp");
+    planet::spice pl("CHURYUMOV-GERASIMENKO", "SUN", "ECLIPJ2000", "NONE");
+
+    // Serial reference (the epochs repeat so that the per-thread caches are hit too)
+    std::vector<double> epochs;
+    for (unsigned i = 0u; i < 200u; ++i) {
+        epochs.push_back(4500. + (i % 50u) * 30.);
+    }
+    std::vector<array3D> r_ref, v_ref;
+    pl.eph(epochs, r_ref, v_ref);
+
+    std::atomic<unsigned> n_errors(0u);
+    std::vector<std::thread> threads;
+    for (unsigned t = 0u; t < 16u; ++t) {
+        threads.emplace_back([t, &pl, &epochs, &r_ref, &v_ref, &n_errors]() {
+            // Odd threads use their own copy of the planet, even threads share the original one
+            planet::spice copy(pl);
+            const planet::spice &my_pl = (t % 2u) ? copy : pl;
+            array3D r, v;
+            std::vector<array3D> rs, vs;
+            for (unsigned k = 0u; k < 20u; ++k) {
+                for (size_t i = 0; i < epochs.size(); ++i) {
+                    my_pl.eph(epochs[i], r, v);
+                    if (r != r_ref[i] || v != v_ref[i]) {
+                        ++n_errors;
+                    }
+                }
+                my_pl.eph(epochs, rs, vs);
+                if (rs != r_ref || vs != v_ref) {
+                    ++n_errors;
+                }
+                // Out of the kernel coverage: must throw, and must not leave SPICE in a failed state
+                try {
+                    my_pl.eph(0., r, v);
+                    ++n_errors;
+                } catch (const std::exception &) {
+                }
+                if (t == 0u && k % 5u == 0u) {
+                    util::load_spice_kernel("C_G_1000012_2012_2017.bsp");
+                }
+            }
+        });
+    }
+    for (auto &th : threads) {
+        th.join();
+    }
+
+    std::cout << "Mismatches: " << n_errors << std::endl;
+    if (n_errors == 0u && !failed_c()) {
+        std::cout << "PASS" << std::endl;
+        return 0;
+    } else {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,127 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/three_impulses_approximation.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/phasing/three_impulses_matrix.hpp>
+#include <keplerian_toolbox/planet/keplerian.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we compare the three impulses cost matrix, and its top-k version, with the scalar
+// three_impulses_approx evaluated on each pair of planets.
+
+std::vector<planet::planet_ptr> belt(unsigned n, std::mt19937 &gen)
+{
+    std::uniform_real_distribution<double> u(0., 1.);
+    std::vector<planet::planet_ptr> retval;
+    for (unsigned j = 0; j < n; ++j) {
+        const array6D elem{{(2. + u(gen)) * ASTRO_AU, 0.3 * u(gen), 0.4 * u(gen), 6.28 * u(gen), 6.28 * u(gen),
+                            6.28 * u(gen)}};
+        retval.push_back(planet::keplerian(epoch(6000.), elem, ASTRO_MU_SUN, 1., 1., 1.).clone());
+    }
+    return retval;
+}
+
+int main()
+{
+    std::mt19937 gen(3u);
+    const auto A = belt(300u, gen), B = belt(1500u, gen);
+    const phasing::soa_elements elA(A, 7000.), elB(B, 7000., 2u);
+    const std::size_t k = 10u;
+    int res = 0;
+
+    for (unsigned n_threads : {1u, 3u, 0u}) {
+        // From A to B
+        std::vector<float> dv;
+        phasing::three_impulses_matrix(elA, elB, dv, n_threads);
+        std::vector<std::size_t> ids;
+        std::vector<float> knn_dv;
+        phasing::three_impulses_knn(elA, elB, k, ids, knn_dv, false, n_threads);
+        if (dv.size() != A.size() * B.size() || ids.size() != A.size() * k || knn_dv.size() != A.size() * k) {
+            std::cout << "Wrong size of the outputs" << std::endl;
+            return 1;
+        }
+        for (std::size_t i = 0; i < A.size(); ++i) {
+            std::vector<std::pair<double, std::size_t>> row;
+            for (std::size_t j = 0; j < B.size(); ++j) {
+                const double ref = three_impulses_approx(*A[i], *B[j], epoch(7000.), epoch(7000.));
+                if (std::abs(dv[i * B.size() + j] - ref) > 1e-5 * ref + 1e-3) {
+                    std::cout << "Transfer " << i << " -> " << j << " differs from the reference: "
+                              << dv[i * B.size() + j] << " " << ref << std::endl;
+                    res = 1;
+                }
+                row.emplace_back(ref, j);
+            }
+            std::sort(row.begin(), row.end());
+            for (std::size_t s = 0; s < k; ++s) {
+                if (ids[i * k + s] != row[s].second
+                    || std::abs(knn_dv[i * k + s] - row[s].first) > 1e-5 * row[s].first) {
+                    std::cout << "Wrong neighbour " << s << " of " << i << std::endl;
+                    res = 1;
+                }
+            }
+        }
+
+        // Within A, excluding the transfers to the same orbit
+        phasing::three_impulses_knn(elA, elA, A.size(), ids, knn_dv, true, n_threads);
+        for (std::size_t i = 0; i < A.size(); ++i) {
+            if (ids[i * A.size() + A.size() - 1u] != A.size() || !std::isinf(knn_dv[i * A.size() + A.size() - 1u])) {
+                std::cout << "Row " << i << " not padded" << std::endl;
+                res = 1;
+            }
+            for (std::size_t s = 0; s + 1u < A.size(); ++s) {
+                if (ids[i * A.size() + s] == i || (s && knn_dv[i * A.size() + s] < knn_dv[i * A.size() + s - 1u])) {
+                    std::cout << "Wrong neighbour " << s << " of " << i << " within the catalog" << std::endl;
+                    res = 1;
+                }
+            }
+        }
+    }
+    try {
+        phasing::soa_elements bad(elA);
+        bad.mu *= 2.;
+        std::vector<float> dv;
+        phasing::three_impulses_matrix(elA, bad, dv);
+        std::cout << "Different central bodies not detected" << std::endl;
+        res = 1;
+    } catch (const std::exception &) {
+    }
+    if (res) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
@@ -0,0 +1,111 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <keplerian_toolbox/catalog/tle_catalog.hpp>
+#include <keplerian_toolbox/planet/tle.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we load the historical two line elements of sgp4_test.txt in a catalog and check
+// that the batch propagation matches planet::tle exactly, whatever the number of threads. We also
+// check that a decaying object is reported in the status array rather than throwing.
+
+int main()
+{
+    std::ifstream txtfile("sgp4_test.txt");
+    if (!txtfile.good()) {
+        std::cout << "File sgp4_test.txt not found" << std::endl;
+        return 1; // exit if file not found
+    }
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(txtfile, line)) {
+        lines.push_back(line);
+    }
+    // A low orbit with a huge drag term (three line format)
+    lines.push_back("0 DECAYING OBJECT");
+    lines.push_back("1 25544U 98067A   08264.51782528 -.00002182  00000-0  50000-2 0  2927");
+    lines.push_back("2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537");
+
+    catalog::tle_catalog cat(lines, 4u);
+    std::cout << "Objects loaded: " << cat.size() << ", rejected: " << cat.get_n_rejected() << std::endl;
+    if (cat.size() != lines.size() / 2u || cat.get_n_rejected() != 0u
+        || cat.get_name(cat.size() - 1u) != "DECAYING OBJECT") {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    const std::size_t n_gps = cat.size() - 1u;
+
+    // Each element set propagated to the epoch of the next one, as in sgp4_test
+    std::vector<double> epochs(cat.get_ref_mjd2000().begin() + 1, cat.get_ref_mjd2000().begin() + 1 + n_gps);
+    std::vector<array3D> r, v;
+    std::vector<int> status;
+    cat.propagate(epochs, r, v, status);
+    for (std::size_t i = 0u; i + 1u < n_gps; ++i) {
+        planet::tle sat(cat.get_line1(i), cat.get_line2(i));
+        array3D r_ref, v_ref;
+        sat.eph(epochs[i], r_ref, v_ref);
+        const std::size_t idx = i * epochs.size() + i;
+        if (status[idx] != catalog::tle_catalog::ok || r[idx] != r_ref || v[idx] != v_ref) {
+            std::cout << "Mismatch for object " << i << std::endl;
+            std::cout << "FAIL" << std::endl;
+            return 1;
+        }
+    }
+
+    // All objects to one epoch, serial and parallel
+    std::vector<array3D> r1, v1, r4, v4;
+    std::vector<int> status1, status4;
+    const double when = cat.get_ref_mjd2000()[n_gps - 1u];
+    cat.propagate(when, r1, v1, status1, 1u);
+    cat.propagate(when, r4, v4, status4, 4u);
+    if (status1 != status4 || status1.size() != cat.size()) {
+        std::cout << "Wrong status array" << std::endl;
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    for (std::size_t i = 0u; i < cat.size(); ++i) {
+        if (status1[i] == catalog::tle_catalog::ok && (r1[i] != r4[i] || v1[i] != v4[i])) {
+            std::cout << "Serial and parallel propagations differ for object " << i << std::endl;
+            std::cout << "FAIL" << std::endl;
+            return 1;
+        }
+    }
+
+    // The decaying object, a month after its epoch
+    array3D r_dec, v_dec;
+    if (cat.propagate(n_gps, cat.get_ref_mjd2000()[n_gps] + 30., r_dec, v_dec) != catalog::tle_catalog::decayed) {
+        std::cout << "Decay not reported" << std::endl;
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}
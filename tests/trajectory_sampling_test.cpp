@@ -0,0 +1,193 @@
+/*****************************************************************************
+ *   Copyright (C) 2004-2018 The pykep development team,                     *
+ *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
+ *                                                                           *
+ *   https://gitter.im/esa/pykep                                             *
+ *   https://github.com/esa/pykep                                            *
+ *                                                                           *
+ *   act@esa.int                                                             *
+ *                                                                           *
+ *   This program is free software; you can redistribute it and/or modify    *
+ *   it under the terms of the GNU General Public License as published by    *
+ *   the Free Software Foundation; either version 2 of the License, or       *
+ *   (at your option) any later version.                                     *
+ *                                                                           *
+ *   This program is distributed in the hope that it will be useful,         *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
+ *   GNU General Public License for more details.                            *
+ *                                                                           *
+ *   You should have received a copy of the GNU General Public License       *
+ *   along with this program; if not, write to the                           *
+ *   Free Software Foundation, Inc.,                                         *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <keplerian_toolbox/astro_constants.hpp>
+#include <keplerian_toolbox/core_functions/propagate_lagrangian.hpp>
+#include <keplerian_toolbox/core_functions/propagate_taylor.hpp>
+#include <keplerian_toolbox/epoch.hpp>
+#include <keplerian_toolbox/lambert_problem.hpp>
+#include <keplerian_toolbox/planet/jpl_low_precision.hpp>
+#include <keplerian_toolbox/sims_flanagan/leg.hpp>
+#include <keplerian_toolbox/sims_flanagan/spacecraft.hpp>
+#include <keplerian_toolbox/util/trajectory_sampling.hpp>
+
+using namespace kep_toolbox;
+
+// In this test we check the trajectory samplers against the ephemerides, the Lambert solutions and the Taylor
+// propagation, and the samples of Sims-Flanagan legs against their state mismatch.
+
+int close(const std::string &name, const array3D &a, const array3D &b, double tol)
+{
+    for (unsigned c = 0; c < 3; ++c) {
+        if (!(std::abs(a[c] - b[c]) <= tol * std::max(std::abs(a[c]), std::abs(b[c])))) {
+            std::cout << name << ": component " << c << " " << a[c] << " " << b[c] << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int check_planet_and_lambert()
+{
+    int res = 0;
+    const unsigned N = 50u;
+    planet::jpl_lp earth("earth"), mars("mars");
+    std::vector<array3D> r, v;
+    util::sample_planet(earth, 1000., 1365., N, r, v);
+    for (unsigned k = 0; k < N && !res; ++k) {
+        array3D r_ref, v_ref;
+        earth.eph(1000. + 365. * k / (N - 1u), r_ref, v_ref);
+        res += close("sample_planet (position)", r[k], r_ref, 1e-14);
+        res += close("sample_planet (velocity)", v[k], v_ref, 1e-14);
+    }
+    array3D r1, v1, r2, v2;
+    earth.eph(1000., r1, v1);
+    mars.eph(1640., r2, v2);
+    lambert_problem l(r1, r2, 640. * ASTRO_DAY2SEC, ASTRO_MU_SUN, false, 1);
+    for (unsigned sol = 0; sol < l.get_v1().size() && !res; ++sol) {
+        util::sample_lambert(l, sol, N, r, v);
+        res += close("sample_lambert (start)", r.front(), l.get_r1(), 1e-14);
+        res += close("sample_lambert (end)", r.back(), l.get_r2(), 1e-8);
+        res += close("sample_lambert (arrival velocity)", v.back(), l.get_v2()[sol], 1e-8);
+        // Energy conservation
+        for (unsigned k = 1; k < N; ++k) {
+            auto energy = [&](unsigned j) {
+                return (v[j][0] * v[j][0] + v[j][1] * v[j][1] + v[j][2] * v[j][2]) / 2.
+                       - ASTRO_MU_SUN / std::sqrt(r[j][0] * r[j][0] + r[j][1] * r[j][1] + r[j][2] * r[j][2]);
+            };
+            if (!(std::abs(energy(k) - energy(0)) <= 1e-10 * std::abs(energy(0)))) {
+                std::cout << "sample_lambert: energy not conserved at sample " << k << std::endl;
+                return 1;
+            }
+        }
+    }
+    try {
+        util::sample_lambert(l, static_cast<unsigned>(l.get_v1().size()), N, r, v);
+        std::cout << "Wrong Lambert solution index not detected" << std::endl;
+        res = 1;
+    } catch (const std::exception &) {
+    }
+    try {
+        util::sample_planet(earth, 0., 1., 1u, r, v);
+        std::cout << "Too few samples not detected" << std::endl;
+        res = 1;
+    } catch (const std::exception &) {
+    }
+    return res;
+}
+
+int check_taylor()
+{
+    const array3D r0{{1., 0.1, 0.}}, v0{{0., 1., 0.1}}, thrust{{0.01, -0.02, 0.005}};
+    const double m0 = 1., veff = 1., tof = 7.;
+    for (unsigned N : {2u, 7u, 500u}) {
+        for (double sign : {1., -1.}) {
+            std::vector<array3D> r, v;
+            std::vector<double> m;
+            util::sample_taylor(r0, v0, m0, thrust, sign * tof, 1., veff, N, r, v, m);
+            for (unsigned k = 0; k < N; ++k) {
+                array3D r_ref = r0, v_ref = v0;
+                double m_ref = m0;
+                propagate_taylor(r_ref, v_ref, m_ref, thrust, sign * tof * k / (N - 1u), 1., veff, -10, -10);
+                if (close("sample_taylor (position)", r[k], r_ref, 1e-8)
+                    || close("sample_taylor (velocity)", v[k], v_ref, 1e-8)
+                    || !(std::abs(m[k] - m_ref) <= 1e-12)) {
+                    std::cout << "sample " << k << " of " << N << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+int check_leg(bool hf)
+{
+    const unsigned n_seg = 10u, N = 20u;
+    sims_flanagan::spacecraft sc(1000., 0.3, 2500.);
+    planet::jpl_lp earth("earth"), mars("mars");
+    array3D r, v;
+    earth.eph(epoch(1000.), r, v);
+    sims_flanagan::sc_state xi(r, v, 1000.);
+    mars.eph(epoch(1250.), r, v);
+    sims_flanagan::sc_state xf(r, v, 800.);
+    std::vector<double> thr(3 * n_seg);
+    for (unsigned i = 0; i < 3 * n_seg; ++i) {
+        thr[i] = 0.5 * std::sin(i + 1.);
+    }
+    sims_flanagan::leg l(epoch(1000.), xi, thr, epoch(1250.), xf, sc, ASTRO_MU_SUN);
+    l.set_high_fidelity(hf);
+    std::vector<array3D> rs, vs;
+    std::vector<double> ms;
+    l.sample_trajectory(N, rs, vs, ms);
+    if (rs.size() != 2u * n_seg * N || close("leg start", rs.front(), xi.get_position(), 1e-15)
+        || close("leg end", vs.back(), xf.get_velocity(), 1e-15) || ms.front() != xi.get_mass()
+        || ms.back() != xf.get_mass()) {
+        return 1;
+    }
+    // At the match point, the samples differ by the mismatch
+    array7D mismatch;
+    l.get_mismatch_con(mismatch.begin(), mismatch.end());
+    const std::size_t n_fwd = (n_seg + 1u) / 2u;
+    array3D r_fwd = rs[2u * n_fwd * N - 1u], v_fwd = vs[2u * n_fwd * N - 1u];
+    std::size_t back = 2u * n_fwd * N;
+    if (!hf) {
+        // In the impulsive model the mismatch is computed at the first backward impulse
+        const double dt = (l.get_t_f().mjd2000() - l.get_t_i().mjd2000()) / n_seg / 2. * ASTRO_DAY2SEC;
+        propagate_lagrangian(r_fwd, v_fwd, dt, ASTRO_MU_SUN);
+        back += N - 1u;
+    }
+    for (unsigned c = 0; c < 3; ++c) {
+        const double dr = r_fwd[c] - rs[back][c], dv = v_fwd[c] - vs[back][c];
+        if (!(std::abs(dr - mismatch[c]) <= 1e-8 * ASTRO_AU
+              && std::abs(dv - mismatch[3 + c]) <= 1e-8 * ASTRO_EARTH_VELOCITY)) {
+            std::cout << "Samples inconsistent with the mismatch: " << dr << " " << mismatch[c] << " " << dv << " "
+                      << mismatch[3 + c] << std::endl;
+            return 1;
+        }
+    }
+    if (!(std::abs(ms[2u * n_fwd * N - 1u] - ms[back] - mismatch[6]) <= 1e-6)) {
+        std::cout << "Samples inconsistent with the mass mismatch" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main()
+{
+    if (check_planet_and_lambert() || check_taylor() || check_leg(false) || check_leg(true)) {
+        std::cout << "FAIL" << std::endl;
+        return 1;
+    }
+    std::cout << "PASS" << std::endl;
+    return 0;
+}